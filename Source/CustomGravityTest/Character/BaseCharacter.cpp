@@ -866,12 +866,12 @@ FVector ABaseCharacter::GetNavAgentLocation() const
 
 	if (GetCharacterMovement() != nullptr)
 	{
-		AgentLocation = GetCharacterMovement()->GetActorFeetLocation();
+		AgentLocation = GetCharacterMovement()->GetGravityFeetLocation();
 	}
 
 	if (FNavigationSystem::IsValidLocation(AgentLocation) == false && CapsuleComponent != nullptr)
 	{
-		AgentLocation = GetActorLocation() - FVector(0, 0, CapsuleComponent->GetScaledCapsuleHalfHeight());
+		AgentLocation = GetActorLocation() + GetGravityDirection() * CapsuleComponent->GetScaledCapsuleHalfHeight();
 	}
 
 	return AgentLocation;
@@ -1553,7 +1553,13 @@ void ABaseCharacter::PreReplication( IRepChangedPropertyTracker & ChangedPropert
 
 	bProxyIsJumpForceApplied = (JumpForceTimeRemaining > 0.0f);
 	ReplicatedMovementMode = CharacterMovement->PackNetworkMovementMode();
-	ReplicatedGravityDirection = CharacterMovement->GetGravityDirection();
+
+	// Skip changes below the replicated precision, analytic fields change gravity slightly every frame.
+	const FVector GravityDirection = CharacterMovement->GetGravityDirection();
+	if (!ReplicatedGravityDirection.Equals(GravityDirection, BaseGravityNetSerialization::ReplicationTolerance))
+	{
+		ReplicatedGravityDirection = GravityDirection;
+	}
 
 	if(IsReplicatingMovement())
 	{
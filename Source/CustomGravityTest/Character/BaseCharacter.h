@@ -15,6 +15,7 @@
 #include "GameFramework/CharacterMovementReplication.h"
 #include "Animation/AnimationAsset.h"
 #include "BaseRootMotionSource.h"
+#include "BaseCharacterGravityNetSerialization.h"
 #include "BaseCharacter.generated.h"
 
 class AController;
@@ -365,16 +366,16 @@ protected:
 	UPROPERTY(Replicated)
 	uint8 ReplicatedMovementMode;
 
-	/** CharacterMovement Custom gravity direction replicated for simulated proxies. */
+	/** CharacterMovement Custom gravity direction replicated for simulated proxies. Only updated when it changes by more than the precision it is sent with. */
 	UPROPERTY(Replicated)
-	FVector_NetQuantizeNormal ReplicatedGravityDirection;
+	FVector_NetQuantizeGravity ReplicatedGravityDirection;
 
 	/** Flag that we are receiving replication of the based movement. */
 	UPROPERTY()
 	bool bInBaseReplication;
 
 	/** Cached version of the replicated gravity direction before replication. Used to compare if the value was changed as a result of replication. */
-	FVector_NetQuantizeNormal PreNetReceivedGravityDirection;
+	FVector_NetQuantizeGravity PreNetReceivedGravityDirection;
 public:
 	UFUNCTION()
 	void OnRep_ReplayLastTransformUpdateTimeStamp();
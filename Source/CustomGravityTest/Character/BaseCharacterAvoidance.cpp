@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BaseCharacterAvoidance.h"
+
+void FBaseCharacterAvoidanceHash::Reset(float InCellSize)
+{
+	Agents.Reset();
+	FirstAgentInCell.Reset();
+	NextAgentInCell.Reset();
+	MaxAgentRadius = 0.f;
+	MaxAgentHalfHeight = 0.f;
+	CellSize = FMath::Max(InCellSize, 1.f);
+}
+
+int32 FBaseCharacterAvoidanceHash::AddAgent(const FBaseCharacterAvoidanceAgent& Agent)
+{
+	const int32 AgentIndex = Agents.Add(Agent);
+	MaxAgentRadius = FMath::Max(MaxAgentRadius, Agent.Radius);
+	MaxAgentHalfHeight = FMath::Max(MaxAgentHalfHeight, Agent.HalfHeight);
+
+	int32& First = FirstAgentInCell.FindOrAdd(FCellKey{ GetCell(Agent.Location), Agent.GravityFieldId }, INDEX_NONE);
+	NextAgentInCell.Add(First);
+	First = AgentIndex;
+
+	return AgentIndex;
+}
+
+void FBaseCharacterAvoidanceHash::LockAgentVelocity(int32 AgentIndex, const FVector& Velocity)
+{
+	if (Agents.IsValidIndex(AgentIndex))
+	{
+		Agents[AgentIndex].Velocity = Velocity;
+		Agents[AgentIndex].bLocked = true;
+	}
+}
+
+FIntVector FBaseCharacterAvoidanceHash::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+FVector FBaseCharacterAvoidanceHash::ComputeAvoidanceVelocity(int32 AgentIndex, const FVector& DesiredVelocity, float ConsiderationRadius, float TimeToPredict, float RadiusExpansion) const
+{
+	const FBaseCharacterAvoidanceAgent& Agent = Agents[AgentIndex];
+	const FVector GravityUp = -Agent.GravityDirection;
+	const FVector PlaneVelocity = FVector::VectorPlaneProject(DesiredVelocity, GravityUp);
+	const FVector::FReal Speed = PlaneVelocity.Size();
+	if (Speed < UE_KINDA_SMALL_NUMBER || TimeToPredict <= 0.f)
+	{
+		return DesiredVelocity;
+	}
+
+	// Gather the obstacles once, relative to the agent and in its gravity plane.
+	struct FObstacle
+	{
+		FVector Offset;
+		FVector Velocity;
+		FVector::FReal RadiusSq;
+		bool bReciprocal;
+	};
+	TArray<FObstacle, TInlineAllocator<16>> Obstacles;
+	ForEachNeighbor(AgentIndex, ConsiderationRadius, [&](int32, const FBaseCharacterAvoidanceAgent& Neighbor)
+	{
+		Obstacles.Add({
+			FVector::VectorPlaneProject(Neighbor.Location - Agent.Location, GravityUp),
+			FVector::VectorPlaneProject(Neighbor.Velocity, GravityUp),
+			FMath::Square(Agent.Radius + Neighbor.Radius + RadiusExpansion),
+			!Neighbor.bLocked });
+	});
+
+	if (Obstacles.Num() == 0)
+	{
+		return DesiredVelocity;
+	}
+
+	// Number of obstacles a candidate velocity runs into within TimeToPredict.
+	auto CountCollisions = [&](const FVector& Candidate)
+	{
+		int32 NumCollisions = 0;
+		for (const FObstacle& Obstacle : Obstacles)
+		{
+			// Unlocked neighbors avoid too and take half of the effort: the agent only needs to cover half the relative velocity.
+			const FVector RelativeVelocity = Obstacle.bReciprocal ? (2.f * Candidate - PlaneVelocity - Obstacle.Velocity) : (Candidate - Obstacle.Velocity);
+			const FVector::FReal ApproachSpeed = RelativeVelocity | Obstacle.Offset;
+			if (ApproachSpeed <= 0.f)
+			{
+				continue;
+			}
+
+			if (Obstacle.Offset.SizeSquared() <= Obstacle.RadiusSq)
+			{
+				// Already overlapping, any velocity getting closer collides.
+				++NumCollisions;
+				continue;
+			}
+
+			const FVector::FReal ClosestTime = FMath::Min<FVector::FReal>(ApproachSpeed / RelativeVelocity.SizeSquared(), TimeToPredict);
+			if ((Obstacle.Offset - RelativeVelocity * ClosestTime).SizeSquared() < Obstacle.RadiusSq)
+			{
+				++NumCollisions;
+			}
+		}
+		return NumCollisions;
+	};
+
+	if (CountCollisions(PlaneVelocity) == 0)
+	{
+		return DesiredVelocity;
+	}
+
+	// Turn away from the desired direction in growing steps, then slow down. Stopping is the last resort.
+	static constexpr float SpeedScales[] = { 1.f, 0.66f, 0.33f };
+	static constexpr float TurnAngles[] = { 22.5f, 45.f, 67.5f, 90.f, 120.f };
+
+	const FVector Forward = PlaneVelocity / Speed;
+	const FVector Right = GravityUp ^ Forward;
+
+	// Candidates keep the part of the desired velocity along gravity, walking on ramps.
+	const FVector VerticalVelocity = DesiredVelocity - PlaneVelocity;
+
+	FVector BestVelocity = FVector::ZeroVector;
+	int32 BestCollisions = CountCollisions(FVector::ZeroVector);
+	for (const float SpeedScale : SpeedScales)
+	{
+		for (const float TurnAngle : TurnAngles)
+		{
+			float Sin, Cos;
+			FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(TurnAngle));
+			for (const float Side : { 1.f, -1.f })
+			{
+				const FVector Candidate = (Forward * Cos + Right * (Side * Sin)) * (Speed * SpeedScale);
+				const int32 NumCollisions = CountCollisions(Candidate);
+				if (NumCollisions == 0)
+				{
+					return Candidate + VerticalVelocity * SpeedScale;
+				}
+
+				if (NumCollisions < BestCollisions)
+				{
+					BestVelocity = Candidate + VerticalVelocity * SpeedScale;
+					BestCollisions = NumCollisions;
+				}
+			}
+		}
+	}
+
+	return BestVelocity;
+}
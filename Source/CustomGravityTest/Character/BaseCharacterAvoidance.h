@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Avoidance state of a character, captured when UBaseCharacterMovementManager builds the avoidance hash. */
+struct FBaseCharacterAvoidanceAgent
+{
+	/** Bottom of the capsule along gravity. */
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	FVector GravityDirection = FVector::DownVector;
+	uint32 GravityFieldId = 0;
+
+	float Radius = 0.f;
+	float HalfHeight = 0.f;
+
+	/** Packed FNavAvoidanceMask of the agent and of the groups it avoids and ignores. */
+	int32 AvoidanceGroup = 0;
+	int32 GroupsToAvoid = 0;
+	int32 GroupsToIgnore = 0;
+
+	/** Whether the velocity of the agent is decided for now, others avoid it without reciprocating. */
+	bool bLocked = false;
+};
+
+/**
+ * Spatial hash of the characters using RVO avoidance, rebuilt once per frame by UBaseCharacterMovementManager.
+ *
+ * Agents are bucketed by gravity field and world space cell, so characters under different fields never see each other and a
+ * neighbor lookup only visits the few cells around the querier. Cells stay three dimensional so curved fields have no seams,
+ * and the gravity relative plane of the querier filters the candidates: neighbors must share its gravity direction closely enough
+ * and overlap it along its gravity up axis.
+ *
+ * Avoidance itself is a sampled reciprocal velocity obstacle in the gravity plane of the querier, tuned by the settings of the
+ * world UAvoidanceManager so both paths behave alike. Agents of the hash still register with UAvoidanceManager every frame, so the
+ * characters it does not hold keep avoiding them.
+ */
+class FBaseCharacterAvoidanceHash
+{
+public:
+	/** Removes every agent and sets the size of the cells for the next build. */
+	void Reset(float InCellSize);
+
+	/** Adds an agent to the hash, returns its index. */
+	int32 AddAgent(const FBaseCharacterAvoidanceAgent& Agent);
+
+	int32 Num() const { return Agents.Num(); }
+
+	const FBaseCharacterAvoidanceAgent& GetAgent(int32 AgentIndex) const { return Agents[AgentIndex]; }
+
+	/** Updates the velocity of an agent once it is decided for the frame, so the agents updating after it avoid it. */
+	void LockAgentVelocity(int32 AgentIndex, const FVector& Velocity);
+
+	/**
+	 * Calls Func(NeighborIndex, Neighbor) for every other agent within Radius of an agent, on its gravity relative plane
+	 * and not ignored by it. Cost grows with the agents in the cells around it only.
+	 */
+	template<typename FuncType>
+	void ForEachNeighbor(int32 AgentIndex, float Radius, FuncType&& Func) const;
+
+	/**
+	 * Returns the velocity closest to DesiredVelocity that does not collide with any neighbor within TimeToPredict.
+	 * Velocities are sampled in the gravity plane of the agent, slower and wider turns first being tried last.
+	 * @param RadiusExpansion	Added to the combined radius of every pair, see UAvoidanceManager::ArtificialRadiusExpansion.
+	 */
+	FVector ComputeAvoidanceVelocity(int32 AgentIndex, const FVector& DesiredVelocity, float ConsiderationRadius, float TimeToPredict, float RadiusExpansion) const;
+
+private:
+	struct FCellKey
+	{
+		FIntVector Cell;
+		uint32 GravityFieldId;
+
+		bool operator==(const FCellKey& Other) const { return Cell == Other.Cell && GravityFieldId == Other.GravityFieldId; }
+		friend uint32 GetTypeHash(const FCellKey& Key) { return HashCombineFast(GetTypeHash(Key.Cell), Key.GravityFieldId); }
+	};
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	TArray<FBaseCharacterAvoidanceAgent> Agents;
+
+	/** First agent of every cell, next agent in the cell of each agent. */
+	TMap<FCellKey, int32> FirstAgentInCell;
+	TArray<int32> NextAgentInCell;
+
+	/** Largest capsule of the agents, lookups reach that much further so big neighbors in farther cells are still found. */
+	float MaxAgentRadius = 0.f;
+	float MaxAgentHalfHeight = 0.f;
+
+	float CellSize = 500.f;
+};
+
+template<typename FuncType>
+void FBaseCharacterAvoidanceHash::ForEachNeighbor(int32 AgentIndex, float Radius, FuncType&& Func) const
+{
+	// Neighbors under a gravity more than 45 degrees away stand on another face of the field.
+	static constexpr float MinGravityDot = 0.707f;
+
+	const FBaseCharacterAvoidanceAgent& Agent = Agents[AgentIndex];
+	const FVector GravityUp = -Agent.GravityDirection;
+
+	// Accepted neighbors are within Radius plus their own radius on the plane, and within both half heights along gravity up.
+	// Gravity can point anywhere, so the cells are gathered within the length of that offset on every world axis.
+	const float Reach = FMath::Sqrt(FMath::Square(Radius + MaxAgentRadius) + FMath::Square(Agent.HalfHeight + MaxAgentHalfHeight));
+	const FIntVector MinCell = GetCell(Agent.Location - FVector(Reach));
+	const FIntVector MaxCell = GetCell(Agent.Location + FVector(Reach));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const int32* First = FirstAgentInCell.Find(FCellKey{ FIntVector(X, Y, Z), Agent.GravityFieldId });
+				for (int32 NeighborIndex = First ? *First : INDEX_NONE; NeighborIndex != INDEX_NONE; NeighborIndex = NextAgentInCell[NeighborIndex])
+				{
+					const FBaseCharacterAvoidanceAgent& Neighbor = Agents[NeighborIndex];
+					if (NeighborIndex == AgentIndex
+						|| (Agent.GroupsToAvoid & Neighbor.AvoidanceGroup) == 0
+						|| (Agent.GroupsToIgnore & Neighbor.AvoidanceGroup) != 0
+						|| (Agent.GravityDirection | Neighbor.GravityDirection) < MinGravityDot)
+					{
+						continue;
+					}
+
+					const FVector Offset = Neighbor.Location - Agent.Location;
+					const FVector::FReal HeightOffset = Offset | GravityUp;
+					if (FMath::Abs(HeightOffset) > Agent.HalfHeight + Neighbor.HalfHeight
+						|| (Offset - GravityUp * HeightOffset).SizeSquared() > FMath::Square(Radius + Neighbor.Radius))
+					{
+						continue;
+					}
+
+					Func(NeighborIndex, Neighbor);
+				}
+			}
+		}
+	}
+}
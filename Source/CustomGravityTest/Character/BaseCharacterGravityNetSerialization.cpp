@@ -0,0 +1,129 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BaseCharacterGravityNetSerialization.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BaseCharacterGravityNetSerialization)
+
+namespace BaseGravityNetSerialization
+{
+	static constexpr uint32 OctahedralMaxValue = (1u << OctahedralComponentBits) - 1u;
+
+	/** Returns the index of the world axis Direction points along (X+, X-, Y+, Y-, Z+, Z-), or INDEX_NONE. */
+	static int32 FindCardinalAxis(const FVector& Direction)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (FMath::Abs(Direction[Axis]) >= 1.0 - CardinalTolerance)
+			{
+				return Axis * 2 + (Direction[Axis] < 0.0 ? 1 : 0);
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	static FVector GetCardinalAxis(uint32 Index)
+	{
+		FVector Direction = FVector::ZeroVector;
+		Direction[FMath::Min<uint32>(Index / 2, 2)] = (Index & 1) ? -1.0 : 1.0;
+		return Direction;
+	}
+
+	static uint32 QuantizeOctahedral(FVector::FReal Value)
+	{
+		return (uint32)FMath::RoundToInt(FMath::Clamp(Value * 0.5 + 0.5, 0.0, 1.0) * OctahedralMaxValue);
+	}
+
+	static FVector::FReal DequantizeOctahedral(uint32 Value)
+	{
+		return (FVector::FReal)Value / OctahedralMaxValue * 2.0 - 1.0;
+	}
+
+	static void EncodeOctahedral(const FVector& Direction, uint32& OutU, uint32& OutV)
+	{
+		const FVector::FReal L1 = FMath::Abs(Direction.X) + FMath::Abs(Direction.Y) + FMath::Abs(Direction.Z);
+		FVector::FReal U = Direction.X / L1;
+		FVector::FReal V = Direction.Y / L1;
+		if (Direction.Z < 0.0)
+		{
+			// Fold the lower hemisphere over the diagonals.
+			const FVector::FReal FoldedU = (1.0 - FMath::Abs(V)) * (U >= 0.0 ? 1.0 : -1.0);
+			const FVector::FReal FoldedV = (1.0 - FMath::Abs(U)) * (V >= 0.0 ? 1.0 : -1.0);
+			U = FoldedU;
+			V = FoldedV;
+		}
+		OutU = QuantizeOctahedral(U);
+		OutV = QuantizeOctahedral(V);
+	}
+
+	static FVector DecodeOctahedral(uint32 InU, uint32 InV)
+	{
+		FVector Direction(DequantizeOctahedral(InU), DequantizeOctahedral(InV), 0.0);
+		Direction.Z = 1.0 - FMath::Abs(Direction.X) - FMath::Abs(Direction.Y);
+		if (Direction.Z < 0.0)
+		{
+			const FVector::FReal UnfoldedX = (1.0 - FMath::Abs(Direction.Y)) * (Direction.X >= 0.0 ? 1.0 : -1.0);
+			const FVector::FReal UnfoldedY = (1.0 - FMath::Abs(Direction.X)) * (Direction.Y >= 0.0 ? 1.0 : -1.0);
+			Direction.X = UnfoldedX;
+			Direction.Y = UnfoldedY;
+		}
+		return Direction.GetSafeNormal(UE_SMALL_NUMBER, FVector::DownVector);
+	}
+
+	uint32 PackDirection(const FVector& Direction)
+	{
+		const FVector Normalized = Direction.GetSafeNormal(UE_SMALL_NUMBER, FVector::DownVector);
+		const int32 Axis = FindCardinalAxis(Normalized);
+		if (Axis != INDEX_NONE)
+		{
+			return 1u | ((uint32)Axis << 1);
+		}
+
+		uint32 U, V;
+		EncodeOctahedral(Normalized, U, V);
+		return (U << 1) | (V << (1 + OctahedralComponentBits));
+	}
+
+	FVector UnpackDirection(uint32 Packed)
+	{
+		if (IsPackedCardinal(Packed))
+		{
+			return GetCardinalAxis(Packed >> 1);
+		}
+
+		const uint32 U = (Packed >> 1) & OctahedralMaxValue;
+		const uint32 V = (Packed >> (1 + OctahedralComponentBits)) & OctahedralMaxValue;
+		return DecodeOctahedral(U, V);
+	}
+
+	void SerializeDirection(FArchive& Ar, FVector& Direction)
+	{
+		uint32 Packed = Ar.IsSaving() ? PackDirection(Direction) : 0;
+
+		uint8 bCardinal = IsPackedCardinal(Packed);
+		Ar.SerializeBits(&bCardinal, 1);
+		if (bCardinal)
+		{
+			uint32 CardinalAxis = Packed >> 1;
+			Ar.SerializeInt(CardinalAxis, NumCardinalAxes);
+			Packed = 1u | (CardinalAxis << 1);
+		}
+		else
+		{
+			uint32 U = (Packed >> 1) & OctahedralMaxValue;
+			uint32 V = (Packed >> (1 + OctahedralComponentBits)) & OctahedralMaxValue;
+			Ar.SerializeInt(U, OctahedralMaxValue + 1);
+			Ar.SerializeInt(V, OctahedralMaxValue + 1);
+			Packed = (U << 1) | (V << (1 + OctahedralComponentBits));
+		}
+
+		if (Ar.IsLoading())
+		{
+			Direction = UnpackDirection(Packed);
+		}
+	}
+
+	FVector QuantizeDirection(const FVector& Direction)
+	{
+		return UnpackDirection(PackDirection(Direction));
+	}
+}
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "BaseCharacterGravityNetSerialization.generated.h"
+
+namespace BaseGravityNetSerialization
+{
+	/** Bits per component of the octahedral encoding, gives a worst case error of about 0.1 degrees. */
+	constexpr int32 OctahedralComponentBits = 11;
+
+	/**
+	 * Directions whose dot product with a world axis is within this of 1 are sent as that axis. 1 - cos(0.1 degrees), so snapping
+	 * moves a direction no further than the octahedral encoding would.
+	 */
+	constexpr float CardinalTolerance = 1.5e-6f;
+
+	/** Smallest change of direction worth replicating, roughly the precision of the octahedral encoding. */
+	constexpr float ReplicationTolerance = 1e-3f;
+
+	/** Number of world axis directions with a dedicated short encoding (X+, X-, Y+, Y-, Z+, Z-). */
+	constexpr uint32 NumCardinalAxes = 6;
+
+	/**
+	 * Packs a gravity direction in a single integer, shared by the legacy and Iris serializers.
+	 * Bit 0 flags a cardinal direction, followed by either the axis index or the two octahedral components.
+	 */
+	uint32 PackDirection(const FVector& Direction);
+
+	/** Inverse of PackDirection(), always returns a normalized direction. */
+	FVector UnpackDirection(uint32 Packed);
+
+	FORCEINLINE bool IsPackedCardinal(uint32 Packed)
+	{
+		return (Packed & 1u) != 0;
+	}
+
+	/**
+	 * Writes or reads a normalized gravity direction.
+	 * Directions along one of the six world axes take 4 bits, any other direction 1 + 2 * OctahedralComponentBits bits in octahedral form.
+	 */
+	void SerializeDirection(FArchive& Ar, FVector& Direction);
+
+	/** Returns the value SerializeDirection() would read back for Direction. */
+	FVector QuantizeDirection(const FVector& Direction);
+}
+
+/**
+ * FVector holding a normalized gravity direction, replicated in the compact form of BaseGravityNetSerialization::SerializeDirection().
+ */
+USTRUCT()
+struct FVector_NetQuantizeGravity : public FVector
+{
+	GENERATED_USTRUCT_BODY()
+
+	FORCEINLINE FVector_NetQuantizeGravity()
+		: FVector(0.0, 0.0, -1.0)
+	{
+	}
+
+	FORCEINLINE FVector_NetQuantizeGravity(const FVector& InVector)
+		: FVector(InVector)
+	{
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		BaseGravityNetSerialization::SerializeDirection(Ar, *this);
+		bOutSuccess = true;
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FVector_NetQuantizeGravity> : public TStructOpsTypeTraitsBase2<FVector_NetQuantizeGravity>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithNetSharedSerialization = true,
+	};
+};
@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** How gravity relative space relates to world space. Picked by UBaseCharacterMovementComponent::SetGravityDirection(). */
+enum class EBaseGravitySpace : uint8
+{
+	/** Gravity points along the default direction, gravity relative space is world space. */
+	Default,
+	/** Gravity points along one of the six world axes, conversions are component swaps and sign flips. */
+	AxisAligned,
+	/** Arbitrary gravity direction, conversions are quaternion rotations. */
+	Custom,
+};
+
+/**
+ * Rotation by a multiple of 90 degrees around the world axes, stored as a signed permutation of the vector components:
+ * Result[i] = Sign[i] * V[Axis[i]].
+ */
+struct FBaseGravityAxisPermutation
+{
+	uint8 Axis[3] = { 0, 1, 2 };
+	FVector::FReal Sign[3] = { 1.0, 1.0, 1.0 };
+
+	FORCEINLINE FVector Apply(const FVector& V) const
+	{
+		return FVector(Sign[0] * V[Axis[0]], Sign[1] * V[Axis[1]], Sign[2] * V[Axis[2]]);
+	}
+
+	/** Returns the permutation undoing this one. */
+	FBaseGravityAxisPermutation Inverse() const
+	{
+		FBaseGravityAxisPermutation Result;
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			Result.Axis[Axis[Index]] = (uint8)Index;
+			Result.Sign[Axis[Index]] = Sign[Index];
+		}
+		return Result;
+	}
+
+	/** Returns the rotation matching this permutation exactly. */
+	FQuat ToQuat() const
+	{
+		return FQuat(FMatrix(Apply(FVector::ForwardVector), Apply(FVector::RightVector), Apply(FVector::UpVector), FVector::ZeroVector));
+	}
+
+	/**
+	 * Builds the permutation matching a rotation, if it maps every world axis onto a world axis.
+	 * The default tolerance on the cosine only accepts rotations within about 0.1 degree of an exact permutation.
+	 * @return false if the rotation is not a multiple of 90 degrees around the world axes, in which case OutPermutation is left untouched.
+	 */
+	static bool FromRotation(const FQuat& Rotation, FBaseGravityAxisPermutation& OutPermutation, FVector::FReal Tolerance = 1.e-6)
+	{
+		FBaseGravityAxisPermutation Result;
+		uint8 UsedAxes = 0;
+		for (int32 Source = 0; Source < 3; ++Source)
+		{
+			FVector SourceAxis = FVector::ZeroVector;
+			SourceAxis[Source] = 1.0;
+			const FVector Rotated = Rotation.RotateVector(SourceAxis);
+
+			int32 Target = 0;
+			for (int32 Candidate = 1; Candidate < 3; ++Candidate)
+			{
+				if (FMath::Abs(Rotated[Candidate]) > FMath::Abs(Rotated[Target]))
+				{
+					Target = Candidate;
+				}
+			}
+
+			if (!FMath::IsNearlyEqual(FMath::Abs(Rotated[Target]), 1.0, Tolerance) || (UsedAxes & (1 << Target)) != 0)
+			{
+				return false;
+			}
+
+			UsedAxes |= (1 << Target);
+			Result.Axis[Target] = (uint8)Source;
+			Result.Sign[Target] = Rotated[Target] > 0.0 ? 1.0 : -1.0;
+		}
+
+		OutPermutation = Result;
+		return true;
+	}
+};
+
+/**
+ * Conversions between world and gravity relative space, specialized at compile time per EBaseGravitySpace.
+ * Movement hot paths are templated on the gravity space and dispatched once, so characters that are not in
+ * a custom gravity field don't pay for any rotation.
+ */
+template<EBaseGravitySpace Space>
+struct TBaseGravitySpace;
+
+template<>
+struct TBaseGravitySpace<EBaseGravitySpace::Default>
+{
+	TBaseGravitySpace(const FVector& GravityDirection, const FQuat& GravityToWorld, const FQuat& WorldToGravity, const FBaseGravityAxisPermutation& GravityToWorldAxes, const FBaseGravityAxisPermutation& WorldToGravityAxes)
+	{
+	}
+
+	/** Rotate a vector from world to gravity space. */
+	FORCEINLINE FVector ToGravity(const FVector& World) const { return World; }
+
+	/** Rotate a vector from gravity to world space. */
+	FORCEINLINE FVector ToWorld(const FVector& Gravity) const { return Gravity; }
+
+	/** Returns the component of a world space vector along the gravity up axis, same as ToGravity(World).Z. */
+	FORCEINLINE FVector::FReal GetUp(const FVector& World) const { return World.Z; }
+
+	/** Returns the world space up vector of gravity space, same as ToWorld(FVector::UpVector). */
+	FORCEINLINE FVector GetUpVector() const { return FVector::UpVector; }
+};
+
+template<>
+struct TBaseGravitySpace<EBaseGravitySpace::AxisAligned>
+{
+	TBaseGravitySpace(const FVector& GravityDirection, const FQuat& GravityToWorld, const FQuat& WorldToGravity, const FBaseGravityAxisPermutation& InGravityToWorldAxes, const FBaseGravityAxisPermutation& InWorldToGravityAxes)
+		: GravityToWorldAxes(InGravityToWorldAxes)
+		, WorldToGravityAxes(InWorldToGravityAxes)
+	{
+	}
+
+	FORCEINLINE FVector ToGravity(const FVector& World) const { return WorldToGravityAxes.Apply(World); }
+	FORCEINLINE FVector ToWorld(const FVector& Gravity) const { return GravityToWorldAxes.Apply(Gravity); }
+	FORCEINLINE FVector::FReal GetUp(const FVector& World) const { return WorldToGravityAxes.Sign[2] * World[WorldToGravityAxes.Axis[2]]; }
+	FORCEINLINE FVector GetUpVector() const { return GravityToWorldAxes.Apply(FVector::UpVector); }
+
+private:
+	FBaseGravityAxisPermutation GravityToWorldAxes;
+	FBaseGravityAxisPermutation WorldToGravityAxes;
+};
+
+template<>
+struct TBaseGravitySpace<EBaseGravitySpace::Custom>
+{
+	TBaseGravitySpace(const FVector& GravityDirection, const FQuat& InGravityToWorld, const FQuat& InWorldToGravity, const FBaseGravityAxisPermutation& GravityToWorldAxes, const FBaseGravityAxisPermutation& WorldToGravityAxes)
+		: GravityToWorld(InGravityToWorld)
+		, WorldToGravity(InWorldToGravity)
+		, UpVector(-GravityDirection)
+	{
+	}
+
+	FORCEINLINE FVector ToGravity(const FVector& World) const { return WorldToGravity.RotateVector(World); }
+	FORCEINLINE FVector ToWorld(const FVector& Gravity) const { return GravityToWorld.RotateVector(Gravity); }
+	FORCEINLINE FVector::FReal GetUp(const FVector& World) const { return World | UpVector; }
+	FORCEINLINE FVector GetUpVector() const { return UpVector; }
+
+private:
+	FQuat GravityToWorld;
+	FQuat WorldToGravity;
+	FVector UpVector;
+};
@@ -0,0 +1,266 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BaseCharacterMoveRecording.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "BaseCharacter.h"
+#include "BaseCharacterMovementComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BaseCharacterMoveRecording)
+
+DEFINE_LOG_CATEGORY_STATIC(LogBaseCharacterMoveRecording, Log, All);
+
+namespace BaseCharacterMoveRecording
+{
+	static constexpr uint32 Magic = 0x524D4743;
+	static constexpr uint32 Version = 2;
+
+	enum class ERecordType : uint8
+	{
+		Stream,
+		Move,
+		End,
+	};
+}
+
+bool UBaseCharacterMoveRecordingPackageMap::SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID)
+{
+	UWorld* World = GetTypedOuter<UWorld>();
+
+	FString PathName;
+	if (Ar.IsSaving())
+	{
+		// Anything outside the world, or spawned in it, won't be found again in another session.
+		if (Obj && World && Obj->IsIn(World))
+		{
+			PathName = Obj->GetPathName(World);
+		}
+		Ar << PathName;
+	}
+	else
+	{
+		Ar << PathName;
+		Obj = PathName.IsEmpty() ? nullptr : StaticFindObject(InClass, World, *PathName);
+	}
+
+	return !Ar.IsError();
+}
+
+bool FBaseCharacterMoveRecording::Load(const FString& Filename)
+{
+	using namespace BaseCharacterMoveRecording;
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *Filename))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(FileData);
+
+	uint32 FileMagic = 0;
+	uint32 FileVersion = 0;
+	Ar << FileMagic << FileVersion;
+	if (FileMagic != Magic || FileVersion != Version)
+	{
+		UE_LOG(LogBaseCharacterMoveRecording, Warning, TEXT("%s is not a move recording of version %u."), *Filename, Version);
+		return false;
+	}
+
+	Ar << MapName;
+
+	Streams.Reset();
+	Moves.Reset();
+	Data.Reset(FileData.Num());
+
+	while (!Ar.AtEnd() && !Ar.IsError())
+	{
+		uint8 RecordType = 0;
+		Ar << RecordType;
+
+		if (RecordType == (uint8)ERecordType::Stream)
+		{
+			uint32 StreamIndex = 0;
+			Ar.SerializeIntPacked(StreamIndex);
+
+			FBaseCharacterRecordedStream Stream;
+			FString CharacterClass;
+			Ar << CharacterClass << Stream.Location << Stream.Rotation << Stream.GravityDirection;
+			Stream.CharacterClass = FSoftClassPath(CharacterClass);
+
+			// Streams are written in order, the first time their character sends a move.
+			if (StreamIndex != (uint32)Streams.Num())
+			{
+				break;
+			}
+			Streams.Add(Stream);
+		}
+		else if (RecordType == (uint8)ERecordType::Move)
+		{
+			FBaseCharacterRecordedMove& Move = Moves.AddDefaulted_GetRef();
+
+			uint32 StreamIndex = 0;
+			uint32 NumBits = 0;
+			Ar.SerializeIntPacked(StreamIndex);
+			Ar.SerializeIntPacked(Move.Frame);
+			Ar << Move.Time;
+			Ar.SerializeIntPacked(NumBits);
+
+			const int32 NumBytes = FMath::DivideAndRoundUp<int32>(NumBits, 8);
+			if (StreamIndex >= (uint32)Streams.Num() || NumBits > FBaseCharacterNetworkSerializationPackedBits::GetMaxNumBits() || Ar.Tell() + NumBytes > Ar.TotalSize())
+			{
+				Ar.SetError();
+				break;
+			}
+
+			Move.StreamIndex = StreamIndex;
+			Move.NumBits = NumBits;
+			Move.DataOffset = Data.AddUninitialized(NumBytes);
+			Ar.Serialize(Data.GetData() + Move.DataOffset, NumBytes);
+		}
+		else if (RecordType == (uint8)ERecordType::End)
+		{
+			uint32 StreamIndex = 0;
+			FVector EndLocation;
+			Ar.SerializeIntPacked(StreamIndex);
+			Ar << EndLocation;
+
+			if (StreamIndex >= (uint32)Streams.Num())
+			{
+				Ar.SetError();
+				break;
+			}
+
+			Streams[StreamIndex].EndLocation = EndLocation;
+			Streams[StreamIndex].bHasEndLocation = true;
+		}
+		else
+		{
+			Ar.SetError();
+		}
+	}
+
+	if (Ar.IsError())
+	{
+		UE_LOG(LogBaseCharacterMoveRecording, Warning, TEXT("%s is truncated or corrupted, loaded its first %d moves."), *Filename, Moves.Num());
+	}
+
+	return Streams.Num() > 0;
+}
+
+void FBaseCharacterMoveRecording::GetMoveBits(const FBaseCharacterRecordedMove& Move, FBaseCharacterServerMovePackedBits& OutPackedBits) const
+{
+	OutPackedBits.DataBits.SetNumUninitialized(Move.NumBits);
+	FMemory::Memcpy(OutPackedBits.DataBits.GetData(), Data.GetData() + Move.DataOffset, FMath::DivideAndRoundUp(Move.NumBits, 8));
+}
+
+int32 FBaseCharacterMoveRecorder::NumRecorders = 0;
+
+TUniquePtr<FBaseCharacterMoveRecorder> FBaseCharacterMoveRecorder::Create(UWorld& World, const FString& Filename)
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer)
+	{
+		return nullptr;
+	}
+
+	return TUniquePtr<FBaseCharacterMoveRecorder>(new FBaseCharacterMoveRecorder(World, Filename, MoveTemp(Writer)));
+}
+
+FBaseCharacterMoveRecorder::FBaseCharacterMoveRecorder(UWorld& World, const FString& InFilename, TUniquePtr<FArchive>&& InWriter)
+	: Filename(InFilename)
+	, Writer(MoveTemp(InWriter))
+	, PackageMap(NewObject<UBaseCharacterMoveRecordingPackageMap>(&World))
+	, BitWriter(PackageMap.Get(), 0)
+	, StartFrame(GFrameCounter)
+	, StartTime(World.GetRealTimeSeconds())
+{
+	using namespace BaseCharacterMoveRecording;
+
+	BitWriter.SetAllowResize(true);
+
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+	FString MapName = World.GetMapName();
+	*Writer << FileMagic << FileVersion << MapName;
+
+	++NumRecorders;
+}
+
+FBaseCharacterMoveRecorder::~FBaseCharacterMoveRecorder()
+{
+	using namespace BaseCharacterMoveRecording;
+
+	// Lets a replay check that its characters end up where the recorded ones did.
+	for (int32 Index = 0; Index < StreamCharacters.Num(); ++Index)
+	{
+		if (const ABaseCharacter* Character = StreamCharacters[Index].Get())
+		{
+			uint8 RecordType = (uint8)ERecordType::End;
+			uint32 StreamIndex = Index;
+			FVector Location = Character->GetActorLocation();
+
+			*Writer << RecordType;
+			Writer->SerializeIntPacked(StreamIndex);
+			*Writer << Location;
+		}
+	}
+
+	Writer->Close();
+	--NumRecorders;
+}
+
+void FBaseCharacterMoveRecorder::RecordServerMove(UBaseCharacterMovementComponent& Component, FBaseCharacterNetworkMoveDataContainer& MoveDataContainer)
+{
+	using namespace BaseCharacterMoveRecording;
+
+	ABaseCharacter* CharacterOwner = Component.GetCharacterOwner();
+	if (!CharacterOwner)
+	{
+		return;
+	}
+
+	int32* StreamIndexPtr = StreamIndices.Find(Component.GetUniqueID());
+	uint32 StreamIndex = StreamIndexPtr ? *StreamIndexPtr : StreamIndices.Num();
+	if (!StreamIndexPtr)
+	{
+		StreamIndices.Add(Component.GetUniqueID(), StreamIndex);
+		StreamCharacters.Add(CharacterOwner);
+
+		uint8 RecordType = (uint8)ERecordType::Stream;
+		FString CharacterClass = CharacterOwner->GetClass()->GetPathName();
+		FVector Location = CharacterOwner->GetActorLocation();
+		FQuat Rotation = CharacterOwner->GetActorQuat();
+		FVector GravityDirection = Component.GetGravityDirection();
+
+		*Writer << RecordType;
+		Writer->SerializeIntPacked(StreamIndex);
+		*Writer << CharacterClass << Location << Rotation << GravityDirection;
+	}
+
+	// Reset bit writer without affecting allocations
+	FBitWriterMark BitWriterReset;
+	BitWriterReset.Pop(BitWriter);
+
+	if (!MoveDataContainer.Serialize(Component, BitWriter, PackageMap.Get()) || BitWriter.IsError())
+	{
+		UE_LOG(LogBaseCharacterMoveRecording, Warning, TEXT("RecordServerMove (%s): Failed to serialize movement data!"), *GetNameSafe(CharacterOwner));
+		return;
+	}
+
+	uint8 RecordType = (uint8)ERecordType::Move;
+	uint32 Frame = (uint32)(GFrameCounter - StartFrame);
+	float Time = (float)(Component.GetWorld()->GetRealTimeSeconds() - StartTime);
+	uint32 NumBits = (uint32)BitWriter.GetNumBits();
+
+	*Writer << RecordType;
+	Writer->SerializeIntPacked(StreamIndex);
+	Writer->SerializeIntPacked(Frame);
+	*Writer << Time;
+	Writer->SerializeIntPacked(NumBits);
+	Writer->Serialize(BitWriter.GetData(), BitWriter.GetNumBytes());
+
+	++NumMoves;
+}
@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "UObject/StrongObjectPtr.h"
+#include "BaseCharacterMoveRecording.generated.h"
+
+class ABaseCharacter;
+class UBaseCharacterMovementComponent;
+struct FBaseCharacterNetworkMoveDataContainer;
+struct FBaseCharacterServerMovePackedBits;
+
+/**
+ * Package map of recorded client moves. Object references are stored as their path name relative to the world rather than as
+ * network GUIDs, so the movement bases placed in the map resolve again when the moves are replayed in another session.
+ * Its outer is the world the moves are recorded or replayed in.
+ */
+UCLASS(Transient)
+class UBaseCharacterMoveRecordingPackageMap : public UPackageMap
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UPackageMap Interface
+	virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID = nullptr) override;
+	//~ End UPackageMap Interface
+};
+
+/** Character a stream of recorded moves was sent for, as it was when its first move arrived. */
+struct FBaseCharacterRecordedStream
+{
+	FSoftClassPath CharacterClass;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector GravityDirection = FVector::DownVector;
+
+	/** Location of the character when the recording stopped, after its last move. Not set if the character was gone by then. */
+	FVector EndLocation = FVector::ZeroVector;
+	bool bHasEndLocation = false;
+};
+
+/** Client move received by the server, still packed. */
+struct FBaseCharacterRecordedMove
+{
+	/** Index of the stream in FBaseCharacterMoveRecording::Streams. */
+	int32 StreamIndex = 0;
+
+	/** Server frames and seconds since the recording started when the move arrived. */
+	uint32 Frame = 0;
+	float Time = 0.f;
+
+	/** Packed move bits, stored at DataOffset in FBaseCharacterMoveRecording::Data. */
+	int32 NumBits = 0;
+	int32 DataOffset = 0;
+};
+
+/** Client moves recorded by FBaseCharacterMoveRecorder, loaded from a file. Moves are in the order the server received them. */
+struct FBaseCharacterMoveRecording
+{
+	/** Map the moves were recorded in. */
+	FString MapName;
+
+	TArray<FBaseCharacterRecordedStream> Streams;
+	TArray<FBaseCharacterRecordedMove> Moves;
+	TArray<uint8> Data;
+
+	/** Returns false if the file could not be read or is not a recording of this version. */
+	bool Load(const FString& Filename);
+
+	/** Copies the bits of a move to packed move data, ready for UBaseCharacterMovementComponent::ServerMovePacked_ServerReceive(). */
+	void GetMoveBits(const FBaseCharacterRecordedMove& Move, FBaseCharacterServerMovePackedBits& OutPackedBits) const;
+};
+
+/**
+ * Writes the client moves received by the server in a world to a file, one stream per character, with the frame and time they arrived.
+ *
+ * Moves are re-encoded with UBaseCharacterMoveRecordingPackageMap once decoded, so the file is independent of the connections that
+ * sent them. The format is a header followed by records, each starting with its type:
+ *   Header:	uint32 Magic, uint32 Version, FString MapName
+ *   Stream:	packed StreamIndex, FString CharacterClass, FVector Location, FQuat Rotation, FVector GravityDirection
+ *   Move:		packed StreamIndex, packed Frame, float Time, packed NumBits, NumBits rounded up to bytes of move data
+ *   End:		packed StreamIndex, FVector Location, written when the recording stops for every character still alive
+ */
+class FBaseCharacterMoveRecorder
+{
+public:
+	/** Returns null if the file could not be opened. */
+	static TUniquePtr<FBaseCharacterMoveRecorder> Create(UWorld& World, const FString& Filename);
+
+	/** Writes the end location of every recorded character still alive, then closes the file. */
+	~FBaseCharacterMoveRecorder();
+
+	/** Appends the move data decoded by the component to the recording. */
+	void RecordServerMove(UBaseCharacterMovementComponent& Component, FBaseCharacterNetworkMoveDataContainer& MoveDataContainer);
+
+	int32 GetNumStreams() const { return StreamIndices.Num(); }
+	int32 GetNumMoves() const { return NumMoves; }
+	const FString& GetFilename() const { return Filename; }
+
+	/** Returns true if any world is recording, lets components skip looking up their recorder. */
+	static bool IsAnyRecording() { return NumRecorders > 0; }
+
+private:
+	FBaseCharacterMoveRecorder(UWorld& World, const FString& InFilename, TUniquePtr<FArchive>&& InWriter);
+
+	FString Filename;
+	TUniquePtr<FArchive> Writer;
+	TStrongObjectPtr<UBaseCharacterMoveRecordingPackageMap> PackageMap;
+	FNetBitWriter BitWriter;
+
+	/** Stream of each recorded component, by unique ID. */
+	TMap<uint32, int32> StreamIndices;
+
+	/** Character of each stream. */
+	TArray<TWeakObjectPtr<ABaseCharacter>> StreamCharacters;
+
+	uint64 StartFrame = 0;
+	double StartTime = 0.0;
+	int32 NumMoves = 0;
+
+	static int32 NumRecorders;
+};
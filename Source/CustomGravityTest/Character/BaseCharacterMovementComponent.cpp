@@ -6,6 +6,10 @@
 =============================================================================*/
 
 #include "BaseCharacterMovementComponent.h"
+#include "BaseCharacterMovementManager.h"
+#include "BaseCharacterAvoidance.h"
+#include "BaseCharacterMoveRecording.h"
+#include "BaseCharacterGravityNetSerialization.h"
 #include "Animation/AnimMontage.h"
 #include "EngineStats.h"
 #include "AI/NavigationSystemBase.h"
@@ -23,6 +27,8 @@
 #include "AI/Navigation/AvoidanceManager.h"
 #include "Components/BrushComponent.h"
 #include "Net/PerfCountersHelpers.h"
+#include "Misc/ScopeExit.h"
+#include "Trace/Trace.inl"
 #if UE_WITH_IRIS
 #include "Net/Iris/ReplicationSystem/ReplicationSystemUtil.h"
 #include "Net/Iris/ReplicationSystem/ActorReplicationBridge.h"
@@ -34,6 +40,29 @@
 
 CSV_DEFINE_CATEGORY(BaseCharacterMovement, true);
 
+// Per character movement counters, enable with -trace=BaseCharacterMovement. @see FBaseCharacterMovementCounters
+UE_TRACE_CHANNEL_DEFINE(BaseCharacterMovementChannel)
+
+UE_TRACE_EVENT_BEGIN(BaseCharacterMovement, CharacterCounters)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, FrameNumber)
+	UE_TRACE_EVENT_FIELD(uint64, TickCycles)
+	UE_TRACE_EVENT_FIELD(uint32, ComponentId)
+	UE_TRACE_EVENT_FIELD(uint8, LocalRole)
+	UE_TRACE_EVENT_FIELD(uint16, Sweeps)
+	UE_TRACE_EVENT_FIELD(uint16, FloorProbes)
+	UE_TRACE_EVENT_FIELD(uint16, StepUps)
+	UE_TRACE_EVENT_FIELD(uint16, SlideIterations)
+	UE_TRACE_EVENT_FIELD(uint16, Substeps)
+	UE_TRACE_EVENT_FIELD(uint16, GravityFieldLookups)
+	UE_TRACE_EVENT_FIELD(uint16, CorrectionsSent)
+	UE_TRACE_EVENT_FIELD(uint16, CorrectionsReceived)
+	UE_TRACE_EVENT_FIELD(uint16, ReplayedMoves)
+	UE_TRACE_EVENT_FIELD(uint16, TranslatedMoves)
+	UE_TRACE_EVENT_FIELD(uint64, ReplayCycles)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, CharacterName)
+UE_TRACE_EVENT_END()
+
 DEFINE_LOG_CATEGORY_STATIC(LogBaseCharacterMovement, Log, All);
 DEFINE_LOG_CATEGORY_STATIC(LogNavMeshMovement, Log, All);
 DEFINE_LOG_CATEGORY_STATIC(LogCharacterNetSmoothing, Log, All);
@@ -44,6 +73,7 @@ DEFINE_LOG_CATEGORY_STATIC(LogCharacterNetSmoothing, Log, All);
 DECLARE_CYCLE_STAT(TEXT("Char Tick"), STAT_CharacterMovementTick, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char NonSimulated Time"), STAT_CharacterMovementNonSimulated, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char Simulated Time"), STAT_CharacterMovementSimulated, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Simulated LOD Time"), STAT_CharacterMovementSimulatedLOD, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char PerformMovement"), STAT_CharacterMovementPerformMovement, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char ReplicateMoveToServer"), STAT_CharacterMovementReplicateMoveToServer, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char CallServerMove"), STAT_CharacterMovementCallServerMove, STATGROUP_Character);
@@ -60,6 +90,8 @@ DECLARE_CYCLE_STAT(TEXT("Char SmoothClientPosition_Visual"), STAT_CharacterMovem
 DECLARE_CYCLE_STAT(TEXT("Char Physics Interation"), STAT_CharPhysicsInteraction, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char StepUp"), STAT_CharStepUp, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char FindFloor"), STAT_CharFindFloor, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FloorCache Hits"), STAT_CharFloorCacheHits, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FloorCache Misses"), STAT_CharFloorCacheMisses, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char AdjustFloorHeight"), STAT_CharAdjustFloorHeight, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char Update Acceleration"), STAT_CharUpdateAcceleration, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char MoveUpdateDelegate"), STAT_CharMoveUpdateDelegate, STATGROUP_Character);
@@ -72,6 +104,7 @@ DECLARE_CYCLE_STAT(TEXT("Char ProcessLanded"), STAT_CharProcessLanded, STATGROUP
 
 
 DECLARE_CYCLE_STAT(TEXT("Char HandleImpact"), STAT_CharHandleImpact, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Avoidance"), STAT_CharAvoidance, STATGROUP_Character);
 
 namespace CharacterMovementConstants
 {
@@ -186,6 +219,21 @@ namespace BaseCharacterMovementCVars
 		TEXT("Tolerance for GetClientNetSendDeltaTime() to remain throttled when small control rotation changes occur."),
 		ECVF_Default);
 
+	static float NetMoveCombiningGravityTolerance = 0.5f;
+	FAutoConsoleVariableRef CVarNetMoveCombiningGravityTolerance(
+		TEXT("cg.NetMoveCombiningGravityTolerance"),
+		NetMoveCombiningGravityTolerance,
+		TEXT("Max angle in degrees between the gravity directions of two client moves for them to be combined, and for gravity to be considered stable by the idle send rate."),
+		ECVF_Default);
+
+	static float NetIdleSendMoveDeltaTime = 0.2f;
+	FAutoConsoleVariableRef CVarNetIdleSendMoveDeltaTime(
+		TEXT("cg.NetIdleSendMoveDeltaTime"),
+		NetIdleSendMoveDeltaTime,
+		TEXT("Time in seconds between client moves sent while the character is stationary and its gravity, base and control rotation match the last acknowledged move.\n")
+		TEXT("Capped below GameNetworkManager MAXCLIENTUPDATEINTERVAL so the server never forces position updates. <=0: Use the regular stationary rate"),
+		ECVF_Default);
+
 	static int32 NetUseClientTimestampForReplicatedTransform = 1;
 	FAutoConsoleVariableRef CVarNetUseClientTimestampForReplicatedTransform(
 		TEXT("p.NetUseClientTimestampForReplicatedTransform"),
@@ -301,6 +349,133 @@ namespace BaseCharacterMovementCVars
 		TEXT("When enabled, this allows a character that's supposed to remain vertical to snap to a vertical orientation even if RotationRate settings would block it. See @ShouldRemainVertical and @RotationRate."),
 		ECVF_Default);
 
+	static bool bUseAxisAlignedGravitySpace = true;
+	FAutoConsoleVariableRef CVarUseAxisAlignedGravitySpace(
+		TEXT("cg.UseAxisAlignedGravitySpace"),
+		bUseAxisAlignedGravitySpace,
+		TEXT("When enabled, gravity along one of the world axes converts between world and gravity space with axis permutations instead of quaternion rotations. Applied the next time the gravity direction changes."),
+		ECVF_Default);
+
+	static bool bUseFloorCache = true;
+	FAutoConsoleVariableRef CVarUseFloorCache(
+		TEXT("cg.FloorCache"),
+		bUseFloorCache,
+		TEXT("When enabled, FindFloor() reuses the previous floor while the capsule, gravity direction and movement base did not change.\n")
+		TEXT("Opt-in per component: bAlwaysCheckFloor is set by default and disables the cache unless bFloorCacheIgnoresAlwaysCheckFloor is set too.\n")
+		TEXT("Forced floor checks, including the ones after gravity transitions, and teleports always check the floor."),
+		ECVF_Default);
+
+	static bool bEnableAsyncFloorChecks = true;
+	FAutoConsoleVariableRef CVarEnableAsyncFloorChecks(
+		TEXT("cg.AsyncFloorChecks"),
+		bEnableAsyncFloorChecks,
+		TEXT("Whether characters with bUseAsyncFloorChecks set may use asynchronous floor sweeps. Disable to make every floor check synchronous."),
+		ECVF_Default);
+
+	static float AsyncFloorCheckTolerance = 5.f;
+	FAutoConsoleVariableRef CVarAsyncFloorCheckTolerance(
+		TEXT("cg.AsyncFloorCheckTolerance"),
+		AsyncFloorCheckTolerance,
+		TEXT("Max distance in cm, perpendicular to gravity, between where a floor sweep issued ahead of time (asynchronously or by the movement manager) was predicted and where the character ended up for it to be used."),
+		ECVF_Default);
+
+	static float AsyncFloorCheckHeightTolerance = 0.5f;
+	FAutoConsoleVariableRef CVarAsyncFloorCheckHeightTolerance(
+		TEXT("cg.AsyncFloorCheckHeightTolerance"),
+		AsyncFloorCheckHeightTolerance,
+		TEXT("Max distance in cm along gravity the character may have moved down from where a floor sweep issued ahead of time started for it to be used.\n")
+		TEXT("Any move against gravity, such as up a slope or a step, discards the sweep: the floor distance would be measured from the wrong height."),
+		ECVF_Default);
+
+	static float NetMovingBaseErrorTime = 0.f;
+	FAutoConsoleVariableRef CVarNetMovingBaseErrorTime(
+		TEXT("cg.NetMovingBaseErrorTime"),
+		NetMovingBaseErrorTime,
+		TEXT("Seconds of movement base motion added to the allowed client position error while based on a moving base.\n")
+		TEXT("Absorbs the small timing differences of based movement between client and server, but also hides that much real drift. <=0: Disable (default)"),
+		ECVF_Default);
+
+	static bool bEnableIncrementalReplay = true;
+	FAutoConsoleVariableRef CVarEnableIncrementalReplay(
+		TEXT("cg.NetIncrementalReplay"),
+		bEnableIncrementalReplay,
+		TEXT("When enabled, corrections that only move the client by a small translation, with the same movement mode, base, velocity and gravity field,\n")
+		TEXT("are applied by translating the predicted state and saved moves instead of simulating every saved move again."),
+		ECVF_Default);
+
+	static float IncrementalReplayMaxOffset = 10.f;
+	FAutoConsoleVariableRef CVarIncrementalReplayMaxOffset(
+		TEXT("cg.NetIncrementalReplayMaxOffset"),
+		IncrementalReplayMaxOffset,
+		TEXT("Largest correction in cm cg.NetIncrementalReplay applies as a translation. Bigger corrections replay the saved moves."),
+		ECVF_Default);
+
+	static float IncrementalReplayMaxVelocityError = 1.f;
+	FAutoConsoleVariableRef CVarIncrementalReplayMaxVelocityError(
+		TEXT("cg.NetIncrementalReplayMaxVelocityError"),
+		IncrementalReplayMaxVelocityError,
+		TEXT("Largest difference in cm/s, per axis, between the corrected and predicted velocity for cg.NetIncrementalReplay to apply."),
+		ECVF_Default);
+
+	static float IncrementalReplayMaxGravityError = 0.1f;
+	FAutoConsoleVariableRef CVarIncrementalReplayMaxGravityError(
+		TEXT("cg.NetIncrementalReplayMaxGravityError"),
+		IncrementalReplayMaxGravityError,
+		TEXT("Largest angle in degrees between the corrected and predicted gravity direction for cg.NetIncrementalReplay to apply. Covers the quantization of the gravity sent with corrections."),
+		ECVF_Default);
+
+	static bool bUseGravityRelativeAvoidance = true;
+	FAutoConsoleVariableRef CVarUseGravityRelativeAvoidance(
+		TEXT("cg.GravityRelativeAvoidance"),
+		bUseGravityRelativeAvoidance,
+		TEXT("When enabled, RVO avoidance looks up neighbors in the per frame avoidance hash of the movement manager and avoids them in the gravity plane,\n")
+		TEXT("only considering characters under the same gravity field. When disabled, it goes through the world UAvoidanceManager, which works in the world XY plane."),
+		ECVF_Default);
+
+	static float FloorCacheTolerance = 0.01f;
+	FAutoConsoleVariableRef CVarFloorCacheTolerance(
+		TEXT("cg.FloorCacheTolerance"),
+		FloorCacheTolerance,
+		TEXT("Distance in cm the capsule can drift from where the cached floor was found before it is queried again. The floor distance is adjusted by the drift along gravity."),
+		ECVF_Default);
+
+	static bool bBatchServerMoves = true;
+	FAutoConsoleVariableRef CVarBatchServerMoves(
+		TEXT("cg.BatchServerMoves"),
+		bBatchServerMoves,
+		TEXT("Whether characters with bBatchServerMoves set queue received client moves and process them in the movement manager tick instead of on arrival."),
+		ECVF_Default);
+
+	static float SimulatedProxyLODInterpolateRate = 10.f;
+	FAutoConsoleVariableRef CVarSimulatedProxyLODInterpolateRate(
+		TEXT("cg.SimulatedProxyLODInterpolateRate"),
+		SimulatedProxyLODInterpolateRate,
+		TEXT("Number of times per second simulated proxies at the Interpolate level of detail update their smoothing.\n")
+		TEXT("<=0: Every frame"),
+		ECVF_Default);
+
+	static bool bNetSnapshotInterpolation = true;
+	FAutoConsoleVariableRef CVarNetSnapshotInterpolation(
+		TEXT("cg.NetSnapshotInterpolation"),
+		bNetSnapshotInterpolation,
+		TEXT("Whether simulated proxies with bUseSnapshotInterpolation set interpolate between buffered server snapshots. When disabled they use the regular linear smoothing."),
+		ECVF_Default);
+
+	static float NetSnapshotMaxExtrapolationTime = 0.1f;
+	FAutoConsoleVariableRef CVarNetSnapshotMaxExtrapolationTime(
+		TEXT("cg.NetSnapshotMaxExtrapolationTime"),
+		NetSnapshotMaxExtrapolationTime,
+		TEXT("Seconds snapshot interpolation keeps moving a simulated proxy along the velocity of its last two snapshots when no newer one arrived.\n")
+		TEXT("Past that, the mesh blends back onto the capsule. <=0: Blend as soon as the newest snapshot is reached"),
+		ECVF_Default);
+
+	static int32 MaxQueuedServerMoves = 8;
+	FAutoConsoleVariableRef CVarMaxQueuedServerMoves(
+		TEXT("cg.MaxQueuedServerMoves"),
+		MaxQueuedServerMoves,
+		TEXT("Max number of client moves a character queues before the queue is processed right away, protects against clients flooding the server between two frames."),
+		ECVF_Default);
+
 #if !UE_BUILD_SHIPPING
 
 	int32 NetShowCorrections = 0;
@@ -517,18 +692,15 @@ UBaseCharacterMovementComponent::UBaseCharacterMovementComponent(const FObjectIn
 	SetWalkableFloorZ(0.71f);
 
 	GravityDirection = DefaultGravityDirection;
+	GravityFieldId = 0;
 	WorldToGravityTransform = FQuat::Identity;
 	GravityToWorldTransform =  FQuat::Identity;
 	bHasCustomGravity = false;
+	GravitySpaceMode = EBaseGravitySpace::Default;
 
-	MaxStepHeight = 45.0f;
 	PerchRadiusThreshold = 0.0f;
 	PerchAdditionalHeight = 40.f;
 
-	MaxFlySpeed = 600.0f;
-	MaxWalkSpeed = 600.0f;
-	MaxSwimSpeed = 300.0f;
-	
 	MaxSimulationTimeStep = 0.05f;
 	MaxSimulationIterations = 8;
 	MaxJumpApexAttemptsPerSimulation = 2;
@@ -539,38 +711,17 @@ UBaseCharacterMovementComponent::UBaseCharacterMovementComponent(const FObjectIn
 	MaxDepenetrationWithPawn = 100.f;
 	MaxDepenetrationWithPawnAsProxy = 2.f;
 
-	// Set to match EVectorQuantization::RoundTwoDecimals
-	NetProxyShrinkRadius = 0.01f;
-	NetProxyShrinkHalfHeight = 0.01f;
-
-	NetworkSimulatedSmoothLocationTime = 0.100f;
-	NetworkSimulatedSmoothRotationTime = 0.050f;
-	ListenServerNetworkSimulatedSmoothLocationTime = 0.040f;
-	ListenServerNetworkSimulatedSmoothRotationTime = 0.033f;
-	NetworkMaxSmoothUpdateDistance = 256.f;
-	NetworkNoSmoothUpdateDistance = 384.f;
+	MovementSettings = nullptr;
 	NetworkSmoothingMode = ENetworkSmoothingMode::Exponential;
 	ServerLastClientGoodMoveAckTime = -1.f;
 	ServerLastClientAdjustmentTime = -1.f;
-	NetworkMinTimeBetweenClientAckGoodMoves = 0.10f;
-	NetworkMinTimeBetweenClientAdjustments = 0.10f;
-	NetworkMinTimeBetweenClientAdjustmentsLargeCorrection = 0.05f;
-	NetworkLargeClientCorrectionDistance = 15.0f;
 
-	MaxWalkSpeedCrouched = MaxWalkSpeed * 0.5f;
 	MaxOutOfWaterStepHeight = 40.0f;
 	OutofWaterZ = 420.0f;
 	AirControl = 0.05f;
 	AirControlBoostMultiplier = 2.f;
 	AirControlBoostVelocityThreshold = 25.f;
 	FallingLateralFriction = 0.f;
-	MaxAcceleration = 2048.0f;
-	BrakingFrictionFactor = 2.0f; // Historical value, 1 would be more appropriate.
-	BrakingSubStepTime = 1.0f / 33.0f;
-	BrakingDecelerationWalking = MaxAcceleration;
-	BrakingDecelerationFalling = 0.f;
-	BrakingDecelerationFlying = 0.f;
-	BrakingDecelerationSwimming = 0.f;
 	LedgeCheckThreshold = 4.0f;
 	JumpOutOfWaterPitch = 11.25f;
 
@@ -578,6 +729,35 @@ UBaseCharacterMovementComponent::UBaseCharacterMovementComponent(const FObjectIn
 	CrouchedSpeedMultiplier_DEPRECATED = 0.5f;
 	UpperImpactNormalScale_DEPRECATED = 0.5f;
 	bForceBraking_DEPRECATED = false;
+	MaxStepHeight_DEPRECATED = -1.f;
+	MaxWalkSpeed_DEPRECATED = -1.f;
+	MaxWalkSpeedCrouched_DEPRECATED = -1.f;
+	MaxSwimSpeed_DEPRECATED = -1.f;
+	MaxFlySpeed_DEPRECATED = -1.f;
+	MaxAcceleration_DEPRECATED = -1.f;
+	MinAnalogWalkSpeed_DEPRECATED = -1.f;
+	BrakingFrictionFactor_DEPRECATED = -1.f;
+	BrakingFriction_DEPRECATED = -1.f;
+	BrakingSubStepTime_DEPRECATED = -1.f;
+	BrakingDecelerationWalking_DEPRECATED = -1.f;
+	BrakingDecelerationFalling_DEPRECATED = -1.f;
+	BrakingDecelerationSwimming_DEPRECATED = -1.f;
+	BrakingDecelerationFlying_DEPRECATED = -1.f;
+	AvoidanceConsiderationRadius_DEPRECATED = -1.f;
+	AvoidanceWeight_DEPRECATED = -1.f;
+	NetworkSimulatedSmoothLocationTime_DEPRECATED = -1.f;
+	NetworkSimulatedSmoothRotationTime_DEPRECATED = -1.f;
+	ListenServerNetworkSimulatedSmoothLocationTime_DEPRECATED = -1.f;
+	ListenServerNetworkSimulatedSmoothRotationTime_DEPRECATED = -1.f;
+	NetworkSnapshotInterpolationDelay_DEPRECATED = -1.f;
+	NetProxyShrinkRadius_DEPRECATED = -1.f;
+	NetProxyShrinkHalfHeight_DEPRECATED = -1.f;
+	NetworkMaxSmoothUpdateDistance_DEPRECATED = -1.f;
+	NetworkNoSmoothUpdateDistance_DEPRECATED = -1.f;
+	NetworkMinTimeBetweenClientAckGoodMoves_DEPRECATED = -1.f;
+	NetworkMinTimeBetweenClientAdjustments_DEPRECATED = -1.f;
+	NetworkMinTimeBetweenClientAdjustmentsLargeCorrection_DEPRECATED = -1.f;
+	NetworkLargeClientCorrectionDistance_DEPRECATED = -1.f;
 #endif
 	
 	Mass = 100.0f;
@@ -629,6 +809,19 @@ UBaseCharacterMovementComponent::UBaseCharacterMovementComponent(const FObjectIn
 	bIgnoreClientMovementErrorChecksAndCorrection = false;
 	bServerAcceptClientAuthoritativePosition = false;
 	bAlwaysCheckFloor = true;
+	bFloorCacheIgnoresAlwaysCheckFloor = false;
+	bUseAsyncFloorChecks = false;
+	bUseMovementManager = false;
+	bBatchServerMoves = false;
+	bUseSimulatedProxyLOD = false;
+	bUseSnapshotInterpolation = false;
+	LastMovementCountersCycles = 0;
+	LastMovementCountersFrame = 0;
+	SimulatedProxyLOD = EBaseSimulatedProxyLOD::Full;
+	SimulatedProxyLODSmoothingTime = 0.f;
+	bRegisteredWithMovementManager = false;
+	AvoidanceHashIndex = INDEX_NONE;
+	AsyncFloorTraceGravityDirection = DefaultGravityDirection;
 
 	// default character can jump, walk, and swim
 	NavAgentProps.bCanJump = true;
@@ -659,7 +852,6 @@ UBaseCharacterMovementComponent::UBaseCharacterMovementComponent(const FObjectIn
 	AvoidanceGroup.bGroup0 = true;
 	GroupsToAvoid.Packed = 0xFFFFFFFF;
 	GroupsToIgnore.Packed = 0;
-	AvoidanceConsiderationRadius = 500.0f;
 
 	OldBaseQuat = FQuat::Identity;
 	OldBaseLocation = FVector::ZeroVector;
@@ -674,6 +866,31 @@ UBaseCharacterMovementComponent::UBaseCharacterMovementComponent(const FObjectIn
 void UBaseCharacterMovementComponent::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (bUseMovementManager || bBatchServerMoves || bUseSimulatedProxyLOD || bUseRVOAvoidance)
+	{
+		if (UBaseCharacterMovementManager* MovementManager = UBaseCharacterMovementManager::Get(this))
+		{
+			MovementManager->RegisterComponent(this);
+			bRegisteredWithMovementManager = true;
+		}
+	}
+}
+
+void UBaseCharacterMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	QueuedServerMoves.Reset();
+
+	if (bRegisteredWithMovementManager)
+	{
+		if (UBaseCharacterMovementManager* MovementManager = UBaseCharacterMovementManager::Get(this))
+		{
+			MovementManager->UnregisterComponent(this);
+		}
+		bRegisteredWithMovementManager = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UBaseCharacterMovementComponent::PostLoad()
@@ -681,11 +898,65 @@ void UBaseCharacterMovementComponent::PostLoad()
 	Super::PostLoad();
 
 #if WITH_EDITORONLY_DATA
+	// Tuning moved to UBaseCharacterMovementSettings. The values this component saved before the move become overrides of its settings,
+	// so Blueprints and placed characters saved before it behave the same. Only values that differed from the archetype were saved.
+	struct FDeprecatedSetting
+	{
+		float UBaseCharacterMovementComponent::* Deprecated;
+		EBaseCharacterMovementSetting Setting;
+	};
+	const FDeprecatedSetting DeprecatedSettings[] =
+	{
+		{ &UBaseCharacterMovementComponent::MaxStepHeight_DEPRECATED, EBaseCharacterMovementSetting::MaxStepHeight },
+		{ &UBaseCharacterMovementComponent::MaxWalkSpeed_DEPRECATED, EBaseCharacterMovementSetting::MaxWalkSpeed },
+		{ &UBaseCharacterMovementComponent::MaxWalkSpeedCrouched_DEPRECATED, EBaseCharacterMovementSetting::MaxWalkSpeedCrouched },
+		{ &UBaseCharacterMovementComponent::MaxSwimSpeed_DEPRECATED, EBaseCharacterMovementSetting::MaxSwimSpeed },
+		{ &UBaseCharacterMovementComponent::MaxFlySpeed_DEPRECATED, EBaseCharacterMovementSetting::MaxFlySpeed },
+		{ &UBaseCharacterMovementComponent::MaxAcceleration_DEPRECATED, EBaseCharacterMovementSetting::MaxAcceleration },
+		{ &UBaseCharacterMovementComponent::MinAnalogWalkSpeed_DEPRECATED, EBaseCharacterMovementSetting::MinAnalogWalkSpeed },
+		{ &UBaseCharacterMovementComponent::BrakingFrictionFactor_DEPRECATED, EBaseCharacterMovementSetting::BrakingFrictionFactor },
+		{ &UBaseCharacterMovementComponent::BrakingFriction_DEPRECATED, EBaseCharacterMovementSetting::BrakingFriction },
+		{ &UBaseCharacterMovementComponent::BrakingSubStepTime_DEPRECATED, EBaseCharacterMovementSetting::BrakingSubStepTime },
+		{ &UBaseCharacterMovementComponent::BrakingDecelerationWalking_DEPRECATED, EBaseCharacterMovementSetting::BrakingDecelerationWalking },
+		{ &UBaseCharacterMovementComponent::BrakingDecelerationFalling_DEPRECATED, EBaseCharacterMovementSetting::BrakingDecelerationFalling },
+		{ &UBaseCharacterMovementComponent::BrakingDecelerationSwimming_DEPRECATED, EBaseCharacterMovementSetting::BrakingDecelerationSwimming },
+		{ &UBaseCharacterMovementComponent::BrakingDecelerationFlying_DEPRECATED, EBaseCharacterMovementSetting::BrakingDecelerationFlying },
+		{ &UBaseCharacterMovementComponent::AvoidanceConsiderationRadius_DEPRECATED, EBaseCharacterMovementSetting::AvoidanceConsiderationRadius },
+		{ &UBaseCharacterMovementComponent::AvoidanceWeight_DEPRECATED, EBaseCharacterMovementSetting::AvoidanceWeight },
+		{ &UBaseCharacterMovementComponent::NetworkSimulatedSmoothLocationTime_DEPRECATED, EBaseCharacterMovementSetting::NetworkSimulatedSmoothLocationTime },
+		{ &UBaseCharacterMovementComponent::NetworkSimulatedSmoothRotationTime_DEPRECATED, EBaseCharacterMovementSetting::NetworkSimulatedSmoothRotationTime },
+		{ &UBaseCharacterMovementComponent::ListenServerNetworkSimulatedSmoothLocationTime_DEPRECATED, EBaseCharacterMovementSetting::ListenServerNetworkSimulatedSmoothLocationTime },
+		{ &UBaseCharacterMovementComponent::ListenServerNetworkSimulatedSmoothRotationTime_DEPRECATED, EBaseCharacterMovementSetting::ListenServerNetworkSimulatedSmoothRotationTime },
+		{ &UBaseCharacterMovementComponent::NetworkSnapshotInterpolationDelay_DEPRECATED, EBaseCharacterMovementSetting::NetworkSnapshotInterpolationDelay },
+		{ &UBaseCharacterMovementComponent::NetProxyShrinkRadius_DEPRECATED, EBaseCharacterMovementSetting::NetProxyShrinkRadius },
+		{ &UBaseCharacterMovementComponent::NetProxyShrinkHalfHeight_DEPRECATED, EBaseCharacterMovementSetting::NetProxyShrinkHalfHeight },
+		{ &UBaseCharacterMovementComponent::NetworkMaxSmoothUpdateDistance_DEPRECATED, EBaseCharacterMovementSetting::NetworkMaxSmoothUpdateDistance },
+		{ &UBaseCharacterMovementComponent::NetworkNoSmoothUpdateDistance_DEPRECATED, EBaseCharacterMovementSetting::NetworkNoSmoothUpdateDistance },
+		{ &UBaseCharacterMovementComponent::NetworkMinTimeBetweenClientAckGoodMoves_DEPRECATED, EBaseCharacterMovementSetting::NetworkMinTimeBetweenClientAckGoodMoves },
+		{ &UBaseCharacterMovementComponent::NetworkMinTimeBetweenClientAdjustments_DEPRECATED, EBaseCharacterMovementSetting::NetworkMinTimeBetweenClientAdjustments },
+		{ &UBaseCharacterMovementComponent::NetworkMinTimeBetweenClientAdjustmentsLargeCorrection_DEPRECATED, EBaseCharacterMovementSetting::NetworkMinTimeBetweenClientAdjustmentsLargeCorrection },
+		{ &UBaseCharacterMovementComponent::NetworkLargeClientCorrectionDistance_DEPRECATED, EBaseCharacterMovementSetting::NetworkLargeClientCorrectionDistance },
+	};
+
+	bool bMigratedSettings = false;
+	for (const FDeprecatedSetting& DeprecatedSetting : DeprecatedSettings)
+	{
+		float& DeprecatedValue = this->*DeprecatedSetting.Deprecated;
+		if (DeprecatedValue >= 0.f)
+		{
+			SetMovementSetting(DeprecatedSetting.Setting, DeprecatedValue);
+			DeprecatedValue = -1.f;
+			bMigratedSettings = true;
+		}
+	}
+
+	UE_CLOG(bMigratedSettings, LogBaseCharacterMovement, Log, TEXT("%s: moved deprecated tuning to MovementSettingOverrides, consider moving it to a shared UBaseCharacterMovementSettings asset."), *GetPathName());
+
 	const FPackageFileVersion LinkerUEVer = GetLinkerUEVersion();
 
 	if (LinkerUEVer < VER_UE4_CHARACTER_MOVEMENT_DECELERATION)
 	{
-		BrakingDecelerationWalking = MaxAcceleration;
+		SetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationWalking, GetMovementSetting(EBaseCharacterMovementSetting::MaxAcceleration));
 	}
 
 	if (LinkerUEVer < VER_UE4_CHARACTER_BRAKING_REFACTOR)
@@ -693,8 +964,9 @@ void UBaseCharacterMovementComponent::PostLoad()
 		// This bool used to apply walking braking in flying and swimming modes.
 		if (bForceBraking_DEPRECATED)
 		{
-			BrakingDecelerationFlying = BrakingDecelerationWalking;
-			BrakingDecelerationSwimming = BrakingDecelerationWalking;
+			const float BrakingDecelerationWalking = GetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationWalking);
+			SetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationFlying, BrakingDecelerationWalking);
+			SetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationSwimming, BrakingDecelerationWalking);
 		}
 	}
 
@@ -706,7 +978,7 @@ void UBaseCharacterMovementComponent::PostLoad()
 
 	if (LinkerUEVer < VER_UE4_DEPRECATED_MOVEMENTCOMPONENT_MODIFIED_SPEEDS)
 	{
-		MaxWalkSpeedCrouched = MaxWalkSpeed * CrouchedSpeedMultiplier_DEPRECATED;
+		SetMovementSetting(EBaseCharacterMovementSetting::MaxWalkSpeedCrouched, GetMovementSetting(EBaseCharacterMovementSetting::MaxWalkSpeed) * CrouchedSpeedMultiplier_DEPRECATED);
 	}
 #endif
 
@@ -714,6 +986,48 @@ void UBaseCharacterMovementComponent::PostLoad()
 }
 
 
+float UBaseCharacterMovementComponent::GetMovementSetting(EBaseCharacterMovementSetting Setting) const
+{
+	for (const FBaseCharacterMovementSettingOverride& Override : MovementSettingOverrides)
+	{
+		if (Override.Setting == Setting)
+		{
+			return Override.Value;
+		}
+	}
+
+	return GetMovementSettings().GetSetting(Setting);
+}
+
+
+void UBaseCharacterMovementComponent::SetMovementSetting(EBaseCharacterMovementSetting Setting, float Value)
+{
+	if (!ensure(Setting < EBaseCharacterMovementSetting::MAX))
+	{
+		return;
+	}
+
+	for (FBaseCharacterMovementSettingOverride& Override : MovementSettingOverrides)
+	{
+		if (Override.Setting == Setting)
+		{
+			Override.Value = Value;
+			return;
+		}
+	}
+
+	FBaseCharacterMovementSettingOverride& Override = MovementSettingOverrides.AddDefaulted_GetRef();
+	Override.Setting = Setting;
+	Override.Value = Value;
+}
+
+
+void UBaseCharacterMovementComponent::ResetMovementSetting(EBaseCharacterMovementSetting Setting)
+{
+	MovementSettingOverrides.RemoveAll([Setting](const FBaseCharacterMovementSettingOverride& Override) { return Override.Setting == Setting; });
+}
+
+
 #if WITH_EDITOR
 void UBaseCharacterMovementComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
@@ -816,6 +1130,8 @@ void UBaseCharacterMovementComponent::SetUpdatedComponent(USceneComponent* NewUp
 		}
 	}
 
+	FloorCache.Invalidate();
+
 	if ( bMovementInProgress )
 	{
 		// failsafe to avoid crashes in CharacterMovement. 
@@ -864,7 +1180,7 @@ void UBaseCharacterMovementComponent::SetUpdatedComponent(USceneComponent* NewUp
 		UAvoidanceManager* AvoidanceManager = GetWorld()->GetAvoidanceManager();
 		if (AvoidanceManager)
 		{
-			AvoidanceManager->RegisterMovementComponent(this, AvoidanceWeight);
+			AvoidanceManager->RegisterMovementComponent(this, GetMovementSetting(EBaseCharacterMovementSetting::AvoidanceWeight));
 		}
 	}
 }
@@ -1194,8 +1510,8 @@ void UBaseCharacterMovementComponent::OnMovementModeChanged(EMovementMode Previo
 		CachedNavLocation = FNavLocation();
 
 		GroundMovementMode = MovementMode;
-		// Walking uses only XY velocity
-		Velocity.Z = 0.f;
+		// Walking uses only velocity along the gravity floor plane
+		Velocity = FVector::VectorPlaneProject(Velocity, -GravityDirection);
 		SetNavWalkingPhysics(true);
 	}
 	else if (PreviousMovementMode == MOVE_NavWalking)
@@ -1402,10 +1718,15 @@ void UBaseCharacterMovementComponent::AddReferencedObjects(UObject* InThis, FRef
 
 void UBaseCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
-	// SCOPED_NAMED_EVENT(UBaseCharacterMovementComponent_TickComponent, FColor::Yellow);
-	// SCOPE_CYCLE_COUNTER(STAT_CharacterMovement);
-	// SCOPE_CYCLE_COUNTER(STAT_CharacterMovementTick);
-	// CSV_SCOPED_TIMING_STAT_EXCLUSIVE(CharacterMovement);
+	SCOPED_NAMED_EVENT(UBaseCharacterMovementComponent_TickComponent, FColor::Yellow);
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementTick);
+	CSV_SCOPED_TIMING_STAT_EXCLUSIVE(BaseCharacterMovement);
+
+	const uint64 TickStartCycles = FPlatformTime::Cycles64();
+	ON_SCOPE_EXIT
+	{
+		FlushMovementCounters(FPlatformTime::Cycles64() - TickStartCycles);
+	};
 
 	FVector InputVector = ConsumeInputVector();
 
@@ -1525,6 +1846,64 @@ void UBaseCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevel
 
 }
 
+void UBaseCharacterMovementComponent::FlushMovementCounters(uint64 TickCycles)
+{
+#if UE_TRACE_ENABLED
+	if (UE_TRACE_CHANNELEXPR_IS_ENABLED(BaseCharacterMovementChannel))
+	{
+		const FString CharacterName = GetNameSafe(CharacterOwner);
+		UE_TRACE_LOG(BaseCharacterMovement, CharacterCounters, BaseCharacterMovementChannel)
+			<< CharacterCounters.Cycle(FPlatformTime::Cycles64())
+			<< CharacterCounters.FrameNumber(GFrameCounter)
+			<< CharacterCounters.TickCycles(TickCycles)
+			<< CharacterCounters.ComponentId(GetUniqueID())
+			<< CharacterCounters.LocalRole(CharacterOwner ? (uint8)CharacterOwner->GetLocalRole() : (uint8)ROLE_None)
+			<< CharacterCounters.Sweeps(MovementCounters.Sweeps)
+			<< CharacterCounters.FloorProbes(MovementCounters.FloorProbes)
+			<< CharacterCounters.StepUps(MovementCounters.StepUps)
+			<< CharacterCounters.SlideIterations(MovementCounters.SlideIterations)
+			<< CharacterCounters.Substeps(MovementCounters.Substeps)
+			<< CharacterCounters.GravityFieldLookups(MovementCounters.GravityFieldLookups)
+			<< CharacterCounters.CorrectionsSent(MovementCounters.CorrectionsSent)
+			<< CharacterCounters.CorrectionsReceived(MovementCounters.CorrectionsReceived)
+			<< CharacterCounters.ReplayedMoves(MovementCounters.ReplayedMoves)
+			<< CharacterCounters.TranslatedMoves(MovementCounters.TranslatedMoves)
+			<< CharacterCounters.ReplayCycles(MovementCounters.ReplayCycles)
+			<< CharacterCounters.CharacterName(*CharacterName, CharacterName.Len());
+	}
+#endif // UE_TRACE_ENABLED
+
+	// Totals of the frame, and the worst character to tell a crowd from a single expensive character.
+	CSV_CUSTOM_STAT(BaseCharacterMovement, Sweeps, (int32)MovementCounters.Sweeps, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, FloorProbes, (int32)MovementCounters.FloorProbes, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, StepUps, (int32)MovementCounters.StepUps, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, SlideIterations, (int32)MovementCounters.SlideIterations, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, Substeps, (int32)MovementCounters.Substeps, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, GravityFieldLookups, (int32)MovementCounters.GravityFieldLookups, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, CorrectionsSent, (int32)MovementCounters.CorrectionsSent, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, CorrectionsReceived, (int32)MovementCounters.CorrectionsReceived, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, ReplayedMoves, (int32)MovementCounters.ReplayedMoves, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, TranslatedMoves, (int32)MovementCounters.TranslatedMoves, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, ReplayMs, (float)FPlatformTime::ToMilliseconds64(MovementCounters.ReplayCycles), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, MaxSweepsPerCharacter, (int32)MovementCounters.Sweeps, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, MaxTickTimePerCharacter, (float)FPlatformTime::ToMilliseconds64(TickCycles), ECsvCustomStatOp::Max);
+
+	LastMovementCounters = MovementCounters;
+	LastMovementCountersCycles = TickCycles;
+	LastMovementCountersFrame = GFrameCounter;
+	MovementCounters.Reset();
+}
+
+bool UBaseCharacterMovementComponent::MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit, ETeleportType Teleport)
+{
+	if (bSweep)
+	{
+		++MovementCounters.Sweeps;
+	}
+
+	return Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, OutHit, Teleport);
+}
+
 void UBaseCharacterMovementComponent::PrePhysicsTickComponent(float DeltaTime, FBaseCharacterMovementComponentPrePhysicsTickFunction& ThisTickFunction)
 {
 }
@@ -1546,8 +1925,8 @@ void UBaseCharacterMovementComponent::AdjustProxyCapsuleSize()
 	{
 		bShrinkProxyCapsule = false;
 
-		float ShrinkRadius = FMath::Max(0.f, NetProxyShrinkRadius);
-		float ShrinkHalfHeight = FMath::Max(0.f, NetProxyShrinkHalfHeight);
+		float ShrinkRadius = FMath::Max(0.f, GetMovementSetting(EBaseCharacterMovementSetting::NetProxyShrinkRadius));
+		float ShrinkHalfHeight = FMath::Max(0.f, GetMovementSetting(EBaseCharacterMovementSetting::NetProxyShrinkHalfHeight));
 
 		if (ShrinkRadius == 0.f && ShrinkHalfHeight == 0.f)
 		{
@@ -1585,6 +1964,14 @@ void UBaseCharacterMovementComponent::SimulatedTick(float DeltaSeconds)
 	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementSimulated);
 	checkSlow(CharacterOwner != nullptr);
 
+	// Root motion and the transition out of it always use the full update.
+	if (SimulatedProxyLOD != EBaseSimulatedProxyLOD::Full && !bWasSimulatingRootMotion
+		&& !CharacterOwner->IsPlayingNetworkedRootMotionMontage() && !CurrentRootMotion.HasActiveRootMotionSources())
+	{
+		SimulatedTickLOD(DeltaSeconds);
+		return;
+	}
+
 	// If we are playing a RootMotion AnimMontage.
 	if (CharacterOwner->IsPlayingNetworkedRootMotionMontage())
 	{
@@ -1790,6 +2177,74 @@ void UBaseCharacterMovementComponent::SimulatedTick(float DeltaSeconds)
 	}
 }
 
+void UBaseCharacterMovementComponent::SimulatedTickLOD(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementSimulatedLOD);
+
+	if (bNetworkUpdateReceived)
+	{
+		bNetworkUpdateReceived = false;
+		ApplyNetworkUpdateFlags();
+	}
+
+	if (SimulatedProxyLOD == EBaseSimulatedProxyLOD::Frozen || !CharacterOwner->IsReplicatingMovement())
+	{
+		return;
+	}
+
+	if (SimulatedProxyLOD == EBaseSimulatedProxyLOD::Extrapolate && MovementMode != MOVE_None
+		&& UpdatedComponent->Mobility == EComponentMobility::Movable && !CharacterOwner->GetReplicatedBasedMovement().IsBaseUnresolved())
+	{
+		// Follow the replicated velocity, projected on the ground plane when walking. Replication snaps the capsule back
+		// on the next update and smoothing hides the error, so there is no need to sweep.
+		FVector Delta = Velocity * DeltaSeconds;
+		if (IsMovingOnGround())
+		{
+			Delta = FVector::VectorPlaneProject(Delta, GravityDirection);
+		}
+
+		if (!Delta.IsNearlyZero())
+		{
+			USkeletalMeshComponent* Mesh = CharacterOwner->GetMesh();
+			const FScopedPreventAttachedComponentMove PreventMeshMovement(!bNetworkSmoothingComplete ? Mesh : nullptr);
+			UpdatedComponent->MoveComponent(Delta, UpdatedComponent->GetComponentQuat(), false, nullptr, MOVECOMP_NoFlags, ETeleportType::TeleportPhysics);
+		}
+	}
+
+	if (!bNetworkSmoothingComplete)
+	{
+		float SmoothingDeltaSeconds = DeltaSeconds;
+		if (SimulatedProxyLOD == EBaseSimulatedProxyLOD::Interpolate && BaseCharacterMovementCVars::SimulatedProxyLODInterpolateRate > 0.f)
+		{
+			SimulatedProxyLODSmoothingTime += DeltaSeconds;
+			if (SimulatedProxyLODSmoothingTime < 1.f / BaseCharacterMovementCVars::SimulatedProxyLODInterpolateRate)
+			{
+				return;
+			}
+			SmoothingDeltaSeconds = SimulatedProxyLODSmoothingTime;
+			SimulatedProxyLODSmoothingTime = 0.f;
+		}
+
+		SCOPE_CYCLE_COUNTER(STAT_CharacterMovementSmoothClientPosition);
+		SmoothClientPosition(SmoothingDeltaSeconds);
+	}
+}
+
+void UBaseCharacterMovementComponent::ApplyNetworkUpdateFlags()
+{
+	if (bNetworkGravityDirectionChanged)
+	{
+		SetGravityDirection(CharacterOwner->GetReplicatedGravityDirection());
+		bNetworkGravityDirectionChanged = false;
+	}
+
+	if (bNetworkMovementModeChanged)
+	{
+		ApplyNetworkMovementMode(CharacterOwner->GetReplicatedMovementMode());
+		bNetworkMovementModeChanged = false;
+	}
+}
+
 FTransform UBaseCharacterMovementComponent::ConvertLocalRootMotionToWorld(const FTransform& LocalRootMotionTransform, float DeltaSeconds)
 {
 	const FTransform PreProcessedRootMotion = ProcessRootMotionPreConvertToWorld.IsBound() ? ProcessRootMotionPreConvertToWorld.Execute(LocalRootMotionTransform, this, DeltaSeconds) : LocalRootMotionTransform;
@@ -2213,6 +2668,7 @@ void UBaseCharacterMovementComponent::UpdateBasedMovement(float DeltaSeconds)
 	// Ignore collision with bases during these movements.
 	TGuardValue<EMoveComponentFlags> ScopedFlagRestore(MoveComponentFlags, MoveComponentFlags | MOVECOMP_IgnoreBases);
 
+	const FVector OldGravityDirection = GravityDirection;
 	FQuat DeltaQuat = FQuat::Identity;
 	FVector DeltaPosition = FVector::ZeroVector;
 
@@ -2238,6 +2694,12 @@ void UBaseCharacterMovementComponent::UpdateBasedMovement(float DeltaSeconds)
 		const FQuatRotationTranslationMatrix NewLocalToWorld(NewBaseQuat, NewBaseLocation);
 
 		FQuat FinalQuat = UpdatedComponent->GetComponentQuat();
+
+		// Gravity from a field moving with the base rotates with it, in the same step as the character.
+		if (bRotationChanged && ShouldGravityFollowBase())
+		{
+			SetGravityDirection(DeltaQuat.RotateVector(GravityDirection).GetSafeNormal(UE_SMALL_NUMBER, GravityDirection));
+		}
 			
 		if (bRotationChanged && !bIgnoreBaseRotation)
 		{
@@ -2271,13 +2733,14 @@ void UBaseCharacterMovementComponent::UpdateBasedMovement(float DeltaSeconds)
 			}
 		}
 
-		// We need to offset the base of the character here, not its origin, so offset by half height
+		// We need to offset the base of the character here, not its origin, so offset by half height along gravity
 		float HalfHeight, Radius;
 		CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(Radius, HalfHeight);
 
-		FVector const BaseOffset(0.0f, 0.0f, HalfHeight);
-		FVector const LocalBasePos = OldLocalToWorld.InverseTransformPosition(UpdatedComponent->GetComponentLocation() - BaseOffset);
-		FVector const NewWorldPos = ConstrainLocationToPlane(NewLocalToWorld.TransformPosition(LocalBasePos) + BaseOffset);
+		FVector const OldBaseOffset = -OldGravityDirection * HalfHeight;
+		FVector const NewBaseOffset = -GravityDirection * HalfHeight;
+		FVector const LocalBasePos = OldLocalToWorld.InverseTransformPosition(UpdatedComponent->GetComponentLocation() - OldBaseOffset);
+		FVector const NewWorldPos = ConstrainLocationToPlane(NewLocalToWorld.TransformPosition(LocalBasePos) + NewBaseOffset);
 		DeltaPosition = ConstrainDirectionToPlane(NewWorldPos - UpdatedComponent->GetComponentLocation());
 
 		// move attached actor
@@ -2313,6 +2776,19 @@ void UBaseCharacterMovementComponent::UpdateBasedMovement(float DeltaSeconds)
 }
 
 
+bool UBaseCharacterMovementComponent::ShouldGravityFollowBase() const
+{
+	const USceneComponent* FieldComponent = GravityFieldComponent.Get();
+	const UPrimitiveComponent* MovementBase = CharacterOwner ? CharacterOwner->GetMovementBase() : nullptr;
+	if (!FieldComponent || !MovementBaseUtility::UseRelativeLocation(MovementBase))
+	{
+		return false;
+	}
+
+	const AActor* FieldRoot = FieldComponent->GetAttachmentRootActor();
+	return FieldRoot && FieldRoot == MovementBase->GetAttachmentRootActor();
+}
+
 void UBaseCharacterMovementComponent::OnUnableToFollowBaseMove(const FVector& DeltaPosition, const FVector& OldLocation, const FHitResult& MoveOnBaseHit)
 {
 	// no default implementation, left for subclasses to override.
@@ -3161,13 +3637,13 @@ float UBaseCharacterMovementComponent::GetMaxSpeed() const
 	{
 	case MOVE_Walking:
 	case MOVE_NavWalking:
-		return IsCrouching() ? MaxWalkSpeedCrouched : MaxWalkSpeed;
+		return IsCrouching() ? GetMovementSetting(EBaseCharacterMovementSetting::MaxWalkSpeedCrouched) : GetMovementSetting(EBaseCharacterMovementSetting::MaxWalkSpeed);
 	case MOVE_Falling:
-		return MaxWalkSpeed;
+		return GetMovementSetting(EBaseCharacterMovementSetting::MaxWalkSpeed);
 	case MOVE_Swimming:
-		return MaxSwimSpeed;
+		return GetMovementSetting(EBaseCharacterMovementSetting::MaxSwimSpeed);
 	case MOVE_Flying:
-		return MaxFlySpeed;
+		return GetMovementSetting(EBaseCharacterMovementSetting::MaxFlySpeed);
 	case MOVE_None:
 	default:
 		return 0.f;
@@ -3181,7 +3657,7 @@ float UBaseCharacterMovementComponent::GetMinAnalogSpeed() const
 	case MOVE_Walking:
 	case MOVE_NavWalking:
 	case MOVE_Falling:
-		return MinAnalogWalkSpeed;
+		return GetMovementSetting(EBaseCharacterMovementSetting::MinAnalogWalkSpeed);
 	default:
 		return 0.f;
 	}
@@ -3215,14 +3691,17 @@ bool UBaseCharacterMovementComponent::ResolvePenetrationImpl(const FVector& Adju
 }
 
 
-float UBaseCharacterMovementComponent::SlideAlongSurface(const FVector& Delta, float Time, const FVector& InNormal, FHitResult& Hit, bool bHandleImpact)
+template<EBaseGravitySpace Space>
+float UBaseCharacterMovementComponent::SlideAlongSurfaceImpl(const FVector& Delta, float Time, const FVector& InNormal, FHitResult& Hit, bool bHandleImpact)
 {
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
+
 	if (!Hit.bBlockingHit)
 	{
 		return 0.f;
 	}
 
-	FVector Normal(RotateWorldToGravity(InNormal));
+	FVector Normal(GravitySpace.ToGravity(InNormal));
 	if (IsMovingOnGround())
 	{
 		// We don't want to be pushed up an unwalkable surface.
@@ -3238,9 +3717,9 @@ float UBaseCharacterMovementComponent::SlideAlongSurface(const FVector& Delta, f
 			// Don't push down into the floor when the impact is on the upper portion of the capsule.
 			if (CurrentFloor.FloorDist < MIN_FLOOR_DIST && CurrentFloor.bBlockingHit)
 			{
-				const FVector FloorNormal = RotateWorldToGravity(CurrentFloor.HitResult.Normal);
+				const FVector FloorNormal = GravitySpace.ToGravity(CurrentFloor.HitResult.Normal);
 
-				const bool bFloorOpposedToMovement = (RotateWorldToGravity(Delta) | FloorNormal) < 0.f && (FloorNormal.Z < 1.f - UE_DELTA);
+				const bool bFloorOpposedToMovement = (GravitySpace.ToGravity(Delta) | FloorNormal) < 0.f && (FloorNormal.Z < 1.f - UE_DELTA);
 				if (bFloorOpposedToMovement)
 				{
 					Normal = FloorNormal;
@@ -3251,21 +3730,39 @@ float UBaseCharacterMovementComponent::SlideAlongSurface(const FVector& Delta, f
 		}
 	}
 
-	return Super::SlideAlongSurface(Delta, Time, RotateGravityToWorld(Normal), Hit, bHandleImpact);
+	return Super::SlideAlongSurface(Delta, Time, GravitySpace.ToWorld(Normal), Hit, bHandleImpact);
 }
 
+float UBaseCharacterMovementComponent::SlideAlongSurface(const FVector& Delta, float Time, const FVector& InNormal, FHitResult& Hit, bool bHandleImpact)
+{
+	++MovementCounters.SlideIterations;
 
-void UBaseCharacterMovementComponent::TwoWallAdjust(FVector& WorldSpaceDelta, const FHitResult& Hit, const FVector& OldHitNormal) const
+	switch (GravitySpaceMode)
+	{
+	case EBaseGravitySpace::AxisAligned:
+		return SlideAlongSurfaceImpl<EBaseGravitySpace::AxisAligned>(Delta, Time, InNormal, Hit, bHandleImpact);
+	case EBaseGravitySpace::Custom:
+		return SlideAlongSurfaceImpl<EBaseGravitySpace::Custom>(Delta, Time, InNormal, Hit, bHandleImpact);
+	default:
+		return SlideAlongSurfaceImpl<EBaseGravitySpace::Default>(Delta, Time, InNormal, Hit, bHandleImpact);
+	}
+}
+
+
+template<EBaseGravitySpace Space>
+void UBaseCharacterMovementComponent::TwoWallAdjustImpl(FVector& WorldSpaceDelta, const FHitResult& Hit, const FVector& OldHitNormal) const
 {
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
+
 	Super::TwoWallAdjust(WorldSpaceDelta, Hit, OldHitNormal);
 
-	FVector GravityRelativeDelta = RotateWorldToGravity(WorldSpaceDelta);
+	FVector GravityRelativeDelta = GravitySpace.ToGravity(WorldSpaceDelta);
 	if (IsMovingOnGround())
 	{
 		// Allow slides up walkable surfaces, but not unwalkable ones (treat those as vertical barriers).
 		if (GravityRelativeDelta.Z > 0.f)
 		{
-			const FVector GravityRelativeHitNormal = RotateWorldToGravity(Hit.Normal);
+			const FVector GravityRelativeHitNormal = GravitySpace.ToGravity(Hit.Normal);
 			if ((GravityRelativeHitNormal.Z >= WalkableFloorZ || IsWalkable(Hit)) && GravityRelativeHitNormal.Z > UE_KINDA_SMALL_NUMBER)
 			{
 				// Maintain horizontal velocity
@@ -3275,6 +3772,7 @@ void UBaseCharacterMovementComponent::TwoWallAdjust(FVector& WorldSpaceDelta, co
 
 				// Should never exceed MaxStepHeight in vertical component, so rescale if necessary.
 				// This should be rare (Hit.Normal.Z above would have been very small) but we'd rather lose horizontal velocity than go too high.
+				const float MaxStepHeight = GetMovementSetting(EBaseCharacterMovementSetting::MaxStepHeight);
 				if (GravityRelativeDelta.Z > MaxStepHeight)
 				{
 					const float Rescale = MaxStepHeight / GravityRelativeDelta.Z;
@@ -3296,7 +3794,20 @@ void UBaseCharacterMovementComponent::TwoWallAdjust(FVector& WorldSpaceDelta, co
 		}
 	}
 
-	WorldSpaceDelta = RotateGravityToWorld(GravityRelativeDelta);
+	WorldSpaceDelta = GravitySpace.ToWorld(GravityRelativeDelta);
+}
+
+void UBaseCharacterMovementComponent::TwoWallAdjust(FVector& WorldSpaceDelta, const FHitResult& Hit, const FVector& OldHitNormal) const
+{
+	switch (GravitySpaceMode)
+	{
+	case EBaseGravitySpace::AxisAligned:
+		return TwoWallAdjustImpl<EBaseGravitySpace::AxisAligned>(WorldSpaceDelta, Hit, OldHitNormal);
+	case EBaseGravitySpace::Custom:
+		return TwoWallAdjustImpl<EBaseGravitySpace::Custom>(WorldSpaceDelta, Hit, OldHitNormal);
+	default:
+		return TwoWallAdjustImpl<EBaseGravitySpace::Default>(WorldSpaceDelta, Hit, OldHitNormal);
+	}
 }
 
 
@@ -3479,7 +3990,7 @@ void UBaseCharacterMovementComponent::CalcVelocity(float DeltaTime, float Fricti
 	{
 		const FVector OldVelocity = Velocity;
 
-		const float ActualBrakingFriction = (bUseSeparateBrakingFriction ? BrakingFriction : Friction);
+		const float ActualBrakingFriction = (bUseSeparateBrakingFriction ? GetMovementSetting(EBaseCharacterMovementSetting::BrakingFriction) : Friction);
 		ApplyVelocityBraking(DeltaTime, ActualBrakingFriction, BrakingDeceleration);
 	
 		// Don't allow braking to lower us below max speed if we started above it.
@@ -3660,10 +4171,10 @@ float UBaseCharacterMovementComponent::GetPathFollowingBrakingDistance(float Max
 
 void UBaseCharacterMovementComponent::CalcAvoidanceVelocity(float DeltaTime)
 {
-	// SCOPE_CYCLE_COUNTER(STAT_AI_ObstacleAvoidance);
+	SCOPE_CYCLE_COUNTER(STAT_CharAvoidance);
 
 	UAvoidanceManager* AvoidanceManager = GetWorld()->GetAvoidanceManager();
-	if (AvoidanceWeight >= 1.0f || AvoidanceManager == NULL || GetCharacterOwner() == NULL)
+	if (GetMovementSetting(EBaseCharacterMovementSetting::AvoidanceWeight) >= 1.0f || AvoidanceManager == NULL || GetCharacterOwner() == NULL)
 	{
 		return;
 	}
@@ -3677,6 +4188,9 @@ void UBaseCharacterMovementComponent::CalcAvoidanceVelocity(float DeltaTime)
 	const bool bShowDebug = AvoidanceManager->IsDebugEnabled(AvoidanceUID);
 #endif
 
+	// Neighbors come from the avoidance hash when this component made it in this frame, from the avoidance manager otherwise.
+	const bool bUseAvoidanceHash = BaseCharacterMovementCVars::bUseGravityRelativeAvoidance && AvoidanceHashIndex != INDEX_NONE;
+
 	//Adjust velocity only if we're in "Walking" mode. We should also check if we're dazed, being knocked around, maybe off-navmesh, etc.
 	UCapsuleComponent *OurCapsule = GetCharacterOwner()->GetCapsuleComponent();
 	if (!Velocity.IsZero() && IsMovingOnGround() && OurCapsule)
@@ -3694,7 +4208,12 @@ void UBaseCharacterMovementComponent::CalcAvoidanceVelocity(float DeltaTime)
 		}
 		else
 		{
-			FVector NewVelocity = AvoidanceManager->GetAvoidanceVelocityForComponent(this);
+			UBaseCharacterMovementManager* MovementManager = bUseAvoidanceHash ? UBaseCharacterMovementManager::Get(this) : nullptr;
+			FBaseCharacterAvoidanceHash* AvoidanceHash = MovementManager ? &MovementManager->GetAvoidanceHash() : nullptr;
+
+			FVector NewVelocity = AvoidanceHash
+				? AvoidanceHash->ComputeAvoidanceVelocity(AvoidanceHashIndex, Velocity, GetMovementSetting(EBaseCharacterMovementSetting::AvoidanceConsiderationRadius), AvoidanceManager->DeltaTimeToPredict, AvoidanceManager->ArtificialRadiusExpansion)
+				: AvoidanceManager->GetAvoidanceVelocityForComponent(this);
 			if (bUseRVOPostProcess)
 			{
 				PostProcessAvoidanceVelocity(NewVelocity);
@@ -3705,6 +4224,10 @@ void UBaseCharacterMovementComponent::CalcAvoidanceVelocity(float DeltaTime)
 				//Had to divert course, lock this avoidance move in for a short time. This will make us a VO, so unlocked others will know to avoid us.
 				Velocity = NewVelocity;
 				SetAvoidanceVelocityLock(AvoidanceManager, AvoidanceManager->LockTimeAfterAvoid);
+				if (AvoidanceHash)
+				{
+					AvoidanceHash->LockAgentVelocity(AvoidanceHashIndex, Velocity);
+				}
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 				if (bShowDebug)
 				{
@@ -3716,6 +4239,10 @@ void UBaseCharacterMovementComponent::CalcAvoidanceVelocity(float DeltaTime)
 			{
 				//Although we didn't divert course, our velocity for this frame is decided. We will not reciprocate anything further, so treat as a VO for the remainder of this frame.
 				SetAvoidanceVelocityLock(AvoidanceManager, AvoidanceManager->LockTimeAfterClean);	//10 ms of lock time should be adequate.
+				if (AvoidanceHash)
+				{
+					AvoidanceHash->LockAgentVelocity(AvoidanceHashIndex, Velocity);
+				}
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 				if (bShowDebug)
 				{
@@ -3725,6 +4252,7 @@ void UBaseCharacterMovementComponent::CalcAvoidanceVelocity(float DeltaTime)
 			}
 		}
 		//RickH - We might do better to do this later in our update
+		// Components in the avoidance hash register too, so the ones outside of it keep avoiding them.
 		AvoidanceManager->UpdateRVO(this);
 
 		bWasAvoidanceUpdated = true;
@@ -3748,6 +4276,26 @@ void UBaseCharacterMovementComponent::PostProcessAvoidanceVelocity(FVector& NewV
 	// empty in base class
 }
 
+bool UBaseCharacterMovementComponent::GetAvoidanceAgent(FBaseCharacterAvoidanceAgent& OutAgent) const
+{
+	const UCapsuleComponent* Capsule = CharacterOwner ? CharacterOwner->GetCapsuleComponent() : nullptr;
+	if (!bUseRVOAvoidance || !Capsule || !UpdatedComponent)
+	{
+		return false;
+	}
+
+	OutAgent.Location = GetGravityFeetLocation();
+	OutAgent.bLocked = AvoidanceLockTimer > 0.f;
+	OutAgent.Velocity = OutAgent.bLocked ? AvoidanceLockVelocity : Velocity;
+	OutAgent.GravityDirection = GravityDirection;
+	OutAgent.GravityFieldId = GravityFieldId;
+	Capsule->GetScaledCapsuleSize(OutAgent.Radius, OutAgent.HalfHeight);
+	OutAgent.AvoidanceGroup = AvoidanceGroup.Packed;
+	OutAgent.GroupsToAvoid = GroupsToAvoid.Packed;
+	OutAgent.GroupsToIgnore = GroupsToIgnore.Packed;
+	return true;
+}
+
 void UBaseCharacterMovementComponent::UpdateDefaultAvoidance()
 {
 	if (!bUseRVOAvoidance)
@@ -3755,7 +4303,7 @@ void UBaseCharacterMovementComponent::UpdateDefaultAvoidance()
 		return;
 	}
 
-	// SCOPE_CYCLE_COUNTER(STAT_AI_ObstacleAvoidance);
+	SCOPE_CYCLE_COUNTER(STAT_CharAvoidance);
 
 	UAvoidanceManager* AvoidanceManager = GetWorld()->GetAvoidanceManager();
 	if (AvoidanceManager && !bWasAvoidanceUpdated && GetCharacterOwner()->GetCapsuleComponent())
@@ -3781,12 +4329,12 @@ int32 UBaseCharacterMovementComponent::GetRVOAvoidanceUID()
 
 void UBaseCharacterMovementComponent::SetRVOAvoidanceWeight(float Weight)
 {
-	AvoidanceWeight = Weight;
+	SetMovementSetting(EBaseCharacterMovementSetting::AvoidanceWeight, Weight);
 }
 
 float UBaseCharacterMovementComponent::GetRVOAvoidanceWeight()
 {
-	return AvoidanceWeight;
+	return GetMovementSetting(EBaseCharacterMovementSetting::AvoidanceWeight);
 }
 
 FVector UBaseCharacterMovementComponent::GetRVOAvoidanceOrigin()
@@ -3802,7 +4350,7 @@ float UBaseCharacterMovementComponent::GetRVOAvoidanceRadius()
 
 float UBaseCharacterMovementComponent::GetRVOAvoidanceConsiderationRadius()
 {
-	return AvoidanceConsiderationRadius;
+	return GetMovementSetting(EBaseCharacterMovementSetting::AvoidanceConsiderationRadius);
 }
 
 float UBaseCharacterMovementComponent::GetRVOAvoidanceHeight()
@@ -3902,7 +4450,7 @@ float UBaseCharacterMovementComponent::GetMaxJumpHeightWithJumpTime() const
 
 float UBaseCharacterMovementComponent::GetMaxAcceleration() const
 {
-	return MaxAcceleration;
+	return GetMovementSetting(EBaseCharacterMovementSetting::MaxAcceleration);
 }
 
 float UBaseCharacterMovementComponent::GetMaxBrakingDeceleration() const
@@ -3911,13 +4459,13 @@ float UBaseCharacterMovementComponent::GetMaxBrakingDeceleration() const
 	{
 		case MOVE_Walking:
 		case MOVE_NavWalking:
-			return BrakingDecelerationWalking;
+			return GetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationWalking);
 		case MOVE_Falling:
-			return BrakingDecelerationFalling;
+			return GetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationFalling);
 		case MOVE_Swimming:
-			return BrakingDecelerationSwimming;
+			return GetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationSwimming);
 		case MOVE_Flying:
-			return BrakingDecelerationFlying;
+			return GetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationFlying);
 		case MOVE_Custom:
 			return 0.f;
 		case MOVE_None:
@@ -3938,7 +4486,7 @@ void UBaseCharacterMovementComponent::ApplyVelocityBraking(float DeltaTime, floa
 		return;
 	}
 
-	const float FrictionFactor = FMath::Max(0.f, BrakingFrictionFactor);
+	const float FrictionFactor = FMath::Max(0.f, GetMovementSetting(EBaseCharacterMovementSetting::BrakingFrictionFactor));
 	Friction = FMath::Max(0.f, Friction * FrictionFactor);
 	BrakingDeceleration = FMath::Max(0.f, BrakingDeceleration);
 	const bool bZeroFriction = (Friction == 0.f);
@@ -3954,7 +4502,7 @@ void UBaseCharacterMovementComponent::ApplyVelocityBraking(float DeltaTime, floa
 	// subdivide braking to get reasonably consistent results at lower frame rates
 	// (important for packet loss situations w/ networking)
 	float RemainingTime = DeltaTime;
-	const float MaxTimeStep = FMath::Clamp(BrakingSubStepTime, 1.0f / 75.0f, 1.0f / 20.0f);
+	const float MaxTimeStep = FMath::Clamp(GetMovementSetting(EBaseCharacterMovementSetting::BrakingSubStepTime), 1.0f / 75.0f, 1.0f / 20.0f);
 
 	// Decelerate to brake to a stop
 	const FVector RevAccel = (bZeroBraking ? FVector::ZeroVector : (-BrakingDeceleration * Velocity.GetSafeNormal()));
@@ -4174,6 +4722,8 @@ void UBaseCharacterMovementComponent::PhysSwimming(float deltaTime, int32 Iterat
 	float OriginalAccelZ = Acceleration.Z;
 	bool bLimitedUpAccel = false;
 
+	const float MaxSwimSpeed = GetMovementSetting(EBaseCharacterMovementSetting::MaxSwimSpeed);
+
 	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() && (Velocity.Z > 0.33f * MaxSwimSpeed) && (NetBuoyancy != 0.f))
 	{
 		//damp positive Z out of water
@@ -4421,6 +4971,21 @@ void UBaseCharacterMovementComponent::SetGravityDirection(const FVector& InNewGr
 			WorldToGravityTransform = FQuat::FindBetweenNormals(FVector::UpVector, -NewGravityDir);
 			GravityToWorldTransform = WorldToGravityTransform.Inverse();
 			bHasCustomGravity = !GravityDirection.Equals(DefaultGravityDirection);
+			GravitySpaceMode = EBaseGravitySpace::Default;
+			if (bHasCustomGravity)
+			{
+				// Gravity boxes are mostly rotated in 90 degree steps, use component swaps instead of quaternion rotations for those.
+				GravitySpaceMode = EBaseGravitySpace::Custom;
+				if (BaseCharacterMovementCVars::bUseAxisAlignedGravitySpace && FBaseGravityAxisPermutation::FromRotation(WorldToGravityTransform, GravityToWorldAxes))
+				{
+					// Snap gravity onto the axis, so the quaternion and permutation conversions agree exactly.
+					WorldToGravityAxes = GravityToWorldAxes.Inverse();
+					WorldToGravityTransform = GravityToWorldAxes.ToQuat();
+					GravityToWorldTransform = WorldToGravityTransform.Inverse();
+					GravityDirection = -GravityToWorldAxes.Apply(FVector::UpVector);
+					GravitySpaceMode = EBaseGravitySpace::AxisAligned;
+				}
+			}
 		}
 	}
 }
@@ -4438,8 +5003,11 @@ float UBaseCharacterMovementComponent::BoostAirControl(float DeltaTime, float Ti
 }
 
 
-void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
+template<EBaseGravitySpace Space>
+void UBaseCharacterMovementComponent::PhysFallingImpl(float deltaTime, int32 Iterations)
 {
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
+
 	SCOPE_CYCLE_COUNTER(STAT_CharPhysFalling);
 
 	if (deltaTime < MIN_TICK_TIME)
@@ -4448,8 +5016,8 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 	}
 
 	FVector FallAcceleration = GetFallingLateralAcceleration(deltaTime);
-	const FVector GravityRelativeFallAcceleration = RotateWorldToGravity(FallAcceleration);
-	FallAcceleration = RotateGravityToWorld(FVector(GravityRelativeFallAcceleration.X, GravityRelativeFallAcceleration.Y, 0));
+	const FVector GravityRelativeFallAcceleration = GravitySpace.ToGravity(FallAcceleration);
+	FallAcceleration = GravitySpace.ToWorld(FVector(GravityRelativeFallAcceleration.X, GravityRelativeFallAcceleration.Y, 0));
 	const bool bHasLimitedAirControl = ShouldLimitAirControl(deltaTime, FallAcceleration);
 
 	float remainingTime = deltaTime;
@@ -4479,7 +5047,7 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 				TGuardValue<FVector> RestoreAcceleration(Acceleration, FallAcceleration);
 				if (HasCustomGravity())
 				{
-					Velocity = FVector::VectorPlaneProject(Velocity, RotateGravityToWorld(FVector::UpVector));
+					Velocity = FVector::VectorPlaneProject(Velocity, GravitySpace.GetUpVector());
 					const FVector GravityRelativeOffset = OldVelocity - Velocity;
 					CalcVelocity(timeTick, FallingLateralFriction, false, MaxDecel);
 					Velocity += GravityRelativeOffset;
@@ -4522,11 +5090,11 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 		DecayFormerBaseVelocity(timeTick);
 
 		// See if we need to sub-step to exactly reach the apex. This is important for avoiding "cutting off the top" of the trajectory as framerate varies.
-		const FVector GravityRelativeOldVelocityWithRootMotion = RotateWorldToGravity(OldVelocityWithRootMotion);
-		if (BaseCharacterMovementCVars::ForceJumpPeakSubstep && GravityRelativeOldVelocityWithRootMotion.Z > 0.f && RotateWorldToGravity(Velocity).Z <= 0.f && NumJumpApexAttempts < MaxJumpApexAttemptsPerSimulation)
+		const FVector GravityRelativeOldVelocityWithRootMotion = GravitySpace.ToGravity(OldVelocityWithRootMotion);
+		if (BaseCharacterMovementCVars::ForceJumpPeakSubstep && GravityRelativeOldVelocityWithRootMotion.Z > 0.f && GravitySpace.GetUp(Velocity) <= 0.f && NumJumpApexAttempts < MaxJumpApexAttemptsPerSimulation)
 		{
 			const FVector DerivedAccel = (Velocity - OldVelocityWithRootMotion) / timeTick;
-			const FVector GravityRelativeDerivedAccel = RotateWorldToGravity(DerivedAccel);
+			const FVector GravityRelativeDerivedAccel = GravitySpace.ToGravity(DerivedAccel);
 			if (!FMath::IsNearlyZero(GravityRelativeDerivedAccel.Z))
 			{
 				const float TimeToApex = -GravityRelativeOldVelocityWithRootMotion.Z / GravityRelativeDerivedAccel.Z;
@@ -4538,8 +5106,8 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 					const FVector ApexVelocity = OldVelocityWithRootMotion + (DerivedAccel * TimeToApex);
 					if (HasCustomGravity())
 					{
-						const FVector GravityRelativeApexVelocity = RotateWorldToGravity(ApexVelocity);
-						Velocity = RotateGravityToWorld(FVector(GravityRelativeApexVelocity.X, GravityRelativeApexVelocity.Y, 0)); // Should be nearly zero anyway, but this makes apex notifications consistent.
+						const FVector GravityRelativeApexVelocity = GravitySpace.ToGravity(ApexVelocity);
+						Velocity = GravitySpace.ToWorld(FVector(GravityRelativeApexVelocity.X, GravityRelativeApexVelocity.Y, 0)); // Should be nearly zero anyway, but this makes apex notifications consistent.
 					}
 					else
 					{
@@ -4556,8 +5124,9 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 					NumJumpApexAttempts++;
 
 					// Refund time to any active Root Motion Sources as well
-					for (TSharedPtr<FBaseRootMotionSource> RootMotionSource : CurrentRootMotion.RootMotionSources)
+					for (TSharedPtr<FBaseRootMotionSource>& RootMotionSource : CurrentRootMotion.RootMotionSources)
 					{
+						FBaseRootMotionSourceGroup::MakeSourceUnique(RootMotionSource);
 						const float RewoundRMSTime = FMath::Max(0.0f, RootMotionSource->GetTime() - TimeToRefund);
 						RootMotionSource->SetTime(RewoundRMSTime);
 					}
@@ -4565,7 +5134,7 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 			}
 		}
 
-		if (bNotifyApex && (RotateWorldToGravity(Velocity).Z < 0.f))
+		if (bNotifyApex && (GravitySpace.GetUp(Velocity) < 0.f))
 		{
 			// Just passed jump apex since now going down
 			bNotifyApex = false;
@@ -4651,7 +5220,7 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 						TGuardValue<FVector> RestoreVelocity(Velocity, OldVelocity);
 						if (HasCustomGravity())
 						{
-							Velocity = FVector::VectorPlaneProject(Velocity, RotateGravityToWorld(FVector::UpVector));
+							Velocity = FVector::VectorPlaneProject(Velocity, GravitySpace.GetUpVector());
 							const FVector GravityRelativeOffset = OldVelocity - Velocity;
 							CalcVelocity(timeTick, FallingLateralFriction, false, MaxDecel);
 							VelocityNoAirControl = Velocity + GravityRelativeOffset;
@@ -4717,7 +5286,7 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 						}
 
 						// Act as if there was no air control on the last move when computing new deflection.
-						if (bHasLimitedAirControl && RotateWorldToGravity(Hit.Normal).Z > CharacterMovementConstants::VERTICAL_SLOPE_NORMAL_Z)
+						if (bHasLimitedAirControl && GravitySpace.GetUp(Hit.Normal) > CharacterMovementConstants::VERTICAL_SLOPE_NORMAL_Z)
 						{
 							const FVector LastMoveNoAirControl = VelocityNoAirControl * LastMoveTimeSlice;
 							Delta = ComputeSlideVector(LastMoveNoAirControl, 1.f, OldHitNormal, Hit);
@@ -4747,7 +5316,7 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 						}
 
 						// bDitch=true means that pawn is straddling two slopes, neither of which it can stand on
-						bool bDitch = ( (RotateWorldToGravity(OldHitImpactNormal).Z > 0.f) && (RotateWorldToGravity(Hit.ImpactNormal).Z > 0.f) && (FMath::Abs(Delta.Z) <= UE_KINDA_SMALL_NUMBER) && ((Hit.ImpactNormal | OldHitImpactNormal) < 0.f) );
+						bool bDitch = ( (GravitySpace.GetUp(OldHitImpactNormal) > 0.f) && (GravitySpace.GetUp(Hit.ImpactNormal) > 0.f) && (FMath::Abs(Delta.Z) <= UE_KINDA_SMALL_NUMBER) && ((Hit.ImpactNormal | OldHitImpactNormal) < 0.f) );
 						SafeMoveUpdatedComponent( Delta, PawnRotation, true, Hit);
 						if ( Hit.Time == 0.f )
 						{
@@ -4766,19 +5335,19 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 							ProcessLanded(Hit, remainingTime, Iterations);
 							return;
 						}
-						else if (GetPerchRadiusThreshold() > 0.f && Hit.Time == 1.f && RotateWorldToGravity(OldHitImpactNormal).Z >= WalkableFloorZ)
+						else if (GetPerchRadiusThreshold() > 0.f && Hit.Time == 1.f && GravitySpace.GetUp(OldHitImpactNormal) >= WalkableFloorZ)
 						{
 							// We might be in a virtual 'ditch' within our perch radius. This is rare.
 							const FVector PawnLocation = UpdatedComponent->GetComponentLocation();
-							const float ZMovedDist = FMath::Abs(RotateWorldToGravity(PawnLocation - OldLocation).Z);
-							const float MovedDist2DSq = FVector::VectorPlaneProject(PawnLocation - OldLocation, RotateGravityToWorld(FVector::UpVector)).Size2D();
+							const float ZMovedDist = FMath::Abs(GravitySpace.GetUp(PawnLocation - OldLocation));
+							const float MovedDist2DSq = FVector::VectorPlaneProject(PawnLocation - OldLocation, GravitySpace.GetUpVector()).Size2D();
 							if (ZMovedDist <= 0.2f * timeTick && MovedDist2DSq <= 4.f * timeTick)
 							{
-								FVector GravityRelativeVelocity = RotateWorldToGravity(Velocity);
+								FVector GravityRelativeVelocity = GravitySpace.ToGravity(Velocity);
 								GravityRelativeVelocity.X += 0.25f * GetMaxSpeed() * (RandomStream.FRand() - 0.5f);
 								GravityRelativeVelocity.Y += 0.25f * GetMaxSpeed() * (RandomStream.FRand() - 0.5f);
 								GravityRelativeVelocity.Z = FMath::Max<float>(JumpZVelocity * 0.25f, 1.f);
-								Velocity = RotateGravityToWorld(GravityRelativeVelocity);
+								Velocity = GravitySpace.ToWorld(GravityRelativeVelocity);
 								Delta = Velocity * timeTick;
 								SafeMoveUpdatedComponent(Delta, PawnRotation, true, Hit);
 							}
@@ -4788,16 +5357,29 @@ void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 			}
 		}
 
-		FVector GravityRelativeVelocity = RotateWorldToGravity(Velocity);
+		FVector GravityRelativeVelocity = GravitySpace.ToGravity(Velocity);
 		if (GravityRelativeVelocity.SizeSquared2D() <= UE_KINDA_SMALL_NUMBER * 10.f)
 		{
 			GravityRelativeVelocity.X = 0.f;
 			GravityRelativeVelocity.Y = 0.f;
-			Velocity = RotateGravityToWorld(GravityRelativeVelocity);
+			Velocity = GravitySpace.ToWorld(GravityRelativeVelocity);
 		}
 	}
 }
 
+void UBaseCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
+{
+	switch (GravitySpaceMode)
+	{
+	case EBaseGravitySpace::AxisAligned:
+		return PhysFallingImpl<EBaseGravitySpace::AxisAligned>(deltaTime, Iterations);
+	case EBaseGravitySpace::Custom:
+		return PhysFallingImpl<EBaseGravitySpace::Custom>(deltaTime, Iterations);
+	default:
+		return PhysFallingImpl<EBaseGravitySpace::Default>(deltaTime, Iterations);
+	}
+}
+
 FVector UBaseCharacterMovementComponent::LimitAirControl(float DeltaTime, const FVector& FallAcceleration, const FHitResult& HitResult, bool bCheckForValidLandingSpot)
 {
 	FVector Result(FallAcceleration);
@@ -4839,7 +5421,7 @@ bool UBaseCharacterMovementComponent::CheckLedgeDirection(const FVector& OldLoca
 	{
 		if ( !Result.bBlockingHit )
 		{
-			GetWorld()->SweepSingleByChannel(Result, SideDest, SideDest + GravDir * (MaxStepHeight + LedgeCheckThreshold), FQuat::Identity, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+			GetWorld()->SweepSingleByChannel(Result, SideDest, SideDest + GravDir * (GetMovementSetting(EBaseCharacterMovementSetting::MaxStepHeight) + LedgeCheckThreshold), FQuat::Identity, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
 		}
 		if ( (Result.Time < 1.f) && IsWalkable(Result) )
 		{
@@ -4967,53 +5549,44 @@ void UBaseCharacterMovementComponent::RevertMove(const FVector& OldLocation, UPr
 }
 
 
-FVector UBaseCharacterMovementComponent::ComputeGroundMovementDelta(const FVector& Delta, const FHitResult& RampHit, const bool bHitFromLineTrace) const
+template<EBaseGravitySpace Space>
+FVector UBaseCharacterMovementComponent::ComputeGroundMovementDeltaImpl(const FVector& Delta, const FHitResult& RampHit, const bool bHitFromLineTrace) const
 {
-	if (!HasCustomGravity())
-	{
-		const FVector FloorNormal = RampHit.ImpactNormal;
-		const FVector ContactNormal = RampHit.Normal;
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
 
-		if (FloorNormal.Z < (1.f - UE_KINDA_SMALL_NUMBER) && FloorNormal.Z > UE_KINDA_SMALL_NUMBER && ContactNormal.Z > UE_KINDA_SMALL_NUMBER && !bHitFromLineTrace && IsWalkable(RampHit))
-		{
-			// Compute a vector that moves parallel to the surface, by projecting the horizontal movement direction onto the ramp.
-			const float FloorDotDelta = (FloorNormal | Delta);
-			FVector RampMovement(Delta.X, Delta.Y, -FloorDotDelta / FloorNormal.Z);
+	const FVector GravityRelativeDelta = GravitySpace.ToGravity(Delta);
+	const FVector GravityRelativeFloorNormal = GravitySpace.ToGravity(RampHit.ImpactNormal);
+	const FVector::FReal ContactNormalZ = GravitySpace.GetUp(RampHit.Normal);
 
-			if (bMaintainHorizontalGroundVelocity)
-			{
-				return RampMovement;
-			}
-			else
-			{
-				return RampMovement.GetSafeNormal() * Delta.Size();
-			}
-		}
-		return Delta;
-	}
-	else
+	if (GravityRelativeFloorNormal.Z < (1.f - UE_KINDA_SMALL_NUMBER) && GravityRelativeFloorNormal.Z > UE_KINDA_SMALL_NUMBER && ContactNormalZ > UE_KINDA_SMALL_NUMBER && !bHitFromLineTrace && IsWalkable(RampHit))
 	{
-		const FVector GravityRelativeDelta = RotateWorldToGravity(Delta);
-		const FVector GravityRelativeFloorNormal = RotateWorldToGravity(RampHit.ImpactNormal);
-		const FVector GravityRelativeContactNormal = RotateWorldToGravity(RampHit.Normal);
+		// Compute a vector that moves parallel to the surface, by projecting the horizontal movement direction onto the ramp.
+		const float FloorDotDelta = (GravityRelativeFloorNormal | GravityRelativeDelta);
+		FVector GravityRelativeRampMovement(GravityRelativeDelta.X, GravityRelativeDelta.Y, -FloorDotDelta / GravityRelativeFloorNormal.Z);
 
-		if (GravityRelativeFloorNormal.Z < (1.f - UE_KINDA_SMALL_NUMBER) && GravityRelativeFloorNormal.Z > UE_KINDA_SMALL_NUMBER && GravityRelativeContactNormal.Z > UE_KINDA_SMALL_NUMBER && !bHitFromLineTrace && IsWalkable(RampHit))
+		if (bMaintainHorizontalGroundVelocity)
 		{
-			// Compute a vector that moves parallel to the surface, by projecting the horizontal movement direction onto the ramp.
-			const float FloorDotDelta = (GravityRelativeFloorNormal | GravityRelativeDelta);
-			FVector GravityRelativeRampMovement(GravityRelativeDelta.X, GravityRelativeDelta.Y, -FloorDotDelta / GravityRelativeFloorNormal.Z);
-
-			if (bMaintainHorizontalGroundVelocity)
-			{
-				return RotateGravityToWorld(GravityRelativeRampMovement);
-			}
-			else
-			{
-				return RotateGravityToWorld(GravityRelativeRampMovement.GetSafeNormal() * GravityRelativeDelta.Size());
-			}
+			return GravitySpace.ToWorld(GravityRelativeRampMovement);
 		}
+		else
+		{
+			return GravitySpace.ToWorld(GravityRelativeRampMovement.GetSafeNormal() * GravityRelativeDelta.Size());
+		}
+	}
 
-		return RotateGravityToWorld(GravityRelativeDelta);
+	return Delta;
+}
+
+FVector UBaseCharacterMovementComponent::ComputeGroundMovementDelta(const FVector& Delta, const FHitResult& RampHit, const bool bHitFromLineTrace) const
+{
+	switch (GravitySpaceMode)
+	{
+	case EBaseGravitySpace::AxisAligned:
+		return ComputeGroundMovementDeltaImpl<EBaseGravitySpace::AxisAligned>(Delta, RampHit, bHitFromLineTrace);
+	case EBaseGravitySpace::Custom:
+		return ComputeGroundMovementDeltaImpl<EBaseGravitySpace::Custom>(Delta, RampHit, bHitFromLineTrace);
+	default:
+		return ComputeGroundMovementDeltaImpl<EBaseGravitySpace::Default>(Delta, RampHit, bHitFromLineTrace);
 	}
 }
 
@@ -5056,15 +5629,18 @@ void UBaseCharacterMovementComponent::OnCharacterStuckInGeometry(const FHitResul
 	bJustTeleported = true;
 }
 
-void UBaseCharacterMovementComponent::MoveAlongFloor(const FVector& InVelocity, float DeltaSeconds, FBaseStepDownResult* OutStepDownResult)
+template<EBaseGravitySpace Space>
+void UBaseCharacterMovementComponent::MoveAlongFloorImpl(const FVector& InVelocity, float DeltaSeconds, FBaseStepDownResult* OutStepDownResult)
 {
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
+
 	if (!CurrentFloor.IsWalkableFloor())
 	{
 		return;
 	}
 
 	// Move along the current floor
-	const FVector Delta = RotateGravityToWorld(RotateWorldToGravity(InVelocity) * FVector(1.0, 1.0, 0.0)) * DeltaSeconds;
+	const FVector Delta = GravitySpace.ToWorld(GravitySpace.ToGravity(InVelocity) * FVector(1.0, 1.0, 0.0)) * DeltaSeconds;
 	FHitResult Hit(1.f);
 	FVector RampVector = ComputeGroundMovementDelta(Delta, CurrentFloor.HitResult, CurrentFloor.bLineTrace);
 	SafeMoveUpdatedComponent(RampVector, UpdatedComponent->GetComponentQuat(), true, Hit);
@@ -5085,7 +5661,7 @@ void UBaseCharacterMovementComponent::MoveAlongFloor(const FVector& InVelocity,
 	{
 		// We impacted something (most likely another ramp, but possibly a barrier).
 		float PercentTimeApplied = Hit.Time;
-		if ((Hit.Time > 0.f) && (Hit.Normal.Z > UE_KINDA_SMALL_NUMBER) && IsWalkable(Hit))
+		if ((Hit.Time > 0.f) && (GravitySpace.GetUp(Hit.Normal) > UE_KINDA_SMALL_NUMBER) && IsWalkable(Hit))
 		{
 			// Another walkable ramp.
 			const float InitialPercentRemaining = 1.f - PercentTimeApplied;
@@ -5103,7 +5679,7 @@ void UBaseCharacterMovementComponent::MoveAlongFloor(const FVector& InVelocity,
 			{
 				// hit a barrier, try to step up
 				const FVector PreStepUpLocation = UpdatedComponent->GetComponentLocation();
-				const FVector GravDir = GetGravityDirection();
+				const FVector GravDir = -GravitySpace.GetUpVector();
 				if (!StepUp(GravDir, Delta * (1.f - PercentTimeApplied), Hit, OutStepDownResult))
 				{
 					UE_LOG(LogBaseCharacterMovement, Verbose, TEXT("- StepUp (ImpactNormal %s, Normal %s"), *Hit.ImpactNormal.ToString(), *Hit.Normal.ToString());
@@ -5121,7 +5697,7 @@ void UBaseCharacterMovementComponent::MoveAlongFloor(const FVector& InVelocity,
 						if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() && StepUpTimeSlice >= UE_KINDA_SMALL_NUMBER)
 						{
 							Velocity = (UpdatedComponent->GetComponentLocation() - PreStepUpLocation) / StepUpTimeSlice;
-							Velocity = FVector::VectorPlaneProject(Velocity, -GravDir);
+							Velocity -= GravitySpace.GetUpVector() * GravitySpace.GetUp(Velocity);
 						}
 					}
 				}
@@ -5135,10 +5711,26 @@ void UBaseCharacterMovementComponent::MoveAlongFloor(const FVector& InVelocity,
 	}
 }
 
+void UBaseCharacterMovementComponent::MoveAlongFloor(const FVector& InVelocity, float DeltaSeconds, FBaseStepDownResult* OutStepDownResult)
+{
+	switch (GravitySpaceMode)
+	{
+	case EBaseGravitySpace::AxisAligned:
+		return MoveAlongFloorImpl<EBaseGravitySpace::AxisAligned>(InVelocity, DeltaSeconds, OutStepDownResult);
+	case EBaseGravitySpace::Custom:
+		return MoveAlongFloorImpl<EBaseGravitySpace::Custom>(InVelocity, DeltaSeconds, OutStepDownResult);
+	default:
+		return MoveAlongFloorImpl<EBaseGravitySpace::Default>(InVelocity, DeltaSeconds, OutStepDownResult);
+	}
+}
 
-void UBaseCharacterMovementComponent::MaintainHorizontalGroundVelocity()
+
+template<EBaseGravitySpace Space>
+void UBaseCharacterMovementComponent::MaintainHorizontalGroundVelocityImpl()
 {
-	FVector GravityRelativeVelocity = RotateWorldToGravity(Velocity);
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
+
+	FVector GravityRelativeVelocity = GravitySpace.ToGravity(Velocity);
 	if (GravityRelativeVelocity.Z != 0.f)
 	{
 		if (bMaintainHorizontalGroundVelocity)
@@ -5153,17 +5745,33 @@ void UBaseCharacterMovementComponent::MaintainHorizontalGroundVelocity()
 		}
 	}
 
-	Velocity = RotateGravityToWorld(GravityRelativeVelocity);
+	Velocity = GravitySpace.ToWorld(GravityRelativeVelocity);
 }
 
-
-void UBaseCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
+void UBaseCharacterMovementComponent::MaintainHorizontalGroundVelocity()
 {
-	SCOPE_CYCLE_COUNTER(STAT_CharPhysWalking);
-
-	if (deltaTime < MIN_TICK_TIME)
+	switch (GravitySpaceMode)
 	{
-		return;
+	case EBaseGravitySpace::AxisAligned:
+		return MaintainHorizontalGroundVelocityImpl<EBaseGravitySpace::AxisAligned>();
+	case EBaseGravitySpace::Custom:
+		return MaintainHorizontalGroundVelocityImpl<EBaseGravitySpace::Custom>();
+	default:
+		return MaintainHorizontalGroundVelocityImpl<EBaseGravitySpace::Default>();
+	}
+}
+
+
+template<EBaseGravitySpace Space>
+void UBaseCharacterMovementComponent::PhysWalkingImpl(float deltaTime, int32 Iterations)
+{
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
+
+	SCOPE_CYCLE_COUNTER(STAT_CharPhysWalking);
+
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
 	}
 
 	if (!CharacterOwner || (!CharacterOwner->Controller && !bRunPhysicsWithNoController && !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() && (CharacterOwner->GetLocalRole() != ROLE_SimulatedProxy)))
@@ -5205,7 +5813,7 @@ void UBaseCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterati
 		// Ensure velocity is horizontal.
 		MaintainHorizontalGroundVelocity();
 		const FVector OldVelocity = Velocity;
-		Acceleration = FVector::VectorPlaneProject(Acceleration, -GravityDirection);
+		Acceleration -= GravitySpace.GetUpVector() * GravitySpace.GetUp(Acceleration);
 
 		// Apply acceleration
 		if( !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() )
@@ -5246,7 +5854,7 @@ void UBaseCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterati
 				const float DesiredDist = Delta.Size();
 				if (DesiredDist > UE_KINDA_SMALL_NUMBER)
 				{
-					const float ActualDist = (UpdatedComponent->GetComponentLocation() - OldLocation).Size2D();
+					const float ActualDist = GravitySpace.ToGravity(UpdatedComponent->GetComponentLocation() - OldLocation).Size2D();
 					remainingTime += timeTick * (1.f - FMath::Min(1.f,ActualDist/DesiredDist));
 				}
 				StartNewPhysics(remainingTime,Iterations);
@@ -5275,7 +5883,7 @@ void UBaseCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterati
 		if ( bCheckLedges && !CurrentFloor.IsWalkableFloor() )
 		{
 			// calculate possible alternate movement
-			const FVector GravDir = GravityDirection;
+			const FVector GravDir = -GravitySpace.GetUpVector();
 			const FVector NewDelta = bTriedLedgeMove ? FVector::ZeroVector : GetLedgeMove(OldLocation, Delta, GravDir);
 			if ( !NewDelta.IsZero() )
 			{
@@ -5331,7 +5939,7 @@ void UBaseCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterati
 				// The floor check failed because it started in penetration
 				// We do not want to try to move downward because the downward sweep failed, rather we'd like to try to pop out of the floor.
 				FHitResult Hit(CurrentFloor.HitResult);
-				Hit.TraceEnd = Hit.TraceStart + RotateGravityToWorld(FVector(0.f, 0.f, MAX_FLOOR_DIST));
+				Hit.TraceEnd = Hit.TraceStart + GravitySpace.GetUpVector() * MAX_FLOOR_DIST;
 				const FVector RequestedAdjustment = GetPenetrationAdjustment(Hit);
 				ResolvePenetration(RequestedAdjustment, Hit, UpdatedComponent->GetComponentQuat());
 				bForceNextFloorCheck = true;
@@ -5380,9 +5988,34 @@ void UBaseCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterati
 	if (IsMovingOnGround())
 	{
 		MaintainHorizontalGroundVelocity();
+
+		// The movement manager prefetches the floor in the same frame, no need for the latent path then.
+		if (ShouldUseAsyncFloorChecks() && !(bRegisteredWithMovementManager && ShouldUseMovementManager()))
+		{
+			RequestAsyncFloorCheck(deltaTime);
+		}
+	}
+}
+
+void UBaseCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
+{
+	switch (GravitySpaceMode)
+	{
+	case EBaseGravitySpace::AxisAligned:
+		return PhysWalkingImpl<EBaseGravitySpace::AxisAligned>(deltaTime, Iterations);
+	case EBaseGravitySpace::Custom:
+		return PhysWalkingImpl<EBaseGravitySpace::Custom>(deltaTime, Iterations);
+	default:
+		return PhysWalkingImpl<EBaseGravitySpace::Default>(deltaTime, Iterations);
 	}
 }
 
+/** Returns Point moved along GravityUp to the gravity relative height of HeightSource. */
+static FVector MoveToGravityHeight(const FVector& Point, const FVector& HeightSource, const FVector& GravityUp)
+{
+	return Point + GravityUp * ((HeightSource - Point) | GravityUp);
+}
+
 void UBaseCharacterMovementComponent::PhysNavWalking(float deltaTime, int32 Iterations)
 {
 	SCOPE_CYCLE_COUNTER(STAT_CharPhysNavWalking);
@@ -5406,7 +6039,7 @@ void UBaseCharacterMovementComponent::PhysNavWalking(float deltaTime, int32 Iter
 	devCode(ensureMsgf(!Velocity.ContainsNaN(), TEXT("PhysNavWalking: Velocity contains NaN before CalcVelocity (%s)\n%s"), *GetPathNameSafe(this), *Velocity.ToString()));
 
 	//bound acceleration
-	Acceleration.Z = 0.f;
+	Acceleration = FVector::VectorPlaneProject(Acceleration, -GravityDirection);
 	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
 	{
 		CalcVelocity(deltaTime, GroundFriction, false, GetMaxBrakingDeceleration());
@@ -5424,26 +6057,33 @@ void UBaseCharacterMovementComponent::PhysNavWalking(float deltaTime, int32 Iter
 
 	Iterations++;
 
-	FVector DesiredMove = Velocity;
-	DesiredMove.Z = 0.f;
+	const FVector GravityUp = -GravityDirection;
+	const FVector DesiredMove = FVector::VectorPlaneProject(Velocity, GravityUp);
 
-	const FVector OldLocation = GetActorFeetLocation();
+	const FVector OldLocation = GetGravityFeetLocation();
 	const FVector DeltaMove = DesiredMove * deltaTime;
 	const bool bDeltaMoveNearlyZero = DeltaMove.IsNearlyZero();
 
 	FVector AdjustedDest = OldLocation + DeltaMove;
 	FNavLocation DestNavLocation;
 
+	// Projections are only reused on the gravity face they were made on.
+	if (CachedNavLocationFieldId != GravityFieldId || !CachedNavLocationGravityDirection.Equals(GravityDirection))
+	{
+		CachedNavLocation = FNavLocation();
+	}
+
 	bool bSameNavLocation = false;
 	if (CachedNavLocation.NodeRef != INVALID_NAVNODEREF)
 	{
 		if (bProjectNavMeshWalking)
 		{
-			const float DistSq2D = (OldLocation - CachedNavLocation.Location).SizeSquared2D();
-			const float DistZ = FMath::Abs(OldLocation.Z - CachedNavLocation.Location.Z);
+			const FVector GravityRelativeOffset = RotateWorldToGravity(OldLocation - CachedNavLocation.Location);
+			const float DistSq2D = GravityRelativeOffset.SizeSquared2D();
+			const float DistZ = FMath::Abs(GravityRelativeOffset.Z);
 
 			const float TotalCapsuleHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() * 2.0f;
-			const float ProjectionScale = (OldLocation.Z > CachedNavLocation.Location.Z) ? NavMeshProjectionHeightScaleUp : NavMeshProjectionHeightScaleDown;
+			const float ProjectionScale = (GravityRelativeOffset.Z > 0.f) ? NavMeshProjectionHeightScaleUp : NavMeshProjectionHeightScaleDown;
 			const float DistZThr = TotalCapsuleHeight * FMath::Max(0.f, ProjectionScale);
 
 			bSameNavLocation = (DistSq2D <= UE_KINDA_SMALL_NUMBER) && (DistZ < DistZThr);
@@ -5475,12 +6115,12 @@ void UBaseCharacterMovementComponent::PhysNavWalking(float deltaTime, int32 Iter
 	{
 		SCOPE_CYCLE_COUNTER(STAT_CharNavProjectPoint);
 
-		// Start the trace from the Z location of the last valid trace.
+		// Start the trace from the gravity relative height of the last valid trace.
 		// Otherwise if we are projecting our location to the underlying geometry and it's far above or below the navmesh,
 		// we'll follow that geometry's plane out of range of valid navigation.
 		if (bSameNavLocation && bProjectNavMeshWalking)
 		{
-			AdjustedDest.Z = CachedNavLocation.Location.Z;
+			AdjustedDest = MoveToGravityHeight(AdjustedDest, CachedNavLocation.Location, GravityUp);
 		}
 
 		// Find the point on the NavMesh
@@ -5492,11 +6132,13 @@ void UBaseCharacterMovementComponent::PhysNavWalking(float deltaTime, int32 Iter
 		}
 
 		CachedNavLocation = DestNavLocation;
+		CachedNavLocationFieldId = GravityFieldId;
+		CachedNavLocationGravityDirection = GravityDirection;
 	}
 
 	if (DestNavLocation.NodeRef != INVALID_NAVNODEREF)
 	{
-		FVector NewLocation(AdjustedDest.X, AdjustedDest.Y, DestNavLocation.Location.Z);
+		FVector NewLocation = MoveToGravityHeight(AdjustedDest, DestNavLocation.Location, GravityUp);
 		if (bProjectNavMeshWalking)
 		{
 			SCOPE_CYCLE_COUNTER(STAT_CharNavProjectLocation);
@@ -5517,7 +6159,7 @@ void UBaseCharacterMovementComponent::PhysNavWalking(float deltaTime, int32 Iter
 		// Update velocity to reflect actual move
 		if (!bJustTeleported && !HasAnimRootMotion() && !CurrentRootMotion.HasVelocity())
 		{
-			Velocity = (GetActorFeetLocation() - OldLocation) / deltaTime;
+			Velocity = (GetGravityFeetLocation() - OldLocation) / deltaTime;
 			MaintainHorizontalGroundVelocity();
 		}
 
@@ -5541,7 +6183,16 @@ bool UBaseCharacterMovementComponent::FindNavFloor(const FVector& TestLocation,
 	const float SearchRadius = AgentProps.AgentRadius * 2.0f;
 	const float SearchHeight = AgentProps.AgentHeight * AgentProps.NavWalkingSearchHeightScale;
 
-	return NavData->ProjectPoint(TestLocation, NavFloorLocation, FVector(SearchRadius, SearchRadius, SearchHeight));
+	FVector SearchExtent(SearchRadius, SearchRadius, SearchHeight);
+	if (HasCustomGravity())
+	{
+		// Nav queries take a world space box, search the bounds of the box aligned with gravity. Exact for axis aligned gravity.
+		SearchExtent = RotateGravityToWorld(FVector(SearchRadius, 0.f, 0.f)).GetAbs()
+			+ RotateGravityToWorld(FVector(0.f, SearchRadius, 0.f)).GetAbs()
+			+ RotateGravityToWorld(FVector(0.f, 0.f, SearchHeight)).GetAbs();
+	}
+
+	return NavData->ProjectPoint(TestLocation, NavFloorLocation, SearchExtent);
 }
 
 FVector UBaseCharacterMovementComponent::ProjectLocationFromNavMesh(float DeltaSeconds, const FVector& CurrentFeetLocation, const FVector& TargetNavLocation, float UpOffset, float DownOffset)
@@ -5556,8 +6207,10 @@ FVector UBaseCharacterMovementComponent::ProjectLocationFromNavMesh(float DeltaS
 		return NewLocation;
 	}
 
-	const FVector TraceStart = FVector(TargetNavLocation.X, TargetNavLocation.Y, TargetNavLocation.Z + UpOffset);
-	const FVector TraceEnd   = FVector(TargetNavLocation.X, TargetNavLocation.Y, TargetNavLocation.Z - DownOffset);
+	// Offsets and heights are along the gravity up axis.
+	const FVector GravityUp = -GravityDirection;
+	const FVector TraceStart = TargetNavLocation + GravityUp * UpOffset;
+	const FVector TraceEnd   = TargetNavLocation - GravityUp * DownOffset;
 
 	// We can skip this trace if we are checking at the same location as the last trace (ie, we haven't moved).
 	const bool bCachedLocationStillValid = (CachedProjectedNavMeshHitResult.bBlockingHit &&
@@ -5603,31 +6256,34 @@ FVector UBaseCharacterMovementComponent::ProjectLocationFromNavMesh(float DeltaS
 	// Project to last plane we found.
 	if (CachedProjectedNavMeshHitResult.bBlockingHit)
 	{
-		if (bCachedLocationStillValid && FMath::IsNearlyEqual(CurrentFeetLocation.Z, CachedProjectedNavMeshHitResult.ImpactPoint.Z, (FVector::FReal)0.01f))
+		const FVector::FReal CurrentFeetZ = CurrentFeetLocation | GravityUp;
+		if (bCachedLocationStillValid && FMath::IsNearlyEqual(CurrentFeetZ, CachedProjectedNavMeshHitResult.ImpactPoint | GravityUp, (FVector::FReal)0.01f))
 		{
 			// Already at destination.
-			NewLocation.Z = CurrentFeetLocation.Z;
+			NewLocation = MoveToGravityHeight(NewLocation, CurrentFeetLocation, GravityUp);
 		}
 		else
 		{
 			//const FVector ProjectedPoint = FMath::LinePlaneIntersection(TraceStart, TraceEnd, CachedProjectedNavMeshHitResult.ImpactPoint, CachedProjectedNavMeshHitResult.Normal);
-			//float ProjectedZ = ProjectedPoint.Z;
+			//float ProjectedZ = ProjectedPoint | GravityUp;
 
-			// Optimized assuming we only care about Z coordinate of result.
+			// Optimized assuming we only care about the gravity relative height of result.
 			const FVector& PlaneOrigin = CachedProjectedNavMeshHitResult.ImpactPoint;
 			const FVector& PlaneNormal = CachedProjectedNavMeshHitResult.Normal;
-			FVector::FReal ProjectedZ = TraceStart.Z + ZOffset * (((PlaneOrigin - TraceStart)|PlaneNormal) / (ZOffset * PlaneNormal.Z));
+			const FVector::FReal TraceStartZ = TraceStart | GravityUp;
+			const FVector::FReal TraceEndZ = TraceEnd | GravityUp;
+			FVector::FReal ProjectedZ = TraceStartZ + ZOffset * (((PlaneOrigin - TraceStart)|PlaneNormal) / (ZOffset * (PlaneNormal | GravityUp)));
 
 			// Limit to not be too far above or below NavMesh location
-			ProjectedZ = FMath::Clamp(ProjectedZ, TraceEnd.Z, TraceStart.Z);
+			ProjectedZ = FMath::Clamp(ProjectedZ, TraceEndZ, TraceStartZ);
 
 			// Interp for smoother updates (less "pop" when trace hits something new). 0 interp speed is instant.
 			const FVector::FReal InterpSpeed = FMath::Max<FVector::FReal>(0.f, NavMeshProjectionInterpSpeed);
-			ProjectedZ = FMath::FInterpTo(CurrentFeetLocation.Z, ProjectedZ, (FVector::FReal)DeltaSeconds, InterpSpeed);
-			ProjectedZ = FMath::Clamp(ProjectedZ, TraceEnd.Z, TraceStart.Z);
+			ProjectedZ = FMath::FInterpTo(CurrentFeetZ, ProjectedZ, (FVector::FReal)DeltaSeconds, InterpSpeed);
+			ProjectedZ = FMath::Clamp(ProjectedZ, TraceEndZ, TraceStartZ);
 
 			// Final result
-			NewLocation.Z = ProjectedZ;
+			NewLocation += GravityUp * (ProjectedZ - (NewLocation | GravityUp));
 		}
 	}
 
@@ -5709,6 +6365,16 @@ const INavigationDataInterface* UBaseCharacterMovementComponent::GetNavData() co
 	return NavData;
 }
 
+FVector UBaseCharacterMovementComponent::GetGravityFeetLocation() const
+{
+	if (!HasCustomGravity() || !UpdatedComponent || !CharacterOwner || CharacterOwner->GetCapsuleComponent() != UpdatedComponent)
+	{
+		return GetActorFeetLocation();
+	}
+
+	return UpdatedComponent->GetComponentLocation() + GravityDirection * CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+}
+
 bool UBaseCharacterMovementComponent::ShouldCatchAir(const FBaseFindFloorResult& OldFloor, const FBaseFindFloorResult& NewFloor)
 {
 	return false;
@@ -5816,7 +6482,7 @@ void UBaseCharacterMovementComponent::ProcessLanded(const FHitResult& Hit, float
 			// otherwise movement will be stuck in infinite loop:
 			// navwalking -> (no navmesh) -> falling -> (standing on something) -> navwalking -> ....
 
-			const FVector TestLocation = GetActorFeetLocation();
+			const FVector TestLocation = GetGravityFeetLocation();
 			FNavLocation NavLocation;
 
 			const bool bHasNavigationData = FindNavFloor(TestLocation, NavLocation);
@@ -6458,8 +7124,11 @@ bool UBaseCharacterMovementComponent::IsWithinEdgeTolerance(const FVector& Capsu
 }
 
 
-void UBaseCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FBaseFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult) const
+template<EBaseGravitySpace Space>
+void UBaseCharacterMovementComponent::ComputeFloorDistImpl(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FBaseFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult) const
 {
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
+
 	UE_LOG(LogBaseCharacterMovement, VeryVerbose, TEXT("[Role:%d] ComputeFloorDist: %s at location %s"), (int32)CharacterOwner->GetLocalRole(), *GetNameSafe(CharacterOwner), *CapsuleLocation.ToString());
 	OutFloorResult.Clear();
 
@@ -6470,8 +7139,8 @@ void UBaseCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 	if (DownwardSweepResult != NULL && DownwardSweepResult->IsValidBlockingHit())
 	{
 		// Only if the supplied sweep was vertical and downward.
-		const bool bIsDownward = RotateWorldToGravity(DownwardSweepResult->TraceStart - DownwardSweepResult->TraceEnd).Z > 0;
-		const bool bIsVertical = RotateWorldToGravity(DownwardSweepResult->TraceStart - DownwardSweepResult->TraceEnd).SizeSquared2D() <= UE_KINDA_SMALL_NUMBER;
+		const bool bIsDownward = GravitySpace.GetUp(DownwardSweepResult->TraceStart - DownwardSweepResult->TraceEnd) > 0;
+		const bool bIsVertical = GravitySpace.ToGravity(DownwardSweepResult->TraceStart - DownwardSweepResult->TraceEnd).SizeSquared2D() <= UE_KINDA_SMALL_NUMBER;
 		if (bIsDownward && bIsVertical)
 		{
 			// Reject hits that are barely on the cusp of the radius of the capsule
@@ -6481,7 +7150,7 @@ void UBaseCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 				bSkipSweep = true;
 
 				const bool bIsWalkable = IsWalkable(*DownwardSweepResult);
-				const float FloorDist = RotateWorldToGravity(CapsuleLocation - DownwardSweepResult->Location).Z;
+				const float FloorDist = GravitySpace.GetUp(CapsuleLocation - DownwardSweepResult->Location);
 				OutFloorResult.SetFromSweep(*DownwardSweepResult, FloorDist, bIsWalkable);
 				
 				if (bIsWalkable)
@@ -6518,7 +7187,7 @@ void UBaseCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 		FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(SweepRadius, PawnHalfHeight - ShrinkHeight);
 
 		FHitResult Hit(1.f);
-		bBlockingHit = FloorSweepTest(Hit, CapsuleLocation, CapsuleLocation + RotateGravityToWorld(FVector(0.f,0.f,-TraceDist)), CollisionChannel, CapsuleShape, QueryParams, ResponseParam);
+		bBlockingHit = FloorSweepTest(Hit, CapsuleLocation, CapsuleLocation + GravitySpace.ToWorld(FVector(0.f,0.f,-TraceDist)), CollisionChannel, CapsuleShape, QueryParams, ResponseParam);
 
 		if (bBlockingHit)
 		{
@@ -6536,7 +7205,7 @@ void UBaseCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 					CapsuleShape.Capsule.HalfHeight = FMath::Max(PawnHalfHeight - ShrinkHeight, CapsuleShape.Capsule.Radius);
 					Hit.Reset(1.f, false);
 
-					bBlockingHit = FloorSweepTest(Hit, CapsuleLocation, CapsuleLocation + RotateGravityToWorld(FVector(0.f,0.f,-TraceDist)), CollisionChannel, CapsuleShape, QueryParams, ResponseParam);
+					bBlockingHit = FloorSweepTest(Hit, CapsuleLocation, CapsuleLocation + GravitySpace.ToWorld(FVector(0.f,0.f,-TraceDist)), CollisionChannel, CapsuleShape, QueryParams, ResponseParam);
 				}
 			}
 
@@ -6572,7 +7241,7 @@ void UBaseCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 		const float ShrinkHeight = PawnHalfHeight;
 		const FVector LineTraceStart = CapsuleLocation;	
 		const float TraceDist = LineDistance + ShrinkHeight;
-		const FVector Down = RotateGravityToWorld(FVector(0.f, 0.f, -TraceDist));
+		const FVector Down = GravitySpace.ToWorld(FVector(0.f, 0.f, -TraceDist));
 		QueryParams.TraceTag = SCENE_QUERY_STAT_NAME_ONLY(FloorLineTrace);
 
 		FHitResult Hit(1.f);
@@ -6601,6 +7270,21 @@ void UBaseCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 	OutFloorResult.bWalkableFloor = false;
 }
 
+void UBaseCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FBaseFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult) const
+{
+	++MovementCounters.FloorProbes;
+
+	switch (GravitySpaceMode)
+	{
+	case EBaseGravitySpace::AxisAligned:
+		return ComputeFloorDistImpl<EBaseGravitySpace::AxisAligned>(CapsuleLocation, LineDistance, SweepDistance, OutFloorResult, SweepRadius, DownwardSweepResult);
+	case EBaseGravitySpace::Custom:
+		return ComputeFloorDistImpl<EBaseGravitySpace::Custom>(CapsuleLocation, LineDistance, SweepDistance, OutFloorResult, SweepRadius, DownwardSweepResult);
+	default:
+		return ComputeFloorDistImpl<EBaseGravitySpace::Default>(CapsuleLocation, LineDistance, SweepDistance, OutFloorResult, SweepRadius, DownwardSweepResult);
+	}
+}
+
 
 void UBaseCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FBaseFindFloorResult& OutFloorResult, bool bCanUseCachedLocation, const FHitResult* DownwardSweepResult) const
 {
@@ -6619,7 +7303,7 @@ void UBaseCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation,
 	// Increase height check slightly if walking, to prevent floor height adjustment from later invalidating the floor result.
 	const float HeightCheckAdjust = (IsMovingOnGround() ? MAX_FLOOR_DIST + UE_KINDA_SMALL_NUMBER : -MAX_FLOOR_DIST);
 
-	float FloorSweepTraceDist = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + HeightCheckAdjust);
+	float FloorSweepTraceDist = FMath::Max(MAX_FLOOR_DIST, GetMovementSetting(EBaseCharacterMovementSetting::MaxStepHeight) + HeightCheckAdjust);
 	float FloorLineTraceDist = FloorSweepTraceDist;
 	bool bNeedToValidateFloor = true;
 	
@@ -6628,6 +7312,19 @@ void UBaseCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation,
 	{
 		UBaseCharacterMovementComponent* MutableThis = const_cast<UBaseCharacterMovementComponent*>(this);
 
+		// Standing still, gravity and base unchanged since the last check.
+		if (DownwardSweepResult == nullptr && TryReuseFloorCache(CapsuleLocation, HeightCheckAdjust, OutFloorResult))
+		{
+			return;
+		}
+
+		// Use a sweep issued ahead of time if it was predicted close to where we are, ComputeFloorDist() then skips its own sweep.
+		FHitResult ProbeFloorHit;
+		if (DownwardSweepResult == nullptr && ConsumeFloorProbe(CapsuleLocation, ProbeFloorHit))
+		{
+			DownwardSweepResult = &ProbeFloorHit;
+		}
+
 		if ( bAlwaysCheckFloor || !bCanUseCachedLocation || bForceNextFloorCheck || bJustTeleported )
 		{
 			MutableThis->bForceNextFloorCheck = false;
@@ -6670,7 +7367,7 @@ void UBaseCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation,
 		const bool bCheckRadius = true;
 		if (ShouldComputePerchResult(OutFloorResult.HitResult, bCheckRadius))
 		{
-			float MaxPerchFloorDist = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + HeightCheckAdjust);
+			float MaxPerchFloorDist = FMath::Max(MAX_FLOOR_DIST, GetMovementSetting(EBaseCharacterMovementSetting::MaxStepHeight) + HeightCheckAdjust);
 			if (IsMovingOnGround())
 			{
 				MaxPerchFloorDist += FMath::Max(0.f, PerchAdditionalHeight);
@@ -6701,6 +7398,309 @@ void UBaseCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation,
 			}
 		}
 	}
+
+	if (bNeedToValidateFloor)
+	{
+		UpdateFloorCache(CapsuleLocation, HeightCheckAdjust, OutFloorResult);
+	}
+}
+
+
+bool UBaseCharacterMovementComponent::IsSimulatedOrAIControlled() const
+{
+	// Players stay synchronous, both on their own client and on the server.
+	return CharacterOwner && (CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy || !CharacterOwner->IsPlayerControlled());
+}
+
+
+bool UBaseCharacterMovementComponent::ShouldUseAsyncFloorChecks() const
+{
+	if (!bUseAsyncFloorChecks || !BaseCharacterMovementCVars::bEnableAsyncFloorChecks || bUseFlatBaseForFloorChecks)
+	{
+		return false;
+	}
+
+	return IsSimulatedOrAIControlled();
+}
+
+
+bool UBaseCharacterMovementComponent::ShouldUseMovementManager() const
+{
+	// Reduced detail proxies don't sweep for the floor.
+	return bUseMovementManager && !bUseFlatBaseForFloorChecks && IsSimulatedOrAIControlled() && SimulatedProxyLOD == EBaseSimulatedProxyLOD::Full;
+}
+
+
+bool UBaseCharacterMovementComponent::ShouldUseSimulatedProxyLOD() const
+{
+	return bUseSimulatedProxyLOD && bRegisteredWithMovementManager && CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy;
+}
+
+
+void UBaseCharacterMovementComponent::SetSimulatedProxyLOD(EBaseSimulatedProxyLOD InLOD)
+{
+	if (SimulatedProxyLOD == InLOD)
+	{
+		return;
+	}
+
+	const EBaseSimulatedProxyLOD PreviousLOD = SimulatedProxyLOD;
+	SimulatedProxyLOD = InLOD;
+	SimulatedProxyLODSmoothingTime = 0.f;
+
+	// Reduced detail updates skip floor checks, don't trust the floor found before.
+	if (PreviousLOD != EBaseSimulatedProxyLOD::Full && InLOD == EBaseSimulatedProxyLOD::Full)
+	{
+		bForceNextFloorCheck = true;
+		InvalidateFloorCache();
+	}
+}
+
+
+bool UBaseCharacterMovementComponent::ShouldBatchServerMoves() const
+{
+	return bBatchServerMoves && BaseCharacterMovementCVars::bBatchServerMoves && bRegisteredWithMovementManager
+		&& CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_Authority && CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy;
+}
+
+
+bool UBaseCharacterMovementComponent::GetFloorProbeSweep(float DeltaTime, FVector& OutStart, FVector& OutEnd, FCollisionShape& OutShape, FCollisionQueryParams& OutQueryParams, FCollisionResponseParams& OutResponseParam) const
+{
+	if (!HasValidData() || !UpdatedComponent->IsQueryCollisionEnabled())
+	{
+		return false;
+	}
+
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+
+	// Same distance as the walking FindFloor(), starting where the current velocity takes us next update.
+	const float TraceDist = FMath::Max(MAX_FLOOR_DIST, GetMovementSetting(EBaseCharacterMovementSetting::MaxStepHeight) + MAX_FLOOR_DIST + UE_KINDA_SMALL_NUMBER);
+	OutStart = UpdatedComponent->GetComponentLocation() + FVector::VectorPlaneProject(Velocity, GravityDirection) * DeltaTime;
+	OutEnd = OutStart + GravityDirection * TraceDist;
+	OutShape = FCollisionShape::MakeCapsule(PawnRadius, PawnHalfHeight);
+
+	OutQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(FloorProbe), false, CharacterOwner);
+	InitCollisionParams(OutQueryParams, OutResponseParam);
+	return true;
+}
+
+
+void UBaseCharacterMovementComponent::RequestAsyncFloorCheck(float DeltaTime)
+{
+	AsyncFloorTraceHandle = FTraceHandle();
+
+	UWorld* World = GetWorld();
+	FVector Start, End;
+	FCollisionShape Shape;
+	FCollisionQueryParams QueryParams;
+	FCollisionResponseParams ResponseParam;
+	if (World && GetFloorProbeSweep(DeltaTime, Start, End, Shape, QueryParams, ResponseParam))
+	{
+		AsyncFloorTraceHandle = World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, GetWorldToGravityTransform(), UpdatedComponent->GetCollisionObjectType(), Shape, QueryParams, ResponseParam);
+		AsyncFloorTraceGravityDirection = GravityDirection;
+	}
+}
+
+
+bool UBaseCharacterMovementComponent::GetFloorProbeRequest(float DeltaTime, FBaseFloorProbeRequest& OutRequest)
+{
+	PrefetchedFloorProbe.Invalidate();
+
+	if (!IsMovingOnGround() || !GetFloorProbeSweep(DeltaTime, OutRequest.Start, OutRequest.End, OutRequest.Shape, OutRequest.QueryParams, OutRequest.ResponseParams))
+	{
+		return false;
+	}
+
+	OutRequest.Rotation = GetWorldToGravityTransform();
+	OutRequest.GravityDirection = GravityDirection;
+	OutRequest.CollisionChannel = UpdatedComponent->GetCollisionObjectType();
+	OutRequest.bHit = false;
+	return true;
+}
+
+
+void UBaseCharacterMovementComponent::SetPrefetchedFloorProbe(const FBaseFloorProbeRequest& Request)
+{
+	++MovementCounters.FloorProbes;
+	PrefetchedFloorProbe.Start = Request.Start;
+	PrefetchedFloorProbe.GravityDirection = Request.GravityDirection;
+	PrefetchedFloorProbe.Hit = Request.Hit;
+	PrefetchedFloorProbe.bValid = Request.bHit;
+}
+
+
+bool UBaseCharacterMovementComponent::AdoptFloorProbe(const FVector& CapsuleLocation, const FVector& ProbeStart, const FVector& ProbeGravityDirection, const FHitResult& ProbeHit, FHitResult& OutHit) const
+{
+	// Penetrating sweeps have no usable floor distance, ComputeFloorDist() must resolve them with its own sweeps.
+	if (!GravityDirection.Equals(ProbeGravityDirection) || !ProbeHit.IsValidBlockingHit() || ProbeHit.bStartPenetrating || !IsValid(ProbeHit.GetComponent()))
+	{
+		return false;
+	}
+
+	// The hit is only moved sideways, so the capsule must be at the height the sweep started from, or barely below it.
+	// Above it, after walking up a slope or a step, the floor distance would be measured from the wrong height.
+	const FVector ProbeOffset = CapsuleLocation - ProbeStart;
+	const float OffsetDown = ProbeOffset | GravityDirection;
+	if (OffsetDown < 0.f || OffsetDown > BaseCharacterMovementCVars::AsyncFloorCheckHeightTolerance)
+	{
+		return false;
+	}
+
+	const FVector PlanarOffset = FVector::VectorPlaneProject(ProbeOffset, GravityDirection);
+	if (PlanarOffset.SizeSquared() > FMath::Square(BaseCharacterMovementCVars::AsyncFloorCheckTolerance))
+	{
+		return false;
+	}
+
+	OutHit = ProbeHit;
+	OutHit.TraceStart += PlanarOffset;
+	OutHit.TraceEnd += PlanarOffset;
+	OutHit.Location += PlanarOffset;
+	OutHit.ImpactPoint += PlanarOffset;
+	return true;
+}
+
+
+bool UBaseCharacterMovementComponent::ConsumeFloorProbe(const FVector& CapsuleLocation, FHitResult& OutHit) const
+{
+	UBaseCharacterMovementComponent* MutableThis = const_cast<UBaseCharacterMovementComponent*>(this);
+
+	// Prefetched this frame by the movement manager.
+	if (PrefetchedFloorProbe.bValid)
+	{
+		MutableThis->PrefetchedFloorProbe.Invalidate();
+		if (AdoptFloorProbe(CapsuleLocation, PrefetchedFloorProbe.Start, PrefetchedFloorProbe.GravityDirection, PrefetchedFloorProbe.Hit, OutHit))
+		{
+			return true;
+		}
+	}
+
+	// Issued asynchronously last frame.
+	if (AsyncFloorTraceHandle.IsValid())
+	{
+		const FTraceHandle Handle = AsyncFloorTraceHandle;
+		MutableThis->AsyncFloorTraceHandle = FTraceHandle();
+
+		FTraceDatum Datum;
+		if (GetWorld()->QueryTraceData(Handle, Datum) && Datum.OutHits.Num() > 0)
+		{
+			return AdoptFloorProbe(CapsuleLocation, Datum.Start, AsyncFloorTraceGravityDirection, Datum.OutHits[0], OutHit);
+		}
+	}
+
+	return false;
+}
+
+
+bool UBaseCharacterMovementComponent::TryReuseFloorCache(const FVector& CapsuleLocation, float HeightCheckAdjust, FBaseFindFloorResult& OutFloorResult) const
+{
+	// Forced checks and teleports must query. So must bAlwaysCheckFloor, which may be set for other objects moving up into the character.
+	if (!BaseCharacterMovementCVars::bUseFloorCache || bForceNextFloorCheck || bJustTeleported || (bAlwaysCheckFloor && !bFloorCacheIgnoresAlwaysCheckFloor))
+	{
+		return false;
+	}
+
+	auto Miss = [this]()
+	{
+		INC_DWORD_STAT(STAT_CharFloorCacheMisses);
+		CSV_CUSTOM_STAT(BaseCharacterMovement, FloorCacheMisses, 1, ECsvCustomStatOp::Accumulate);
+		const_cast<UBaseCharacterMovementComponent*>(this)->FloorCache.Invalidate();
+		return false;
+	};
+
+	if (!FloorCache.bValid)
+	{
+		return Miss();
+	}
+
+	// Capsule and gravity.
+	const float Tolerance = FMath::Max(0.f, BaseCharacterMovementCVars::FloorCacheTolerance);
+	const FVector Drift = CapsuleLocation - FloorCache.CapsuleLocation;
+	if (Drift.SizeSquared() > FMath::Square(Tolerance)
+		|| HeightCheckAdjust != FloorCache.HeightCheckAdjust
+		|| !GravityDirection.Equals(FloorCache.GravityDirection, UE_KINDA_SMALL_NUMBER)
+		|| !UpdatedComponent->GetComponentQuat().Equals(FloorCache.CapsuleRotation, UE_KINDA_SMALL_NUMBER))
+	{
+		return Miss();
+	}
+
+	float CapsuleRadius, CapsuleHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(CapsuleRadius, CapsuleHalfHeight);
+	if (CapsuleRadius != FloorCache.CapsuleRadius || CapsuleHalfHeight != FloorCache.CapsuleHalfHeight)
+	{
+		return Miss();
+	}
+
+	// Movement base, which must not have moved since.
+	UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+	const FName BaseBoneName = CharacterOwner->GetBasedMovement().BoneName;
+	if (MovementBase != FloorCache.MovementBase.Get() || BaseBoneName != FloorCache.BaseBoneName)
+	{
+		return Miss();
+	}
+
+	if (MovementBase)
+	{
+		FVector BaseLocation;
+		FQuat BaseRotation;
+		if (!MovementBaseUtility::GetMovementBaseTransform(MovementBase, BaseBoneName, BaseLocation, BaseRotation)
+			|| !BaseLocation.Equals(FloorCache.BaseLocation, Tolerance)
+			|| !BaseRotation.Equals(FloorCache.BaseRotation, UE_KINDA_SMALL_NUMBER))
+		{
+			return Miss();
+		}
+	}
+
+	// The floor itself must still be there and block us. Only the base is tracked, other movable floors are queried every time.
+	const UPrimitiveComponent* FloorComponent = FloorCache.FloorResult.HitResult.GetComponent();
+	const AActor* FloorActor = FloorComponent ? FloorComponent->GetOwner() : nullptr;
+	if (!IsValid(FloorComponent) || (FloorActor && !IsValid(FloorActor))
+		|| (FloorComponent->Mobility == EComponentMobility::Movable && FloorComponent != MovementBase)
+		|| !FloorComponent->IsQueryCollisionEnabled()
+		|| FloorComponent->GetCollisionResponseToChannel(UpdatedComponent->GetCollisionObjectType()) != ECR_Block)
+	{
+		return Miss();
+	}
+
+	OutFloorResult = FloorCache.FloorResult;
+
+	// Account for the drift along gravity, the floor is still where it was.
+	const float DriftUp = Drift | -GravityDirection;
+	OutFloorResult.FloorDist += DriftUp;
+	if (OutFloorResult.bLineTrace)
+	{
+		OutFloorResult.LineDist += DriftUp;
+	}
+
+	INC_DWORD_STAT(STAT_CharFloorCacheHits);
+	CSV_CUSTOM_STAT(BaseCharacterMovement, FloorCacheHits, 1, ECsvCustomStatOp::Accumulate);
+	return true;
+}
+
+
+void UBaseCharacterMovementComponent::UpdateFloorCache(const FVector& CapsuleLocation, float HeightCheckAdjust, const FBaseFindFloorResult& FloorResult) const
+{
+	FBaseFloorCache& MutableCache = const_cast<UBaseCharacterMovementComponent*>(this)->FloorCache;
+
+	// Nothing worth keeping if there is no floor, something could have moved under us by next frame.
+	if (!BaseCharacterMovementCVars::bUseFloorCache || !FloorResult.bBlockingHit)
+	{
+		MutableCache.Invalidate();
+		return;
+	}
+
+	MutableCache.FloorResult = FloorResult;
+	MutableCache.CapsuleLocation = CapsuleLocation;
+	MutableCache.CapsuleRotation = UpdatedComponent->GetComponentQuat();
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(MutableCache.CapsuleRadius, MutableCache.CapsuleHalfHeight);
+	MutableCache.HeightCheckAdjust = HeightCheckAdjust;
+	MutableCache.GravityDirection = GravityDirection;
+
+	UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+	MutableCache.MovementBase = MovementBase;
+	MutableCache.BaseBoneName = CharacterOwner->GetBasedMovement().BoneName;
+	MutableCache.bValid = !MovementBase || MovementBaseUtility::GetMovementBaseTransform(MovementBase, MutableCache.BaseBoneName, MutableCache.BaseLocation, MutableCache.BaseRotation);
 }
 
 
@@ -6954,22 +7954,30 @@ bool UBaseCharacterMovementComponent::CanStepUp(const FHitResult& Hit) const
 }
 
 
-bool UBaseCharacterMovementComponent::StepUp(const FVector& GravDir, const FVector& Delta, const FHitResult &InHit, FBaseStepDownResult* OutStepDownResult)
+template<EBaseGravitySpace Space>
+bool UBaseCharacterMovementComponent::StepUpImpl(const FVector& GravDir, const FVector& Delta, const FHitResult &InHit, FBaseStepDownResult* OutStepDownResult)
 {
+	const TBaseGravitySpace<Space> GravitySpace = MakeGravitySpace<Space>();
+
 	SCOPE_CYCLE_COUNTER(STAT_CharStepUp);
 
+	const float MaxStepHeight = GetMovementSetting(EBaseCharacterMovementSetting::MaxStepHeight);
 	if (!CanStepUp(InHit) || MaxStepHeight <= 0.f)
 	{
 		return false;
 	}
 
+	++MovementCounters.StepUps;
+
 	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
 	float PawnRadius, PawnHalfHeight;
 	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
 
 	// Don't bother stepping up if top of capsule is hitting something.
-	const float InitialImpactZ = InHit.ImpactPoint.Z;
-	if (InitialImpactZ > OldLocation.Z + (PawnHalfHeight - PawnRadius))
+	// Heights are measured along the gravity up axis.
+	const float OldLocationZ = GravitySpace.GetUp(OldLocation);
+	const float InitialImpactZ = GravitySpace.GetUp(InHit.ImpactPoint);
+	if (InitialImpactZ > OldLocationZ + (PawnHalfHeight - PawnRadius))
 	{
 		return false;
 	}
@@ -6985,7 +7993,7 @@ bool UBaseCharacterMovementComponent::StepUp(const FVector& GravDir, const FVect
 	float StepTravelUpHeight = MaxStepHeight;
 	float StepTravelDownHeight = StepTravelUpHeight;
 	const float StepSideZ = -1.f * FVector::DotProduct(InHit.ImpactNormal, GravDir);
-	float PawnInitialFloorBaseZ = OldLocation.Z - PawnHalfHeight;
+	float PawnInitialFloorBaseZ = OldLocationZ - PawnHalfHeight;
 	float PawnFloorPointZ = PawnInitialFloorBaseZ;
 
 	if (IsMovingOnGround() && CurrentFloor.IsWalkableFloor())
@@ -6999,7 +8007,7 @@ bool UBaseCharacterMovementComponent::StepUp(const FVector& GravDir, const FVect
 		const bool bHitVerticalFace = !IsWithinEdgeTolerance(InHit.Location, InHit.ImpactPoint, PawnRadius);
 		if (!CurrentFloor.bLineTrace && !bHitVerticalFace)
 		{
-			PawnFloorPointZ = CurrentFloor.HitResult.ImpactPoint.Z;
+			PawnFloorPointZ = GravitySpace.GetUp(CurrentFloor.HitResult.ImpactPoint);
 		}
 		else
 		{
@@ -7090,7 +8098,7 @@ bool UBaseCharacterMovementComponent::StepUp(const FVector& GravDir, const FVect
 	if (Hit.IsValidBlockingHit())
 	{	
 		// See if this step sequence would have allowed us to travel higher than our max step height allows.
-		const float DeltaZ = Hit.ImpactPoint.Z - PawnFloorPointZ;
+		const float DeltaZ = GravitySpace.GetUp(Hit.ImpactPoint) - PawnFloorPointZ;
 		if (DeltaZ > MaxStepHeight)
 		{
 			//UE_LOG(LogBaseCharacterMovement, VeryVerbose, TEXT("- Reject StepUp (too high Height %.3f) up from floor base %f to %f"), DeltaZ, PawnInitialFloorBaseZ, NewLocation.Z);
@@ -7112,7 +8120,7 @@ bool UBaseCharacterMovementComponent::StepUp(const FVector& GravDir, const FVect
 
 			// Also reject if we would end up being higher than our starting location by stepping down.
 			// It's fine to step down onto an unwalkable normal below us, we will just slide off. Rejecting those moves would prevent us from being able to walk off the edge.
-			if (Hit.Location.Z > OldLocation.Z)
+			if (GravitySpace.GetUp(Hit.Location) > OldLocationZ)
 			{
 				//UE_LOG(LogBaseCharacterMovement, VeryVerbose, TEXT("- Reject StepUp (unwalkable normal %s above old position)"), *Hit.ImpactNormal.ToString());
 				ScopedStepUpMovement.RevertMove();
@@ -7143,7 +8151,7 @@ bool UBaseCharacterMovementComponent::StepUp(const FVector& GravDir, const FVect
 
 			// Reject unwalkable normals if we end up higher than our initial height.
 			// It's fine to walk down onto an unwalkable surface, don't reject those moves.
-			if (Hit.Location.Z > OldLocation.Z)
+			if (GravitySpace.GetUp(Hit.Location) > OldLocationZ)
 			{
 				// We should reject the floor result if we are trying to step up an actual step where we are not able to perch (this is rare).
 				// In those cases we should instead abort the step up and try to slide along the stair.
@@ -7170,6 +8178,19 @@ bool UBaseCharacterMovementComponent::StepUp(const FVector& GravDir, const FVect
 	return true;
 }
 
+bool UBaseCharacterMovementComponent::StepUp(const FVector& GravDir, const FVector& Delta, const FHitResult &InHit, FBaseStepDownResult* OutStepDownResult)
+{
+	switch (GravitySpaceMode)
+	{
+	case EBaseGravitySpace::AxisAligned:
+		return StepUpImpl<EBaseGravitySpace::AxisAligned>(GravDir, Delta, InHit, OutStepDownResult);
+	case EBaseGravitySpace::Custom:
+		return StepUpImpl<EBaseGravitySpace::Custom>(GravDir, Delta, InHit, OutStepDownResult);
+	default:
+		return StepUpImpl<EBaseGravitySpace::Default>(GravDir, Delta, InHit, OutStepDownResult);
+	}
+}
+
 void UBaseCharacterMovementComponent::HandleImpact(const FHitResult& Impact, float TimeSlice, const FVector& MoveDelta)
 {
 	SCOPE_CYCLE_COUNTER(STAT_CharHandleImpact);
@@ -7567,6 +8588,8 @@ float UBaseCharacterMovementComponent::GetAnalogInputModifier() const
 
 float UBaseCharacterMovementComponent::GetSimulationTimeStep(float RemainingTime, int32 Iterations) const
 {
+	++MovementCounters.Substeps;
+
 	static uint32 s_WarningCount = 0;
 	if (RemainingTime > MaxSimulationTimeStep)
 	{
@@ -7679,8 +8702,10 @@ void UBaseCharacterMovementComponent::SmoothCorrection(const FVector& OldLocatio
 		//////////////////////////////////////////////////////////////////////////
 		// Update smoothing timestamps
 
+		const bool bUseSnapshots = ShouldUseSnapshotInterpolation();
+
 		// If running ahead, pull back slightly. This will cause the next delta to seem slightly longer, and cause us to lerp to it slightly slower.
-		if (ClientData->SmoothingClientTimeStamp > ClientData->SmoothingServerTimeStamp)
+		if (!bUseSnapshots && ClientData->SmoothingClientTimeStamp > ClientData->SmoothingServerTimeStamp)
 		{
 			const double OldClientTimeStamp = ClientData->SmoothingClientTimeStamp;
 			ClientData->SmoothingClientTimeStamp = FMath::LerpStable(ClientData->SmoothingServerTimeStamp, OldClientTimeStamp, 0.5);
@@ -7705,14 +8730,32 @@ void UBaseCharacterMovementComponent::SmoothCorrection(const FVector& OldLocatio
 			OldServerTimeStamp = ClientData->SmoothingServerTimeStamp;
 		}
 
-		// Don't let the client fall too far behind or run ahead of new server time.
-		const double ServerDeltaTime = ClientData->SmoothingServerTimeStamp - OldServerTimeStamp;
-		const double MaxOffset = ClientData->MaxClientSmoothingDeltaTime;
-		const double MinOffset = FMath::Min(double(ClientData->SmoothNetUpdateTime), MaxOffset);
-		
-		// MaxDelta is the farthest behind we're allowed to be after receiving a new server time.
-		const double MaxDelta = FMath::Clamp(ServerDeltaTime * 1.25, MinOffset, MaxOffset);
-		ClientData->SmoothingClientTimeStamp = FMath::Clamp(ClientData->SmoothingClientTimeStamp, ClientData->SmoothingServerTimeStamp - MaxDelta, ClientData->SmoothingServerTimeStamp);
+		if (bUseSnapshots)
+		{
+			// Teleports start over from the new location.
+			if (DistSq > FMath::Square(ClientData->NoSmoothNetUpdateDist))
+			{
+				ClientData->SmoothingSnapshots.Reset();
+				ClientData->SmoothingClientTimeStamp = ClientData->SmoothingServerTimeStamp;
+			}
+
+			// The buffered snapshots cover the time in between updates, only catch up when falling too far behind.
+			// The clock may have run up to SnapshotInterpolationDelay ahead while no updates arrived, it slows down until it is behind again.
+			ClientData->SmoothingClientTimeStamp = FMath::Clamp(ClientData->SmoothingClientTimeStamp, ClientData->SmoothingServerTimeStamp - ClientData->MaxClientSmoothingDeltaTime,
+				ClientData->SmoothingServerTimeStamp + ClientData->SnapshotInterpolationDelay + FMath::Max(0.f, BaseCharacterMovementCVars::NetSnapshotMaxExtrapolationTime));
+			AddSmoothingSnapshot(*ClientData, NewLocation, NewRotation);
+		}
+		else
+		{
+			// Don't let the client fall too far behind or run ahead of new server time.
+			const double ServerDeltaTime = ClientData->SmoothingServerTimeStamp - OldServerTimeStamp;
+			const double MaxOffset = ClientData->MaxClientSmoothingDeltaTime;
+			const double MinOffset = FMath::Min(double(ClientData->SmoothNetUpdateTime), MaxOffset);
+
+			// MaxDelta is the farthest behind we're allowed to be after receiving a new server time.
+			const double MaxDelta = FMath::Clamp(ServerDeltaTime * 1.25, MinOffset, MaxOffset);
+			ClientData->SmoothingClientTimeStamp = FMath::Clamp(ClientData->SmoothingClientTimeStamp, ClientData->SmoothingServerTimeStamp - MaxDelta, ClientData->SmoothingServerTimeStamp);
+		}
 
 		// Compute actual delta between new server timestamp and client simulation.
 		ClientData->LastCorrectionDelta = ClientData->SmoothingServerTimeStamp - ClientData->SmoothingClientTimeStamp;
@@ -7819,7 +8862,11 @@ void UBaseCharacterMovementComponent::SmoothClientPosition_Interpolate(float Del
 	FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
 	if (ClientData)
 	{
-		if (NetworkSmoothingMode == ENetworkSmoothingMode::Linear)
+		if (NetworkSmoothingMode == ENetworkSmoothingMode::Linear && ShouldUseSnapshotInterpolation() && !ClientData->SmoothingSnapshots.IsEmpty())
+		{
+			SmoothClientPosition_InterpolateSnapshots(*ClientData, DeltaSeconds);
+		}
+		else if (NetworkSmoothingMode == ENetworkSmoothingMode::Linear)
 		{
 			const UWorld* MyWorld = GetWorld();
 
@@ -7963,6 +9010,166 @@ void UBaseCharacterMovementComponent::SmoothClientPosition_Interpolate(float Del
 	}
 }
 
+bool UBaseCharacterMovementComponent::ShouldUseSnapshotInterpolation() const
+{
+	return bUseSnapshotInterpolation && BaseCharacterMovementCVars::bNetSnapshotInterpolation && NetworkSmoothingMode == ENetworkSmoothingMode::Linear
+		&& CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy;
+}
+
+void UBaseCharacterMovementComponent::AddSmoothingSnapshot(FNetworkPredictionData_Client_Character& ClientData, const FVector& NewLocation, const FQuat& NewRotation)
+{
+	// Don't interpolate from snapshots older than the client is allowed to lag behind, e.g. after the character stopped replicating for a while.
+	FBaseCharacterSmoothingSnapshotBuffer& Snapshots = ClientData.SmoothingSnapshots;
+	if (!Snapshots.IsEmpty() && Snapshots.Last().ServerTimeStamp < ClientData.SmoothingServerTimeStamp - ClientData.MaxClientSmoothingDeltaTime)
+	{
+		Snapshots.Reset();
+	}
+
+	FBaseCharacterSmoothingSnapshot Snapshot;
+	Snapshot.ServerTimeStamp = ClientData.SmoothingServerTimeStamp;
+	Snapshot.Location = NewLocation;
+	Snapshot.Rotation = NewRotation;
+	Snapshot.GravityDirection = CharacterOwner->GetReplicatedGravityDirection().GetSafeNormal(UE_SMALL_NUMBER, DefaultGravityDirection);
+
+	// Store the transform relative to a base that can move, so the interpolation follows the base.
+	const FBaseBasedMovementInfo& BasedMovement = CharacterOwner->GetReplicatedBasedMovement();
+	FVector BaseLocation;
+	FQuat BaseQuat;
+	if (MovementBaseUtility::UseRelativeLocation(BasedMovement.MovementBase)
+		&& MovementBaseUtility::GetMovementBaseTransform(BasedMovement.MovementBase, BasedMovement.BoneName, BaseLocation, BaseQuat))
+	{
+		const FQuat InvBaseQuat = BaseQuat.Inverse();
+		Snapshot.Location = InvBaseQuat.RotateVector(NewLocation - BaseLocation);
+		Snapshot.Rotation = InvBaseQuat * NewRotation;
+		Snapshot.GravityDirection = InvBaseQuat.RotateVector(Snapshot.GravityDirection);
+		Snapshot.MovementBase = BasedMovement.MovementBase;
+		Snapshot.MovementBaseBoneName = BasedMovement.BoneName;
+		Snapshot.bRelativeToBase = true;
+	}
+
+	Snapshots.Push(Snapshot);
+}
+
+namespace BaseCharacterSmoothingSnapshots
+{
+	/** Gets the space a snapshot is stored in. Returns false if the movement base it is relative to is gone. */
+	static bool GetSnapshotFrame(const FBaseCharacterSmoothingSnapshot& Snapshot, FVector& OutLocation, FQuat& OutQuat)
+	{
+		OutLocation = FVector::ZeroVector;
+		OutQuat = FQuat::Identity;
+		return !Snapshot.bRelativeToBase || MovementBaseUtility::GetMovementBaseTransform(Snapshot.MovementBase.Get(), Snapshot.MovementBaseBoneName, OutLocation, OutQuat);
+	}
+}
+
+void UBaseCharacterMovementComponent::SmoothClientPosition_InterpolateSnapshots(FNetworkPredictionData_Client_Character& ClientData, float DeltaSeconds)
+{
+	using namespace BaseCharacterSmoothingSnapshots;
+
+	FBaseCharacterSmoothingSnapshotBuffer& Snapshots = ClientData.SmoothingSnapshots;
+	check(!Snapshots.IsEmpty());
+
+	// Display the character SnapshotInterpolationDelay behind the client clock. When updates stop, the clock keeps running past the newest snapshot
+	// for up to cg.NetSnapshotMaxExtrapolationTime, extrapolating. While it is ahead of the newest update it runs slower, so the delay is regained
+	// without going back in time once updates resume.
+	const float MaxExtrapolationTime = FMath::Max(0.f, BaseCharacterMovementCVars::NetSnapshotMaxExtrapolationTime);
+	const float ClockRate = ClientData.SmoothingClientTimeStamp > ClientData.SmoothingServerTimeStamp ? 0.75f : 1.f;
+	ClientData.SmoothingClientTimeStamp = FMath::Min(ClientData.SmoothingClientTimeStamp + DeltaSeconds * ClockRate, ClientData.SmoothingServerTimeStamp + ClientData.SnapshotInterpolationDelay + MaxExtrapolationTime);
+	const double NewestTimeStamp = Snapshots.Last().ServerTimeStamp;
+	const double RenderTimeStamp = FMath::Min(ClientData.SmoothingClientTimeStamp - ClientData.SnapshotInterpolationDelay, NewestTimeStamp + MaxExtrapolationTime);
+
+	// Past the extrapolation time, blend the mesh back onto the capsule, which keeps simulating, instead of snapping it there.
+	if (Snapshots.Num() > 1 && RenderTimeStamp >= NewestTimeStamp + MaxExtrapolationTime)
+	{
+		const float BlendTime = FMath::Max(ClientData.SmoothNetUpdateTime, UE_KINDA_SMALL_NUMBER);
+		ClientData.MeshTranslationOffset *= FMath::Clamp(1.f - DeltaSeconds / BlendTime, 0.f, 1.f);
+		if (ClientData.MeshTranslationOffset.IsNearlyZero())
+		{
+			ClientData.MeshTranslationOffset = FVector::ZeroVector;
+			bNetworkSmoothingComplete = true;
+		}
+		return;
+	}
+
+	// Find the snapshots around the render time. Outside of the buffered time range the oldest or newest snapshot is held.
+	int32 ToIndex = 0;
+	while (ToIndex < Snapshots.Num() - 1 && Snapshots[ToIndex].ServerTimeStamp < RenderTimeStamp)
+	{
+		++ToIndex;
+	}
+	const FBaseCharacterSmoothingSnapshot& From = Snapshots[FMath::Max(ToIndex - 1, 0)];
+	const FBaseCharacterSmoothingSnapshot& To = Snapshots[ToIndex];
+	const double SnapshotDeltaTime = To.ServerTimeStamp - From.ServerTimeStamp;
+	const double RawAlpha = SnapshotDeltaTime > UE_SMALL_NUMBER ? (RenderTimeStamp - From.ServerTimeStamp) / SnapshotDeltaTime : 1.0;
+	const float Alpha = (float)FMath::Clamp(RawAlpha, 0.0, 1.0);
+
+	// Beyond the newest snapshot the location keeps going along the last snapshot velocity, rotation and gravity hold.
+	const FVector::FReal LocationAlpha = FMath::Max(RawAlpha, 0.0);
+
+	FVector FromFrameLocation, ToFrameLocation;
+	FQuat FromFrameQuat, ToFrameQuat;
+	if (!GetSnapshotFrame(From, FromFrameLocation, FromFrameQuat) || !GetSnapshotFrame(To, ToFrameLocation, ToFrameQuat))
+	{
+		// The base went away, snap to the capsule until the next update.
+		Snapshots.Reset();
+		ClientData.MeshTranslationOffset = FVector::ZeroVector;
+		ClientData.MeshRotationOffset = ClientData.MeshRotationTarget;
+		bNetworkSmoothingComplete = true;
+		return;
+	}
+
+	FVector FromLocation = From.Location;
+	FQuat FromRotation = From.Rotation;
+	FVector FromGravityDirection = From.GravityDirection;
+	FVector ToLocation = To.Location;
+	FQuat ToRotation = To.Rotation;
+	FVector ToGravityDirection = To.GravityDirection;
+
+	// Interpolate in the space of the base when both snapshots share it, in world space when the base changed in between.
+	if (From.bRelativeToBase != To.bRelativeToBase || From.MovementBase != To.MovementBase || From.MovementBaseBoneName != To.MovementBaseBoneName)
+	{
+		FromLocation = FromFrameLocation + FromFrameQuat.RotateVector(FromLocation);
+		FromRotation = FromFrameQuat * FromRotation;
+		FromGravityDirection = FromFrameQuat.RotateVector(FromGravityDirection);
+		ToLocation = ToFrameLocation + ToFrameQuat.RotateVector(ToLocation);
+		ToRotation = ToFrameQuat * ToRotation;
+		ToGravityDirection = ToFrameQuat.RotateVector(ToGravityDirection);
+		ToFrameLocation = FVector::ZeroVector;
+		ToFrameQuat = FQuat::Identity;
+	}
+
+	// Rotate the gravity frame of the first snapshot along the shortest arc to the gravity of the second one, and interpolate the rotation
+	// relative to that frame. Walking over a gravity change then turns the character with the gravity instead of cutting through it in world space.
+	const FQuat FromGravityFrame = FQuat::FindBetweenNormals(DefaultGravityDirection, FromGravityDirection);
+	const FQuat GravityDelta = FQuat::FindBetweenNormals(FromGravityDirection, ToGravityDirection);
+	const FQuat ToGravityFrame = GravityDelta * FromGravityFrame;
+	const FQuat GravityFrame = FQuat::Slerp(FQuat::Identity, GravityDelta, Alpha) * FromGravityFrame;
+	const FQuat GravityRelativeRotation = FQuat::Slerp(FromGravityFrame.Inverse() * FromRotation, ToGravityFrame.Inverse() * ToRotation, Alpha);
+
+	const FVector SmoothLocation = ToFrameLocation + ToFrameQuat.RotateVector(FromLocation + (ToLocation - FromLocation) * LocationAlpha);
+	const FQuat SmoothRotation = (ToFrameQuat * GravityFrame * GravityRelativeRotation).GetNormalized();
+
+	ClientData.MeshTranslationOffset = SmoothLocation - UpdatedComponent->GetComponentLocation();
+	ClientData.MeshRotationOffset = SmoothRotation;
+	ClientData.MeshRotationTarget = SmoothRotation;
+
+	// Keep the mesh within the distance it is allowed to lag behind the capsule, which simulates ahead of the snapshots.
+	if (ClientData.MeshTranslationOffset.SizeSquared() > FMath::Square(ClientData.MaxSmoothNetUpdateDist))
+	{
+		ClientData.MeshTranslationOffset = ClientData.MeshTranslationOffset.GetSafeNormal() * ClientData.MaxSmoothNetUpdateDist;
+	}
+
+	// Done once the render time reaches a newest snapshot the character stopped at, the capsule stays there too. A moving character
+	// is extrapolated, then blended onto the capsule above.
+	if (ToIndex == Snapshots.Num() - 1 && Alpha >= 1.f && (Snapshots.Num() == 1 || FromLocation.Equals(ToLocation, UE_KINDA_SMALL_NUMBER)))
+	{
+		ClientData.MeshTranslationOffset = FVector::ZeroVector;
+		bNetworkSmoothingComplete = true;
+	}
+
+	UE_LOG(LogCharacterNetSmoothing, VeryVerbose, TEXT("InterpolateSnapshots: RenderTimeStamp: %.6f, From: %.6f, To: %.6f, Alpha: %.6f for %s"),
+		RenderTimeStamp, From.ServerTimeStamp, To.ServerTimeStamp, Alpha, *GetNameSafe(CharacterOwner));
+}
+
 void UBaseCharacterMovementComponent::SmoothClientPosition_UpdateVisuals()
 {
 	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementSmoothClientPosition_Visual);
@@ -8067,6 +9274,27 @@ bool UBaseCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
 		return false;
 	}
 
+	const uint64 ReplayStartCycles = FPlatformTime::Cycles64();
+
+	// Corrections that only translate the predicted state are applied without simulating the saved moves again.
+	if (ClientData->ReplayTranslation.bValid && TranslateClientReplay(*ClientData))
+	{
+		UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ClientUpdatePositionAfterServerUpdate Translated %d Moves by %s"), ClientData->SavedMoves.Num(), *ClientData->ReplayTranslation.Offset.ToString());
+
+		if (FSavedMove_Character* const PendingMove = ClientData->PendingMove.Get())
+		{
+			PendingMove->bForceNoCombine = true;
+		}
+
+		CharacterOwner->SavedRootMotion.Clear();
+		CharacterOwner->bClientResimulateRootMotion = false;
+
+		MovementCounters.TranslatedMoves += (uint16)ClientData->SavedMoves.Num();
+		MovementCounters.ReplayCycles += FPlatformTime::Cycles64() - ReplayStartCycles;
+		return true;
+	}
+	ClientData->ReplayTranslation.bValid = false;
+
 	// Save important values that might get affected by the replay.
 	const float SavedAnalogInputModifier = AnalogInputModifier;
 	const FRootMotionMovementParams BackupRootMotionParams = RootMotionParams; // For animation root motion
@@ -8137,10 +9365,123 @@ bool UBaseCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
 	bWantsToCrouch = bRealCrouch;
 	bForceMaxAccel = bRealForceMaxAccel;
 	bForceNextFloorCheck = true;
+
+	MovementCounters.ReplayedMoves += (uint16)ClientData->SavedMoves.Num();
+	MovementCounters.ReplayCycles += FPlatformTime::Cycles64() - ReplayStartCycles;
 	
 	return (ClientData->SavedMoves.Num() > 0);
 }
 
+bool UBaseCharacterMovementComponent::CanTranslateClientReplay(const FNetworkPredictionData_Client_Character& ClientData, const FVector& NewLocation, const FVector& NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, uint8 ServerMovementMode, const FVector& ServerGravityDirection, FBaseCharacterReplayTranslation& OutTranslation) const
+{
+	const FSavedMove_Character* AckedMove = ClientData.LastAckedMove.Get();
+	if (!BaseCharacterMovementCVars::bEnableIncrementalReplay || !AckedMove || ClientData.SavedMoves.Num() == 0 || !UpdatedComponent)
+	{
+		return false;
+	}
+
+	// Root motion is resimulated from the server state, it can't be translated.
+	if (CharacterOwner->bClientResimulateRootMotion || CharacterOwner->bClientResimulateRootMotionSources || HasRootMotionSources() || CharacterOwner->IsPlayingNetworkedRootMotionMontage())
+	{
+		return false;
+	}
+
+	// The server must agree with everything but the location, and the velocity must match or the unacked moves would diverge.
+	if (ServerMovementMode != AckedMove->EndPackedMovementMode
+		|| NewBase != AckedMove->EndBase.Get()
+		|| NewBaseBoneName != AckedMove->EndBoneName
+		|| GravityFieldId != AckedMove->EndGravityFieldId
+		|| (ServerGravityDirection | AckedMove->EndGravityDirection) < FMath::Cos(FMath::DegreesToRadians(BaseCharacterMovementCVars::IncrementalReplayMaxGravityError))
+		|| !NewVelocity.Equals(AckedMove->SavedVelocity, BaseCharacterMovementCVars::IncrementalReplayMaxVelocityError))
+	{
+		return false;
+	}
+
+	// Unacked moves that changed mode, base or gravity field may not have done so from the corrected location.
+	// The pending move is one of the saved moves too.
+	for (int32 MoveIndex = 0; MoveIndex < ClientData.SavedMoves.Num(); ++MoveIndex)
+	{
+		const FSavedMove_Character* Move = ClientData.SavedMoves[MoveIndex].Get();
+		if (Move->StartPackedMovementMode != AckedMove->EndPackedMovementMode
+			|| Move->EndPackedMovementMode != AckedMove->EndPackedMovementMode
+			|| Move->StartBase != AckedMove->EndBase
+			|| Move->EndBase != AckedMove->EndBase
+			|| Move->StartGravityFieldId != AckedMove->EndGravityFieldId
+			|| Move->EndGravityFieldId != AckedMove->EndGravityFieldId)
+		{
+			return false;
+		}
+	}
+
+	// Dynamic bases may have moved since the acked move, the offset is taken in base space and applied where the base is now.
+	OutTranslation.Offset = NewLocation - AckedMove->SavedLocation;
+	OutTranslation.RelativeOffset = FVector::ZeroVector;
+	if (MovementBaseUtility::UseRelativeLocation(NewBase))
+	{
+		FVector RelativeLocation;
+		MovementBaseUtility::TransformLocationToLocal(NewBase, NewBaseBoneName, NewLocation, RelativeLocation);
+		OutTranslation.RelativeOffset = RelativeLocation - AckedMove->SavedRelativeLocation;
+		MovementBaseUtility::TransformDirectionToWorld(NewBase, NewBaseBoneName, OutTranslation.RelativeOffset, OutTranslation.Offset);
+	}
+
+	return OutTranslation.Offset.SizeSquared() <= FMath::Square(BaseCharacterMovementCVars::IncrementalReplayMaxOffset);
+}
+
+bool UBaseCharacterMovementComponent::TranslateClientReplay(FNetworkPredictionData_Client_Character& ClientData)
+{
+	// Predicted and translated floors closer than this (dot product of the normals) count as the same floor.
+	static constexpr float SameFloorNormalDot = 0.999f;
+
+	FBaseCharacterReplayTranslation& Translation = ClientData.ReplayTranslation;
+	Translation.bValid = false;
+
+	const FVector NewLocation = Translation.Location + Translation.Offset;
+	if (OverlapTest(NewLocation, Translation.Rotation, UpdatedComponent->GetCollisionObjectType(), GetPawnCapsuleCollisionShape(SHRINK_None), CharacterOwner))
+	{
+		return false;
+	}
+
+	// On the ground, the translated capsule must still stand on the floor the prediction ended on, at a height walking would keep.
+	FBaseFindFloorResult NewFloor;
+	if (IsMovingOnGround())
+	{
+		FindFloor(NewLocation, NewFloor, false);
+		if (!NewFloor.IsWalkableFloor()
+			|| NewFloor.HitResult.GetComponent() != Translation.Floor.HitResult.GetComponent()
+			|| (NewFloor.HitResult.ImpactNormal | Translation.Floor.HitResult.ImpactNormal) < SameFloorNormalDot
+			|| FMath::Abs(NewFloor.FloorDist - Translation.Floor.FloorDist) > MAX_FLOOR_DIST - MIN_FLOOR_DIST)
+		{
+			return false;
+		}
+	}
+
+	UpdatedComponent->SetWorldLocationAndRotation(NewLocation, Translation.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	Velocity = Translation.Velocity;
+	if (IsMovingOnGround())
+	{
+		CurrentFloor = NewFloor;
+	}
+
+	// Unacked moves, the pending one included, now end where replaying them from the corrected location would have.
+	for (int32 MoveIndex = 0; MoveIndex < ClientData.SavedMoves.Num(); ++MoveIndex)
+	{
+		FSavedMove_Character* const Move = ClientData.SavedMoves[MoveIndex].Get();
+		Move->StartLocation += Translation.Offset;
+		Move->SavedLocation += Translation.Offset;
+		Move->StartRelativeLocation += Translation.RelativeOffset;
+		Move->SavedRelativeLocation += Translation.RelativeOffset;
+	}
+
+	SaveBaseLocation();
+
+	LastUpdateLocation = NewLocation;
+	LastUpdateRotation = Translation.Rotation;
+	LastUpdateVelocity = Velocity;
+
+	UpdateComponentVelocity();
+	return true;
+}
+
 
 bool UBaseCharacterMovementComponent::ForcePositionUpdate(float DeltaTime)
 {
@@ -8452,7 +9793,10 @@ void UBaseCharacterMovementComponent::ReplicateMoveToServer(float DeltaTime, con
 		if (bCanDelayMove && ClientData->PendingMove.IsValid() == false)
 		{
 			// Decide whether to hold off on move
-			const float NetMoveDeltaSeconds = FMath::Clamp(GetClientNetSendDeltaTime(PC, ClientData, NewMovePtr), 1.f/120.f, 1.f/5.f);
+			// The upper bound only leaves room for the idle rate, see cg.NetIdleSendMoveDeltaTime.
+			const AGameNetworkManager* GameNetworkManager = GetDefault<AGameNetworkManager>();
+			const float MaxNetMoveDeltaSeconds = FMath::Max(1.f/5.f, FMath::Min(BaseCharacterMovementCVars::NetIdleSendMoveDeltaTime, 0.8f * GameNetworkManager->MAXCLIENTUPDATEINTERVAL));
+			const float NetMoveDeltaSeconds = FMath::Clamp(GetClientNetSendDeltaTime(PC, ClientData, NewMovePtr), 1.f/120.f, MaxNetMoveDeltaSeconds);
 			const float SecondsSinceLastMoveSent = MyWorld->GetRealTimeSeconds() - ClientData->ClientUpdateRealTime;
 
 			if (SecondsSinceLastMoveSent < NetMoveDeltaSeconds)
@@ -8914,7 +10258,7 @@ bool FBaseCharacterNetworkSerializationPackedBits::NetSerialize(FArchive& Ar, cl
 	uint32 NumBits = DataBits.Num();
 	Ar.SerializeIntPacked(NumBits);
 
-	if (NumBits > static_cast<uint32>(BaseCharacterMovementCVars::NetPackedMovementMaxBits))
+	if (NumBits > GetMaxNumBits())
 	{
 		// Protect against bad data that could cause server to allocate way too much memory.
 		UE_LOG(LogNetPlayerMovement, Error, TEXT("FBaseCharacterNetworkSerializationPackedBits::NetSerialize: Dropping move due to NumBits (%d) exceeding allowable limit (%d). See NetPackedMovementMaxBits."), NumBits, BaseCharacterMovementCVars::NetPackedMovementMaxBits);
@@ -8933,6 +10277,11 @@ bool FBaseCharacterNetworkSerializationPackedBits::NetSerialize(FArchive& Ar, cl
 	return !Ar.IsError();
 }
 
+uint32 FBaseCharacterNetworkSerializationPackedBits::GetMaxNumBits()
+{
+	return static_cast<uint32>(FMath::Max(0, BaseCharacterMovementCVars::NetPackedMovementMaxBits));
+}
+
 void FBaseCharacterNetworkMoveDataContainer::ClientFillNetworkMoveData(const FSavedMove_Character* ClientNewMove, const FSavedMove_Character* ClientPendingMove, const FSavedMove_Character* ClientOldMove)
 {
 	bDisableCombinedScopedMove = false;
@@ -9075,12 +10424,45 @@ void UBaseCharacterMovementComponent::ServerMovePacked_ServerReceive(const FBase
 		return;
 	}
 
+	if (FBaseCharacterMoveRecorder::IsAnyRecording() && !ServerMoveReplayPackageMap)
+	{
+		// Decoded an extra time on arrival, the recording stores moves with references that resolve outside this session.
+		const UBaseCharacterMovementManager* Manager = UBaseCharacterMovementManager::Get(this);
+		FBaseCharacterMoveRecorder* MoveRecorder = Manager ? Manager->GetServerMoveRecorder() : nullptr;
+		if (MoveRecorder && ServerMovePacked_DecodeMoveData(PackedBits))
+		{
+			MoveRecorder->RecordServerMove(*this, GetNetworkMoveDataContainer());
+		}
+	}
+
+	if (ShouldBatchServerMoves())
+	{
+		// Processed in order with the other queued moves by UBaseCharacterMovementManager, see ProcessQueuedServerMoves().
+		QueuedServerMoves.Add(PackedBits);
+		if (QueuedServerMoves.Num() >= BaseCharacterMovementCVars::MaxQueuedServerMoves)
+		{
+			ProcessQueuedServerMoves();
+		}
+		return;
+	}
+
+	// Batching may have been turned off with moves still queued, keep them in order.
+	ProcessQueuedServerMoves();
+
+	if (ServerMovePacked_DecodeMoveData(PackedBits))
+	{
+		ServerMove_HandleMoveData(GetNetworkMoveDataContainer());
+	}
+}
+
+bool UBaseCharacterMovementComponent::ServerMovePacked_DecodeMoveData(const FBaseCharacterServerMovePackedBits& PackedBits)
+{
 	const int32 NumBits = PackedBits.DataBits.Num();
 	if (NumBits > BaseCharacterMovementCVars::NetPackedMovementMaxBits)
 	{
 		// Protect against bad data that could cause server to allocate way too much memory.
 		UE_LOG(LogNetPlayerMovement, Error, TEXT("ServerMovePacked_ServerReceive (%s): Dropping move due to NumBits (%d) exceeding allowable limit (%d). See NetPackedMovementMaxBits."), *GetNameSafe(GetOwner()), NumBits, BaseCharacterMovementCVars::NetPackedMovementMaxBits);
-		return;
+		return false;
 	}
 
 	// Reuse bit reader to avoid allocating memory each time.
@@ -9094,13 +10476,14 @@ void UBaseCharacterMovementComponent::ServerMovePacked_ServerReceive(const FBase
 	else
 #endif
 	{
-		ServerMoveBitReader.PackageMap = PackedBits.GetPackageMap();
+		// Replayed moves don't come from a connection.
+		ServerMoveBitReader.PackageMap = PackedBits.GetPackageMap() ? PackedBits.GetPackageMap() : ToRawPtr(ServerMoveReplayPackageMap);
 	}
 
 	if (ServerMoveBitReader.PackageMap == nullptr)
 	{
 		devCode(UE_LOG(LogNetPlayerMovement, Error, TEXT("ServerMovePacked_ServerReceive: Failed to find PackageMap for data serialization!")));
-		return;
+		return false;
 	}
 
 	// Deserialize bits to move data struct.
@@ -9109,10 +10492,43 @@ void UBaseCharacterMovementComponent::ServerMovePacked_ServerReceive(const FBase
 	if (!MoveDataContainer.Serialize(*this, ServerMoveBitReader, ServerMoveBitReader.PackageMap) || ServerMoveBitReader.IsError())
 	{
 		devCode(UE_LOG(LogNetPlayerMovement, Error, TEXT("ServerMovePacked_ServerReceive: Failed to serialize movement data!")));
+		return false;
+	}
+
+	return true;
+}
+
+void UBaseCharacterMovementComponent::ProcessQueuedServerMoves()
+{
+	if (QueuedServerMoves.Num() == 0)
+	{
 		return;
 	}
 
-	ServerMove_HandleMoveData(MoveDataContainer);
+	// Moves are handled one at a time through the shared data container, in the order they were received.
+	// Swap the queue out first, handling a move can end play or flush the queue again.
+	TArray<FBaseCharacterServerMovePackedBits> MovesToProcess = MoveTemp(QueuedServerMoves);
+	QueuedServerMoves.Reset();
+
+	for (const FBaseCharacterServerMovePackedBits& PackedBits : MovesToProcess)
+	{
+		if (!HasValidData() || !IsActive())
+		{
+			break;
+		}
+
+		if (ServerMovePacked_DecodeMoveData(PackedBits))
+		{
+			ServerMove_HandleMoveData(GetNetworkMoveDataContainer());
+		}
+	}
+
+	// Give the allocation back to the queue so steady state batching does not allocate.
+	if (QueuedServerMoves.Num() == 0)
+	{
+		MovesToProcess.Reset();
+		QueuedServerMoves = MoveTemp(MovesToProcess);
+	}
 }
 
 void UBaseCharacterMovementComponent::ServerMove_HandleMoveData(const FBaseCharacterNetworkMoveDataContainer& MoveDataContainer)
@@ -9156,8 +10572,8 @@ void UBaseCharacterMovementComponent::ServerMove_HandleMoveData(const FBaseChara
 
 void UBaseCharacterMovementComponent::ServerMove_PerformMovement(const FBaseCharacterNetworkMoveData& MoveData)
 {
-	// SCOPE_CYCLE_COUNTER(STAT_CharacterMovementServerMove);
-	// CSV_SCOPED_TIMING_STAT(CharacterMovement, CharacterMovementServerMove);
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementServerMove);
+	CSV_SCOPED_TIMING_STAT(BaseCharacterMovement, ServerMove);
 
 	if (!HasValidData() || !IsActive())
 	{
@@ -9372,6 +10788,7 @@ void UBaseCharacterMovementComponent::ServerMoveHandleClientError(float ClientTi
 		{
 			float ClientForwardFactor = 1.f;
 			UPrimitiveComponent* LastServerMovementBasePtr = LastServerMovementBase.Get();
+			const float MaxWalkSpeed = GetMovementSetting(EBaseCharacterMovementSetting::MaxWalkSpeed);
 			if (IsValid(LastServerMovementBasePtr) && MovementBaseUtility::IsDynamicBase(LastServerMovementBasePtr) && MaxWalkSpeed > UE_KINDA_SMALL_NUMBER)
 			{
 				const FVector LastBaseVelocity = MovementBaseUtility::GetMovementBaseVelocity(LastServerMovementBasePtr, LastServerMovementBaseBoneName);
@@ -9617,9 +11034,20 @@ bool UBaseCharacterMovementComponent::ServerExceedsAllowablePositionError(float
 
 	const FVector LocDiff = UpdatedComponent->GetComponentLocation() - ClientWorldLocation;	
 	const AGameNetworkManager* GameNetworkManager = (const AGameNetworkManager*)(AGameNetworkManager::StaticClass()->GetDefaultObject());
-	if (GameNetworkManager->ExceedsAllowablePositionError(LocDiff))
+	bool bExceedsAllowablePositionError = GameNetworkManager->ExceedsAllowablePositionError(LocDiff);
+
+	// On a moving base, client and server split the base motion across moves slightly differently. Allow the error that motion explains.
+	if (bExceedsAllowablePositionError && BaseCharacterMovementCVars::NetMovingBaseErrorTime > 0.f && MovementBaseUtility::UseRelativeLocation(ClientMovementBase))
+	{
+		const FVector BaseVelocity = MovementBaseUtility::GetMovementBaseVelocity(ClientMovementBase, ClientBaseBoneName)
+			+ MovementBaseUtility::GetMovementBaseTangentialVelocity(ClientMovementBase, ClientBaseBoneName, UpdatedComponent->GetComponentLocation());
+		const float MaxPositionError = FMath::Sqrt(GameNetworkManager->MAXPOSITIONERRORSQUARED) + BaseVelocity.Size() * BaseCharacterMovementCVars::NetMovingBaseErrorTime;
+		bExceedsAllowablePositionError = LocDiff.SizeSquared() > FMath::Square(MaxPositionError);
+	}
+
+	if (bExceedsAllowablePositionError)
 	{
-		bNetworkLargeClientCorrection |= (LocDiff.SizeSquared() > FMath::Square(NetworkLargeClientCorrectionDistance));
+		bNetworkLargeClientCorrection |= (LocDiff.SizeSquared() > FMath::Square(GetMovementSetting(EBaseCharacterMovementSetting::NetworkLargeClientCorrectionDistance)));
 		return true;
 	}
 
@@ -9727,6 +11155,12 @@ void UBaseCharacterMovementComponent::UpdateFloorFromAdjustment()
 
 void UBaseCharacterMovementComponent::MoveResponsePacked_ServerSend(const FBaseCharacterMoveResponsePackedBits& PackedBits)
 {
+	// Replayed characters have no client to respond to.
+	if (ServerMoveReplayPackageMap)
+	{
+		return;
+	}
+
 	// Pass through RPC call to character on client, there is less RPC bandwidth overhead when used on an Actor rather than a Component.
 	CharacterOwner->ClientMoveResponsePacked(PackedBits);
 }
@@ -9796,7 +11230,7 @@ void UBaseCharacterMovementComponent::ServerSendMoveResponse(const FBaseClientAd
 	else
 #endif
 	{
-		MoveResponseBitWriter.PackageMap = NetConnection ? ToRawPtr(NetConnection->PackageMap) : nullptr;
+		MoveResponseBitWriter.PackageMap = NetConnection ? ToRawPtr(NetConnection->PackageMap) : ToRawPtr(ServerMoveReplayPackageMap);
 	}
 
 	if (MoveResponseBitWriter.PackageMap == nullptr)
@@ -9871,7 +11305,20 @@ bool FBaseCharacterMoveResponseDataContainer::Serialize(UBaseCharacterMovementCo
 
 		ClientAdjustment.NewLoc.NetSerialize(Ar, PackageMap, bLocalSuccess);
 		ClientAdjustment.NewVel.NetSerialize(Ar, PackageMap, bLocalSuccess);
-		NetSerializeOptionalValue(bIsSaving, Ar, ClientAdjustment.GravityDirection, UBaseCharacterMovementComponent::DefaultGravityDirection, PackageMap);
+
+		// Gravity is only sent when not the default, in compact form: a few bits for world axes, octahedral otherwise.
+		// It is not delta encoded against the last acked value: responses are unreliable and client moves carry no gravity, so the
+		// server can't know which value the client holds, and corrections are too rare for an acknowledgement in every move to pay off.
+		uint8 bHasCustomGravity = bIsSaving ? !ClientAdjustment.GravityDirection.Equals(UBaseCharacterMovementComponent::DefaultGravityDirection) : 0;
+		Ar.SerializeBits(&bHasCustomGravity, 1);
+		if (bHasCustomGravity)
+		{
+			BaseGravityNetSerialization::SerializeDirection(Ar, ClientAdjustment.GravityDirection);
+		}
+		else if (!bIsSaving)
+		{
+			ClientAdjustment.GravityDirection = UBaseCharacterMovementComponent::DefaultGravityDirection;
+		}
 
 		if (bHasRotation)
 		{
@@ -9922,6 +11369,8 @@ void UBaseCharacterMovementComponent::ClientHandleMoveResponse(const FBaseCharac
 	}
 	else
 	{
+		++MovementCounters.CorrectionsReceived;
+
 		// Wrappers to old RPC handlers, to maintain compatibility. If overrides need additional serialized data, they can access GetMoveResponseDataContainer()
 		if (MoveResponse.bRootMotionSourceCorrection)
 		{
@@ -10013,7 +11462,7 @@ void UBaseCharacterMovementComponent::SendClientAdjustment()
 	if (ServerData->PendingAdjustment.bAckGoodMove)
 	{
 		// just notify client this move was received
-		if (CurrentTime - ServerLastClientGoodMoveAckTime > NetworkMinTimeBetweenClientAckGoodMoves)
+		if (CurrentTime - ServerLastClientGoodMoveAckTime > GetMovementSetting(EBaseCharacterMovementSetting::NetworkMinTimeBetweenClientAckGoodMoves))
 		{
 			ServerLastClientGoodMoveAckTime = CurrentTime;
 			ServerSendMoveResponse(ServerData->PendingAdjustment);
@@ -10023,9 +11472,11 @@ void UBaseCharacterMovementComponent::SendClientAdjustment()
 	{
 		// We won't be back in here until the next client move and potential correction is received, so use the correct time now.
 		// Protect against bad data by taking appropriate min/max of editable values.
+		const float MinTimeBetweenClientAdjustmentsLargeCorrection = GetMovementSetting(EBaseCharacterMovementSetting::NetworkMinTimeBetweenClientAdjustmentsLargeCorrection);
+		const float MinTimeBetweenClientAdjustments = GetMovementSetting(EBaseCharacterMovementSetting::NetworkMinTimeBetweenClientAdjustments);
 		const float AdjustmentTimeThreshold = bNetworkLargeClientCorrection ?
-			FMath::Min(NetworkMinTimeBetweenClientAdjustmentsLargeCorrection, NetworkMinTimeBetweenClientAdjustments) :
-			FMath::Max(NetworkMinTimeBetweenClientAdjustmentsLargeCorrection, NetworkMinTimeBetweenClientAdjustments);
+			FMath::Min(MinTimeBetweenClientAdjustmentsLargeCorrection, MinTimeBetweenClientAdjustments) :
+			FMath::Max(MinTimeBetweenClientAdjustmentsLargeCorrection, MinTimeBetweenClientAdjustments);
 
 		// Check if correction is throttled based on time limit between updates.
 		if (CurrentTime - ServerLastClientAdjustmentTime > AdjustmentTimeThreshold)
@@ -10034,6 +11485,7 @@ void UBaseCharacterMovementComponent::SendClientAdjustment()
 
 			ServerData->PendingAdjustment.MovementMode = PackNetworkMovementMode();
 			ServerSendMoveResponse(ServerData->PendingAdjustment);
+			++MovementCounters.CorrectionsSent;
 		}
 	}
 
@@ -10123,7 +11575,22 @@ void UBaseCharacterMovementComponent::ClientAdjustPosition_Implementation
 	}
 
 	// Trigger event
-	OnClientCorrectionReceived(*ClientData, TimeStamp, WorldShiftedNewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode, DefaultGravityDirection);
+	const FVector ServerGravityDirection = ResponseDataContainer.ClientAdjustment.GravityDirection;
+	OnClientCorrectionReceived(*ClientData, TimeStamp, WorldShiftedNewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode, ServerGravityDirection);
+
+	// Keep the predicted state when the correction may be applied to it as a translation, see ClientUpdatePositionAfterServerUpdate().
+	// A correction still waiting to be replayed already replaced the predicted state, so the next one can't be translated.
+	FBaseCharacterReplayTranslation& ReplayTranslation = ClientData->ReplayTranslation;
+	const bool bPredictedRotation = !OptionalRotation.IsSet() || (ClientData->LastAckedMove.IsValid() && OptionalRotation->Equals(ClientData->LastAckedMove->SavedRotation, 0.1f));
+	ReplayTranslation.bValid = !ClientData->bUpdatePosition && bPredictedRotation
+		&& CanTranslateClientReplay(*ClientData, WorldShiftedNewLocation, NewVelocity, NewBase, NewBaseBoneName, ServerMovementMode, ServerGravityDirection, ReplayTranslation);
+	if (ReplayTranslation.bValid)
+	{
+		ReplayTranslation.Location = UpdatedComponent->GetComponentLocation();
+		ReplayTranslation.Rotation = UpdatedComponent->GetComponentQuat();
+		ReplayTranslation.Velocity = Velocity;
+		ReplayTranslation.Floor = CurrentFloor;
+	}
 
 	// Trust the server's positioning.
 	if (UpdatedComponent)
@@ -10517,11 +11984,21 @@ void UBaseCharacterMovementComponent::SetAvoidanceEnabled(bool bEnable)
 			UWorld* World = GetWorld();
 			UAvoidanceManager* AvoidanceManager = World ? World->GetAvoidanceManager() : nullptr;
 
+			// The movement manager builds the gravity relative avoidance hash, make sure it knows about this component.
+			if (bEnable && !bRegisteredWithMovementManager && HasBegunPlay())
+			{
+				if (UBaseCharacterMovementManager* MovementManager = UBaseCharacterMovementManager::Get(this))
+				{
+					MovementManager->RegisterComponent(this);
+					bRegisteredWithMovementManager = true;
+				}
+			}
+
 			if (AvoidanceManager)
 			{
 				if (bEnable)
 				{
-					AvoidanceManager->RegisterMovementComponent(this, AvoidanceWeight);
+					AvoidanceManager->RegisterMovementComponent(this, GetMovementSetting(EBaseCharacterMovementSetting::AvoidanceWeight));
 				}
 				else if (!AvoidanceManager->IsAutoPurgeEnabled())
 				{
@@ -10565,6 +12042,7 @@ void UBaseCharacterMovementComponent::ApplyRepulsionForce(float DeltaSeconds)
 			const float RepulsionForceRadius = CapsuleRadius * 1.2f;
 			const float StopBodyDistance = 2.5f;
 			const FVector MyLocation = UpdatedPrimitive->GetComponentLocation();
+			const FVector GravityUp = -GravityDirection;
 
 			for (int32 i=0; i < Overlaps.Num(); i++)
 			{
@@ -10608,7 +12086,7 @@ void UBaseCharacterMovementComponent::ApplyRepulsionForce(float DeltaSeconds)
 				// Trace to get the hit location on the capsule
 				FHitResult Hit;
 				bool bHasHit = UpdatedPrimitive->LineTraceComponent(Hit, BodyLocation,
-																	FVector(MyLocation.X, MyLocation.Y, BodyLocation.Z),
+																	MoveToGravityHeight(MyLocation, BodyLocation, GravityUp),
 																	QueryParams);
 
 				FVector HitLoc = Hit.ImpactPoint;
@@ -10621,8 +12099,8 @@ void UBaseCharacterMovementComponent::ApplyRepulsionForce(float DeltaSeconds)
 					bIsPenetrating = true;
 				}
 
-				const float DistanceNow = (HitLoc - BodyLocation).SizeSquared2D();
-				const float DistanceLater = (HitLoc - (BodyLocation + BodyVelocity * DeltaSeconds)).SizeSquared2D();
+				const float DistanceNow = FVector::VectorPlaneProject(HitLoc - BodyLocation, GravityUp).SizeSquared();
+				const float DistanceLater = FVector::VectorPlaneProject(HitLoc - (BodyLocation + BodyVelocity * DeltaSeconds), GravityUp).SizeSquared();
 
 				if (bHasHit && DistanceNow < StopBodyDistance && !bIsPenetrating)
 				{
@@ -10634,11 +12112,11 @@ void UBaseCharacterMovementComponent::ApplyRepulsionForce(float DeltaSeconds)
 
 					if (bHasHit)
 					{
-						ForceCenter.Z = HitLoc.Z;
+						ForceCenter = MoveToGravityHeight(MyLocation, HitLoc, GravityUp);
 					}
 					else
 					{
-						ForceCenter.Z = FMath::Clamp(BodyLocation.Z, MyLocation.Z - CapsuleHalfHeight, MyLocation.Z + CapsuleHalfHeight);
+						ForceCenter += GravityUp * FMath::Clamp<FVector::FReal>((BodyLocation - MyLocation) | GravityUp, -CapsuleHalfHeight, CapsuleHalfHeight);
 					}
 
 					OverlapBody->AddRadialForceToBody(ForceCenter, RepulsionForceRadius, RepulsionForce * Mass, ERadialImpulseFalloff::RIF_Constant);
@@ -10901,39 +12379,23 @@ void UBaseCharacterMovementComponent::RemoveRootMotionSourceByID(uint16 RootMoti
 void UBaseCharacterMovementComponent::ConvertRootMotionServerIDsToLocalIDs(const FBaseRootMotionSourceGroup& LocalRootMotionToMatchWith, FBaseRootMotionSourceGroup& InOutServerRootMotion, float TimeStamp)
 {
 	// Remove out of date mappings, they can never be used again.
-	for (int32 MappingIndex = 0; MappingIndex < RootMotionIDMappings.Num(); MappingIndex++)
+	RootMotionIDMappings.RemoveExpired(TimeStamp);
+
+	// Index the active local root motion sources by LocalID.
+	TMap<uint16, const FBaseRootMotionSource*, TInlineSetAllocator<FBaseRootMotionServerToLocalIDMap::InlineSize>> LocalRootMotionSourcesByID;
+	for (const TSharedPtr<FBaseRootMotionSource>& LocalRootMotionSource : LocalRootMotionToMatchWith.RootMotionSources)
 	{
-		if (RootMotionIDMappings[MappingIndex].IsStillValid(TimeStamp))
+		if (LocalRootMotionSource.IsValid() && !LocalRootMotionSourcesByID.Contains(LocalRootMotionSource->LocalID))
 		{
-			// MappingIndex is valid, remove anything before it.
-			const int32 CutOffIndex = MappingIndex - 1;
-			if (CutOffIndex >= 0)
-			{
-				// Most recent entries added last, so we can cull the top of the list.
-				RootMotionIDMappings.RemoveAt(0, CutOffIndex + 1, false);
-				break;
-			}
+			LocalRootMotionSourcesByID.Add(LocalRootMotionSource->LocalID, LocalRootMotionSource.Get());
 		}
 	}
 
 	// Remove mappings that don't map to an active local root motion source.
-	for (int32 MappingIndex = RootMotionIDMappings.Num()-1; MappingIndex>=0; MappingIndex--)
-	{
-		bool bFoundLocalSource = false;
-		for (const TSharedPtr<FBaseRootMotionSource>& LocalRootMotionSource : LocalRootMotionToMatchWith.RootMotionSources)
-		{
-			if (LocalRootMotionSource.IsValid() && (LocalRootMotionSource->LocalID == RootMotionIDMappings[MappingIndex].LocalID))
-			{
-				bFoundLocalSource = true;
-				break;
-			}
-		}
-
-		if (!bFoundLocalSource)
+	RootMotionIDMappings.RemoveAll([&LocalRootMotionSourcesByID](const FBaseRootMotionServerToLocalIDMapping& Mapping)
 		{
-			RootMotionIDMappings.RemoveAt(MappingIndex, 1, false);
-		}
-	}
+			return !LocalRootMotionSourcesByID.Contains(Mapping.LocalID);
+		});
 
 	bool bDumpDebugInfo = false;
 
@@ -10948,6 +12410,7 @@ void UBaseCharacterMovementComponent::ConvertRootMotionServerIDsToLocalIDs(const
 	{
 		if (ServerRootMotionSource.IsValid())
 		{
+			FBaseRootMotionSourceGroup::MakeSourceUnique(ServerRootMotionSource);
 			const uint16 ServerID = ServerRootMotionSource->LocalID;
 
 			// Reset LocalID of replicated ServerRootMotionSource, and find a local match.
@@ -10955,96 +12418,64 @@ void UBaseCharacterMovementComponent::ConvertRootMotionServerIDsToLocalIDs(const
 
 			// See if we have any recent mappings that match this server ID
 			// If we do, change it to that mapping and update the timestamp
+			if (FBaseRootMotionServerToLocalIDMapping* Mapping = RootMotionIDMappings.FindByServerID(ServerID))
 			{
-				bool bMappingFound = false;
-				for (FBaseRootMotionServerToLocalIDMapping& Mapping : RootMotionIDMappings)
-				{
-					if (ServerID == Mapping.ServerID)
-					{
-						ServerRootMotionSource->LocalID = Mapping.LocalID;
-						Mapping.TimeStamp = TimeStamp;
-						bMappingFound = true;
-						break; // Found it, don't need to search any more mappings
-					}
-				}
+				ServerRootMotionSource->LocalID = Mapping->LocalID;
+				Mapping->TimeStamp = TimeStamp;
 
-				if (bMappingFound)
+				// We rely on this rule (Matches) being always true, so in non-shipping builds make sure it never breaks.
+				if (const FBaseRootMotionSource* const* LocalRootMotionSource = LocalRootMotionSourcesByID.Find(ServerRootMotionSource->LocalID))
 				{
-					// We rely on this rule (Matches) being always true, so in non-shipping builds make sure it never breaks.
-					for (const TSharedPtr<FBaseRootMotionSource>& LocalRootMotionSource : LocalRootMotionToMatchWith.RootMotionSources)
+					if (!(*LocalRootMotionSource)->Matches(ServerRootMotionSource.Get()))
 					{
-						if (LocalRootMotionSource.IsValid() && (LocalRootMotionSource->LocalID == ServerRootMotionSource->LocalID))
-						{
-							if (!LocalRootMotionSource->Matches(ServerRootMotionSource.Get()))
-							{
-								ensureMsgf(false,
-									TEXT("Character(%s) Local RootMotionSource(%s) has the same LocalID(%d) as a non-matching ServerRootMotionSource(%s)!"),
-									*GetNameSafe(CharacterOwner), *LocalRootMotionSource->ToSimpleString(), LocalRootMotionSource->LocalID, *ServerRootMotionSource->ToSimpleString());
-
-								bDumpDebugInfo = true;
-							}
+						ensureMsgf(false,
+							TEXT("Character(%s) Local RootMotionSource(%s) has the same LocalID(%d) as a non-matching ServerRootMotionSource(%s)!"),
+							*GetNameSafe(CharacterOwner), *(*LocalRootMotionSource)->ToSimpleString(), (*LocalRootMotionSource)->LocalID, *ServerRootMotionSource->ToSimpleString());
 
-							break;
-						}
+						bDumpDebugInfo = true;
 					}
-
-					// We've found the correct LocalID, done with this one, process next ServerRootMotionSource
-					continue;
 				}
+
+				// We've found the correct LocalID, done with this one, process next ServerRootMotionSource
+				continue;
 			}
 
 			// If no mapping found, find match out of Local RootMotionSources that are not already mapped
-			bool bMatchFound = false;
-			TArray<TSharedPtr<FBaseRootMotionSource>> LocalRootMotionSources;
-			LocalRootMotionSources.Reserve(LocalRootMotionToMatchWith.RootMotionSources.Num() + LocalRootMotionToMatchWith.PendingAddRootMotionSources.Num());
-			LocalRootMotionSources.Append(LocalRootMotionToMatchWith.RootMotionSources);
-			LocalRootMotionSources.Append(LocalRootMotionToMatchWith.PendingAddRootMotionSources);
-			for (const TSharedPtr<FBaseRootMotionSource>& LocalRootMotionSource : LocalRootMotionSources)
+			auto TryMatchLocalRootMotionSource = [this, &ServerRootMotionSource, ServerID, TimeStamp](const TSharedPtr<FBaseRootMotionSource>& LocalRootMotionSource)
 			{
-				if (LocalRootMotionSource.IsValid())
+				// If the LocalID is already mapped to a ServerID it's already "claimed",
+				// it's not valid for being a match to our unmatched server source
+				if (LocalRootMotionSource.IsValid() && !RootMotionIDMappings.ContainsLocalID(LocalRootMotionSource->LocalID)
+					&& LocalRootMotionSource->Matches(ServerRootMotionSource.Get()))
 				{
-					const uint16 LocalID = LocalRootMotionSource->LocalID;
-
-					// Check if the LocalID is already mapped to a ServerID; if it's already "claimed",
-					// it's not valid for being a match to our unmatched server source
-					{
-						bool bMappingFound = false;
-						for (FBaseRootMotionServerToLocalIDMapping& Mapping : RootMotionIDMappings)
-						{
-							if (LocalID == Mapping.LocalID)
-							{
-								bMappingFound = true;
-								break; // Found it, don't need to search any more mappings
-							}
-						}
-
-						if (bMappingFound)
-						{
-							continue; // We found a ServerID matching this LocalID, so we don't try to match this
-						}
-					}
+					// We have a match! Assign LocalID and add to Mapping
+					ServerRootMotionSource->LocalID = LocalRootMotionSource->LocalID;
+					RootMotionIDMappings.Add(ServerID, LocalRootMotionSource->LocalID, TimeStamp);
+					return true;
+				}
+				return false;
+			};
 
-					// This LocalRootMotionSource is a valid possible match to the ServerRootMotionSource
-					if (LocalRootMotionSource->Matches(ServerRootMotionSource.Get()))
+			bool bMatchFound = false;
+			for (const TSharedPtr<FBaseRootMotionSource>& LocalRootMotionSource : LocalRootMotionToMatchWith.RootMotionSources)
+			{
+				if (TryMatchLocalRootMotionSource(LocalRootMotionSource))
+				{
+					bMatchFound = true;
+					break; // Stop searching LocalRootMotionSources, we've found a match
+				}
+			}
+			if (!bMatchFound)
+			{
+				for (const TSharedPtr<FBaseRootMotionSource>& LocalRootMotionSource : LocalRootMotionToMatchWith.PendingAddRootMotionSources)
+				{
+					if (TryMatchLocalRootMotionSource(LocalRootMotionSource))
 					{
-						// We have a match!
-						// Assign LocalID
-						ServerRootMotionSource->LocalID = LocalID;
-
-						// Add to Mapping
-						{
-							FBaseRootMotionServerToLocalIDMapping NewMapping;
-							NewMapping.LocalID = LocalID;
-							NewMapping.ServerID = ServerID;
-							NewMapping.TimeStamp = TimeStamp;
-
-							RootMotionIDMappings.Add(NewMapping);
-							bMatchFound = true;
-							break; // Stop searching LocalRootMotionSources, we've found a match
-						}
+						bMatchFound = true;
+						break;
 					}
 				}
-			} // loop through LocalRootMotionSources
+			}
 
 			// if we don't find a match, set an invalid LocalID so that we know it's an invalid ID from the server
 			// This doesn't mean it's a "bad" RootMotionSource; just that the Server sent a RootMotionSource
@@ -11061,9 +12492,9 @@ void UBaseCharacterMovementComponent::ConvertRootMotionServerIDsToLocalIDs(const
 	if (bDumpDebugInfo)
 	{
 		UE_LOG(LogRootMotion, Warning, TEXT("Dumping current mappings:"));
-		for (FBaseRootMotionServerToLocalIDMapping& Mapping : RootMotionIDMappings)
+		for (const TPair<uint16, FBaseRootMotionServerToLocalIDMapping>& Mapping : RootMotionIDMappings.GetMappings())
 		{
-			UE_LOG(LogRootMotion, Warning, TEXT("- LocalID(%d) ServerID(%d)"), Mapping.LocalID, Mapping.ServerID);
+			UE_LOG(LogRootMotion, Warning, TEXT("- LocalID(%d) ServerID(%d)"), Mapping.Value.LocalID, Mapping.Value.ServerID);
 		}
 
 		UE_LOG(LogRootMotion, Warning, TEXT("Dumping local RootMotionSources:"));
@@ -11108,6 +12539,7 @@ FNetworkPredictionData_Client_Character::FNetworkPredictionData_Client_Character
 	, MaxClientSmoothingDeltaTime(0.5f)
 	, SmoothingServerTimeStamp(0.f)
 	, SmoothingClientTimeStamp(0.f)
+	, SnapshotInterpolationDelay(0.f)
 	, MaxSmoothNetUpdateDist(0.f)
 	, NoSmoothNetUpdateDist(0.f)
 	, SmoothNetUpdateTime(0.f)
@@ -11118,12 +12550,19 @@ FNetworkPredictionData_Client_Character::FNetworkPredictionData_Client_Character
 	, SimulatedDebugDrawTime(0.0f)
 	, DebugForcedPacketLossTimerStart(0.0f)
 {
-	MaxSmoothNetUpdateDist = ClientMovement.NetworkMaxSmoothUpdateDistance;
-	NoSmoothNetUpdateDist = ClientMovement.NetworkNoSmoothUpdateDistance;
+	MaxSmoothNetUpdateDist = ClientMovement.GetMovementSetting(EBaseCharacterMovementSetting::NetworkMaxSmoothUpdateDistance);
+	NoSmoothNetUpdateDist = ClientMovement.GetMovementSetting(EBaseCharacterMovementSetting::NetworkNoSmoothUpdateDistance);
 
 	const bool bIsListenServer = (ClientMovement.GetNetMode() == NM_ListenServer);
-	SmoothNetUpdateTime = (bIsListenServer ? ClientMovement.ListenServerNetworkSimulatedSmoothLocationTime : ClientMovement.NetworkSimulatedSmoothLocationTime);
-	SmoothNetUpdateRotationTime = (bIsListenServer ? ClientMovement.ListenServerNetworkSimulatedSmoothRotationTime : ClientMovement.NetworkSimulatedSmoothRotationTime);
+	SmoothNetUpdateTime = ClientMovement.GetMovementSetting(bIsListenServer ? EBaseCharacterMovementSetting::ListenServerNetworkSimulatedSmoothLocationTime : EBaseCharacterMovementSetting::NetworkSimulatedSmoothLocationTime);
+	SmoothNetUpdateRotationTime = ClientMovement.GetMovementSetting(bIsListenServer ? EBaseCharacterMovementSetting::ListenServerNetworkSimulatedSmoothRotationTime : EBaseCharacterMovementSetting::NetworkSimulatedSmoothRotationTime);
+	SnapshotInterpolationDelay = ClientMovement.GetMovementSetting(EBaseCharacterMovementSetting::NetworkSnapshotInterpolationDelay);
+
+	// Keep every update received within the interpolation delay, plus the one before the render time and one for jitter.
+	if (const AActor* Owner = ClientMovement.GetOwner())
+	{
+		SmoothingSnapshots.SetCapacity(FMath::CeilToInt(SnapshotInterpolationDelay * FMath::Max(Owner->NetUpdateFrequency, 1.f)) + 2);
+	}
 
 	const AGameNetworkManager* GameNetworkManager = (const AGameNetworkManager*)(AGameNetworkManager::StaticClass()->GetDefaultObject());
 	if (GameNetworkManager)
@@ -11154,7 +12593,7 @@ void FNetworkPredictionData_Client_Character::AddStructReferencedObjects(FRefere
 {
 	Super::AddStructReferencedObjects(Collector);
 
-	for (FSavedMovePtr SavedMove : SavedMoves)
+	for (const FSavedMovePtr& SavedMove : SavedMoves)
 	{
 		if (const FSavedMove_Character* SavedMovePtr = SavedMove.Get())
 		{
@@ -11265,13 +12704,13 @@ void FNetworkPredictionData_Client_Character::AckMove(int32 AckedMoveIndex, UBas
 	if( AckedMoveIndex != INDEX_NONE )
 	{
 		// Keep reference to LastAckedMove
-		const FSavedMovePtr& AckedMove = SavedMoves[AckedMoveIndex];
+		FSavedMovePtr& AckedMove = SavedMoves[AckedMoveIndex];
 		UE_LOG(LogNetPlayerMovement, VeryVerbose, TEXT("AckedMove Index: %2d (%2d moves). TimeStamp: %f, CurrentTimeStamp: %f"), AckedMoveIndex, SavedMoves.Num(), AckedMove->TimeStamp, CurrentTimeStamp);
 		if( LastAckedMove.IsValid() )
 		{
 			FreeMove(LastAckedMove);
 		}
-		LastAckedMove = AckedMove;
+		LastAckedMove = MoveTemp(AckedMove);
 
 		// Free expired moves.
 		for(int32 MoveIndex=0; MoveIndex<AckedMoveIndex; MoveIndex++)
@@ -11280,9 +12719,8 @@ void FNetworkPredictionData_Client_Character::AckMove(int32 AckedMoveIndex, UBas
 			FreeMove(Move);
 		}
 
-		// And finally cull all of those, so only the unacknowledged moves remain in SavedMoves.
-		const bool bAllowShrinking = false;
-		SavedMoves.RemoveAt(0, AckedMoveIndex + 1, bAllowShrinking);
+		// And finally cull all of those, so only the unacknowledged moves remain in SavedMoves. This only advances the head of the buffer.
+		SavedMoves.PopFront(AckedMoveIndex + 1);
 	}
 
 	if (const UWorld* const World = CharacterMovementComponent.GetWorld())
@@ -11401,6 +12839,8 @@ void FSavedMove_Character::Clear()
 	StartAttachSocketName = NAME_None;
 	StartAttachRelativeLocation = FVector::ZeroVector;
 	StartAttachRelativeRotation = FRotator::ZeroRotator;
+	StartGravityDirection = UBaseCharacterMovementComponent::DefaultGravityDirection;
+	StartGravityFieldId = 0;
 
 	SavedLocation = FVector::ZeroVector;
 	SavedRotation = FRotator::ZeroRotator;
@@ -11422,6 +12862,8 @@ void FSavedMove_Character::Clear()
 	EndAttachSocketName = NAME_None;
 	EndAttachRelativeLocation = FVector::ZeroVector;
 	EndAttachRelativeRotation = FRotator::ZeroRotator;
+	EndGravityDirection = UBaseCharacterMovementComponent::DefaultGravityDirection;
+	EndGravityFieldId = 0;
 
 	RootMotionMontage = NULL;
 	RootMotionTrackPosition = 0.f;
@@ -11514,6 +12956,10 @@ void FSavedMove_Character::SetInitialPosition(ABaseCharacter* Character)
 	StartControlRotation = Character->GetControlRotation().Clamp();
 	Character->GetCapsuleComponent()->GetScaledCapsuleSize(StartCapsuleRadius, StartCapsuleHalfHeight);
 
+	// Gravity state
+	StartGravityDirection = Character->GetCharacterMovement()->GetGravityDirection();
+	StartGravityFieldId = Character->GetCharacterMovement()->GetGravityFieldId();
+
 	// Jump state
 	bPressedJump = Character->bPressedJump;
 	bWasJumping = Character->bWasJumping;
@@ -11527,6 +12973,8 @@ void FSavedMove_Character::PostUpdate(ABaseCharacter* Character, FSavedMove_Char
 	// Common code for both recording and after a replay.
 	{
 		EndPackedMovementMode = Character->GetCharacterMovement()->PackNetworkMovementMode();
+		EndGravityDirection = Character->GetCharacterMovement()->GetGravityDirection();
+		EndGravityFieldId = Character->GetCharacterMovement()->GetGravityFieldId();
 		SavedLocation = Character->GetActorLocation();
 		SavedRotation = Character->GetActorRotation();
 		SavedVelocity = Character->GetVelocity();
@@ -11629,6 +13077,12 @@ void FSavedMove_Character::PostUpdate(ABaseCharacter* Character, FSavedMove_Char
 		{
 			bForceNoCombine = true;
 		}
+
+		// Don't combine or delay moves where gravity flipped or the character entered another gravity field.
+		if (!IsMatchingGravity(StartGravityDirection, StartGravityFieldId, EndGravityDirection, EndGravityFieldId))
+		{
+			bForceNoCombine = true;
+		}
 	}
 	else if (PostUpdateMode == PostUpdate_Replay)
 	{
@@ -11661,6 +13115,11 @@ bool FSavedMove_Character::IsImportantMove(const FSavedMovePtr& LastAckedMovePtr
 		return true;
 	}
 
+	if (!LastAckedMove->IsMatchingGravity(EndGravityDirection, EndGravityFieldId))
+	{
+		return true;
+	}
+
 	// check if acceleration has changed significantly
 	if (Acceleration != LastAckedMove->Acceleration)
 	{
@@ -11734,12 +13193,40 @@ float UBaseCharacterMovementComponent::GetClientNetSendDeltaTime(const APlayerCo
 		if (Acceleration.IsZero() && Velocity.IsZero() && ClientData->LastAckedMove.IsValid() && ClientData->LastAckedMove->IsMatchingStartControlRotation(PC))
 		{
 			NetMoveDelta = FMath::Max(GameNetworkManager->ClientNetSendMoveDeltaTimeStationary, NetMoveDelta);
+
+			// Lower it further when nothing the server could disagree with changed since the last acked move: same gravity, and the same base, which is not moving.
+			const FSavedMove_Character& LastAckedMove = *ClientData->LastAckedMove;
+			const UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+			if (BaseCharacterMovementCVars::NetIdleSendMoveDeltaTime > 0.f
+				&& LastAckedMove.IsMatchingGravity(GravityDirection, GravityFieldId)
+				&& LastAckedMove.EndBase.Get() == MovementBase
+				&& !MovementBaseUtility::IsDynamicBase(MovementBase))
+			{
+				const float MaxIdleDelta = 0.8f * GameNetworkManager->MAXCLIENTUPDATEINTERVAL;
+				NetMoveDelta = FMath::Max(FMath::Min(BaseCharacterMovementCVars::NetIdleSendMoveDeltaTime, MaxIdleDelta), NetMoveDelta);
+			}
 		}
 	}
 	
 	return NetMoveDelta;
 }
 
+bool FSavedMove_Character::IsMatchingGravity(const FVector& OtherGravityDirection, uint32 OtherGravityFieldId) const
+{
+	return IsMatchingGravity(EndGravityDirection, EndGravityFieldId, OtherGravityDirection, OtherGravityFieldId);
+}
+
+bool FSavedMove_Character::IsMatchingGravity(const FVector& GravityDirectionA, uint32 GravityFieldIdA, const FVector& GravityDirectionB, uint32 GravityFieldIdB)
+{
+	if (GravityFieldIdA != GravityFieldIdB)
+	{
+		return false;
+	}
+
+	const float CosTolerance = FMath::Cos(FMath::DegreesToRadians(FMath::Max(0.f, BaseCharacterMovementCVars::NetMoveCombiningGravityTolerance)));
+	return (GravityDirectionA | GravityDirectionB) >= CosTolerance;
+}
+
 bool FSavedMove_Character::IsMatchingStartControlRotation(const APlayerController* PC) const
 {
 	return PC ? StartControlRotation.Equals(PC->GetControlRotation(), BaseCharacterMovementCVars::NetStationaryRotationTolerance) : false;
@@ -11869,6 +13356,13 @@ bool FSavedMove_Character::CanCombineWith(const FSavedMovePtr& NewMovePtr, ABase
 		return false;
 	}
 
+	// The combined move is replayed from our start, it must run under the same gravity as both moves did.
+	if (StartGravityFieldId != NewMove->StartGravityFieldId || !IsMatchingGravity(NewMove->StartGravityDirection, NewMove->StartGravityFieldId)
+		|| !NewMove->IsMatchingGravity(StartGravityDirection, StartGravityFieldId))
+	{
+		return false;
+	}
+
 	if (StartCapsuleRadius != NewMove->StartCapsuleRadius)
 	{
 		return false;
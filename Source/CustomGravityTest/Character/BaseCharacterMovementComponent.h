@@ -20,6 +20,8 @@
 #include "BaseCharacterMovementReplication.h"
 #include "Interfaces/NetworkPredictionInterface.h"
 #include "BaseCharacterMovementComponentCommon.h"
+#include "BaseCharacterGravitySpace.h"
+#include "BaseCharacterMovementSettings.h"
 #include "BaseCharacterMovementComponent.generated.h"
 
 class ABaseCharacter;
@@ -29,6 +31,8 @@ class FSavedMove_Character;
 class UPrimitiveComponent;
 class INavigationData;
 class UBaseCharacterMovementComponent;
+struct FBaseCharacterAvoidanceAgent;
+struct FBaseCharacterReplayTranslation;
 
 DECLARE_DELEGATE_RetVal_ThreeParams(FTransform, FOnProcessRootMotion, const FTransform&, UBaseCharacterMovementComponent*, float)
 
@@ -152,10 +156,6 @@ public:
 	UPROPERTY(Category="Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite)
 	float GravityScale;
 
-	/** Maximum height character can step up */
-	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0", ForceUnits="cm"))
-	float MaxStepHeight;
-
 	/** Initial velocity (instantaneous vertical acceleration) when jumping. */
 	UPROPERTY(Category="Character Movement: Jumping / Falling", EditAnywhere, BlueprintReadWrite, meta=(DisplayName="Jump Z Velocity", ClampMin="0", UIMin="0", ForceUnits="cm/s"))
 	float JumpZVelocity;
@@ -205,6 +205,52 @@ private:
 
 	/** Whether the character has custom local gravity set. Cached in SetGravityDirection(). */
 	bool bHasCustomGravity;
+
+	/** Which specialization of the gravity space conversions the movement hot paths use. Cached in SetGravityDirection(). */
+	EBaseGravitySpace GravitySpaceMode;
+
+	/** Identifier of the gravity field GravityDirection comes from, 0 if none. @see SetGravityFieldId() */
+	uint32 GravityFieldId;
+
+	/** Component of the gravity field GravityDirection comes from, if its direction is constant in its frame. @see SetGravityFieldComponent() */
+	TWeakObjectPtr<const USceneComponent> GravityFieldComponent;
+
+	/** Same rotations as WorldToGravityTransform and GravityToWorldTransform as axis permutations. Only valid when GravitySpaceMode is AxisAligned. */
+	FBaseGravityAxisPermutation GravityToWorldAxes;
+	FBaseGravityAxisPermutation WorldToGravityAxes;
+
+	/** Last floor found by FindFloor(), reused while the capsule, gravity and base stay the same. Opt-in, see bFloorCacheIgnoresAlwaysCheckFloor and cg.FloorCache */
+	FBaseFloorCache FloorCache;
+
+	/** Pending asynchronous floor sweep issued by RequestAsyncFloorCheck(), and the gravity it was issued with. */
+	FTraceHandle AsyncFloorTraceHandle;
+	FVector AsyncFloorTraceGravityDirection;
+
+	/** Floor sweep run by the movement manager ahead of this frame's update. @see GetFloorProbeRequest() */
+	FBaseFloorProbe PrefetchedFloorProbe;
+
+	/** Whether BeginPlay() registered this component with UBaseCharacterMovementManager. */
+	bool bRegisteredWithMovementManager;
+
+	/** Client moves received since the last ProcessQueuedServerMoves(), still packed. @see bBatchServerMoves */
+	TArray<FBaseCharacterServerMovePackedBits> QueuedServerMoves;
+
+	/** Index of this component in the avoidance hash of UBaseCharacterMovementManager this frame, INDEX_NONE if not in it. */
+	int32 AvoidanceHashIndex;
+
+	/** Level of detail of the simulated proxy update. @see SetSimulatedProxyLOD() */
+	EBaseSimulatedProxyLOD SimulatedProxyLOD;
+
+	/** Time accumulated since smoothing last ran at EBaseSimulatedProxyLOD::Interpolate. */
+	float SimulatedProxyLODSmoothingTime;
+
+	/** Operations counted since the last tick. Mutable so const queries such as ComputeFloorDist() can count themselves. @see FlushMovementCounters() */
+	mutable FBaseCharacterMovementCounters MovementCounters;
+
+	/** Counters and tick time reported by the last FlushMovementCounters(), and the frame it ran on. */
+	FBaseCharacterMovementCounters LastMovementCounters;
+	uint64 LastMovementCountersCycles;
+	uint64 LastMovementCountersFrame;
 public:
 	
 	/**
@@ -243,84 +289,6 @@ public:
 	/** Saved location of object we are standing on, for UpdateBasedMovement() to determine if base moved in the last frame, and therefore pawn needs an update. */
 	FVector OldBaseLocation;
 
-	/** The maximum ground speed when walking. Also determines maximum lateral speed when falling. */
-	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
-	float MaxWalkSpeed;
-
-	/** The maximum ground speed when walking and crouched. */
-	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
-	float MaxWalkSpeedCrouched;
-
-	/** The maximum swimming speed. */
-	UPROPERTY(Category="Character Movement: Swimming", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
-	float MaxSwimSpeed;
-
-	/** The maximum flying speed. */
-	UPROPERTY(Category="Character Movement: Flying", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
-	float MaxFlySpeed;
-
-	/** Max Acceleration (rate of change of velocity) */
-	UPROPERTY(Category="Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0"))
-	float MaxAcceleration;
-
-	/** The ground speed that we should accelerate up to when walking at minimum analog stick tilt */
-	UPROPERTY(Category = "Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0", ForceUnits="cm/s"))
-	float MinAnalogWalkSpeed;
-
-	/**
-	 * Factor used to multiply actual value of friction used when braking.
-	 * This applies to any friction value that is currently used, which may depend on bUseSeparateBrakingFriction.
-	 * @note This is 2 by default for historical reasons, a value of 1 gives the true drag equation.
-	 * @see bUseSeparateBrakingFriction, GroundFriction, BrakingFriction
-	 */
-	UPROPERTY(Category="Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0"))
-	float BrakingFrictionFactor;
-
-	/**
-	 * Friction (drag) coefficient applied when braking (whenever Acceleration = 0, or if character is exceeding max speed); actual value used is this multiplied by BrakingFrictionFactor.
-	 * When braking, this property allows you to control how much friction is applied when moving across the ground, applying an opposing force that scales with current velocity.
-	 * Braking is composed of friction (velocity-dependent drag) and constant deceleration.
-	 * This is the current value, used in all movement modes; if this is not desired, override it or bUseSeparateBrakingFriction when movement mode changes.
-	 * @note Only used if bUseSeparateBrakingFriction setting is true, otherwise current friction such as GroundFriction is used.
-	 * @see bUseSeparateBrakingFriction, BrakingFrictionFactor, GroundFriction, BrakingDecelerationWalking
-	 */
-	UPROPERTY(Category="Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0", EditCondition="bUseSeparateBrakingFriction"))
-	float BrakingFriction;
-
-	/**
-	 * Time substepping when applying braking friction. Smaller time steps increase accuracy at the slight cost of performance, especially if there are large frame times.
-	 */
-	UPROPERTY(Category="Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ClampMin="0.0166", ClampMax="0.05", UIMin="0.0166", UIMax="0.05"))
-	float BrakingSubStepTime;
-
-	/**
-	 * Deceleration when walking and not applying acceleration. This is a constant opposing force that directly lowers velocity by a constant value.
-	 * @see GroundFriction, MaxAcceleration
-	 */
-	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0"))
-	float BrakingDecelerationWalking;
-
-	/**
-	 * Lateral deceleration when falling and not applying acceleration.
-	 * @see MaxAcceleration
-	 */
-	UPROPERTY(Category="Character Movement: Jumping / Falling", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0"))
-	float BrakingDecelerationFalling;
-
-	/**
-	 * Deceleration when swimming and not applying acceleration.
-	 * @see MaxAcceleration
-	 */
-	UPROPERTY(Category="Character Movement: Swimming", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0"))
-	float BrakingDecelerationSwimming;
-
-	/**
-	 * Deceleration when flying and not applying acceleration.
-	 * @see MaxAcceleration
-	 */
-	UPROPERTY(Category="Character Movement: Flying", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0"))
-	float BrakingDecelerationFlying;
-
 	/**
 	 * When falling, amount of lateral movement control available to the character.
 	 * 0 = no control, 1 = full control at max speed of MaxWalkSpeed.
@@ -597,6 +565,94 @@ public:
 
 	UPROPERTY()
 	float UpperImpactNormalScale_DEPRECATED;
+
+	/** Tuning that moved to UBaseCharacterMovementSettings, loaded from older assets and turned into MovementSettingOverrides in PostLoad(). Negative when not set. */
+	UPROPERTY()
+	float MaxStepHeight_DEPRECATED;
+
+	UPROPERTY()
+	float MaxWalkSpeed_DEPRECATED;
+
+	UPROPERTY()
+	float MaxWalkSpeedCrouched_DEPRECATED;
+
+	UPROPERTY()
+	float MaxSwimSpeed_DEPRECATED;
+
+	UPROPERTY()
+	float MaxFlySpeed_DEPRECATED;
+
+	UPROPERTY()
+	float MaxAcceleration_DEPRECATED;
+
+	UPROPERTY()
+	float MinAnalogWalkSpeed_DEPRECATED;
+
+	UPROPERTY()
+	float BrakingFrictionFactor_DEPRECATED;
+
+	UPROPERTY()
+	float BrakingFriction_DEPRECATED;
+
+	UPROPERTY()
+	float BrakingSubStepTime_DEPRECATED;
+
+	UPROPERTY()
+	float BrakingDecelerationWalking_DEPRECATED;
+
+	UPROPERTY()
+	float BrakingDecelerationFalling_DEPRECATED;
+
+	UPROPERTY()
+	float BrakingDecelerationSwimming_DEPRECATED;
+
+	UPROPERTY()
+	float BrakingDecelerationFlying_DEPRECATED;
+
+	UPROPERTY()
+	float AvoidanceConsiderationRadius_DEPRECATED;
+
+	UPROPERTY()
+	float AvoidanceWeight_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkSimulatedSmoothLocationTime_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkSimulatedSmoothRotationTime_DEPRECATED;
+
+	UPROPERTY()
+	float ListenServerNetworkSimulatedSmoothLocationTime_DEPRECATED;
+
+	UPROPERTY()
+	float ListenServerNetworkSimulatedSmoothRotationTime_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkSnapshotInterpolationDelay_DEPRECATED;
+
+	UPROPERTY()
+	float NetProxyShrinkRadius_DEPRECATED;
+
+	UPROPERTY()
+	float NetProxyShrinkHalfHeight_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkMaxSmoothUpdateDistance_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkNoSmoothUpdateDistance_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkMinTimeBetweenClientAckGoodMoves_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkMinTimeBetweenClientAdjustments_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkMinTimeBetweenClientAdjustmentsLargeCorrection_DEPRECATED;
+
+	UPROPERTY()
+	float NetworkLargeClientCorrectionDistance_DEPRECATED;
 #endif
 
 protected:
@@ -630,11 +686,11 @@ protected:
 	UPROPERTY(Transient)
 	float ServerLastTransformUpdateTimeStamp;
 
-	/** Timestamp of last client adjustment sent. See NetworkMinTimeBetweenClientAdjustments. */
+	/** Timestamp of last client adjustment sent. See UBaseCharacterMovementSettings::NetworkMinTimeBetweenClientAdjustments. */
 	UPROPERTY(Transient)
 	float ServerLastClientGoodMoveAckTime;
 
-	/** Timestamp of last client adjustment sent. See NetworkMinTimeBetweenClientAdjustments. */
+	/** Timestamp of last client adjustment sent. See UBaseCharacterMovementSettings::NetworkMinTimeBetweenClientAdjustments. */
 	UPROPERTY(Transient)
 	float ServerLastClientAdjustmentTime;
 
@@ -759,82 +815,39 @@ public:
 	float MaxDepenetrationWithPawnAsProxy;
 
 	/**
-	 * How long to take to smoothly interpolate from the old pawn position on the client to the corrected one sent by the server. Not used by Linear smoothing.
+	 * Movement, avoidance and network tuning. Identical for every character of a class, so shared through an asset rather than stored per component.
+	 * Uses the defaults of UBaseCharacterMovementSettings when not set. @see GetMovementSetting()
 	 */
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
-	float NetworkSimulatedSmoothLocationTime;
+	UPROPERTY(Category="Character Movement (General Settings)", EditDefaultsOnly)
+	TObjectPtr<UBaseCharacterMovementSettings> MovementSettings;
 
-	/**
-	 * How long to take to smoothly interpolate from the old pawn rotation on the client to the corrected one sent by the server. Not used by Linear smoothing.
-	 */
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
-	float NetworkSimulatedSmoothRotationTime;
-
-	/**
-	* Similar setting as NetworkSimulatedSmoothLocationTime but only used on Listen servers.
-	*/
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
-	float ListenServerNetworkSimulatedSmoothLocationTime;
-
-	/**
-	* Similar setting as NetworkSimulatedSmoothRotationTime but only used on Listen servers.
-	*/
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
-	float ListenServerNetworkSimulatedSmoothRotationTime;
-
-	/**
-	 * Shrink simulated proxy capsule radius by this amount, to account for network rounding that may cause encroachment. Changing during gameplay is not supported.
-	 * @see AdjustProxyCapsuleSize()
-	 */
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
-	float NetProxyShrinkRadius;
+	/** Returns the shared tuning of this component, never null. It ignores the overrides of this component, read values with GetMovementSetting(). */
+	const UBaseCharacterMovementSettings& GetMovementSettings() const { return MovementSettings ? *MovementSettings : *GetDefault<UBaseCharacterMovementSettings>(); }
 
 	/**
-	 * Shrink simulated proxy capsule half height by this amount, to account for network rounding that may cause encroachment. Changing during gameplay is not supported.
-	 * @see AdjustProxyCapsuleSize()
+	 * Returns the value of a setting for this component: its override if it has one, otherwise the value of MovementSettings.
+	 * Components usually override few settings, if any, so this only scans a short array before the shared asset.
 	 */
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
-	float NetProxyShrinkHalfHeight;
+	UFUNCTION(BlueprintPure, Category="Pawn|Components|CharacterMovement")
+	float GetMovementSetting(EBaseCharacterMovementSetting Setting) const;
 
-	/** Maximum distance character is allowed to lag behind server location when interpolating between updates. */
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
-	float NetworkMaxSmoothUpdateDistance;
-
-	/**
-	 * Maximum distance beyond which character is teleported to the new server location without any smoothing.
-	 */
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
-	float NetworkNoSmoothUpdateDistance;
+	/** Overrides a setting of MovementSettings for this component only, for instance to change the walk speed at runtime. */
+	UFUNCTION(BlueprintCallable, Category="Pawn|Components|CharacterMovement")
+	void SetMovementSetting(EBaseCharacterMovementSetting Setting, float Value);
 
-	/**
-	 * Minimum time on the server between acknowledging good client moves. This can save on bandwidth. Set to 0 to disable throttling.
-	 */
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=s))
-	float NetworkMinTimeBetweenClientAckGoodMoves;
+	/** Removes the override of a setting, this component uses the value of MovementSettings again. */
+	UFUNCTION(BlueprintCallable, Category="Pawn|Components|CharacterMovement")
+	void ResetMovementSetting(EBaseCharacterMovementSetting Setting);
 
+protected:
 	/**
-	 * Minimum time on the server between sending client adjustments when client has exceeded allowable position error.
-	 * Should be >= NetworkMinTimeBetweenClientAdjustmentsLargeCorrection (the larger value is used regardless).
-  	 * This can save on bandwidth. Set to 0 to disable throttling.
-	 * @see ServerLastClientAdjustmentTime
+	 * Settings this component uses instead of the ones of MovementSettings, at most one per setting. Kept as a short list of
+	 * differences so characters sharing an asset store none of its values. @see SetMovementSetting()
 	 */
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=s))
-	float NetworkMinTimeBetweenClientAdjustments;
-
-	/**
-	* Minimum time on the server between sending client adjustments when client has exceeded allowable position error by a large amount (NetworkLargeClientCorrectionDistance).
-	* Should be <= NetworkMinTimeBetweenClientAdjustments (the smaller value is used regardless).
-	* @see NetworkMinTimeBetweenClientAdjustments
-	*/
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=s))
-	float NetworkMinTimeBetweenClientAdjustmentsLargeCorrection;
+	UPROPERTY(Category="Character Movement (General Settings)", EditAnywhere, AdvancedDisplay)
+	TArray<FBaseCharacterMovementSettingOverride> MovementSettingOverrides;
 
-	/**
-	* If client error is larger than this, sets bNetworkLargeClientCorrection to reduce delay between client adjustments.
-	* @see NetworkMinTimeBetweenClientAdjustments, NetworkMinTimeBetweenClientAdjustmentsLargeCorrection
-	*/
-	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
-	float NetworkLargeClientCorrectionDistance;
+public:
 
 	/** Used in determining if pawn is going off ledge.  If the ledge is "shorter" than this value then the pawn will be able to walk off it. **/
 	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ForceUnits=cm))
@@ -982,10 +995,62 @@ public:
 	 * Whether we always force floor checks for stationary Characters while walking.
 	 * Normally floor checks are avoided if possible when not moving, but this can be used to force them if there are use-cases where they are being skipped erroneously
 	 * (such as objects moving up into the character from below).
+	 * The floor cache (cg.FloorCache) is not used when this is set, unless bFloorCacheIgnoresAlwaysCheckFloor is. As this is set by default, the cache is opt-in.
 	 */
 	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
 	uint8 bAlwaysCheckFloor:1;
 
+	/**
+	 * If true, the floor cache (cg.FloorCache) is used even when bAlwaysCheckFloor is set. False by default, so the cache only applies to
+	 * components that opt in here or clear bAlwaysCheckFloor. It never applies to forced floor checks (bForceNextFloorCheck), which includes
+	 * the checks after gravity transitions, nor right after teleports.
+	 * The cache only notices the movement base and the floor itself moving: only enable where no other object can move up into, or spawn under, the character.
+	 */
+	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
+	uint8 bFloorCacheIgnoresAlwaysCheckFloor:1;
+
+	/**
+	 * If true, AI and simulated characters sweep for the floor of their next walking update asynchronously, along gravity, and use the result one frame later.
+	 * Trades one frame of floor latency for fewer blocking sweeps on the game thread. Player controlled autonomous and authoritative characters always check synchronously.
+	 * @see ShouldUseAsyncFloorChecks()
+	 */
+	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
+	uint8 bUseAsyncFloorChecks:1;
+
+	/**
+	 * If true, this component registers with UBaseCharacterMovementManager, which runs the scene queries of AI and simulated characters in parallel batches
+	 * before they tick. Player controlled autonomous and authoritative characters are skipped. Only read in BeginPlay.
+	 * @see ShouldUseMovementManager()
+	 */
+	UPROPERTY(Category="Character Movement (General Settings)", EditDefaultsOnly, BlueprintReadOnly, AdvancedDisplay)
+	uint8 bUseMovementManager:1;
+
+	/**
+	 * If true, the server queues the moves it receives from the owning client instead of running them on arrival, and UBaseCharacterMovementManager
+	 * runs the queue of every such character once per frame, in a stable order, before any character ticks. Only read in BeginPlay.
+	 * @see ShouldBatchServerMoves(), cg.BatchServerMoves
+	 */
+	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, BlueprintReadOnly, AdvancedDisplay)
+	uint8 bBatchServerMoves:1;
+
+	/**
+	 * If true, UBaseCharacterMovementManager picks the level of detail of this character's updates while it is a simulated proxy,
+	 * from its distance to the local viewers, whether it was rendered recently and its gravity. Only read in BeginPlay.
+	 * @see SetSimulatedProxyLOD(), cg.SimulatedProxyLOD
+	 */
+	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, BlueprintReadOnly, AdvancedDisplay)
+	uint8 bUseSimulatedProxyLOD:1;
+
+	/**
+	 * If true and NetworkSmoothingMode is Linear, simulated proxies keep the last few server updates and display the character
+	 * UBaseCharacterMovementSettings::NetworkSnapshotInterpolationDelay behind the newest one, interpolating between the two updates around that time.
+	 * Location is interpolated relative to the movement base and rotation relative to the gravity direction, which is interpolated as well,
+	 * so characters walking over gravity changes do not snap. Lets simulated proxies replicate at a lower rate.
+	 * @see UBaseCharacterMovementSettings::NetworkSnapshotInterpolationDelay, cg.NetSnapshotInterpolation
+	 */
+	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, BlueprintReadOnly, AdvancedDisplay)
+	uint8 bUseSnapshotInterpolation:1;
+
 	/**
 	 * Performs floor checks as if the character is using a shape with a flat base.
 	 * This avoids the situation where characters slowly lower off the side of a ledge (as their capsule 'balances' on the edge).
@@ -1073,9 +1138,6 @@ public:
 	/** Returns if the character rotation should be corrected on clients when sending a server move response correction. */
 	virtual bool ShouldCorrectRotation() const { return false; }
 
-	UPROPERTY(Category="Character Movement: Avoidance", EditAnywhere, BlueprintReadOnly, meta=(ForceUnits=cm))
-	float AvoidanceConsiderationRadius;
-
 	/**
 	 * Velocity requested by path following.
 	 * @see RequestDirectMove()
@@ -1128,10 +1190,6 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|CharacterMovement")
 	void SetGroupsToIgnoreMask(const FNavAvoidanceMask& GroupMask);
 
-	/** De facto default value 0.5 (due to that being the default in the avoidance registration function), indicates RVO behavior. */
-	UPROPERTY(Category="Character Movement: Avoidance", EditAnywhere, BlueprintReadOnly)
-	float AvoidanceWeight;
-
 	/** Temporarily holds launch velocity when pawn is to be launched so it happens at end of movement. */
 	UPROPERTY()
 	FVector PendingLaunchVelocity;
@@ -1139,6 +1197,10 @@ public:
 	/** last known location projected on navmesh, used by NavWalking mode */
 	FNavLocation CachedNavLocation;
 
+	/** Gravity field and direction CachedNavLocation was projected with, it is only reused on the same gravity face. */
+	uint32 CachedNavLocationFieldId = 0;
+	FVector CachedNavLocationGravityDirection = FVector::ZeroVector;
+
 	/** Last valid projected hit result from raycast to geometry from navmesh */
 	FHitResult CachedProjectedNavMeshHitResult;
 
@@ -1249,6 +1311,7 @@ public:
 	virtual void OnRegister() override;
 	virtual void BeginDestroy() override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void PostLoad() override;
 	virtual void Deactivate() override;
 	virtual void RegisterComponentTickFunctions(bool bRegister) override;
@@ -1603,6 +1666,32 @@ public:
 	/** Returns the current gravity direction. */
 	FVector GetGravityDirection() const { return GravityDirection; }
 
+	/** Returns the bottom of the capsule along the gravity direction. Same as GetActorFeetLocation() for default gravity. */
+	FVector GetGravityFeetLocation() const;
+
+	/**
+	 * Set the identifier of the gravity field driving the gravity direction, 0 for none.
+	 * Only used by client moves, which are not combined across a change of field, and not replicated.
+	 */
+	void SetGravityFieldId(uint32 InGravityFieldId) { GravityFieldId = InGravityFieldId; }
+
+	/** Returns the identifier of the gravity field driving the gravity direction. @see SetGravityFieldId() */
+	uint32 GetGravityFieldId() const { return GravityFieldId; }
+
+	/**
+	 * Set the component of the gravity field driving the gravity direction, null for none. Only set it for fields whose direction is constant
+	 * in the frame of the component, such as gravity boxes. When it moves along with the movement base, gravity follows the base. @see ShouldGravityFollowBase()
+	 */
+	void SetGravityFieldComponent(const USceneComponent* InGravityFieldComponent) { GravityFieldComponent = InGravityFieldComponent; }
+
+	/**
+	 * Returns true if the gravity field is attached to the same actor as a dynamic movement base. UpdateBasedMovement() then rotates
+	 * the gravity direction with the base, in the same step as the character, so client and server agree on gravity at every move
+	 * instead of sampling the field at different times. Only exact for fields with a constant direction in their own frame: in a field whose
+	 * direction depends on the location, walking on the base changes gravity, so those fields should not be set with SetGravityFieldComponent().
+	 */
+	bool ShouldGravityFollowBase() const;
+
 	/** Returns a quaternion transforming from world to gravity space. */
 	FQuat GetWorldToGravityTransform() const { return WorldToGravityTransform; }
 
@@ -1610,10 +1699,63 @@ public:
 	FQuat GetGravityToWorldTransform() const { return GravityToWorldTransform; }
 
 	/** Rotate a vector from world to gravity space. */
-	FVector RotateGravityToWorld(const FVector& World) const { return WorldToGravityTransform.RotateVector(World); }
+	FVector RotateGravityToWorld(const FVector& World) const
+	{
+		switch (GravitySpaceMode)
+		{
+		case EBaseGravitySpace::Default:		return World;
+		case EBaseGravitySpace::AxisAligned:	return GravityToWorldAxes.Apply(World);
+		default:								return WorldToGravityTransform.RotateVector(World);
+		}
+	}
 
 	/** Rotate a vector gravity to world space. */
-	FVector RotateWorldToGravity(const FVector& Gravity) const { return GravityToWorldTransform.RotateVector(Gravity); }
+	FVector RotateWorldToGravity(const FVector& Gravity) const
+	{
+		switch (GravitySpaceMode)
+		{
+		case EBaseGravitySpace::Default:		return Gravity;
+		case EBaseGravitySpace::AxisAligned:	return WorldToGravityAxes.Apply(Gravity);
+		default:								return GravityToWorldTransform.RotateVector(Gravity);
+		}
+	}
+
+	/** Rotate a rotation from gravity to world space, such as a gravity relative control rotation. */
+	FQuat RotateGravityToWorld(const FQuat& GravityRelativeRotation) const
+	{
+		return bHasCustomGravity ? WorldToGravityTransform * GravityRelativeRotation : GravityRelativeRotation;
+	}
+
+	/** Rotate a rotation from world to gravity space. */
+	FQuat RotateWorldToGravity(const FQuat& WorldRotation) const
+	{
+		return bHasCustomGravity ? GravityToWorldTransform * WorldRotation : WorldRotation;
+	}
+
+	/** Returns the gravity space specialization currently in use. */
+	EBaseGravitySpace GetGravitySpaceMode() const { return GravitySpaceMode; }
+
+	/** Returns the gravity space conversions for a given specialization. Must match GetGravitySpaceMode(). */
+	template<EBaseGravitySpace Space>
+	TBaseGravitySpace<Space> MakeGravitySpace() const
+	{
+		checkSlow(Space == GravitySpaceMode);
+		// Note the cached transforms are named after the space they rotate from.
+		return TBaseGravitySpace<Space>(GravityDirection, WorldToGravityTransform, GravityToWorldTransform, GravityToWorldAxes, WorldToGravityAxes);
+	}
+
+private:
+	// Implementations of the movement hot paths specialized per gravity space. The virtual entry points dispatch
+	// on GravitySpaceMode once, so the conversions inside compile down to nothing for default gravity.
+	template<EBaseGravitySpace Space> void PhysFallingImpl(float deltaTime, int32 Iterations);
+	template<EBaseGravitySpace Space> FVector ComputeGroundMovementDeltaImpl(const FVector& Delta, const FHitResult& RampHit, const bool bHitFromLineTrace) const;
+	template<EBaseGravitySpace Space> float SlideAlongSurfaceImpl(const FVector& Delta, float Time, const FVector& InNormal, FHitResult& Hit, bool bHandleImpact);
+	template<EBaseGravitySpace Space> void TwoWallAdjustImpl(FVector& WorldSpaceDelta, const FHitResult& Hit, const FVector& OldHitNormal) const;
+	template<EBaseGravitySpace Space> void ComputeFloorDistImpl(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FBaseFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult) const;
+	template<EBaseGravitySpace Space> void PhysWalkingImpl(float deltaTime, int32 Iterations);
+	template<EBaseGravitySpace Space> void MoveAlongFloorImpl(const FVector& InVelocity, float DeltaSeconds, FBaseStepDownResult* OutStepDownResult);
+	template<EBaseGravitySpace Space> bool StepUpImpl(const FVector& GravDir, const FVector& Delta, const FHitResult& InHit, FBaseStepDownResult* OutStepDownResult);
+	template<EBaseGravitySpace Space> void MaintainHorizontalGroundVelocityImpl();
 
 protected:
 
@@ -1976,6 +2118,9 @@ public:
 	 */
 	virtual void FindFloor(const FVector& CapsuleLocation, FBaseFindFloorResult& OutFloorResult, bool bCanUseCachedLocation, const FHitResult* DownwardSweepResult = NULL) const;
 
+	/** Discards the floor result FindFloor() may reuse across frames, forcing the next floor check to query the world. */
+	void InvalidateFloorCache() { FloorCache.Invalidate(); }
+
 	/**
 	* Sweeps a vertical trace to find the floor for the capsule at the given location. Will attempt to perch if ShouldComputePerchResult() returns true for the downward sweep result.
 	* No floor will be found if collision is disabled on the capsule!
@@ -2001,6 +2146,114 @@ public:
 	 */
 	virtual void ComputeFloorDist(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FBaseFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult = NULL) const;
 
+protected:
+	/** Returns true and fills OutFloorResult if FloorCache holds a floor that is still valid for the capsule at the given location. */
+	bool TryReuseFloorCache(const FVector& CapsuleLocation, float HeightCheckAdjust, FBaseFindFloorResult& OutFloorResult) const;
+
+	/** Stores a floor result computed by FindFloor() in FloorCache. */
+	void UpdateFloorCache(const FVector& CapsuleLocation, float HeightCheckAdjust, const FBaseFindFloorResult& FloorResult) const;
+
+	/** Issues an asynchronous floor sweep from where the character is expected to be after its next walking update. */
+	virtual void RequestAsyncFloorCheck(float DeltaTime);
+
+	/** Computes the floor sweep issued ahead of a walking update, from where the current velocity takes the character in DeltaTime. */
+	bool GetFloorProbeSweep(float DeltaTime, FVector& OutStart, FVector& OutEnd, FCollisionShape& OutShape, FCollisionQueryParams& OutQueryParams, FCollisionResponseParams& OutResponseParam) const;
+
+	/**
+	 * Retrieves a floor sweep issued ahead of time, either prefetched by the movement manager or by the last RequestAsyncFloorCheck(),
+	 * if it finished, did not start penetrating and was issued close enough to CapsuleLocation: within cg.AsyncFloorCheckTolerance sideways,
+	 * and at the same height up to cg.AsyncFloorCheckHeightTolerance below. The hit is moved to CapsuleLocation so it can be used as the downward
+	 * sweep of ComputeFloorDist(), the synchronous sweep runs otherwise. Consumes the probe.
+	 */
+	bool ConsumeFloorProbe(const FVector& CapsuleLocation, FHitResult& OutHit) const;
+
+	/** Validates a floor sweep issued from ProbeStart for use at CapsuleLocation. @see ConsumeFloorProbe() */
+	bool AdoptFloorProbe(const FVector& CapsuleLocation, const FVector& ProbeStart, const FVector& ProbeGravityDirection, const FHitResult& ProbeHit, FHitResult& OutHit) const;
+
+	/** Returns true for simulated proxies and characters not controlled by a player. */
+	bool IsSimulatedOrAIControlled() const;
+
+public:
+	/** Returns true if floor checks should use the asynchronous one frame latency path. @see bUseAsyncFloorChecks */
+	virtual bool ShouldUseAsyncFloorChecks() const;
+
+	/** Returns true if UBaseCharacterMovementManager should process this component this frame. @see bUseMovementManager */
+	virtual bool ShouldUseMovementManager() const;
+
+	/** Returns true if client moves received on the server should be queued for UBaseCharacterMovementManager. @see bBatchServerMoves */
+	virtual bool ShouldBatchServerMoves() const;
+
+	/** Returns true if client moves are waiting in the server move queue. */
+	bool HasQueuedServerMoves() const { return QueuedServerMoves.Num() > 0; }
+
+	/** Unpacks and handles every queued client move, in the order they were received. Called by UBaseCharacterMovementManager. */
+	void ProcessQueuedServerMoves();
+
+	/** Returns true if UBaseCharacterMovementManager should pick the level of detail of this component. @see bUseSimulatedProxyLOD */
+	virtual bool ShouldUseSimulatedProxyLOD() const;
+
+	/**
+	 * Sets the level of detail of the movement update while this character is a simulated proxy.
+	 * Root motion is always simulated at full detail. Normally driven by UBaseCharacterMovementManager.
+	 */
+	void SetSimulatedProxyLOD(EBaseSimulatedProxyLOD InLOD);
+
+	/** Returns the level of detail of the movement update of this simulated proxy. */
+	EBaseSimulatedProxyLOD GetSimulatedProxyLOD() const { return SimulatedProxyLOD; }
+
+	/** Counts a gravity field lookup made on behalf of this character, for the movement counters. */
+	void CountGravityFieldLookup() const { ++MovementCounters.GravityFieldLookups; }
+
+	/** Returns the operations counted since the last tick. */
+	const FBaseCharacterMovementCounters& GetMovementCounters() const { return MovementCounters; }
+
+	/**
+	 * Returns the counters reported by the last tick, along with the time it took in cycles and its frame number (GFrameCounter).
+	 * @return False if the component never ticked.
+	 */
+	bool GetLastMovementCounters(FBaseCharacterMovementCounters& OutCounters, uint64& OutTickCycles, uint64& OutFrameNumber) const
+	{
+		OutCounters = LastMovementCounters;
+		OutTickCycles = LastMovementCountersCycles;
+		OutFrameNumber = LastMovementCountersFrame;
+		return LastMovementCountersFrame != 0;
+	}
+
+protected:
+	/**
+	 * Reports the movement counters of this tick to the BaseCharacterMovement trace channel and CSV category, then resets them.
+	 * Work done between two ticks, such as server moves and corrections, is reported with the next tick.
+	 * @param TickCycles	Time spent in TickComponent(), in cycles.
+	 */
+	void FlushMovementCounters(uint64 TickCycles);
+
+	//BEGIN UMovementComponent Interface
+	virtual bool MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit = nullptr, ETeleportType Teleport = ETeleportType::None) override;
+	//END UMovementComponent Interface
+
+public:
+
+	/**
+	 * Fills the floor sweep of this frame's walking update, from the predicted end location, so it can run ahead of time.
+	 * Called by UBaseCharacterMovementManager on the game thread, which runs the sweeps of every request on worker threads.
+	 * Clears the previous prefetched probe. Returns false if there is nothing to prefetch.
+	 */
+	bool GetFloorProbeRequest(float DeltaTime, FBaseFloorProbeRequest& OutRequest);
+
+	/** Stores the result of a sweep filled by GetFloorProbeRequest(), for FindFloor() to consume. Called on the game thread. */
+	void SetPrefetchedFloorProbe(const FBaseFloorProbeRequest& Request);
+
+	/**
+	 * Fills the avoidance state of this component for the avoidance hash of UBaseCharacterMovementManager.
+	 * Returns false if it does not take part in avoidance this frame.
+	 */
+	bool GetAvoidanceAgent(FBaseCharacterAvoidanceAgent& OutAgent) const;
+
+	/** Sets the index of this component in the avoidance hash, INDEX_NONE if not in it. Called by UBaseCharacterMovementManager. */
+	void SetAvoidanceHashIndex(int32 InAvoidanceHashIndex) { AvoidanceHashIndex = InAvoidanceHashIndex; }
+
+public:
+
 	/**
 	* Compute distance to the floor from bottom sphere of capsule and store the result in FloorResult.
 	* This distance is the swept distance of the capsule to the first point impacted by the lower hemisphere, or distance from the bottom of the capsule in the case of a line trace.
@@ -2147,6 +2400,12 @@ protected:
 	/** Simulate movement on a non-owning client. Called by SimulatedTick(). */
 	virtual void SimulateMovement(float DeltaTime);
 
+	/** Reduced detail version of SimulatedTick(), used when the simulated proxy LOD is not EBaseSimulatedProxyLOD::Full. */
+	virtual void SimulatedTickLOD(float DeltaSeconds);
+
+	/** Applies replicated gravity and movement mode changes, the only part of a network update the reduced detail updates need. */
+	void ApplyNetworkUpdateFlags();
+
 	/** Special Tick to allow custom server-side functionality on Autonomous Proxies. 
 	 * Called for all remote APs, including APs controlled on Listen Servers such as the hosting player's Character.
 	 * If full server-side control is desired, you may need to override ControlledCharacterMove as well.
@@ -2226,9 +2485,18 @@ protected:
 	 */
 	void SmoothClientPosition_Interpolate(float DeltaSeconds);
 
+	/** Snapshot interpolation part of SmoothClientPosition_Interpolate(). @see bUseSnapshotInterpolation */
+	void SmoothClientPosition_InterpolateSnapshots(class FNetworkPredictionData_Client_Character& ClientData, float DeltaSeconds);
+
 	/** Update mesh location based on interpolated values. */
 	void SmoothClientPosition_UpdateVisuals();
 
+	/** Returns true if this simulated proxy smooths by interpolating between buffered server snapshots. @see bUseSnapshotInterpolation */
+	bool ShouldUseSnapshotInterpolation() const;
+
+	/** Adds the server transform received in SmoothCorrection() to the snapshot buffer. */
+	void AddSmoothingSnapshot(class FNetworkPredictionData_Client_Character& ClientData, const FVector& NewLocation, const FQuat& NewRotation);
+
 	/*
 	========================================================================
 	Here's how player movement prediction, replication and correction works in network games:
@@ -2258,6 +2526,23 @@ protected:
 	/** If bUpdatePosition is true, then replay any unacked moves. Returns whether any moves were actually replayed. */
 	virtual bool ClientUpdatePositionAfterServerUpdate();
 
+	/**
+	 * Returns whether a correction only moves the predicted state by a small translation, with the same movement mode, base,
+	 * velocity, gravity field and gravity direction, and no transition in the unacked moves. Such corrections can be applied by translating the predicted
+	 * state instead of replaying the saved moves. Called by ClientAdjustPosition_Implementation() before the correction is applied.
+	 * @param ServerGravityDirection	Gravity direction sent with the correction, must match the one the acked move ended with.
+	 * @param OutTranslation	Receives the world and, on dynamic bases, base relative offset of the correction.
+	 * @see cg.NetIncrementalReplay
+	 */
+	virtual bool CanTranslateClientReplay(const FNetworkPredictionData_Client_Character& ClientData, const FVector& NewLocation, const FVector& NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, uint8 ServerMovementMode, const FVector& ServerGravityDirection, FBaseCharacterReplayTranslation& OutTranslation) const;
+
+	/**
+	 * Moves the character to its predicted state translated by the offset found by CanTranslateClientReplay(), and translates the
+	 * saved moves with it. Leaves the corrected state untouched and returns false if the translated capsule does not fit or does not
+	 * keep the same floor, the saved moves must then be replayed.
+	 */
+	virtual bool TranslateClientReplay(FNetworkPredictionData_Client_Character& ClientData);
+
 	/**
 	 * On the client, calls the ServerMovePacked_ClientSend() function with packed movement data.
 	 * First the FBaseCharacterNetworkMoveDataContainer from GetNetworkMoveDataContainer() is updated with ClientFillNetworkMoveData(), then serialized into a data stream to send client player moves to the server.
@@ -2384,10 +2669,13 @@ public:
 
 	/**
 	 * On the server, receives packed move data from the Character RPC, unpacks them into the FBaseCharacterNetworkMoveDataContainer returned from GetNetworkMoveDataContainer(),
-	 * and passes the data container to ServerMove_HandleMoveData().
+	 * and passes the data container to ServerMove_HandleMoveData(). Queues the data instead when ShouldBatchServerMoves() is true.
 	 */
 	void ServerMovePacked_ServerReceive(const FBaseCharacterServerMovePackedBits& PackedBits);
 
+	/** Unpacks move data into the FBaseCharacterNetworkMoveDataContainer returned from GetNetworkMoveDataContainer(). Returns false if the data was rejected. */
+	bool ServerMovePacked_DecodeMoveData(const FBaseCharacterServerMovePackedBits& PackedBits);
+
 	/* Sends a move response from the server to the client (through character to avoid component RPC overhead), eventually calling MoveResponsePacked_ClientReceive() on the client. */
 	void MoveResponsePacked_ServerSend(const FBaseCharacterMoveResponsePackedBits& PackedBits);
 
@@ -2451,6 +2739,13 @@ protected:
 	 */
 	FBaseCharacterNetworkMoveDataContainer& GetNetworkMoveDataContainer() const { return *NetworkMoveDataContainerPtr; }
 
+	/**
+	 * Set the package map used for the move data of a character replaying recorded client moves, as it has no connection to take one from.
+	 * Move responses are dropped while one is set, and received moves are not recorded.
+	 * @see FBaseCharacterMoveRecording, UServerMoveReplaySubsystem
+	 */
+	void SetServerMoveReplayPackageMap(UPackageMap* PackageMap) { ServerMoveReplayPackageMap = PackageMap; }
+
 	/**
 	 * Current move data being processed or handled.
 	 * This is set before MoveAutonomous (for replayed moves and server moves), and cleared thereafter.
@@ -2511,6 +2806,10 @@ private:
 	/** Used for reading server move RPC bits. */
 	FNetBitReader ServerMoveBitReader;
 
+	/** Package map of replayed client moves. @see SetServerMoveReplayPackageMap() */
+	UPROPERTY(Transient)
+	TObjectPtr<UPackageMap> ServerMoveReplayPackageMap;
+
 	/** Current network move data being processed or handled within the NetworkMoveDataContainer. */
 	FBaseCharacterNetworkMoveData* CurrentNetworkMoveData;
 
@@ -2567,8 +2866,7 @@ public:
 	void ConvertRootMotionServerIDsToLocalIDs(const FBaseRootMotionSourceGroup& LocalRootMotionToMatchWith, FBaseRootMotionSourceGroup& InOutServerRootMotion, float TimeStamp);
 
 	/** Collection of the most recent ID mappings */
-	enum class ERootMotionMapping : uint32 { MapSize = 16 };
-	TArray<FBaseRootMotionServerToLocalIDMapping, TInlineAllocator<(uint32)ERootMotionMapping::MapSize> > RootMotionIDMappings;
+	FBaseRootMotionServerToLocalIDMap RootMotionIDMappings;
 
 protected:
 	/** Restores Velocity to LastPreAdditiveVelocity during Root Motion Phys*() function calls */
@@ -2767,6 +3065,8 @@ public:
 	FName StartAttachSocketName;
 	FVector StartAttachRelativeLocation;
 	FRotator StartAttachRelativeRotation;
+	FVector StartGravityDirection;
+	uint32 StartGravityFieldId;
 
 	// Information after the move has been performed
 	uint8 EndPackedMovementMode;
@@ -2784,6 +3084,8 @@ public:
 	FName EndAttachSocketName;
 	FVector EndAttachRelativeLocation;
 	FRotator EndAttachRelativeRotation;
+	FVector EndGravityDirection;
+	uint32 EndGravityFieldId;
 
 	FVector Acceleration;
 	float MaxSpeed;
@@ -2833,6 +3135,12 @@ public:
 	/** Set the properties describing the final position, etc. of the moved pawn. */
 	virtual void PostUpdate(ABaseCharacter* C, EPostUpdateMode PostUpdateMode);
 	
+	/** Returns true if this move ended in the given gravity field, with a gravity direction within cg.NetMoveCombiningGravityTolerance of the given one. */
+	bool IsMatchingGravity(const FVector& OtherGravityDirection, uint32 OtherGravityFieldId) const;
+
+	/** Returns true if both gravities are from the same field, with directions within cg.NetMoveCombiningGravityTolerance of each other. */
+	static bool IsMatchingGravity(const FVector& GravityDirectionA, uint32 GravityFieldIdA, const FVector& GravityDirectionB, uint32 GravityFieldIdB);
+
 	/** Returns true if this move can be combined with NewMove for replication without changing any behavior */
 	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ABaseCharacter* InCharacter, float MaxDelta) const;
 
@@ -2878,6 +3186,203 @@ inline FSavedMove_Character& FSavedMove_Character::operator=(FSavedMove_Characte
 PRAGMA_ENABLE_DEPRECATION_WARNINGS
 
 
+/**
+ * Queue of saved moves ordered oldest to newest, stored in a power of two ring of slots.
+ * Acking moves advances the head instead of compacting, and slots are reused so the storage is only allocated once.
+ * Indexing is relative to the oldest move, like the TArray it replaces.
+ */
+class FSavedMoveBuffer
+{
+public:
+	int32 Num() const { return NumMoves; }
+	bool IsEmpty() const { return NumMoves == 0; }
+	bool IsValidIndex(int32 Index) const { return Index >= 0 && Index < NumMoves; }
+
+	FSavedMovePtr& operator[](int32 Index)
+	{
+		checkSlow(IsValidIndex(Index));
+		return Slots[(Head + Index) & (Slots.Num() - 1)];
+	}
+
+	const FSavedMovePtr& operator[](int32 Index) const
+	{
+		checkSlow(IsValidIndex(Index));
+		return Slots[(Head + Index) & (Slots.Num() - 1)];
+	}
+
+	FSavedMovePtr& Last() { return (*this)[NumMoves - 1]; }
+	const FSavedMovePtr& Last() const { return (*this)[NumMoves - 1]; }
+
+	/** Makes room for at least Capacity moves, keeping the current ones. */
+	void Reserve(int32 Capacity)
+	{
+		if (Capacity > Slots.Num())
+		{
+			Grow(Capacity);
+		}
+	}
+
+	/** Adds a move after the newest one. */
+	void Push(FSavedMovePtr Move)
+	{
+		if (NumMoves == Slots.Num())
+		{
+			Grow(NumMoves + 1);
+		}
+		Slots[(Head + NumMoves) & (Slots.Num() - 1)] = MoveTemp(Move);
+		++NumMoves;
+	}
+
+	/** Removes and returns the newest move. */
+	FSavedMovePtr Pop(bool bAllowShrinking = false)
+	{
+		check(NumMoves > 0);
+		--NumMoves;
+		return MoveTemp(Slots[(Head + NumMoves) & (Slots.Num() - 1)]);
+	}
+
+	/** Removes the Count oldest moves. */
+	void PopFront(int32 Count)
+	{
+		check(Count >= 0 && Count <= NumMoves);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Slots[(Head + Index) & (Slots.Num() - 1)].Reset();
+		}
+		Head = NumMoves == Count ? 0 : (Head + Count) & (Slots.Num() - 1);
+		NumMoves -= Count;
+	}
+
+	/** Removes every move, keeping the storage. */
+	void Reset()
+	{
+		PopFront(NumMoves);
+	}
+
+	/** Removes every move and frees the storage. */
+	void Empty()
+	{
+		Slots.Empty();
+		Head = 0;
+		NumMoves = 0;
+	}
+
+	template<typename BufferType, typename ElementType>
+	struct TBufferIterator
+	{
+		BufferType& Buffer;
+		int32 Index;
+
+		ElementType& operator*() const { return Buffer[Index]; }
+		TBufferIterator& operator++() { ++Index; return *this; }
+		bool operator!=(const TBufferIterator& Other) const { return Index != Other.Index; }
+	};
+
+	TBufferIterator<FSavedMoveBuffer, FSavedMovePtr> begin() { return { *this, 0 }; }
+	TBufferIterator<FSavedMoveBuffer, FSavedMovePtr> end() { return { *this, NumMoves }; }
+	TBufferIterator<const FSavedMoveBuffer, const FSavedMovePtr> begin() const { return { *this, 0 }; }
+	TBufferIterator<const FSavedMoveBuffer, const FSavedMovePtr> end() const { return { *this, NumMoves }; }
+
+private:
+	void Grow(int32 MinCapacity)
+	{
+		TArray<FSavedMovePtr> NewSlots;
+		NewSlots.SetNum(FMath::RoundUpToPowerOfTwo(FMath::Max(MinCapacity, 4)));
+		for (int32 Index = 0; Index < NumMoves; ++Index)
+		{
+			NewSlots[Index] = MoveTemp((*this)[Index]);
+		}
+		Slots = MoveTemp(NewSlots);
+		Head = 0;
+	}
+
+	TArray<FSavedMovePtr> Slots;
+	int32 Head = 0;
+	int32 NumMoves = 0;
+};
+
+
+/**
+ * Server transform of a simulated proxy received at a given server time, used by snapshot interpolation.
+ * Location, rotation and gravity direction are stored in the local space of the movement base when the base can move, in world space otherwise.
+ */
+struct FBaseCharacterSmoothingSnapshot
+{
+	double ServerTimeStamp = 0.0;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector GravityDirection = FVector::DownVector;
+	TWeakObjectPtr<UPrimitiveComponent> MovementBase;
+	FName MovementBaseBoneName;
+	bool bRelativeToBase = false;
+};
+
+/** Ring of the most recent smoothing snapshots, ordered oldest to newest. The capacity is set once, see SetCapacity(). */
+class FBaseCharacterSmoothingSnapshotBuffer
+{
+public:
+	/** Snapshots kept when no capacity was set. */
+	static constexpr int32 MinCapacity = 4;
+
+	/** Upper bound of the capacity, so a long delay or high update rate doesn't grow the buffer of every proxy without limit. */
+	static constexpr int32 MaxCapacity = 64;
+
+	FBaseCharacterSmoothingSnapshotBuffer()
+	{
+		Snapshots.SetNum(MinCapacity);
+	}
+
+	/** Resizes the ring to hold Capacity snapshots, clamped to [MinCapacity, MaxCapacity]. Removes every snapshot. */
+	void SetCapacity(int32 Capacity)
+	{
+		Snapshots.SetNum(FMath::Clamp(Capacity, MinCapacity, MaxCapacity));
+		Reset();
+	}
+
+	int32 Num() const { return NumSnapshots; }
+	bool IsEmpty() const { return NumSnapshots == 0; }
+	int32 GetCapacity() const { return Snapshots.Num(); }
+
+	const FBaseCharacterSmoothingSnapshot& operator[](int32 Index) const
+	{
+		checkSlow(Index >= 0 && Index < NumSnapshots);
+		return Snapshots[(Head + Index) % Snapshots.Num()];
+	}
+
+	const FBaseCharacterSmoothingSnapshot& Last() const { return (*this)[NumSnapshots - 1]; }
+
+	/** Adds a snapshot after the newest one, dropping the oldest when full. A snapshot that is not newer than the newest one replaces it. */
+	void Push(const FBaseCharacterSmoothingSnapshot& Snapshot)
+	{
+		const int32 Capacity = Snapshots.Num();
+		if (NumSnapshots > 0 && Snapshot.ServerTimeStamp <= Last().ServerTimeStamp)
+		{
+			Snapshots[(Head + NumSnapshots - 1) % Capacity] = Snapshot;
+			return;
+		}
+
+		if (NumSnapshots == Capacity)
+		{
+			Head = (Head + 1) % Capacity;
+			--NumSnapshots;
+		}
+		Snapshots[(Head + NumSnapshots) % Capacity] = Snapshot;
+		++NumSnapshots;
+	}
+
+	void Reset()
+	{
+		Head = 0;
+		NumSnapshots = 0;
+	}
+
+private:
+	TArray<FBaseCharacterSmoothingSnapshot> Snapshots;
+	int32 Head = 0;
+	int32 NumSnapshots = 0;
+};
+
+
 class FCharacterReplaySample
 {
 public:
@@ -2895,6 +3400,23 @@ public:
 	float			Time;					// This represents time since replay started
 };
 
+/** Predicted state of an autonomous proxy kept over a correction that may be applied as a translation. @see UBaseCharacterMovementComponent::CanTranslateClientReplay() */
+struct FBaseCharacterReplayTranslation
+{
+	/** World space offset of the correction. */
+	FVector Offset = FVector::ZeroVector;
+
+	/** Offset of the correction relative to a dynamic movement base, zero otherwise. */
+	FVector RelativeOffset = FVector::ZeroVector;
+
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector Velocity = FVector::ZeroVector;
+	FBaseFindFloorResult Floor;
+
+	bool bValid = false;
+};
+
 class FNetworkPredictionData_Client_Character : public FNetworkPredictionData_Client, protected FNoncopyable
 {
 	using Super = FNetworkPredictionData_Client;
@@ -2916,7 +3438,7 @@ public:
 	/** Last World timestamp (undilated, real time) at which we received a server ack for a move. This could be either a good move or a correction from the server. */
 	float LastReceivedAckRealTime;
 
-	TArray<FSavedMovePtr> SavedMoves;		// Buffered moves pending position updates, orderd oldest to newest. Moves that have been acked by the server are removed.
+	FSavedMoveBuffer SavedMoves;			// Buffered moves pending position updates, orderd oldest to newest. Moves that have been acked by the server are removed.
 	TArray<FSavedMovePtr> FreeMoves;		// freed moves, available for buffering
 	FSavedMovePtr PendingMove;				// PendingMove already processed on client - waiting to combine with next movement to reduce client to server bandwidth
 	FSavedMovePtr LastAckedMove;			// Last acknowledged sent move.
@@ -2926,6 +3448,9 @@ public:
 
 	uint32 bUpdatePosition:1; // when true, update the position (via ClientUpdatePosition)
 
+	/** Set by the last correction when it can be applied by translating the predicted state instead of replaying the saved moves. */
+	FBaseCharacterReplayTranslation ReplayTranslation;
+
 	// Mesh smoothing variables (for network smoothing)
 	//
 	
@@ -2960,14 +3485,26 @@ public:
 	double SmoothingClientTimeStamp;
 
 	/**
-	 * Copied value from UBaseCharacterMovementComponent::NetworkMaxSmoothUpdateDistance.
-	 * @see UBaseCharacterMovementComponent::NetworkMaxSmoothUpdateDistance
+	 * Recent server transforms of a simulated proxy using snapshot interpolation. Sized to cover SnapshotInterpolationDelay at the owner's NetUpdateFrequency.
+	 * @see UBaseCharacterMovementComponent::bUseSnapshotInterpolation
+	 */
+	FBaseCharacterSmoothingSnapshotBuffer SmoothingSnapshots;
+
+	/**
+	 * Copied value from UBaseCharacterMovementSettings::NetworkSnapshotInterpolationDelay.
+	 * @see UBaseCharacterMovementSettings::NetworkSnapshotInterpolationDelay
+	 */
+	float SnapshotInterpolationDelay;
+
+	/**
+	 * Copied value from UBaseCharacterMovementSettings::NetworkMaxSmoothUpdateDistance.
+	 * @see UBaseCharacterMovementSettings::NetworkMaxSmoothUpdateDistance
 	 */
 	float MaxSmoothNetUpdateDist;
 
 	/**
-	 * Copied value from UBaseCharacterMovementComponent::NetworkNoSmoothUpdateDistance.
-	 * @see UBaseCharacterMovementComponent::NetworkNoSmoothUpdateDistance
+	 * Copied value from UBaseCharacterMovementSettings::NetworkNoSmoothUpdateDistance.
+	 * @see UBaseCharacterMovementSettings::NetworkNoSmoothUpdateDistance
 	 */
 	float NoSmoothNetUpdateDist;
 
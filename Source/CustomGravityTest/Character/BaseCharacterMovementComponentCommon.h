@@ -20,6 +20,20 @@ enum EBaseShrinkCapsuleExtent
 	CGSHRINK_AllCustom,		// Change both radius and height, based on a supplied param
 };
 
+/** Level of detail of the movement update of a simulated proxy. @see UBaseCharacterMovementComponent::SetSimulatedProxyLOD() */
+UENUM(BlueprintType)
+enum class EBaseSimulatedProxyLOD : uint8
+{
+	/** Regular simulation: swept movement, floor checks and smoothing every frame. */
+	Full,
+	/** Moves the capsule along the replicated velocity without collision or floor checks, smoothing every frame. */
+	Extrapolate,
+	/** Keeps the capsule at the last replicated location, smoothing at a reduced rate. See cg.SimulatedProxyLODInterpolateRate. */
+	Interpolate,
+	/** No movement update at all, only network state changes are applied. */
+	Frozen,
+};
+
 /** Data about the floor for walking movement, used by CharacterMovementComponent. */
 USTRUCT(BlueprintType)
 struct FBaseFindFloorResult
@@ -94,6 +108,105 @@ public:
 };
 
 
+/**
+ * Floor result kept by FindFloor() so it can be reused across frames by a character that did not move.
+ * Keyed on everything the floor query depends on: capsule location, rotation and size, gravity and movement base.
+ */
+struct FBaseFloorCache
+{
+	FBaseFindFloorResult FloorResult;
+
+	FVector CapsuleLocation = FVector::ZeroVector;
+	FQuat CapsuleRotation = FQuat::Identity;
+	float CapsuleRadius = 0.f;
+	float CapsuleHalfHeight = 0.f;
+
+	/** Floor sweep distance adjustment, depends on the movement mode. */
+	float HeightCheckAdjust = 0.f;
+
+	FVector GravityDirection = FVector::ZeroVector;
+
+	/** Movement base and its transform when the floor was found. */
+	TWeakObjectPtr<UPrimitiveComponent> MovementBase;
+	FName BaseBoneName;
+	FVector BaseLocation = FVector::ZeroVector;
+	FQuat BaseRotation = FQuat::Identity;
+
+	bool bValid = false;
+
+	void Invalidate() { bValid = false; }
+};
+
+/** Floor sweep run ahead of the walking update that uses it, see UBaseCharacterMovementComponent::ConsumeFloorProbe(). */
+struct FBaseFloorProbe
+{
+	FHitResult Hit;
+
+	/** Capsule location and gravity direction the sweep was issued with. */
+	FVector Start = FVector::ZeroVector;
+	FVector GravityDirection = FVector::ZeroVector;
+
+	bool bValid = false;
+
+	void Invalidate() { bValid = false; }
+};
+
+/**
+ * Everything a floor probe sweep reads, copied from the component on the game thread so the sweep can run on a worker thread
+ * without touching the component, its capsule, base or gravity. See UBaseCharacterMovementComponent::GetFloorProbeRequest().
+ */
+struct FBaseFloorProbeRequest
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector GravityDirection = FVector::ZeroVector;
+	FCollisionShape Shape;
+	ECollisionChannel CollisionChannel = ECC_Pawn;
+	FCollisionQueryParams QueryParams;
+	FCollisionResponseParams ResponseParams;
+
+	/** Filled by the sweep. */
+	FHitResult Hit;
+	bool bHit = false;
+};
+
+/**
+ * Number of the operations driving the cost of a movement update, counted per character between two ticks.
+ * Reported to the BaseCharacterMovement trace channel and CSV category, see UBaseCharacterMovementComponent::FlushMovementCounters().
+ */
+struct FBaseCharacterMovementCounters
+{
+	/** Swept moves of the updated component, including the ones made by SafeMoveUpdatedComponent(). */
+	uint16 Sweeps = 0;
+
+	/** Floor sweeps and traces, from ComputeFloorDist() and the movement manager prefetch. */
+	uint16 FloorProbes = 0;
+
+	uint16 StepUps = 0;
+
+	/** Calls to SlideAlongSurface(). */
+	uint16 SlideIterations = 0;
+
+	/** Time steps handed out by GetSimulationTimeStep(). */
+	uint16 Substeps = 0;
+
+	uint16 GravityFieldLookups = 0;
+
+	/** Move corrections sent by the server and received by the owning client. */
+	uint16 CorrectionsSent = 0;
+	uint16 CorrectionsReceived = 0;
+
+	/** Saved moves simulated again after a correction, and saved moves only translated by an incremental replay instead. */
+	uint16 ReplayedMoves = 0;
+	uint16 TranslatedMoves = 0;
+
+	/** Time spent replaying saved moves after corrections, in cycles. */
+	uint64 ReplayCycles = 0;
+
+	void Reset() { *this = FBaseCharacterMovementCounters(); }
+};
+
 /** Struct updated by StepUp() to return result of final step down, if applicable. */
 struct FBaseStepDownResult
 {
@@ -0,0 +1,434 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BaseCharacterMovementManager.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/Paths.h"
+#include "BaseCharacter.h"
+#include "BaseCharacterMovementComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BaseCharacterMovementManager)
+
+DECLARE_CYCLE_STAT(TEXT("Char MovementManager Tick"), STAT_CharMovementManagerTick, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char MovementManager Components"), STAT_CharMovementManagerComponents, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char MovementManager ServerMoves"), STAT_CharMovementManagerServerMoves, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char MovementManager ServerMove Components"), STAT_CharMovementManagerServerMoveComponents, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char MovementManager SimulatedProxyLOD"), STAT_CharMovementManagerSimulatedProxyLOD, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char SimulatedProxyLOD Full"), STAT_CharSimulatedProxyLODFull, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char SimulatedProxyLOD Extrapolate"), STAT_CharSimulatedProxyLODExtrapolate, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char SimulatedProxyLOD Interpolate"), STAT_CharSimulatedProxyLODInterpolate, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char SimulatedProxyLOD Frozen"), STAT_CharSimulatedProxyLODFrozen, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char MovementManager Avoidance"), STAT_CharMovementManagerAvoidance, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Avoidance Agents"), STAT_CharAvoidanceAgents, STATGROUP_Character);
+
+DEFINE_LOG_CATEGORY_STATIC(LogBaseCharacterMovementManager, Log, All);
+
+namespace BaseCharacterMovementManagerCVars
+{
+	static bool bEnableMovementManager = true;
+	FAutoConsoleVariableRef CVarEnableMovementManager(
+		TEXT("cg.MovementManager"),
+		bEnableMovementManager,
+		TEXT("Whether the movement manager prefetches scene queries for the components registered with it. When disabled, they run their queries as usual."),
+		ECVF_Default);
+
+	static int32 MovementManagerMinBatchSize = 4;
+	FAutoConsoleVariableRef CVarMovementManagerMinBatchSize(
+		TEXT("cg.MovementManagerMinBatchSize"),
+		MovementManagerMinBatchSize,
+		TEXT("Minimum number of components processed by a single worker task of the movement manager.\n")
+		TEXT("<=0: Process every component on the game thread"),
+		ECVF_Default);
+
+	static float AvoidanceCellSize = 500.f;
+	FAutoConsoleVariableRef CVarAvoidanceCellSize(
+		TEXT("cg.AvoidanceCellSize"),
+		AvoidanceCellSize,
+		TEXT("Size in cm of the cells of the avoidance hash. Best around the avoidance consideration radius of the characters."),
+		ECVF_Default);
+
+	static bool bEnableSimulatedProxyLOD = true;
+	FAutoConsoleVariableRef CVarEnableSimulatedProxyLOD(
+		TEXT("cg.SimulatedProxyLOD"),
+		bEnableSimulatedProxyLOD,
+		TEXT("Whether the movement manager lowers the level of detail of simulated proxies with bUseSimulatedProxyLOD set. When disabled, they all use the full update."),
+		ECVF_Default);
+
+	static float SimulatedProxyLODExtrapolateDistance = 3000.f;
+	FAutoConsoleVariableRef CVarSimulatedProxyLODExtrapolateDistance(
+		TEXT("cg.SimulatedProxyLODExtrapolateDistance"),
+		SimulatedProxyLODExtrapolateDistance,
+		TEXT("Distance in cm to the closest local viewer beyond which simulated proxies only extrapolate."),
+		ECVF_Default);
+
+	static float SimulatedProxyLODInterpolateDistance = 6000.f;
+	FAutoConsoleVariableRef CVarSimulatedProxyLODInterpolateDistance(
+		TEXT("cg.SimulatedProxyLODInterpolateDistance"),
+		SimulatedProxyLODInterpolateDistance,
+		TEXT("Distance in cm to the closest local viewer beyond which simulated proxies only interpolate, at a reduced rate."),
+		ECVF_Default);
+
+	static float SimulatedProxyLODFrozenDistance = 15000.f;
+	FAutoConsoleVariableRef CVarSimulatedProxyLODFrozenDistance(
+		TEXT("cg.SimulatedProxyLODFrozenDistance"),
+		SimulatedProxyLODFrozenDistance,
+		TEXT("Distance in cm to the closest local viewer beyond which simulated proxies are not updated at all."),
+		ECVF_Default);
+
+	static float SimulatedProxyLODRenderTolerance = 0.5f;
+	FAutoConsoleVariableRef CVarSimulatedProxyLODRenderTolerance(
+		TEXT("cg.SimulatedProxyLODRenderTolerance"),
+		SimulatedProxyLODRenderTolerance,
+		TEXT("Time in seconds since a simulated proxy was last rendered before it is considered hidden. Hidden proxies interpolate at most, and freeze beyond the extrapolate distance."),
+		ECVF_Default);
+
+	static float SimulatedProxyLODGravityAngle = 45.f;
+	FAutoConsoleVariableRef CVarSimulatedProxyLODGravityAngle(
+		TEXT("cg.SimulatedProxyLODGravityAngle"),
+		SimulatedProxyLODGravityAngle,
+		TEXT("Angle in degrees between the gravity of a simulated proxy and of the closest local viewer beyond which the proxy drops one level of detail, up to Interpolate.\n")
+		TEXT("<=0: Ignore gravity"),
+		ECVF_Default);
+
+}
+
+static FAutoConsoleCommandWithWorldAndArgs RecordServerMovesCommand(
+	TEXT("cg.RecordServerMoves"),
+	TEXT("Writes the client moves received by the server to a file, for cg.ReplayServerMoves. Defaults to Saved/MoveRecordings/<Map>_<Time>.cgmoves.\n")
+	TEXT("Usage: cg.RecordServerMoves [Filename]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UBaseCharacterMovementManager* Manager = UBaseCharacterMovementManager::Get(World);
+		if (!Manager || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogBaseCharacterMovementManager, Warning, TEXT("cg.RecordServerMoves: only available on servers."));
+			return;
+		}
+
+		const FString Filename = Args.Num() > 0 ? Args[0] :
+			FPaths::ProjectSavedDir() / TEXT("MoveRecordings") / FString::Printf(TEXT("%s_%s.cgmoves"), *World->GetMapName(), *FDateTime::Now().ToString());
+
+		if (Manager->StartServerMoveRecording(Filename))
+		{
+			UE_LOG(LogBaseCharacterMovementManager, Display, TEXT("Recording client moves to %s"), *Filename);
+		}
+		else
+		{
+			UE_LOG(LogBaseCharacterMovementManager, Warning, TEXT("cg.RecordServerMoves: could not open %s."), *Filename);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld StopRecordingServerMovesCommand(
+	TEXT("cg.StopRecordingServerMoves"),
+	TEXT("Closes the recording started by cg.RecordServerMoves."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UBaseCharacterMovementManager* Manager = UBaseCharacterMovementManager::Get(World))
+		{
+			Manager->StopServerMoveRecording();
+		}
+	}));
+
+void FBaseCharacterMovementManagerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Target->Tick(DeltaTime);
+	}
+}
+
+FString FBaseCharacterMovementManagerTickFunction::DiagnosticMessage()
+{
+	return TEXT("FBaseCharacterMovementManagerTickFunction");
+}
+
+FName FBaseCharacterMovementManagerTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return FName(TEXT("BaseCharacterMovementManager"));
+}
+
+void UBaseCharacterMovementManager::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.Target = this;
+	TickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UBaseCharacterMovementManager::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+	TickFunction.Target = nullptr;
+
+	StopServerMoveRecording();
+
+	Components.Reset();
+	FrameComponents.Reset();
+	FrameServerMoveComponents.Reset();
+	AvoidanceHash.Reset(0.f);
+
+	Super::Deinitialize();
+}
+
+void UBaseCharacterMovementManager::RegisterComponent(UBaseCharacterMovementComponent* Component)
+{
+	if (Component && !Components.Contains(Component))
+	{
+		Components.Add(Component);
+		Component->PrimaryComponentTick.AddPrerequisite(this, TickFunction);
+	}
+}
+
+void UBaseCharacterMovementManager::UnregisterComponent(UBaseCharacterMovementComponent* Component)
+{
+	if (Component && Components.RemoveSwap(Component) > 0)
+	{
+		Component->SetAvoidanceHashIndex(INDEX_NONE);
+		Component->PrimaryComponentTick.RemovePrerequisite(this, TickFunction);
+	}
+}
+
+void UBaseCharacterMovementManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharMovementManagerTick);
+
+	ProcessServerMoves();
+	UpdateSimulatedProxyLODs();
+	UpdateAvoidanceHash();
+
+	if (!BaseCharacterMovementManagerCVars::bEnableMovementManager)
+	{
+		return;
+	}
+
+	// Serial gather, eligibility depends on roles and controllers which can change at any time.
+	FrameComponents.Reset();
+	for (UBaseCharacterMovementComponent* Component : Components)
+	{
+		if (IsValid(Component) && Component->IsComponentTickEnabled() && Component->ShouldUseMovementManager())
+		{
+			FrameComponents.Add(Component);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_CharMovementManagerComponents, FrameComponents.Num());
+
+	if (FrameComponents.Num() == 0)
+	{
+		return;
+	}
+
+	// Copy the sweep inputs on the game thread, the workers never read the components.
+	FrameProbeComponents.Reset();
+	FrameProbeRequests.Reset();
+	for (UBaseCharacterMovementComponent* Component : FrameComponents)
+	{
+		FBaseFloorProbeRequest& Request = FrameProbeRequests.AddDefaulted_GetRef();
+		if (Component->GetFloorProbeRequest(DeltaTime, Request))
+		{
+			FrameProbeComponents.Add(Component);
+		}
+		else
+		{
+			FrameProbeRequests.Pop(false);
+		}
+	}
+
+	// Parallel phase, scene queries only on the copied inputs.
+	const UWorld* World = GetWorld();
+	const int32 MinBatchSize = BaseCharacterMovementManagerCVars::MovementManagerMinBatchSize;
+	const EParallelForFlags Flags = MinBatchSize > 0 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+	ParallelFor(TEXT("BaseCharacterMovementManager"), FrameProbeRequests.Num(), FMath::Max(1, MinBatchSize), [this, World](int32 Index)
+	{
+		FBaseFloorProbeRequest& Request = FrameProbeRequests[Index];
+		Request.bHit = World->SweepSingleByChannel(Request.Hit, Request.Start, Request.End, Request.Rotation, Request.CollisionChannel, Request.Shape, Request.QueryParams, Request.ResponseParams);
+	}, Flags);
+
+	for (int32 Index = 0; Index < FrameProbeComponents.Num(); ++Index)
+	{
+		FrameProbeComponents[Index]->SetPrefetchedFloorProbe(FrameProbeRequests[Index]);
+	}
+
+	// The serial phase is the regular tick of each component, which depends on this tick function. Proxy simulation runs there in full,
+	// moving components and firing overlaps is not safe to do from the workers.
+}
+
+void UBaseCharacterMovementManager::ProcessServerMoves()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharMovementManagerServerMoves);
+
+	FrameServerMoveComponents.Reset();
+	for (UBaseCharacterMovementComponent* Component : Components)
+	{
+		if (IsValid(Component) && Component->HasQueuedServerMoves())
+		{
+			FrameServerMoveComponents.Add(Component);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_CharMovementManagerServerMoveComponents, FrameServerMoveComponents.Num());
+
+	// Registration order changes as components come and go, sort so characters simulate in the same order every frame.
+	FrameServerMoveComponents.Sort([](const UBaseCharacterMovementComponent& A, const UBaseCharacterMovementComponent& B)
+	{
+		return A.GetUniqueID() < B.GetUniqueID();
+	});
+
+	for (UBaseCharacterMovementComponent* Component : FrameServerMoveComponents)
+	{
+		// Handling a move can destroy other characters.
+		if (IsValid(Component))
+		{
+			Component->ProcessQueuedServerMoves();
+		}
+	}
+}
+
+void UBaseCharacterMovementManager::UpdateAvoidanceHash()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharMovementManagerAvoidance);
+
+	AvoidanceHash.Reset(BaseCharacterMovementManagerCVars::AvoidanceCellSize);
+
+	FBaseCharacterAvoidanceAgent Agent;
+	for (UBaseCharacterMovementComponent* Component : Components)
+	{
+		if (IsValid(Component))
+		{
+			Component->SetAvoidanceHashIndex(Component->GetAvoidanceAgent(Agent) ? AvoidanceHash.AddAgent(Agent) : INDEX_NONE);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_CharAvoidanceAgents, AvoidanceHash.Num());
+}
+
+void UBaseCharacterMovementManager::UpdateSimulatedProxyLODs()
+{
+	using namespace BaseCharacterMovementManagerCVars;
+
+	SCOPE_CYCLE_COUNTER(STAT_CharMovementManagerSimulatedProxyLOD);
+
+	struct FViewer
+	{
+		FVector Location;
+		FVector GravityDirection;
+	};
+
+	// Only clients have simulated proxies, and they rarely have more than a couple of local players.
+	TArray<FViewer, TInlineAllocator<4>> Viewers;
+	if (bEnableSimulatedProxyLOD)
+	{
+		for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+		{
+			const APlayerController* PlayerController = Iterator->Get();
+			if (PlayerController && PlayerController->IsLocalController())
+			{
+				FViewer& Viewer = Viewers.AddDefaulted_GetRef();
+				FRotator ViewRotation;
+				PlayerController->GetPlayerViewPoint(Viewer.Location, ViewRotation);
+
+				const ABaseCharacter* ViewerCharacter = Cast<ABaseCharacter>(PlayerController->GetPawn());
+				Viewer.GravityDirection = ViewerCharacter ? ViewerCharacter->GetCharacterMovement()->GetGravityDirection() : UBaseCharacterMovementComponent::DefaultGravityDirection;
+			}
+		}
+	}
+
+	const float CosGravityAngle = FMath::Cos(FMath::DegreesToRadians(SimulatedProxyLODGravityAngle));
+
+	for (UBaseCharacterMovementComponent* Component : Components)
+	{
+		if (!IsValid(Component))
+		{
+			continue;
+		}
+
+		if (!Component->ShouldUseSimulatedProxyLOD() || Viewers.Num() == 0)
+		{
+			Component->SetSimulatedProxyLOD(EBaseSimulatedProxyLOD::Full);
+			continue;
+		}
+
+		const ABaseCharacter* Character = Component->GetCharacterOwner();
+		const FVector Location = Component->UpdatedComponent->GetComponentLocation();
+
+		const FViewer* ClosestViewer = nullptr;
+		double ClosestDistSq = TNumericLimits<double>::Max();
+		for (const FViewer& Viewer : Viewers)
+		{
+			const double DistSq = FVector::DistSquared(Location, Viewer.Location);
+			if (DistSq < ClosestDistSq)
+			{
+				ClosestDistSq = DistSq;
+				ClosestViewer = &Viewer;
+			}
+		}
+
+		EBaseSimulatedProxyLOD LOD = EBaseSimulatedProxyLOD::Full;
+		if (ClosestDistSq > FMath::Square(SimulatedProxyLODFrozenDistance))
+		{
+			LOD = EBaseSimulatedProxyLOD::Frozen;
+		}
+		else if (ClosestDistSq > FMath::Square(SimulatedProxyLODInterpolateDistance))
+		{
+			LOD = EBaseSimulatedProxyLOD::Interpolate;
+		}
+		else if (ClosestDistSq > FMath::Square(SimulatedProxyLODExtrapolateDistance))
+		{
+			LOD = EBaseSimulatedProxyLOD::Extrapolate;
+		}
+
+		// Characters under another gravity, for instance on the far side of a planet, matter less than those sharing ours.
+		if (SimulatedProxyLODGravityAngle > 0.f && LOD < EBaseSimulatedProxyLOD::Interpolate
+			&& (Component->GetGravityDirection() | ClosestViewer->GravityDirection) < CosGravityAngle)
+		{
+			LOD = (EBaseSimulatedProxyLOD)((uint8)LOD + 1);
+		}
+
+		if (!Character->WasRecentlyRendered(SimulatedProxyLODRenderTolerance))
+		{
+			LOD = LOD >= EBaseSimulatedProxyLOD::Extrapolate ? EBaseSimulatedProxyLOD::Frozen : EBaseSimulatedProxyLOD::Interpolate;
+		}
+
+		Component->SetSimulatedProxyLOD(LOD);
+
+		switch (LOD)
+		{
+		case EBaseSimulatedProxyLOD::Full:			INC_DWORD_STAT(STAT_CharSimulatedProxyLODFull); break;
+		case EBaseSimulatedProxyLOD::Extrapolate:	INC_DWORD_STAT(STAT_CharSimulatedProxyLODExtrapolate); break;
+		case EBaseSimulatedProxyLOD::Interpolate:	INC_DWORD_STAT(STAT_CharSimulatedProxyLODInterpolate); break;
+		default:									INC_DWORD_STAT(STAT_CharSimulatedProxyLODFrozen); break;
+		}
+	}
+}
+
+bool UBaseCharacterMovementManager::StartServerMoveRecording(const FString& Filename)
+{
+	StopServerMoveRecording();
+
+	ServerMoveRecorder = FBaseCharacterMoveRecorder::Create(*GetWorld(), Filename);
+	return ServerMoveRecorder.IsValid();
+}
+
+void UBaseCharacterMovementManager::StopServerMoveRecording()
+{
+	if (ServerMoveRecorder)
+	{
+		UE_LOG(LogBaseCharacterMovementManager, Display, TEXT("Recorded %d client moves from %d characters to %s"),
+			ServerMoveRecorder->GetNumMoves(), ServerMoveRecorder->GetNumStreams(), *ServerMoveRecorder->GetFilename());
+		ServerMoveRecorder.Reset();
+	}
+}
+
+UBaseCharacterMovementManager* UBaseCharacterMovementManager::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UBaseCharacterMovementManager>() : nullptr;
+}
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BaseCharacterMoveRecording.h"
+#include "BaseCharacterAvoidance.h"
+#include "BaseCharacterMovementComponentCommon.h"
+#include "BaseCharacterMovementManager.generated.h"
+
+class UBaseCharacterMovementManager;
+class UBaseCharacterMovementComponent;
+
+/** Tick function of UBaseCharacterMovementManager, runs before every managed movement component. */
+USTRUCT()
+struct FBaseCharacterMovementManagerTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	UBaseCharacterMovementManager* Target = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FBaseCharacterMovementManagerTickFunction> : public TStructOpsTypeTraitsBase2<FBaseCharacterMovementManagerTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Batches the read-only part of the movement of simulated proxies and AI characters across worker threads.
+ *
+ * Movement components with bUseMovementManager register themselves in BeginPlay. Every frame, before any of them ticks,
+ * the manager copies the inputs of the floor sweep their walking update will need (see UBaseCharacterMovementComponent::GetFloorProbeRequest())
+ * and runs those sweeps in parallel. The components then tick as usual on the game thread, consuming those results instead of sweeping,
+ * so every transform write, overlap and physics interaction still happens serially.
+ *
+ * Only that one floor sweep per component runs in parallel. SimulatedTick() and SimulateMovement() of simulated proxies stay serial
+ * on the game thread: they move the updated component, fire overlaps and read other characters, none of which is safe off the game thread.
+ *
+ * On the server, it also runs the client moves queued by components with bBatchServerMoves, once per frame and in a stable order,
+ * before the parallel phase. Move responses are unchanged, they are sent from SendClientAdjustment() when the net driver replicates.
+ *
+ * On clients, it picks the level of detail of the simulated proxies with bUseSimulatedProxyLOD from their significance: distance to
+ * the closest local viewer, whether they were rendered recently and how far their gravity is from that viewer's.
+ *
+ * It also rebuilds the avoidance hash every frame from the components with RVO avoidance enabled, so their neighbor lookups don't
+ * go through the world UAvoidanceManager. They still register with it, for the other avoiding agents. See FBaseCharacterAvoidanceHash.
+ */
+UCLASS()
+class UBaseCharacterMovementManager : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	//~ Begin UWorldSubsystem Interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~ End UWorldSubsystem Interface
+
+	/** Adds a movement component to the managed set and makes it tick after the manager. */
+	void RegisterComponent(UBaseCharacterMovementComponent* Component);
+
+	/** Removes a movement component from the managed set. */
+	void UnregisterComponent(UBaseCharacterMovementComponent* Component);
+
+	/** Runs the queued server moves, updates the simulated proxy levels of detail, then runs the parallel phase. Called by the tick function. */
+	void Tick(float DeltaTime);
+
+	int32 GetNumComponents() const { return Components.Num(); }
+
+	/** Starts writing the client moves received by this world to a file, replacing the current recording if any. Returns false if the file could not be opened. */
+	bool StartServerMoveRecording(const FString& Filename);
+
+	/** Closes the current recording, if any. */
+	void StopServerMoveRecording();
+
+	/** Returns the avoidance hash built this frame. Components update their own entry once their velocity is decided. */
+	FBaseCharacterAvoidanceHash& GetAvoidanceHash() { return AvoidanceHash; }
+
+	/** Returns the current recording of client moves, null if not recording. */
+	FBaseCharacterMoveRecorder* GetServerMoveRecorder() const { return ServerMoveRecorder.Get(); }
+
+	/** Helper to get the manager of the world an object lives in. May return null. */
+	static UBaseCharacterMovementManager* Get(const UObject* WorldContextObject);
+
+private:
+	/** Handles the client moves queued by every registered component since the last frame. */
+	void ProcessServerMoves();
+
+	/** Picks the level of detail of every registered simulated proxy. */
+	void UpdateSimulatedProxyLODs();
+
+	/** Rebuilds the avoidance hash from the registered components using RVO avoidance. */
+	void UpdateAvoidanceHash();
+
+	FBaseCharacterMovementManagerTickFunction TickFunction;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UBaseCharacterMovementComponent>> Components;
+
+	/** Components processed this frame, kept around to avoid allocating every tick. */
+	TArray<UBaseCharacterMovementComponent*> FrameComponents;
+
+	/** Floor probes of the components processed this frame, and the component of each. */
+	TArray<FBaseFloorProbeRequest> FrameProbeRequests;
+	TArray<UBaseCharacterMovementComponent*> FrameProbeComponents;
+
+	/** Components with queued server moves this frame. */
+	TArray<UBaseCharacterMovementComponent*> FrameServerMoveComponents;
+
+	/** Characters using RVO avoidance this frame. */
+	FBaseCharacterAvoidanceHash AvoidanceHash;
+
+	/** Current recording of client moves. @see cg.RecordServerMoves */
+	TUniquePtr<FBaseCharacterMoveRecorder> ServerMoveRecorder;
+};
@@ -52,6 +52,9 @@ struct FBaseCharacterNetworkSerializationPackedBits
 	bool NetSerialize(FArchive& Ar, UPackageMap* PackageMap, bool& bOutSuccess);
 	UPackageMap* GetPackageMap() const { return SavedPackageMap; }
 
+	/** Largest number of bits accepted when receiving, see p.NetPackedMovementMaxBits. */
+	static uint32 GetMaxNumBits();
+
 	//------------------------------------------------------------------------
 	// Data
 
@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BaseCharacterMovementSettings.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BaseCharacterMovementSettings)
+
+namespace BaseCharacterMovementSettings
+{
+	/** Member of every EBaseCharacterMovementSetting, in the order of the enum. */
+	static float UBaseCharacterMovementSettings::* const SettingMembers[] =
+	{
+		&UBaseCharacterMovementSettings::MaxStepHeight,
+		&UBaseCharacterMovementSettings::MaxWalkSpeed,
+		&UBaseCharacterMovementSettings::MaxWalkSpeedCrouched,
+		&UBaseCharacterMovementSettings::MaxSwimSpeed,
+		&UBaseCharacterMovementSettings::MaxFlySpeed,
+		&UBaseCharacterMovementSettings::MaxAcceleration,
+		&UBaseCharacterMovementSettings::MinAnalogWalkSpeed,
+		&UBaseCharacterMovementSettings::BrakingFrictionFactor,
+		&UBaseCharacterMovementSettings::BrakingFriction,
+		&UBaseCharacterMovementSettings::BrakingSubStepTime,
+		&UBaseCharacterMovementSettings::BrakingDecelerationWalking,
+		&UBaseCharacterMovementSettings::BrakingDecelerationFalling,
+		&UBaseCharacterMovementSettings::BrakingDecelerationSwimming,
+		&UBaseCharacterMovementSettings::BrakingDecelerationFlying,
+		&UBaseCharacterMovementSettings::AvoidanceConsiderationRadius,
+		&UBaseCharacterMovementSettings::AvoidanceWeight,
+		&UBaseCharacterMovementSettings::NetworkSimulatedSmoothLocationTime,
+		&UBaseCharacterMovementSettings::NetworkSimulatedSmoothRotationTime,
+		&UBaseCharacterMovementSettings::ListenServerNetworkSimulatedSmoothLocationTime,
+		&UBaseCharacterMovementSettings::ListenServerNetworkSimulatedSmoothRotationTime,
+		&UBaseCharacterMovementSettings::NetworkSnapshotInterpolationDelay,
+		&UBaseCharacterMovementSettings::NetProxyShrinkRadius,
+		&UBaseCharacterMovementSettings::NetProxyShrinkHalfHeight,
+		&UBaseCharacterMovementSettings::NetworkMaxSmoothUpdateDistance,
+		&UBaseCharacterMovementSettings::NetworkNoSmoothUpdateDistance,
+		&UBaseCharacterMovementSettings::NetworkMinTimeBetweenClientAckGoodMoves,
+		&UBaseCharacterMovementSettings::NetworkMinTimeBetweenClientAdjustments,
+		&UBaseCharacterMovementSettings::NetworkMinTimeBetweenClientAdjustmentsLargeCorrection,
+		&UBaseCharacterMovementSettings::NetworkLargeClientCorrectionDistance,
+	};
+	static_assert(UE_ARRAY_COUNT(SettingMembers) == (int32)EBaseCharacterMovementSetting::MAX, "Every EBaseCharacterMovementSetting needs a member.");
+}
+
+UBaseCharacterMovementSettings::UBaseCharacterMovementSettings()
+{
+	MaxStepHeight = 45.0f;
+	MaxWalkSpeed = 600.0f;
+	MaxWalkSpeedCrouched = MaxWalkSpeed * 0.5f;
+	MaxSwimSpeed = 300.0f;
+	MaxFlySpeed = 600.0f;
+	MaxAcceleration = 2048.0f;
+	MinAnalogWalkSpeed = 0.0f;
+	BrakingFrictionFactor = 2.0f; // Historical value, 1 would be more appropriate.
+	BrakingFriction = 0.0f;
+	BrakingSubStepTime = 1.0f / 33.0f;
+	BrakingDecelerationWalking = MaxAcceleration;
+	BrakingDecelerationFalling = 0.f;
+	BrakingDecelerationSwimming = 0.f;
+	BrakingDecelerationFlying = 0.f;
+	AvoidanceConsiderationRadius = 500.0f;
+	AvoidanceWeight = 0.0f;
+
+	// Set to match EVectorQuantization::RoundTwoDecimals
+	NetProxyShrinkRadius = 0.01f;
+	NetProxyShrinkHalfHeight = 0.01f;
+
+	NetworkSimulatedSmoothLocationTime = 0.100f;
+	NetworkSimulatedSmoothRotationTime = 0.050f;
+	ListenServerNetworkSimulatedSmoothLocationTime = 0.040f;
+	ListenServerNetworkSimulatedSmoothRotationTime = 0.033f;
+	NetworkSnapshotInterpolationDelay = 0.100f;
+	NetworkMaxSmoothUpdateDistance = 256.f;
+	NetworkNoSmoothUpdateDistance = 384.f;
+	NetworkMinTimeBetweenClientAckGoodMoves = 0.10f;
+	NetworkMinTimeBetweenClientAdjustments = 0.10f;
+	NetworkMinTimeBetweenClientAdjustmentsLargeCorrection = 0.05f;
+	NetworkLargeClientCorrectionDistance = 15.0f;
+}
+
+float UBaseCharacterMovementSettings::GetSetting(EBaseCharacterMovementSetting Setting) const
+{
+	check(Setting < EBaseCharacterMovementSetting::MAX);
+	return this->*BaseCharacterMovementSettings::SettingMembers[(int32)Setting];
+}
@@ -0,0 +1,250 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "BaseCharacterMovementSettings.generated.h"
+
+/** Tuning values of UBaseCharacterMovementSettings, which a UBaseCharacterMovementComponent can override for itself. */
+UENUM(BlueprintType)
+enum class EBaseCharacterMovementSetting : uint8
+{
+	MaxStepHeight,
+	MaxWalkSpeed,
+	MaxWalkSpeedCrouched,
+	MaxSwimSpeed,
+	MaxFlySpeed,
+	MaxAcceleration,
+	MinAnalogWalkSpeed,
+	BrakingFrictionFactor,
+	BrakingFriction,
+	BrakingSubStepTime,
+	BrakingDecelerationWalking,
+	BrakingDecelerationFalling,
+	BrakingDecelerationSwimming,
+	BrakingDecelerationFlying,
+	AvoidanceConsiderationRadius,
+	AvoidanceWeight,
+	NetworkSimulatedSmoothLocationTime,
+	NetworkSimulatedSmoothRotationTime,
+	ListenServerNetworkSimulatedSmoothLocationTime,
+	ListenServerNetworkSimulatedSmoothRotationTime,
+	NetworkSnapshotInterpolationDelay,
+	NetProxyShrinkRadius,
+	NetProxyShrinkHalfHeight,
+	NetworkMaxSmoothUpdateDistance,
+	NetworkNoSmoothUpdateDistance,
+	NetworkMinTimeBetweenClientAckGoodMoves,
+	NetworkMinTimeBetweenClientAdjustments,
+	NetworkMinTimeBetweenClientAdjustmentsLargeCorrection,
+	NetworkLargeClientCorrectionDistance,
+	MAX UMETA(Hidden)
+};
+
+/** Value of a setting a single component uses instead of the one of its UBaseCharacterMovementSettings. */
+USTRUCT(BlueprintType)
+struct FBaseCharacterMovementSettingOverride
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category="Movement Settings", EditAnywhere, BlueprintReadOnly)
+	EBaseCharacterMovementSetting Setting = EBaseCharacterMovementSetting::MaxWalkSpeed;
+
+	UPROPERTY(Category="Movement Settings", EditAnywhere, BlueprintReadOnly)
+	float Value = 0.f;
+};
+
+/**
+ * Movement, avoidance and network tuning of UBaseCharacterMovementComponent, which is the same for every character of a class.
+ * Referenced by UBaseCharacterMovementComponent::MovementSettings, so many characters share a single copy instead of carrying
+ * these values in every component. Components without an asset use the defaults of this class.
+ *
+ * Values a component changes at runtime, or a Blueprint or placed character changes for itself, are stored on that component as
+ * overrides of this asset, see UBaseCharacterMovementComponent::SetMovementSetting(). The asset itself is never modified during play.
+ */
+UCLASS(BlueprintType)
+class UBaseCharacterMovementSettings : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UBaseCharacterMovementSettings();
+
+	/** Returns the value of a setting, as set in this asset. */
+	float GetSetting(EBaseCharacterMovementSetting Setting) const;
+
+	/** Maximum height character can step up */
+	UPROPERTY(Category="Walking", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0", ForceUnits="cm"))
+	float MaxStepHeight;
+
+	/** The maximum ground speed when walking. Also determines maximum lateral speed when falling. */
+	UPROPERTY(Category="Walking", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
+	float MaxWalkSpeed;
+
+	/** The maximum ground speed when walking and crouched. */
+	UPROPERTY(Category="Walking", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
+	float MaxWalkSpeedCrouched;
+
+	/** The maximum swimming speed. */
+	UPROPERTY(Category="Swimming", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
+	float MaxSwimSpeed;
+
+	/** The maximum flying speed. */
+	UPROPERTY(Category="Flying", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
+	float MaxFlySpeed;
+
+	/** Max Acceleration (rate of change of velocity) */
+	UPROPERTY(Category="General", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0"))
+	float MaxAcceleration;
+
+	/** The ground speed that we should accelerate up to when walking at minimum analog stick tilt */
+	UPROPERTY(Category="Walking", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0", ForceUnits="cm/s"))
+	float MinAnalogWalkSpeed;
+
+	/**
+	 * Factor used to multiply actual value of friction used when braking.
+	 * This applies to any friction value that is currently used, which may depend on UBaseCharacterMovementComponent::bUseSeparateBrakingFriction.
+	 * @note This is 2 by default for historical reasons, a value of 1 gives the true drag equation.
+	 * @see UBaseCharacterMovementComponent::bUseSeparateBrakingFriction, UBaseCharacterMovementComponent::GroundFriction, BrakingFriction
+	 */
+	UPROPERTY(Category="General", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0"))
+	float BrakingFrictionFactor;
+
+	/**
+	 * Friction (drag) coefficient applied when braking (whenever Acceleration = 0, or if character is exceeding max speed); actual value used is this multiplied by BrakingFrictionFactor.
+	 * Braking is composed of friction (velocity-dependent drag) and constant deceleration.
+	 * @note Only used if UBaseCharacterMovementComponent::bUseSeparateBrakingFriction is true, otherwise current friction such as GroundFriction is used.
+	 * @see BrakingFrictionFactor, BrakingDecelerationWalking
+	 */
+	UPROPERTY(Category="General", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0"))
+	float BrakingFriction;
+
+	/**
+	 * Time substepping when applying braking friction. Smaller time steps increase accuracy at the slight cost of performance, especially if there are large frame times.
+	 */
+	UPROPERTY(Category="General", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0166", ClampMax="0.05", UIMin="0.0166", UIMax="0.05"))
+	float BrakingSubStepTime;
+
+	/**
+	 * Deceleration when walking and not applying acceleration. This is a constant opposing force that directly lowers velocity by a constant value.
+	 * @see UBaseCharacterMovementComponent::GroundFriction, MaxAcceleration
+	 */
+	UPROPERTY(Category="Walking", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0"))
+	float BrakingDecelerationWalking;
+
+	/**
+	 * Lateral deceleration when falling and not applying acceleration.
+	 * @see MaxAcceleration
+	 */
+	UPROPERTY(Category="Jumping / Falling", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0"))
+	float BrakingDecelerationFalling;
+
+	/**
+	 * Deceleration when swimming and not applying acceleration.
+	 * @see MaxAcceleration
+	 */
+	UPROPERTY(Category="Swimming", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0"))
+	float BrakingDecelerationSwimming;
+
+	/**
+	 * Deceleration when flying and not applying acceleration.
+	 * @see MaxAcceleration
+	 */
+	UPROPERTY(Category="Flying", EditDefaultsOnly, meta=(ClampMin="0", UIMin="0"))
+	float BrakingDecelerationFlying;
+
+	/** Distance within which other agents are considered when computing the avoidance velocity. */
+	UPROPERTY(Category="Avoidance", EditDefaultsOnly, meta=(ForceUnits=cm))
+	float AvoidanceConsiderationRadius;
+
+	/** De facto default value 0.5 (due to that being the default in the avoidance registration function), indicates RVO behavior. */
+	UPROPERTY(Category="Avoidance", EditDefaultsOnly)
+	float AvoidanceWeight;
+
+	/**
+	 * How long to take to smoothly interpolate from the old pawn position on the client to the corrected one sent by the server. Not used by Linear smoothing.
+	 */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
+	float NetworkSimulatedSmoothLocationTime;
+
+	/**
+	 * How long to take to smoothly interpolate from the old pawn rotation on the client to the corrected one sent by the server. Not used by Linear smoothing.
+	 */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
+	float NetworkSimulatedSmoothRotationTime;
+
+	/**
+	* Similar setting as NetworkSimulatedSmoothLocationTime but only used on Listen servers.
+	*/
+	UPROPERTY(Category="Networking", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
+	float ListenServerNetworkSimulatedSmoothLocationTime;
+
+	/**
+	* Similar setting as NetworkSimulatedSmoothRotationTime but only used on Listen servers.
+	*/
+	UPROPERTY(Category="Networking", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
+	float ListenServerNetworkSimulatedSmoothRotationTime;
+
+	/**
+	 * How far behind the newest server snapshot simulated proxies using snapshot interpolation are displayed.
+	 * Should cover the interval between two movement updates of the character plus some jitter, so there is always a newer snapshot to interpolate to.
+	 * @see UBaseCharacterMovementComponent::bUseSnapshotInterpolation
+	 */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", ForceUnits=s))
+	float NetworkSnapshotInterpolationDelay;
+
+	/**
+	 * Shrink simulated proxy capsule radius by this amount, to account for network rounding that may cause encroachment. Changing during gameplay is not supported.
+	 * @see UBaseCharacterMovementComponent::AdjustProxyCapsuleSize()
+	 */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
+	float NetProxyShrinkRadius;
+
+	/**
+	 * Shrink simulated proxy capsule half height by this amount, to account for network rounding that may cause encroachment. Changing during gameplay is not supported.
+	 * @see UBaseCharacterMovementComponent::AdjustProxyCapsuleSize()
+	 */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
+	float NetProxyShrinkHalfHeight;
+
+	/** Maximum distance character is allowed to lag behind server location when interpolating between updates. */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
+	float NetworkMaxSmoothUpdateDistance;
+
+	/**
+	 * Maximum distance beyond which character is teleported to the new server location without any smoothing.
+	 */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
+	float NetworkNoSmoothUpdateDistance;
+
+	/**
+	 * Minimum time on the server between acknowledging good client moves. This can save on bandwidth. Set to 0 to disable throttling.
+	 */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=s))
+	float NetworkMinTimeBetweenClientAckGoodMoves;
+
+	/**
+	 * Minimum time on the server between sending client adjustments when client has exceeded allowable position error.
+	 * Should be >= NetworkMinTimeBetweenClientAdjustmentsLargeCorrection (the larger value is used regardless).
+  	 * This can save on bandwidth. Set to 0 to disable throttling.
+	 * @see UBaseCharacterMovementComponent::ServerLastClientAdjustmentTime
+	 */
+	UPROPERTY(Category="Networking", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=s))
+	float NetworkMinTimeBetweenClientAdjustments;
+
+	/**
+	* Minimum time on the server between sending client adjustments when client has exceeded allowable position error by a large amount (NetworkLargeClientCorrectionDistance).
+	* Should be <= NetworkMinTimeBetweenClientAdjustments (the smaller value is used regardless).
+	* @see NetworkMinTimeBetweenClientAdjustments
+	*/
+	UPROPERTY(Category="Networking", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=s))
+	float NetworkMinTimeBetweenClientAdjustmentsLargeCorrection;
+
+	/**
+	* If client error is larger than this, sets UBaseCharacterMovementComponent::bNetworkLargeClientCorrection to reduce delay between client adjustments.
+	* @see NetworkMinTimeBetweenClientAdjustments, NetworkMinTimeBetweenClientAdjustmentsLargeCorrection
+	*/
+	UPROPERTY(Category="Networking", EditDefaultsOnly, meta=(ClampMin="0.0", UIMin="0.0", ForceUnits=cm))
+	float NetworkLargeClientCorrectionDistance;
+};
@@ -0,0 +1,485 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BaseCharacterNetSerializers.h"
+#include "BaseCharacterMovementReplication.h"
+#include "BaseCharacterGravityNetSerialization.h"
+#include "EngineLogs.h"
+
+#if UE_WITH_IRIS
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetBitStreamUtil.h"
+#include "Iris/Serialization/NetSerializerDelegates.h"
+#include "Iris/Serialization/ObjectNetSerializer.h"
+#endif
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BaseCharacterNetSerializers)
+
+#if UE_WITH_IRIS
+
+namespace UE::Net
+{
+
+//////////////////////////////////////////////////////////////////////////
+// FBaseCharacterNetworkSerializationPackedBitsNetSerializer
+
+struct FBaseCharacterNetworkSerializationPackedBitsNetSerializer
+{
+	static constexpr uint32 Version = 0;
+
+	static constexpr bool bHasDynamicState = true;
+	static constexpr bool bHasCustomNetReference = true;
+
+	/** Object references are captured by UIrisObjectReferencePackageMap, a move never needs more than a handful of them. */
+	static constexpr uint32 MaxObjectReferences = 63;
+	static constexpr uint32 ObjectReferenceCountBits = 6;
+
+	struct FQuantizedType
+	{
+		uint32 NumBits;
+		uint32 MaxWords;
+		uint32* DataWords;
+
+		uint32 NumObjectReferences;
+		uint32 MaxObjectReferences;
+		uint8* ObjectReferenceStorage;
+	};
+
+	typedef FBaseCharacterNetworkSerializationPackedBits SourceType;
+	typedef FQuantizedType QuantizedType;
+	typedef FBaseCharacterNetworkSerializationPackedBitsNetSerializerConfig ConfigType;
+
+	static const ConfigType DefaultConfig;
+
+	static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+	static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+
+	static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+	static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+
+	static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+	static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+	static void CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args);
+	static void FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args);
+
+	static void CollectNetReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args);
+
+private:
+	/** Object references are quantized by the regular object serializer, this struct only stores them. */
+	static const FNetSerializer& GetObjectSerializer() { return UE_NET_GET_SERIALIZER(FObjectNetSerializer); }
+	static NetSerializerConfigParam GetObjectSerializerConfig() { return NetSerializerConfigParam(GetObjectSerializer().DefaultConfig); }
+
+	static uint8* GetObjectReference(const QuantizedType& Value, uint32 Index)
+	{
+		return Value.ObjectReferenceStorage + Index * GetObjectSerializer().QuantizedTypeSize;
+	}
+
+	static void GrowStorage(QuantizedType& Value, uint32 NumBits, uint32 NumObjectReferences);
+	static void FreeStorage(QuantizedType& Value);
+};
+
+UE_NET_IMPLEMENT_SERIALIZER(FBaseCharacterNetworkSerializationPackedBitsNetSerializer);
+
+const FBaseCharacterNetworkSerializationPackedBitsNetSerializer::ConfigType FBaseCharacterNetworkSerializationPackedBitsNetSerializer::DefaultConfig;
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::GrowStorage(QuantizedType& Value, uint32 NumBits, uint32 NumObjectReferences)
+{
+	// Quantized states are reused from frame to frame, only reallocate when the payload grows.
+	const uint32 NumWords = FMath::DivideAndRoundUp(NumBits, 32U);
+	if (NumWords > Value.MaxWords)
+	{
+		Value.DataWords = static_cast<uint32*>(FMemory::Realloc(Value.DataWords, NumWords * sizeof(uint32), alignof(uint32)));
+		Value.MaxWords = NumWords;
+	}
+
+	if (NumObjectReferences > Value.MaxObjectReferences)
+	{
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		Value.ObjectReferenceStorage = static_cast<uint8*>(FMemory::Realloc(Value.ObjectReferenceStorage, NumObjectReferences * ObjectSerializer.QuantizedTypeSize, ObjectSerializer.QuantizedTypeAlignment));
+		Value.MaxObjectReferences = NumObjectReferences;
+	}
+
+	Value.NumBits = NumBits;
+	Value.NumObjectReferences = NumObjectReferences;
+}
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::FreeStorage(QuantizedType& Value)
+{
+	FMemory::Free(Value.DataWords);
+	FMemory::Free(Value.ObjectReferenceStorage);
+	FMemory::Memzero(Value);
+}
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	WritePackedUint32(Writer, Value.NumBits);
+	if (Value.NumBits > 0)
+	{
+		Writer->WriteBitStream(Value.DataWords, 0U, Value.NumBits);
+	}
+
+	Writer->WriteBits(Value.NumObjectReferences, ObjectReferenceCountBits);
+	if (Value.NumObjectReferences > 0)
+	{
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetSerializeArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = GetObjectSerializerConfig();
+		for (uint32 Index = 0; Index < Value.NumObjectReferences; ++Index)
+		{
+			ObjectArgs.Source = NetSerializerValuePointer(GetObjectReference(Value, Index));
+			ObjectSerializer.Serialize(Context, ObjectArgs);
+		}
+	}
+}
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+{
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+	const uint32 NumBits = ReadPackedUint32(Reader);
+	if (NumBits > FBaseCharacterNetworkSerializationPackedBits::GetMaxNumBits())
+	{
+		// Protect against bad data that could cause server to allocate way too much memory.
+		UE_LOG(LogNetPlayerMovement, Error, TEXT("FBaseCharacterNetworkSerializationPackedBitsNetSerializer::Deserialize: Dropping move due to NumBits (%u) exceeding allowable limit (%u). See NetPackedMovementMaxBits."), NumBits, FBaseCharacterNetworkSerializationPackedBits::GetMaxNumBits());
+		Context.SetError(GNetError_ArraySizeTooLarge);
+		return;
+	}
+
+	// The reference count follows the payload, size the data words first and the references once known.
+	GrowStorage(Target, NumBits, Target.NumObjectReferences);
+	if (NumBits > 0)
+	{
+		Reader->ReadBitStream(Target.DataWords, NumBits);
+	}
+
+	const uint32 NumObjectReferences = Reader->ReadBits(ObjectReferenceCountBits);
+	GrowStorage(Target, NumBits, NumObjectReferences);
+	if (NumObjectReferences > 0)
+	{
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetDeserializeArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = GetObjectSerializerConfig();
+		for (uint32 Index = 0; Index < NumObjectReferences; ++Index)
+		{
+			ObjectArgs.Target = NetSerializerValuePointer(GetObjectReference(Target, Index));
+			ObjectSerializer.Deserialize(Context, ObjectArgs);
+		}
+	}
+}
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	const uint32 NumBits = static_cast<uint32>(Source.DataBits.Num());
+	const uint32 NumObjectReferences = static_cast<uint32>(Source.ObjectReferences.Num());
+	if (!ensureMsgf(NumObjectReferences <= MaxObjectReferences, TEXT("FBaseCharacterNetworkSerializationPackedBitsNetSerializer: Too many object references (%u) in packed move data."), NumObjectReferences))
+	{
+		Context.SetError(GNetError_ArraySizeTooLarge);
+		return;
+	}
+	GrowStorage(Target, NumBits, NumObjectReferences);
+
+	if (NumBits > 0)
+	{
+		FMemory::Memcpy(Target.DataWords, Source.DataBits.GetData(), FMath::DivideAndRoundUp(NumBits, 32U) * sizeof(uint32));
+	}
+
+	if (NumObjectReferences > 0)
+	{
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetQuantizeArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = GetObjectSerializerConfig();
+		for (uint32 Index = 0; Index < NumObjectReferences; ++Index)
+		{
+			UObject* Object = Source.ObjectReferences[Index];
+			ObjectArgs.Source = NetSerializerValuePointer(&Object);
+			ObjectArgs.Target = NetSerializerValuePointer(GetObjectReference(Target, Index));
+			ObjectSerializer.Quantize(Context, ObjectArgs);
+		}
+	}
+}
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+{
+	const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+
+	Target.DataBits.Init(false, Source.NumBits);
+	if (Source.NumBits > 0)
+	{
+		FMemory::Memcpy(Target.DataBits.GetData(), Source.DataWords, FMath::DivideAndRoundUp(Source.NumBits, 32U) * sizeof(uint32));
+	}
+
+	Target.ObjectReferences.Reset(Source.NumObjectReferences);
+	if (Source.NumObjectReferences > 0)
+	{
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetDequantizeArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = GetObjectSerializerConfig();
+		for (uint32 Index = 0; Index < Source.NumObjectReferences; ++Index)
+		{
+			UObject* Object = nullptr;
+			ObjectArgs.Source = NetSerializerValuePointer(GetObjectReference(Source, Index));
+			ObjectArgs.Target = NetSerializerValuePointer(&Object);
+			ObjectSerializer.Dequantize(Context, ObjectArgs);
+			Target.ObjectReferences.Add(Object);
+		}
+	}
+}
+
+bool FBaseCharacterNetworkSerializationPackedBitsNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+{
+	if (!Args.bStateIsQuantized)
+	{
+		const SourceType& Value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+		const SourceType& Value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+		return Value0.DataBits == Value1.DataBits && Value0.ObjectReferences == Value1.ObjectReferences;
+	}
+
+	const QuantizedType& Value0 = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+	const QuantizedType& Value1 = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+
+	if (Value0.NumBits != Value1.NumBits || Value0.NumObjectReferences != Value1.NumObjectReferences)
+	{
+		return false;
+	}
+
+	// Bits past NumBits in the last word are never written to the stream, ignore them.
+	const uint32 NumFullWords = Value0.NumBits / 32U;
+	if (NumFullWords > 0 && FMemory::Memcmp(Value0.DataWords, Value1.DataWords, NumFullWords * sizeof(uint32)) != 0)
+	{
+		return false;
+	}
+
+	if (const uint32 NumTailBits = Value0.NumBits & 31U)
+	{
+		const uint32 TailMask = (1U << NumTailBits) - 1U;
+		if (((Value0.DataWords[NumFullWords] ^ Value1.DataWords[NumFullWords]) & TailMask) != 0)
+		{
+			return false;
+		}
+	}
+
+	const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+	FNetIsEqualArgs ObjectArgs = Args;
+	ObjectArgs.NetSerializerConfig = GetObjectSerializerConfig();
+	for (uint32 Index = 0; Index < Value0.NumObjectReferences; ++Index)
+	{
+		ObjectArgs.Source0 = NetSerializerValuePointer(GetObjectReference(Value0, Index));
+		ObjectArgs.Source1 = NetSerializerValuePointer(GetObjectReference(Value1, Index));
+		if (!ObjectSerializer.IsEqual(Context, ObjectArgs))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FBaseCharacterNetworkSerializationPackedBitsNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	return static_cast<uint32>(Source.DataBits.Num()) <= FBaseCharacterNetworkSerializationPackedBits::GetMaxNumBits()
+		&& static_cast<uint32>(Source.ObjectReferences.Num()) <= MaxObjectReferences;
+}
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args)
+{
+	const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	// Target is a shallow copy of Source at this point, give it storage of its own.
+	Target.DataWords = nullptr;
+	Target.MaxWords = 0;
+	Target.ObjectReferenceStorage = nullptr;
+	Target.MaxObjectReferences = 0;
+	GrowStorage(Target, Source.NumBits, Source.NumObjectReferences);
+
+	if (Source.NumBits > 0)
+	{
+		FMemory::Memcpy(Target.DataWords, Source.DataWords, FMath::DivideAndRoundUp(Source.NumBits, 32U) * sizeof(uint32));
+	}
+
+	if (Source.NumObjectReferences > 0)
+	{
+		FMemory::Memcpy(Target.ObjectReferenceStorage, Source.ObjectReferenceStorage, Source.NumObjectReferences * GetObjectSerializer().QuantizedTypeSize);
+	}
+}
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args)
+{
+	QuantizedType& Value = *reinterpret_cast<QuantizedType*>(Args.Source);
+	FreeStorage(Value);
+}
+
+void FBaseCharacterNetworkSerializationPackedBitsNetSerializer::CollectNetReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+
+	const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+	FNetCollectReferencesArgs ObjectArgs = Args;
+	ObjectArgs.NetSerializerConfig = GetObjectSerializerConfig();
+	for (uint32 Index = 0; Index < Value.NumObjectReferences; ++Index)
+	{
+		ObjectArgs.Source = NetSerializerValuePointer(GetObjectReference(Value, Index));
+		ObjectSerializer.CollectNetReferences(Context, ObjectArgs);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FVectorNetQuantizeGravityNetSerializer
+
+struct FVectorNetQuantizeGravityNetSerializer
+{
+	static constexpr uint32 Version = 0;
+
+	/** The packed form of BaseGravityNetSerialization::PackDirection(). */
+	typedef uint32 QuantizedType;
+	typedef FVector_NetQuantizeGravity SourceType;
+	typedef FVectorNetQuantizeGravityNetSerializerConfig ConfigType;
+
+	static const ConfigType DefaultConfig;
+
+	static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+	static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+
+	static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+	static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+
+	static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+	static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+private:
+	static constexpr uint32 CardinalAxisBits = 3;
+};
+
+UE_NET_IMPLEMENT_SERIALIZER(FVectorNetQuantizeGravityNetSerializer);
+
+const FVectorNetQuantizeGravityNetSerializer::ConfigType FVectorNetQuantizeGravityNetSerializer::DefaultConfig;
+
+void FVectorNetQuantizeGravityNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+{
+	using namespace BaseGravityNetSerialization;
+
+	const QuantizedType Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	// Same layout as the legacy path, one flag bit then either the axis or both octahedral components.
+	if (Writer->WriteBool(IsPackedCardinal(Value)))
+	{
+		Writer->WriteBits(Value >> 1, CardinalAxisBits);
+	}
+	else
+	{
+		Writer->WriteBits(Value >> 1, 2 * OctahedralComponentBits);
+	}
+}
+
+void FVectorNetQuantizeGravityNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+{
+	using namespace BaseGravityNetSerialization;
+
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+	if (Reader->ReadBool())
+	{
+		const uint32 CardinalAxis = Reader->ReadBits(CardinalAxisBits);
+		if (CardinalAxis >= NumCardinalAxes)
+		{
+			Context.SetError(GNetError_InvalidValue);
+			return;
+		}
+		Target = 1U | (CardinalAxis << 1);
+	}
+	else
+	{
+		Target = Reader->ReadBits(2 * OctahedralComponentBits) << 1;
+	}
+}
+
+void FVectorNetQuantizeGravityNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	Target = BaseGravityNetSerialization::PackDirection(Source);
+}
+
+void FVectorNetQuantizeGravityNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+{
+	const QuantizedType Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+	Target = BaseGravityNetSerialization::UnpackDirection(Source);
+}
+
+bool FVectorNetQuantizeGravityNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+{
+	if (Args.bStateIsQuantized)
+	{
+		return *reinterpret_cast<const QuantizedType*>(Args.Source0) == *reinterpret_cast<const QuantizedType*>(Args.Source1);
+	}
+
+	const SourceType& Value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+	const SourceType& Value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+	return BaseGravityNetSerialization::PackDirection(Value0) == BaseGravityNetSerialization::PackDirection(Value1);
+}
+
+bool FVectorNetQuantizeGravityNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	return !Source.ContainsNaN();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Registration
+
+static const FName PropertyNetSerializerRegistry_NAME_BaseCharacterNetworkSerializationPackedBits(TEXT("BaseCharacterNetworkSerializationPackedBits"));
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterNetworkSerializationPackedBits, FBaseCharacterNetworkSerializationPackedBitsNetSerializer);
+
+// Struct serializers do not carry over to subclasses, so the RPC payload types are forwarded explicitly.
+static const FName PropertyNetSerializerRegistry_NAME_BaseCharacterServerMovePackedBits(TEXT("BaseCharacterServerMovePackedBits"));
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterServerMovePackedBits, FBaseCharacterNetworkSerializationPackedBitsNetSerializer);
+
+static const FName PropertyNetSerializerRegistry_NAME_BaseCharacterMoveResponsePackedBits(TEXT("BaseCharacterMoveResponsePackedBits"));
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterMoveResponsePackedBits, FBaseCharacterNetworkSerializationPackedBitsNetSerializer);
+
+static const FName PropertyNetSerializerRegistry_NAME_Vector_NetQuantizeGravity(TEXT("Vector_NetQuantizeGravity"));
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector_NetQuantizeGravity, FVectorNetQuantizeGravityNetSerializer);
+
+class FBaseCharacterNetSerializerRegistryDelegates final : private FNetSerializerRegistryDelegates
+{
+	virtual ~FBaseCharacterNetSerializerRegistryDelegates();
+
+	virtual void OnPreFreezeNetSerializerRegistry() override;
+
+	static FBaseCharacterNetSerializerRegistryDelegates Instance;
+};
+
+FBaseCharacterNetSerializerRegistryDelegates FBaseCharacterNetSerializerRegistryDelegates::Instance;
+
+FBaseCharacterNetSerializerRegistryDelegates::~FBaseCharacterNetSerializerRegistryDelegates()
+{
+	UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterNetworkSerializationPackedBits);
+	UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterServerMovePackedBits);
+	UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterMoveResponsePackedBits);
+	UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector_NetQuantizeGravity);
+}
+
+void FBaseCharacterNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+{
+	UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterNetworkSerializationPackedBits);
+	UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterServerMovePackedBits);
+	UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_BaseCharacterMoveResponsePackedBits);
+	UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector_NetQuantizeGravity);
+}
+
+}
+
+#endif // UE_WITH_IRIS
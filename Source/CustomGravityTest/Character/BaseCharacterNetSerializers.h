@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Iris/Serialization/NetSerializer.h"
+#include "BaseCharacterNetSerializers.generated.h"
+
+/**
+ * Iris serializers for the character movement replication structs.
+ *
+ * FBaseCharacterNetworkSerializationPackedBits and its ServerMove / MoveResponse subclasses carry the packed move and move
+ * response RPC payloads, FVector_NetQuantizeGravity the replicated gravity direction. Without these, Iris falls back to
+ * calling their legacy NetSerialize() on the game thread. FBaseBasedMovementInfo is made only of regular properties and
+ * already gets a generated Iris descriptor.
+ */
+
+USTRUCT()
+struct FBaseCharacterNetworkSerializationPackedBitsNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+USTRUCT()
+struct FVectorNetQuantizeGravityNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+namespace UE::Net
+{
+
+UE_NET_DECLARE_SERIALIZER(FBaseCharacterNetworkSerializationPackedBitsNetSerializer, );
+UE_NET_DECLARE_SERIALIZER(FVectorNetQuantizeGravityNetSerializer, );
+
+}
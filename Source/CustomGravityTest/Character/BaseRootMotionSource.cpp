@@ -103,10 +103,56 @@ FBaseRootMotionServerToLocalIDMapping::FBaseRootMotionServerToLocalIDMapping()
 {
 }
 
-bool FBaseRootMotionServerToLocalIDMapping::IsStillValid(float CurrentTimeStamp)
+bool FBaseRootMotionServerToLocalIDMapping::IsStillValid(float CurrentTimeStamp) const
 {
-	const float MappingValidityDuration = 3.0f; // Mappings updated within this many seconds are still valid
-	return TimeStamp >= (CurrentTimeStamp - MappingValidityDuration);
+	return TimeStamp >= (CurrentTimeStamp - ValidityDuration);
+}
+
+//
+// FBaseRootMotionServerToLocalIDMap
+//
+
+void FBaseRootMotionServerToLocalIDMap::Add(uint16 ServerID, uint16 LocalID, float TimeStamp)
+{
+	if (const FBaseRootMotionServerToLocalIDMapping* PreviousMapping = MappingsByServerID.Find(ServerID))
+	{
+		ServerIDsByLocalID.Remove(PreviousMapping->LocalID);
+	}
+	if (const uint16* PreviousServerID = ServerIDsByLocalID.Find(LocalID))
+	{
+		MappingsByServerID.Remove(*PreviousServerID);
+	}
+
+	FBaseRootMotionServerToLocalIDMapping& Mapping = MappingsByServerID.Add(ServerID);
+	Mapping.ServerID = ServerID;
+	Mapping.LocalID = LocalID;
+	Mapping.TimeStamp = TimeStamp;
+	ServerIDsByLocalID.Add(LocalID, ServerID);
+
+	OldestTimeStamp = FMath::Min(OldestTimeStamp, TimeStamp);
+}
+
+void FBaseRootMotionServerToLocalIDMap::RemoveExpired(float CurrentTimeStamp)
+{
+	// Mappings only get newer when updated, so nothing expired while the oldest time stamp is still valid.
+	if (OldestTimeStamp >= CurrentTimeStamp - FBaseRootMotionServerToLocalIDMapping::ValidityDuration)
+	{
+		return;
+	}
+
+	OldestTimeStamp = MAX_flt;
+	for (FMappingsByServerID::TIterator It = MappingsByServerID.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsStillValid(CurrentTimeStamp))
+		{
+			ServerIDsByLocalID.Remove(It.Value().LocalID);
+			It.RemoveCurrent();
+		}
+		else
+		{
+			OldestTimeStamp = FMath::Min(OldestTimeStamp, It.Value().TimeStamp);
+		}
+	}
 }
 
 //
@@ -1447,7 +1493,7 @@ void FBaseRootMotionSourceGroup::PrepareRootMotion(float DeltaTime, const ABaseC
 	// Add pending sources
 	{
 		RootMotionSources.Append(PendingAddRootMotionSources);
-		PendingAddRootMotionSources.Empty();
+		PendingAddRootMotionSources.Reset();
 	}
 
 	// Sort by priority
@@ -1478,6 +1524,8 @@ void FBaseRootMotionSourceGroup::PrepareRootMotion(float DeltaTime, const ABaseC
 			{
 				if (!RootMotionSource->Status.HasFlag(EBaseRootMotionSourceStatusFlags::Prepared) || bForcePrepareAll)
 				{
+					MakeSourceUnique(RootMotionSource);
+
 					float SimulationTime = DeltaTime;
 
 					// If we've received authoritative correction to root motion state, we need to
@@ -1768,8 +1816,9 @@ void FBaseRootMotionSourceGroup::SetPendingRootMotionSourceMinStartTimes(float N
 {
 	for (auto& RootMotionSource : PendingAddRootMotionSources)
 	{
-		if (RootMotionSource.IsValid())
+		if (RootMotionSource.IsValid() && RootMotionSource->StartTime < NewStartTime)
 		{
+			MakeSourceUnique(RootMotionSource);
 			const float PreviousStartTime = RootMotionSource->StartTime;
 			const float MinStartTime = NewStartTime;
 			RootMotionSource->StartTime = FMath::Max(PreviousStartTime, NewStartTime);
@@ -1789,6 +1838,7 @@ void FBaseRootMotionSourceGroup::ApplyTimeStampReset(float DeltaTime)
 	{
 		if (RootMotionSource.IsValid() && RootMotionSource->IsStartTimeValid())
 		{
+			MakeSourceUnique(RootMotionSource);
 			const float PreviousStartTime = RootMotionSource->StartTime;
 			RootMotionSource->StartTime -= DeltaTime;
 			UE_LOG(LogRootMotion, VeryVerbose, TEXT("Applying time stamp reset to RootMotionSource %s StartTime: previous(%f), new(%f)"), *RootMotionSource->ToSimpleString(), PreviousStartTime, RootMotionSource->StartTime);
@@ -1799,6 +1849,7 @@ void FBaseRootMotionSourceGroup::ApplyTimeStampReset(float DeltaTime)
 	{
 		if (RootMotionSource.IsValid() && RootMotionSource->IsStartTimeValid())
 		{
+			MakeSourceUnique(RootMotionSource);
 			const float PreviousStartTime = RootMotionSource->StartTime;
 			RootMotionSource->StartTime -= DeltaTime;
 			UE_LOG(LogRootMotion, VeryVerbose, TEXT("Applying time stamp reset to PendingAddRootMotionSource %s StartTime: previous(%f), new(%f)"), *RootMotionSource->ToSimpleString(), PreviousStartTime, RootMotionSource->StartTime);
@@ -1836,18 +1887,22 @@ uint16 FBaseRootMotionSourceGroup::ApplyRootMotionSource(TSharedPtr<FBaseRootMot
 
 TSharedPtr<FBaseRootMotionSource> FBaseRootMotionSourceGroup::GetRootMotionSource(FName InstanceName)
 {
-	for (const auto& RootMotionSource : RootMotionSources)
+	for (auto& RootMotionSource : RootMotionSources)
 	{
 		if (RootMotionSource.IsValid() && RootMotionSource->InstanceName == InstanceName)
 		{
+			// The caller may modify the source, so it can't stay shared with copies of this group.
+			MakeSourceUnique(RootMotionSource);
 			return TSharedPtr<FBaseRootMotionSource>(RootMotionSource);
 		}
 	}
 
-	for (const auto& RootMotionSource : PendingAddRootMotionSources)
+	for (auto& RootMotionSource : PendingAddRootMotionSources)
 	{
 		if (RootMotionSource.IsValid() && RootMotionSource->InstanceName == InstanceName)
 		{
+			// The caller may modify the source, so it can't stay shared with copies of this group.
+			MakeSourceUnique(RootMotionSource);
 			return TSharedPtr<FBaseRootMotionSource>(RootMotionSource);
 		}
 	}
@@ -1857,18 +1912,22 @@ TSharedPtr<FBaseRootMotionSource> FBaseRootMotionSourceGroup::GetRootMotionSourc
 
 TSharedPtr<FBaseRootMotionSource> FBaseRootMotionSourceGroup::GetRootMotionSourceByID(uint16 RootMotionSourceID)
 {
-	for (const auto& RootMotionSource : RootMotionSources)
+	for (auto& RootMotionSource : RootMotionSources)
 	{
 		if (RootMotionSource.IsValid() && RootMotionSource->LocalID == RootMotionSourceID)
 		{
+			// The caller may modify the source, so it can't stay shared with copies of this group.
+			MakeSourceUnique(RootMotionSource);
 			return TSharedPtr<FBaseRootMotionSource>(RootMotionSource);
 		}
 	}
 
-	for (const auto& RootMotionSource : PendingAddRootMotionSources)
+	for (auto& RootMotionSource : PendingAddRootMotionSources)
 	{
 		if (RootMotionSource.IsValid() && RootMotionSource->LocalID == RootMotionSourceID)
 		{
+			// The caller may modify the source, so it can't stay shared with copies of this group.
+			MakeSourceUnique(RootMotionSource);
 			return TSharedPtr<FBaseRootMotionSource>(RootMotionSource);
 		}
 	}
@@ -1880,18 +1939,20 @@ void FBaseRootMotionSourceGroup::RemoveRootMotionSource(FName InstanceName)
 {
 	if (!InstanceName.IsNone()) // Don't allow removing None since that's the default
 	{
-		for (const auto& RootMotionSource : RootMotionSources)
+		for (auto& RootMotionSource : RootMotionSources)
 		{
 			if (RootMotionSource.IsValid() && RootMotionSource->InstanceName == InstanceName)
 			{
+				MakeSourceUnique(RootMotionSource);
 				RootMotionSource->Status.SetFlag(EBaseRootMotionSourceStatusFlags::MarkedForRemoval);
 			}
 		}
 
-		for (const auto& RootMotionSource : PendingAddRootMotionSources)
+		for (auto& RootMotionSource : PendingAddRootMotionSources)
 		{
 			if (RootMotionSource.IsValid() && RootMotionSource->InstanceName == InstanceName)
 			{
+				MakeSourceUnique(RootMotionSource);
 				RootMotionSource->Status.SetFlag(EBaseRootMotionSourceStatusFlags::MarkedForRemoval);
 			}
 		}
@@ -1902,18 +1963,20 @@ void FBaseRootMotionSourceGroup::RemoveRootMotionSourceByID(uint16 RootMotionSou
 {
 	if (RootMotionSourceID != (uint16)EBaseRootMotionSourceID::Invalid)
 	{
-		for (const auto& RootMotionSource : RootMotionSources)
+		for (auto& RootMotionSource : RootMotionSources)
 		{
 			if (RootMotionSource.IsValid() && RootMotionSource->LocalID == RootMotionSourceID)
 			{
+				MakeSourceUnique(RootMotionSource);
 				RootMotionSource->Status.SetFlag(EBaseRootMotionSourceStatusFlags::MarkedForRemoval);
 			}
 		}
 
-		for (const auto& RootMotionSource : PendingAddRootMotionSources)
+		for (auto& RootMotionSource : PendingAddRootMotionSources)
 		{
 			if (RootMotionSource.IsValid() && RootMotionSource->LocalID == RootMotionSourceID)
 			{
+				MakeSourceUnique(RootMotionSource);
 				RootMotionSource->Status.SetFlag(EBaseRootMotionSourceStatusFlags::MarkedForRemoval);
 			}
 		}
@@ -1954,7 +2017,7 @@ void FBaseRootMotionSourceGroup::UpdateStateFrom(const FBaseRootMotionSourceGrou
 	{
 		if (TakeFromRootMotionSource.IsValid() && (TakeFromRootMotionSource->LocalID != (uint16)EBaseRootMotionSourceID::Invalid))
 		{
-			for (const TSharedPtr<FBaseRootMotionSource>& RootMotionSource : RootMotionSources)
+			for (TSharedPtr<FBaseRootMotionSource>& RootMotionSource : RootMotionSources)
 			{
 				if (RootMotionSource.IsValid() && (RootMotionSource->LocalID == TakeFromRootMotionSource->LocalID))
 				{
@@ -1992,6 +2055,7 @@ void FBaseRootMotionSourceGroup::UpdateStateFrom(const FBaseRootMotionSourceGrou
 						continue;
 					}
 
+					MakeSourceUnique(RootMotionSource);
 					const bool bSuccess = RootMotionSource->UpdateStateFrom(TakeFromRootMotionSource.Get(), bMarkForSimulatedCatchup);
 					if (bSuccess)
 					{
@@ -2023,7 +2087,7 @@ struct FBaseRootMotionSourceDeleter
 	}
 };
 
-void FBaseRootMotionSourceGroup::NetSerializeRMSArray(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, TArray< TSharedPtr<FBaseRootMotionSource> >& RootMotionSourceArray, uint8 MaxNumRootMotionSourcesToSerialize/* = MAX_uint8*/)
+void FBaseRootMotionSourceGroup::NetSerializeRMSArray(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, FBaseRootMotionSourceArray& RootMotionSourceArray, uint8 MaxNumRootMotionSourcesToSerialize/* = MAX_uint8*/)
 {
 	uint8 SourcesNum;
 	if (Ar.IsSaving())
@@ -2067,10 +2131,10 @@ void FBaseRootMotionSourceGroup::NetSerializeRMSArray(FArchive& Ar, class UPacka
 			{
 				if (Ar.IsLoading())
 				{
-					if (RootMotionSourceArray[i].IsValid() && ScriptStructLocal == ScriptStruct.Get())
+					if (RootMotionSourceArray[i].IsValid() && RootMotionSourceArray[i].IsUnique() && ScriptStructLocal == ScriptStruct.Get())
 					{
-						// What we have locally is the same type as we're being serialized into, so we don't need to
-						// reallocate - just use existing structure
+						// What we have locally is the same type as we're being serialized into and no other group
+						// shares it, so we don't need to reallocate - just use existing structure
 					}
 					else
 					{
@@ -2169,8 +2233,8 @@ void FBaseRootMotionSourceGroup::CullInvalidSources()
 
 void FBaseRootMotionSourceGroup::Clear()
 {
-	RootMotionSources.Empty();
-	PendingAddRootMotionSources.Empty();
+	RootMotionSources.Reset();
+	PendingAddRootMotionSources.Reset();
 	bIsAdditiveVelocityApplied = false;
 	bHasAdditiveSources = false;
 	bHasOverrideSources = false;
@@ -2178,19 +2242,25 @@ void FBaseRootMotionSourceGroup::Clear()
 	LastAccumulatedSettings.Clear();
 }
 
+void FBaseRootMotionSourceGroup::MakeSourceUnique(TSharedPtr<FBaseRootMotionSource>& RootMotionSource)
+{
+	if (RootMotionSource.IsValid() && !RootMotionSource.IsUnique())
+	{
+		RootMotionSource = TSharedPtr<FBaseRootMotionSource>(RootMotionSource->Clone());
+	}
+}
+
 FBaseRootMotionSourceGroup& FBaseRootMotionSourceGroup::operator=(const FBaseRootMotionSourceGroup& Other)
 {
-	// Perform deep copy of this Group
+	// Share the Sources of Other, whichever group modifies one first clones it (see MakeSourceUnique())
 	if (this != &Other)
 	{
-		// Deep copy Sources
-		RootMotionSources.Empty(Other.RootMotionSources.Num());
-		for (int i = 0; i < Other.RootMotionSources.Num(); ++i)
+		RootMotionSources.Reset(Other.RootMotionSources.Num());
+		for (const TSharedPtr<FBaseRootMotionSource>& RootMotionSource : Other.RootMotionSources)
 		{
-			if (Other.RootMotionSources[i].IsValid())
+			if (RootMotionSource.IsValid())
 			{
-				FBaseRootMotionSource* CopyOfSourcePtr = Other.RootMotionSources[i]->Clone();
-				RootMotionSources.Add(TSharedPtr<FBaseRootMotionSource>(CopyOfSourcePtr));
+				RootMotionSources.Add(RootMotionSource);
 			}
 			else
 			{
@@ -2198,14 +2268,12 @@ FBaseRootMotionSourceGroup& FBaseRootMotionSourceGroup::operator=(const FBaseRoo
 			}
 		}
 
-		// Deep copy PendingAdd sources
-		PendingAddRootMotionSources.Empty(Other.PendingAddRootMotionSources.Num());
-		for (int i = 0; i < Other.PendingAddRootMotionSources.Num(); ++i)
+		PendingAddRootMotionSources.Reset(Other.PendingAddRootMotionSources.Num());
+		for (const TSharedPtr<FBaseRootMotionSource>& RootMotionSource : Other.PendingAddRootMotionSources)
 		{
-			if (Other.PendingAddRootMotionSources[i].IsValid())
+			if (RootMotionSource.IsValid())
 			{
-				FBaseRootMotionSource* CopyOfSourcePtr = Other.PendingAddRootMotionSources[i]->Clone();
-				PendingAddRootMotionSources.Add(TSharedPtr<FBaseRootMotionSource>(CopyOfSourcePtr));
+				PendingAddRootMotionSources.Add(RootMotionSource);
 			}
 			else
 			{
@@ -2249,7 +2317,7 @@ bool FBaseRootMotionSourceGroup::operator==(const FBaseRootMotionSourceGroup& Ot
 		{
 			if (RootMotionSources[i].IsValid())
 			{
-				if (!RootMotionSources[i]->MatchesAndHasSameState(Other.RootMotionSources[i].Get()))
+				if (RootMotionSources[i] != Other.RootMotionSources[i] && !RootMotionSources[i]->MatchesAndHasSameState(Other.RootMotionSources[i].Get()))
 				{
 					return false; // They're valid and don't match/have same state
 				}
@@ -2266,7 +2334,7 @@ bool FBaseRootMotionSourceGroup::operator==(const FBaseRootMotionSourceGroup& Ot
 		{
 			if (PendingAddRootMotionSources[i].IsValid())
 			{
-				if (!PendingAddRootMotionSources[i]->MatchesAndHasSameState(Other.PendingAddRootMotionSources[i].Get()))
+				if (PendingAddRootMotionSources[i] != Other.PendingAddRootMotionSources[i] && !PendingAddRootMotionSources[i]->MatchesAndHasSameState(Other.PendingAddRootMotionSources[i].Get()))
 				{
 					return false; // They're valid and don't match/have same state
 				}
@@ -87,8 +87,60 @@ struct FBaseRootMotionServerToLocalIDMapping
 	uint16 LocalID; // ID of root motion source on local client
 	float TimeStamp; // Last time this ID mapping was updated/still valid
 
+	// Mappings updated within this many seconds are still valid
+	static constexpr float ValidityDuration = 3.0f;
+
 	// Given CurrentTimeStamp, returns whether this mapping is still valid (has expired yet)
-	bool IsStillValid(float CurrentTimeStamp);
+	bool IsStillValid(float CurrentTimeStamp) const;
+};
+
+/**
+ * Set of RootMotionSource server to local ID mappings, indexed by both IDs.
+ * Expired mappings are removed in bulk, and only once the oldest mapping can have expired.
+ */
+struct FBaseRootMotionServerToLocalIDMap
+{
+	/** Number of mappings stored without allocating. */
+	static constexpr int32 InlineSize = 16;
+
+	typedef TMap<uint16, FBaseRootMotionServerToLocalIDMapping, TInlineSetAllocator<InlineSize>> FMappingsByServerID;
+
+	/** Returns the mapping of a server ID, or nullptr. Its TimeStamp can be updated in place. */
+	FBaseRootMotionServerToLocalIDMapping* FindByServerID(uint16 ServerID) { return MappingsByServerID.Find(ServerID); }
+
+	/** Returns true if a server ID is already mapped to LocalID. */
+	bool ContainsLocalID(uint16 LocalID) const { return ServerIDsByLocalID.Contains(LocalID); }
+
+	/** Maps ServerID to LocalID, replacing any previous mapping of either ID. */
+	void Add(uint16 ServerID, uint16 LocalID, float TimeStamp);
+
+	/** Removes every mapping that is no longer valid at CurrentTimeStamp. */
+	void RemoveExpired(float CurrentTimeStamp);
+
+	/** Removes every mapping for which Predicate returns true. */
+	template<typename PredicateType>
+	void RemoveAll(PredicateType Predicate)
+	{
+		for (FMappingsByServerID::TIterator It = MappingsByServerID.CreateIterator(); It; ++It)
+		{
+			if (Predicate(It.Value()))
+			{
+				ServerIDsByLocalID.Remove(It.Value().LocalID);
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	int32 Num() const { return MappingsByServerID.Num(); }
+
+	const FMappingsByServerID& GetMappings() const { return MappingsByServerID; }
+
+private:
+	FMappingsByServerID MappingsByServerID;
+	TMap<uint16, uint16, TInlineSetAllocator<InlineSize>> ServerIDsByLocalID;
+
+	/** No mapping was updated before this time, used to skip RemoveExpired() while nothing can have expired. */
+	float OldestTimeStamp = MAX_flt;
 };
 
 /** 
@@ -735,9 +787,15 @@ struct TStructOpsTypeTraits< FBaseRootMotionSource_JumpForce > : public TStructO
 	};
 };
 
+/** Array of root motion sources, with enough inline room for the sources an ability commonly stacks so copying a group does not allocate. */
+typedef TArray< TSharedPtr<FBaseRootMotionSource>, TInlineAllocator<4> > FBaseRootMotionSourceArray;
+
 /**
  *	Group of Root Motion Sources that are applied
  *
+ *	Copies of a group share their sources until one of them modifies a source, which is then cloned (copy-on-write).
+ *	Saving, combining and restoring moves only copies pointers this way. Code modifying a source of
+ *	RootMotionSources or PendingAddRootMotionSources directly must call MakeSourceUnique() on it first.
  **/
 USTRUCT()
 struct FBaseRootMotionSourceGroup
@@ -749,10 +807,10 @@ struct FBaseRootMotionSourceGroup
 	virtual ~FBaseRootMotionSourceGroup() {}
 
 	/** Root Motion Sources currently applied in this Group */
-	TArray< TSharedPtr<FBaseRootMotionSource> > RootMotionSources;
+	FBaseRootMotionSourceArray RootMotionSources;
 
 	/** Root Motion Sources to be added next frame */
-	TArray< TSharedPtr<FBaseRootMotionSource> > PendingAddRootMotionSources;
+	FBaseRootMotionSourceArray PendingAddRootMotionSources;
 
 	/** 
 	 *  Whether this group has additive root motion sources
@@ -840,10 +898,13 @@ struct FBaseRootMotionSourceGroup
 	 *  @return LocalID for this RMS */
 	uint16 ApplyRootMotionSource(TSharedPtr<FBaseRootMotionSource> SourcePtr);
 
-	/** Get a RootMotionSource from this Group by name */
+	/**
+	 * Get a RootMotionSource from this Group by name. The source is made unique so the caller can modify it.
+	 * Look it up again instead of keeping the pointer across frames, a held pointer makes the group clone the source on its next update.
+	 */
 	TSharedPtr<FBaseRootMotionSource> GetRootMotionSource(FName InstanceName);
 
-	/** Get a RootMotionSource from this Group by ID */
+	/** Get a RootMotionSource from this Group by ID. @see GetRootMotionSource() */
 	TSharedPtr<FBaseRootMotionSource> GetRootMotionSourceByID(uint16 RootMotionSourceID);
 
 	/** Remove a RootMotionSource from this Group by name */
@@ -870,7 +931,10 @@ struct FBaseRootMotionSourceGroup
 	/** Removes any Sources without a valid ID */
 	void CullInvalidSources();
 
-	/** Copy operator - deep copy so it can be used for archiving/saving off moves */
+	/** Clones RootMotionSource if it is shared with another group, so it can be modified without affecting copies of this group. */
+	static void MakeSourceUnique(TSharedPtr<FBaseRootMotionSource>& RootMotionSource);
+
+	/** Copy operator - shares the sources of Other, they are cloned once either group modifies them */
 	FBaseRootMotionSourceGroup& operator=(const FBaseRootMotionSourceGroup& Other);
 
 	/** Comparison operator - needs matching Sources along with identical states in those sources */
@@ -891,7 +955,7 @@ protected:
 	void AccumulateRootMotionVelocityFromSource(const FBaseRootMotionSource& RootMotionSource, float DeltaTime, const ABaseCharacter& Character, const UBaseCharacterMovementComponent& MoveComponent, FVector& InOutVelocity) const;
 
 	/** Helper function for serializing array of root motion sources */
-	static void NetSerializeRMSArray(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, TArray< TSharedPtr<FBaseRootMotionSource> >& RootMotionSourceArray, uint8 MaxNumRootMotionSourcesToSerialize = MAX_uint8);
+	static void NetSerializeRMSArray(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, FBaseRootMotionSourceArray& RootMotionSourceArray, uint8 MaxNumRootMotionSourcesToSerialize = MAX_uint8);
 
 };
 
@@ -900,7 +964,7 @@ struct TStructOpsTypeTraits<FBaseRootMotionSourceGroup> : public TStructOpsTypeT
 {
 	enum
 	{
-		WithCopy = true,		// Necessary so that TSharedPtr<FBaseRootMotionSource> Data is copied around
+		WithCopy = true,		// Necessary so that TSharedPtr<FBaseRootMotionSource> Data is shared around
 		WithNetSerializer = true,
 		WithIdenticalViaEquality = true,
 		WithAddStructReferencedObjects = true,
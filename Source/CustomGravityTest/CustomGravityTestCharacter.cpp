@@ -12,10 +12,14 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "GravityBoxAreaVolume.h"
+#include "GravityFieldSubsystem.h"
 #include "InputActionValue.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
+// Gravity of a box following a moving base is resynced with the box past one degree of numerical drift.
+static const float GravityFollowingBaseResyncDot = 0.99985f;
+
 //////////////////////////////////////////////////////////////////////////
 // ACustomGravityTestCharacter
 
@@ -37,10 +41,10 @@ ACustomGravityTestCharacter::ACustomGravityTestCharacter()
 	// instead of recompiling to adjust them
 	GetCharacterMovement()->JumpZVelocity = 700.f;
 	GetCharacterMovement()->AirControl = 0.35f;
-	GetCharacterMovement()->MaxWalkSpeed = 500.f;
-	GetCharacterMovement()->MinAnalogWalkSpeed = 20.f;
-	GetCharacterMovement()->BrakingDecelerationWalking = 2000.f;
-	GetCharacterMovement()->BrakingDecelerationFalling = 1500.0f;
+	GetCharacterMovement()->SetMovementSetting(EBaseCharacterMovementSetting::MaxWalkSpeed, 500.f);
+	GetCharacterMovement()->SetMovementSetting(EBaseCharacterMovementSetting::MinAnalogWalkSpeed, 20.f);
+	GetCharacterMovement()->SetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationWalking, 2000.f);
+	GetCharacterMovement()->SetMovementSetting(EBaseCharacterMovementSetting::BrakingDecelerationFalling, 1500.0f);
 
 	// Create a camera boom (pulls in towards the player if there is a collision)
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
@@ -83,32 +87,50 @@ void ACustomGravityTestCharacter::Tick(float DeltaSeconds)
 	if (GetLocalRole() >= ROLE_AutonomousProxy && MovementComponent->MovementMode != EMovementMode::MOVE_None)
 	{
 		// Update gravity
-		FOverlapResult GravityOverlapResult = FindGravityOverlap();
-		if (GravityOverlapResult.Component != nullptr)
+		const FGravityFieldSample GravityField = FindGravityField();
+
+		// While a box moves with the movement base, based movement already rotated gravity in every move. Only resync when it drifted.
+		// Other fields change direction with the location inside of them, so they are sampled every frame.
+		const bool bGravityFollowsBase = GravityField.Component == CurrentGravityField.Get() && MovementComponent->ShouldGravityFollowBase();
+		if (GravityField.IsValid() && (!bGravityFollowsBase || (GravityField.Direction | MovementComponent->GetGravityDirection()) < GravityFollowingBaseResyncDot))
 		{
-			// const FVector UpVector = GravityOverlapResult.GetActor()->GetActorUpVector();
-			const FVector UpVector = GravityOverlapResult.GetComponent()->GetUpVector();
-			MovementComponent->SetGravityDirection(UpVector * -1.0f);
-	
-			if (MovementComponent->MovementMode == EMovementMode::MOVE_Flying)
-				MovementComponent->SetMovementMode(EMovementMode::MOVE_Walking);
-
-			// AActor* Base = GravityOverlapResult.GetActor();
-			// UPrimitiveComponent* BasePrimitiveRoot = Cast<UPrimitiveComponent>(Base->GetRootComponent());
-			// if (BasePrimitiveRoot)
-			{
-				SetBase(GravityOverlapResult.GetComponent());
-			}
+			MovementComponent->SetGravityDirection(GravityField.Direction);
 		}
-		else
-		{
-			MovementComponent->SetMovementMode(EMovementMode::MOVE_Flying);
+		MovementComponent->SetGravityFieldId(GravityField.IsValid() ? GravityField.Component->GetUniqueID() : 0);
+		MovementComponent->SetGravityFieldComponent(Cast<UGravityBoxAreaVolume>(GravityField.Component));
 
-			SetBase(nullptr);
+		// Base and movement mode only change on transitions between fields. A stale field was destroyed while we were in it.
+		UPrimitiveComponent* PreviousField = CurrentGravityField.Get();
+		if (GravityField.Component != PreviousField || CurrentGravityField.IsStale() || !bGravityFieldInitialized)
+		{
+			bGravityFieldInitialized = true;
+			CurrentGravityField = GravityField.Component;
+			GravityFieldChanged(GravityField.Component, PreviousField);
 		}
 	}
 }
 
+void ACustomGravityTestCharacter::GravityFieldChanged(UPrimitiveComponent* NewField, UPrimitiveComponent* PreviousField)
+{
+	UBaseCharacterMovementComponent* MovementComponent = GetCharacterMovement();
+
+	if (NewField)
+	{
+		if (MovementComponent->MovementMode == EMovementMode::MOVE_Flying)
+			MovementComponent->SetMovementMode(EMovementMode::MOVE_Walking);
+
+		SetBase(NewField);
+	}
+	else
+	{
+		MovementComponent->SetMovementMode(EMovementMode::MOVE_Flying);
+
+		SetBase(nullptr);
+	}
+
+	OnGravityFieldChanged.Broadcast(this, NewField, PreviousField);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Input
 
@@ -141,7 +163,8 @@ void ACustomGravityTestCharacter::Move(const FInputActionValue& Value)
 	if (Controller != nullptr)
 	{
 		// find out which way is forward
-		const FRotator Rotation = Controller->GetControlRotation();
+		const ACustomGravityTestPlayerController* PlayerController = Cast<ACustomGravityTestPlayerController>(Controller);
+		const FQuat Rotation = PlayerController ? PlayerController->GetControlQuat() : Controller->GetControlRotation().Quaternion();
 
 		// FRotator GravityRotation = ACustomGravityTestPlayerController::GetGravityRelativeRotation(Rotation, GetCharacterMovement()->GetGravityDirection());
 		// FRotator RotatorForSideMovement = ACustomGravityTestPlayerController::GetGravityWorldRotation(FRotator(0.0f, GravityRotation.Yaw, GravityRotation.Roll), GetCharacterMovement()->GetGravityDirection());
@@ -149,8 +172,8 @@ void ACustomGravityTestCharacter::Move(const FInputActionValue& Value)
 		// const FVector ForwardDirection = FRotationMatrix(RotatorForForwardMovement).GetUnitAxis(EAxis::Y);
 		// const FVector RightDirection = FRotationMatrix(RotatorForSideMovement).GetUnitAxis(EAxis::X);
 
-		const FVector ForwardDirection = FRotationMatrix(Rotation).GetUnitAxis(EAxis::Y);
-		const FVector RightDirection = FRotationMatrix(Rotation).GetUnitAxis(EAxis::X);
+		const FVector ForwardDirection = Rotation.GetAxisY();
+		const FVector RightDirection = Rotation.GetAxisX();
 		
 		// add movement 
 		AddMovementInput(ForwardDirection, MovementVector.X);
@@ -171,67 +194,21 @@ void ACustomGravityTestCharacter::Look(const FInputActionValue& Value)
 	}
 }
 
-FOverlapResult ACustomGravityTestCharacter::FindGravityOverlap() const
+FGravityFieldSample ACustomGravityTestCharacter::FindGravityField()
 {
-	const UCapsuleComponent* Capsule = GetCapsuleComponent();
-	FCollisionObjectQueryParams ObjectQueryParams;
-	ObjectQueryParams.AddObjectTypesToQuery(GravityAreaCollisionChannel);
-
-	FCollisionQueryParams QueryParams;
-
-	const FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(Capsule->GetScaledCapsuleRadius(), Capsule->GetScaledCapsuleHalfHeight());
-
-	// Box gravity fields take priority
-	TArray<FOverlapResult> Results;
-	if (GetWorld()->OverlapMultiByObjectType(
-		Results,
-		Capsule->GetComponentLocation(),
-		Capsule->GetComponentRotation().Quaternion(),
-		ObjectQueryParams,
-		CapsuleShape,
-		QueryParams
-	))
+	const UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this);
+	if (!GravityFields)
 	{
-		int32 BestOverlapIdx = -1;
-			
-		for (int32 OverlapIdx = 0; OverlapIdx < Results.Num(); ++OverlapIdx)
-		{
-			FOverlapResult const& O = Results[OverlapIdx];
-
-			if (!O.Component.IsValid()) 
-				continue;
-
-			if (O.Component.Get()->IsA(UGravityBoxAreaVolume::StaticClass()))
-			{
-				if (BestOverlapIdx != -1)
-				{
-					const FOverlapResult& BestOverlap = Results[BestOverlapIdx];
-
-					UGravityBoxAreaVolume* BestBoxArea = Cast<UGravityBoxAreaVolume>(BestOverlap.Component.Get());
-					UGravityBoxAreaVolume* CurrBoxArea = Cast<UGravityBoxAreaVolume>(O.Component.Get());
-					
-					const FVector BestExtent = BestBoxArea->GetScaledBoxExtent();
-					const FVector CurrExtent = CurrBoxArea->GetScaledBoxExtent(); 
-
-					if (CurrExtent.SquaredLength() < BestExtent.SquaredLength())
-					{
-						BestOverlapIdx = OverlapIdx;
-					}
-				}
-				else
-				{
-					BestOverlapIdx = OverlapIdx;
-				}
-			}
-		}
-
-		if (BestOverlapIdx != -1)
-			return Results[BestOverlapIdx];
+		return FGravityFieldSample();
 	}
 
-	// Test against planet gravity fields
+	GetCharacterMovement()->CountGravityFieldLookup();
 
-	// Damn
-	FOverlapResult Result;
-	return Result;	
+	const UCapsuleComponent* Capsule = GetCapsuleComponent();
+	return GravityFields->FindGravityFieldCached(
+		GravityFieldCache,
+		Capsule->GetComponentLocation(),
+		Capsule->GetComponentQuat(),
+		Capsule->GetScaledCapsuleRadius(),
+		Capsule->GetScaledCapsuleHalfHeight());
 }
\ No newline at end of file
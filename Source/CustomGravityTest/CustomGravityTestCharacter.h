@@ -5,16 +5,20 @@
 #include "CoreMinimal.h"
 #include "Character/BaseCharacter.h"
 #include "Logging/LogMacros.h"
+#include "GravityFieldTypes.h"
 #include "CustomGravityTestCharacter.generated.h"
 
 class USpringArmComponent;
 class UCameraComponent;
 class UInputMappingContext;
 class UInputAction;
+class UPrimitiveComponent;
 struct FInputActionValue;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FGravityFieldChangedSignature, class ACustomGravityTestCharacter*, Character, UPrimitiveComponent*, NewField, UPrimitiveComponent*, PreviousField);
+
 UCLASS(config=Game)
 class ACustomGravityTestCharacter : public ABaseCharacter
 {
@@ -25,12 +29,26 @@ public:
 	
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+
+	/** Returns the gravity field the character is currently in, null if none. */
+	UPrimitiveComponent* GetCurrentGravityField() const { return CurrentGravityField.Get(); }
+
+	/**
+	 * Called when the character enters a gravity field (PreviousField is null), leaves one (NewField is null),
+	 * or switches to a field with higher priority.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Gravity")
+	FGravityFieldChangedSignature OnGravityFieldChanged;
 	
 protected:
 	void Move(const FInputActionValue& Value);
 	void Look(const FInputActionValue& Value);
 	
-	FOverlapResult FindGravityOverlap() const;
+	/** Finds the gravity field the character capsule is currently in, if any. */
+	FGravityFieldSample FindGravityField();
+
+	/** Handles a gravity field transition: updates the movement base and mode, then broadcasts OnGravityFieldChanged. */
+	virtual void GravityFieldChanged(UPrimitiveComponent* NewField, UPrimitiveComponent* PreviousField);
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	
@@ -39,10 +57,20 @@ protected:
 	virtual void Tick(float DeltaSeconds) override;
 
 public:
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gravity")
+	/** No longer used: gravity areas register with UGravityFieldSubsystem instead of being found with overlap queries. Kept so existing values still load. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gravity", meta = (DeprecatedProperty, DeprecationMessage = "Gravity areas are found through the gravity field subsystem, the collision channel is no longer used."))
 	TEnumAsByte<ECollisionChannel> GravityAreaCollisionChannel;
 
 private:
+	/** Last gravity field found, reused while the character doesn't move far from it. */
+	FGravityFieldQueryCache GravityFieldCache;
+
+	/** Gravity field found on the last update, only changes on transitions. */
+	TWeakObjectPtr<UPrimitiveComponent> CurrentGravityField;
+
+	/** False until the first gravity update, which always runs the transition to set up the initial base and mode. */
+	bool bGravityFieldInitialized = false;
+
 	/** Camera boom positioning the camera behind the character */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	USpringArmComponent* CameraBoom;
@@ -5,46 +5,59 @@
 void ACustomGravityTestPlayerController::UpdateRotation(float DeltaTime)
 {
 	FVector GravityDirection = FVector::DownVector;
+	const UBaseCharacterMovementComponent* MoveComp = nullptr;
 	if (ACustomGravityTestCharacter* PlayerCharacter = Cast<ACustomGravityTestCharacter>(GetPawn()))
 	{
-		if (UBaseCharacterMovementComponent* MoveComp = PlayerCharacter->GetCharacterMovement())
+		MoveComp = PlayerCharacter->GetCharacterMovement();
+		if (MoveComp)
 		{
 			GravityDirection = MoveComp->GetGravityDirection();
 		}
 	}
  
-	// Get the current control rotation in world space
-	FRotator ViewRotation = GetControlRotation();
- 
-	// Add any rotation from the gravity changes, if any happened.
-	// Delete this code block if you don't want the camera to automatically compensate for gravity rotation.
-	if (!LastFrameGravity.Equals(FVector::ZeroVector))
+	// The gravity relative rotation of last frame is still valid as long as nothing else changed the control rotation and gravity didn't change.
+	const bool bControlRotationChanged = !bHasCachedControlRotation || GetControlRotation() != LastControlRotation;
+	const bool bGravityChanged = !LastFrameGravity.Equals(GravityDirection);
+	if (bControlRotationChanged || bGravityChanged)
 	{
-		const FQuat DeltaGravityRotation = FQuat::FindBetweenNormals(LastFrameGravity, GravityDirection);
-		const FQuat WarpedCameraRotation = DeltaGravityRotation * FQuat(ViewRotation);
+		// Get the current control rotation in world space
+		FQuat WorldRotation = bControlRotationChanged ? GetControlRotation().Quaternion() : ControlQuat;
+ 
+		// Add any rotation from the gravity changes, if any happened.
+		// Delete this code block if you don't want the camera to automatically compensate for gravity rotation.
+		if (bGravityChanged && !LastFrameGravity.Equals(FVector::ZeroVector))
+		{
+			const FQuat DeltaGravityRotation = FQuat::FindBetweenNormals(LastFrameGravity, GravityDirection);
+			WorldRotation = DeltaGravityRotation * WorldRotation;
+		}
  
-		ViewRotation = WarpedCameraRotation.Rotator();	
+		// Convert the view rotation from world space to gravity relative space, reusing the transforms cached by the movement component.
+		// Now we can work with the rotation as if no custom gravity was affecting it.
+		GravityRelativeControlRotation = MoveComp ? MoveComp->RotateWorldToGravity(WorldRotation) : WorldRotation;
 	}
 	LastFrameGravity = GravityDirection;
  
-	// Convert the view rotation from world space to gravity relative space.
-	// Now we can work with the rotation as if no custom gravity was affecting it.
-	ViewRotation = GetGravityRelativeRotation(ViewRotation, GravityDirection);
- 
 	// Calculate Delta to be applied on ViewRotation
 	FRotator DeltaRot(RotationInput);
  
 	if (PlayerCameraManager)
 	{
-		ACustomGravityTestCharacter* PlayerCharacter = Cast<ACustomGravityTestCharacter>(GetPawn());
- 
+		FRotator ViewRotation = GravityRelativeControlRotation.Rotator();
 		PlayerCameraManager->ProcessViewRotation(DeltaTime, ViewRotation, DeltaRot);
  
 		// Zero the roll of the camera as we always want it horizontal in relation to the gravity.
 		ViewRotation.Roll = 0;
+		GravityRelativeControlRotation = ViewRotation.Quaternion();
  
 		// Convert the rotation back to world space, and set it as the current control rotation.
-		SetControlRotation(GetGravityWorldRotation(ViewRotation, GravityDirection));
+		ControlQuat = MoveComp ? MoveComp->RotateGravityToWorld(GravityRelativeControlRotation) : GravityRelativeControlRotation;
+		SetControlRotation(ControlQuat.Rotator());
+		LastControlRotation = GetControlRotation();
+		bHasCachedControlRotation = true;
+	}
+	else
+	{
+		bHasCachedControlRotation = false;
 	}
  
 	// APawn* const P = GetPawnOrSpectator();
@@ -54,6 +67,11 @@ void ACustomGravityTestPlayerController::UpdateRotation(float DeltaTime)
 	// }
 }
  
+FQuat ACustomGravityTestPlayerController::GetControlQuat() const
+{
+	return (bHasCachedControlRotation && GetControlRotation() == LastControlRotation) ? ControlQuat : GetControlRotation().Quaternion();
+}
+ 
 FRotator ACustomGravityTestPlayerController::GetGravityRelativeRotation(FRotator Rotation, FVector GravityDirection)
 {
 	if (!GravityDirection.Equals(FVector::DownVector))
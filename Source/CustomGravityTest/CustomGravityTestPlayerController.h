@@ -20,6 +20,20 @@ public:
 	UFUNCTION(BlueprintPure)
 	static FRotator GetGravityWorldRotation(FRotator Rotation, FVector GravityDirection);
 
+	// Returns the control rotation as a quaternion, reusing the one UpdateRotation() set when the control rotation was not changed since.
+	FQuat GetControlQuat() const;
+
+	// Returns the control rotation relative to the gravity of the pawn, as of the last UpdateRotation().
+	FQuat GetGravityRelativeControlRotation() const { return GravityRelativeControlRotation; }
+
 private:
 	FVector LastFrameGravity = FVector::ZeroVector;
+
+	// Control rotation kept relative to gravity between frames, and the world space rotation it was last set to.
+	FQuat GravityRelativeControlRotation = FQuat::Identity;
+	FQuat ControlQuat = FQuat::Identity;
+
+	// Control rotation as set by the last UpdateRotation(), to detect changes made elsewhere.
+	FRotator LastControlRotation = FRotator::ZeroRotator;
+	bool bHasCachedControlRotation = false;
 };
\ No newline at end of file
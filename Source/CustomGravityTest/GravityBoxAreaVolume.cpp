@@ -1,4 +1,5 @@
 #include "GravityBoxAreaVolume.h"
+#include "GravityFieldSubsystem.h"
 
 UGravityBoxAreaVolume::UGravityBoxAreaVolume()
 {
@@ -8,4 +9,33 @@ UGravityBoxAreaVolume::UGravityBoxAreaVolume()
 void UGravityBoxAreaVolume::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->RegisterGravityBox(this);
+	}
+}
+
+void UGravityBoxAreaVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->UnregisterGravityBox(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGravityBoxAreaVolume::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	// Keep the spatial index in sync for boxes attached to moving actors.
+	if (HasBegunPlay())
+	{
+		if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+		{
+			GravityFields->UpdateGravityBox(this);
+		}
+	}
 }
@@ -0,0 +1,57 @@
+#include "GravityCapsuleAreaVolume.h"
+#include "Engine/CollisionProfile.h"
+#include "GravityFieldSubsystem.h"
+
+UGravityCapsuleAreaVolume::UGravityCapsuleAreaVolume()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Gravity is evaluated analytically, no physics queries involved.
+	SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	SetGenerateOverlapEvents(false);
+}
+
+FGravityFieldShape UGravityCapsuleAreaVolume::BuildGravityFieldShape() const
+{
+	FGravityFieldShape Shape;
+	const FVector Center = GetComponentLocation();
+	const FVector Axis = GetUpVector() * GetScaledCapsuleHalfHeight_WithoutHemisphere();
+	Shape.Points.Add(Center - Axis);
+	Shape.Points.Add(Center + Axis);
+	Shape.Radius = GetScaledCapsuleRadius();
+	Shape.Settings = GravitySettings;
+	return Shape;
+}
+
+void UGravityCapsuleAreaVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->RegisterGravityField(this, BuildGravityFieldShape());
+	}
+}
+
+void UGravityCapsuleAreaVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->UnregisterGravityField(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGravityCapsuleAreaVolume::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	if (HasBegunPlay())
+	{
+		if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+		{
+			GravityFields->UpdateGravityField(this, BuildGravityFieldShape());
+		}
+	}
+}
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/CapsuleComponent.h"
+#include "GravityFieldTypes.h"
+#include "GravityCapsuleAreaVolume.generated.h"
+
+/** Capsule/cylinder gravity field. Inside the capsule, gravity pulls towards its central axis. */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class CUSTOMGRAVITYTEST_API UGravityCapsuleAreaVolume : public UCapsuleComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGravityCapsuleAreaVolume();
+
+	/** Builds the closed-form shape of this field from the current component transform. */
+	FGravityFieldShape BuildGravityFieldShape() const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity")
+	FGravityFieldSettings GravitySettings;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+};
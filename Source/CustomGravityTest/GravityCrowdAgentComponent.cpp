@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityCrowdAgentComponent.h"
+#include "GameFramework/Actor.h"
+#include "GravityCrowdSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GravityCrowdAgentComponent)
+
+UGravityCrowdAgentComponent::UGravityCrowdAgentComponent()
+{
+	// Moved by UGravityCrowdSubsystem.
+	PrimaryComponentTick.bCanEverTick = false;
+
+	Radius = 34.f;
+	HalfHeight = 88.f;
+	MaxWalkSpeed = 600.f;
+	MaxAcceleration = 2048.f;
+	BrakingDecelerationWalking = 2048.f;
+	GroundFriction = 8.f;
+	AirControl = 0.05f;
+	JumpZVelocity = 420.f;
+	GravityScale = 1.f;
+	MaxStepHeight = 45.f;
+	WalkableFloorAngle = 44.765f;
+	CollisionChannel = ECC_Pawn;
+
+	DesiredVelocity = FVector::ZeroVector;
+	bPendingJump = false;
+	AgentIndex = INDEX_NONE;
+}
+
+void UGravityCrowdAgentComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Clients get the movement of the owner through replication.
+	if (GetOwner()->HasAuthority())
+	{
+		if (UGravityCrowdSubsystem* Crowd = UGravityCrowdSubsystem::Get(this))
+		{
+			Crowd->AddAgent(this);
+		}
+	}
+}
+
+void UGravityCrowdAgentComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGravityCrowdSubsystem* Crowd = UGravityCrowdSubsystem::Get(this))
+	{
+		Crowd->RemoveAgent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGravityCrowdAgentComponent::SetDesiredVelocity(const FVector& InDesiredVelocity)
+{
+	DesiredVelocity = InDesiredVelocity;
+}
+
+FVector UGravityCrowdAgentComponent::GetVelocity() const
+{
+	const UGravityCrowdSubsystem* Crowd = AgentIndex != INDEX_NONE ? UGravityCrowdSubsystem::Get(this) : nullptr;
+	return Crowd ? Crowd->GetAgentVelocity(AgentIndex) : FVector::ZeroVector;
+}
+
+FVector UGravityCrowdAgentComponent::GetGravityDirection() const
+{
+	const UGravityCrowdSubsystem* Crowd = AgentIndex != INDEX_NONE ? UGravityCrowdSubsystem::Get(this) : nullptr;
+	return Crowd ? Crowd->GetAgentGravityDirection(AgentIndex) : -GetOwner()->GetActorUpVector();
+}
+
+bool UGravityCrowdAgentComponent::IsWalking() const
+{
+	const UGravityCrowdSubsystem* Crowd = AgentIndex != INDEX_NONE ? UGravityCrowdSubsystem::Get(this) : nullptr;
+	return Crowd && Crowd->GetAgentMovementMode(AgentIndex) == EGravityCrowdMovementMode::Walking;
+}
+
+void UGravityCrowdAgentComponent::Jump()
+{
+	bPendingJump = true;
+}
@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GravityCrowdAgentComponent.generated.h"
+
+/**
+ * Moves its owner as an agent of UGravityCrowdSubsystem: walking and falling under custom gravity, without the client prediction,
+ * root motion and networking state of UBaseCharacterMovementComponent. Meant for server controlled crowds, the owner replicates
+ * its movement as any other actor.
+ *
+ * The agent is a capsule aligned with gravity. It only moves where its owner has authority, towards the velocity set with
+ * SetDesiredVelocity(), and the crowd places the owner root every frame.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class CUSTOMGRAVITYTEST_API UGravityCrowdAgentComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGravityCrowdAgentComponent();
+
+	/** Sets the velocity the agent accelerates towards, projected onto its floor when walking. Length is clamped to MaxWalkSpeed. */
+	UFUNCTION(BlueprintCallable, Category = "Crowd Movement")
+	void SetDesiredVelocity(const FVector& InDesiredVelocity);
+
+	UFUNCTION(BlueprintCallable, Category = "Crowd Movement")
+	FVector GetDesiredVelocity() const { return DesiredVelocity; }
+
+	/** Current velocity of the agent, as of the last crowd update. */
+	UFUNCTION(BlueprintCallable, Category = "Crowd Movement")
+	FVector GetVelocity() const;
+
+	/** Current gravity direction of the agent, as of the last crowd update. */
+	UFUNCTION(BlueprintCallable, Category = "Crowd Movement")
+	FVector GetGravityDirection() const;
+
+	/** Returns true if the agent stands on a walkable floor. */
+	UFUNCTION(BlueprintCallable, Category = "Crowd Movement")
+	bool IsWalking() const;
+
+	/** Makes a walking agent leave the ground with JumpZVelocity along its gravity up axis. */
+	UFUNCTION(BlueprintCallable, Category = "Crowd Movement")
+	void Jump();
+
+	/** Index of the agent in UGravityCrowdSubsystem, INDEX_NONE if not registered. */
+	int32 GetAgentIndex() const { return AgentIndex; }
+
+	/** Capsule radius of the agent. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "1", UIMin = "1", ForceUnits = "cm"))
+	float Radius;
+
+	/** Capsule half height of the agent, including the hemispheres. The owner root is placed at the capsule center. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "1", UIMin = "1", ForceUnits = "cm"))
+	float HalfHeight;
+
+	/** Max speed when walking. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm/s"))
+	float MaxWalkSpeed;
+
+	/** Acceleration towards the desired velocity. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "0", UIMin = "0"))
+	float MaxAcceleration;
+
+	/** Deceleration when walking without desired velocity. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "0", UIMin = "0"))
+	float BrakingDecelerationWalking;
+
+	/** Friction applied when walking, see UBaseCharacterMovementComponent::GroundFriction. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "0", UIMin = "0"))
+	float GroundFriction;
+
+	/** Fraction of MaxAcceleration available when falling. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "0", UIMin = "0"))
+	float AirControl;
+
+	/** Initial speed along the gravity up axis when jumping. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm/s"))
+	float JumpZVelocity;
+
+	/** Multiplier of the gravity of the field the agent is in. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement")
+	float GravityScale;
+
+	/** Max height of a ledge the agent steps onto, and the distance it stays snapped to a floor going down slopes and steps. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm"))
+	float MaxStepHeight;
+
+	/** Max angle in degrees of a walkable floor, relative to the gravity up axis. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement", meta = (ClampMin = "0", ClampMax = "90", UIMin = "0", UIMax = "90", ForceUnits = "degrees"))
+	float WalkableFloorAngle;
+
+	/** Collision channel the agent sweeps on. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd Movement")
+	TEnumAsByte<ECollisionChannel> CollisionChannel;
+
+protected:
+	//~ Begin UActorComponent Interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End UActorComponent Interface
+
+private:
+	friend class UGravityCrowdSubsystem;
+
+	FVector DesiredVelocity;
+
+	/** Set by Jump(), consumed by the next crowd update. */
+	bool bPendingJump;
+
+	int32 AgentIndex;
+};
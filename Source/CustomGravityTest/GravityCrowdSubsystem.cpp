@@ -0,0 +1,435 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityCrowdSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Character/BaseCharacterMovementComponent.h"
+#include "GravityCrowdAgentComponent.h"
+#include "GravityFieldSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GravityCrowdSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Crowd Tick"), STAT_GravityCrowdTick, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Crowd Simulate"), STAT_GravityCrowdSimulate, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Crowd Apply"), STAT_GravityCrowdApply, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Agents"), STAT_GravityCrowdAgents, STATGROUP_Character);
+
+namespace GravityCrowdCVars
+{
+	static int32 CrowdMinBatchSize = 16;
+	FAutoConsoleVariableRef CVarCrowdMinBatchSize(
+		TEXT("cg.CrowdMinBatchSize"),
+		CrowdMinBatchSize,
+		TEXT("Minimum number of crowd agents simulated by a single worker task.\n")
+		TEXT("<=0: Simulate every agent on the game thread"),
+		ECVF_Default);
+
+	static float CrowdMaxDeltaTime = 0.1f;
+	FAutoConsoleVariableRef CVarCrowdMaxDeltaTime(
+		TEXT("cg.CrowdMaxDeltaTime"),
+		CrowdMaxDeltaTime,
+		TEXT("Longest time step of a crowd update, longer frames slow the crowd down instead of tunneling through floors."),
+		ECVF_Default);
+}
+
+namespace GravityCrowd
+{
+	static bool IsWalkable(const FHitResult& Hit, const FVector& Up, float WalkableFloorZ)
+	{
+		return Hit.IsValidBlockingHit() && (Hit.ImpactNormal | Up) >= WalkableFloorZ;
+	}
+
+	/** Velocity update of UBaseCharacterMovementComponent::CalcVelocity() for a requested velocity, in the gravity plane. */
+	static FVector CalcWalkingVelocity(const FVector& Velocity, const FVector& DesiredVelocity, const FGravityCrowdAgentParams& Params, float DeltaTime)
+	{
+		if (DesiredVelocity.IsNearlyZero())
+		{
+			// Friction and braking, stopping rather than reversing.
+			const FVector OldVelocity = Velocity;
+			const FVector NewVelocity = Velocity + (-Params.GroundFriction * Velocity - Params.BrakingDecelerationWalking * Velocity.GetSafeNormal()) * DeltaTime;
+			return (NewVelocity | OldVelocity) > 0.0 ? NewVelocity : FVector::ZeroVector;
+		}
+
+		// Friction turns the velocity towards the desired direction, then acceleration brings it to the desired speed.
+		const FVector DesiredDirection = DesiredVelocity.GetSafeNormal();
+		FVector NewVelocity = Velocity - (Velocity - DesiredDirection * Velocity.Size()) * FMath::Min(DeltaTime * Params.GroundFriction, 1.f);
+		NewVelocity += (DesiredVelocity - NewVelocity).GetClampedToMaxSize(Params.MaxAcceleration * DeltaTime);
+		return NewVelocity;
+	}
+
+	/** Query shape and params shared by every sweep of an agent. */
+	struct FAgentQuery
+	{
+		FAgentQuery(const UWorld& InWorld, const AActor* Owner, const FGravityCrowdAgentParams& Params)
+			: World(InWorld)
+			, Shape(FCollisionShape::MakeCapsule(Params.Radius, Params.HalfHeight))
+			, QueryParams(SCENE_QUERY_STAT(GravityCrowdSweep), false, Owner)
+			, Channel(Params.CollisionChannel)
+		{
+		}
+
+		bool Sweep(FHitResult& OutHit, const FVector& Start, const FVector& End, const FQuat& Rotation) const
+		{
+			return World.SweepSingleByChannel(OutHit, Start, End, Rotation, Channel, Shape, QueryParams);
+		}
+
+		const UWorld& World;
+		FCollisionShape Shape;
+		FCollisionQueryParams QueryParams;
+		ECollisionChannel Channel;
+	};
+}
+
+bool UGravityCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGravityCrowdSubsystem::Deinitialize()
+{
+	Agents.Reset();
+	Owners.Reset();
+	Params.Reset();
+	Locations.Reset();
+	Rotations.Reset();
+	Velocities.Reset();
+	DesiredVelocities.Reset();
+	GravityDirections.Reset();
+	FloorNormals.Reset();
+	MovementModes.Reset();
+	PendingJumps.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UGravityCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGravityCrowdSubsystem, STATGROUP_Tickables);
+}
+
+UGravityCrowdSubsystem* UGravityCrowdSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UGravityCrowdSubsystem>() : nullptr;
+}
+
+void UGravityCrowdSubsystem::AddAgent(UGravityCrowdAgentComponent* Agent)
+{
+	const AActor* Owner = Agent ? Agent->GetOwner() : nullptr;
+	if (!Owner || Agent->AgentIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	FGravityCrowdAgentParams& AgentParams = Params.AddDefaulted_GetRef();
+	AgentParams.Radius = Agent->Radius;
+	AgentParams.HalfHeight = FMath::Max(Agent->HalfHeight, Agent->Radius);
+	AgentParams.MaxWalkSpeed = Agent->MaxWalkSpeed;
+	AgentParams.MaxAcceleration = Agent->MaxAcceleration;
+	AgentParams.BrakingDecelerationWalking = Agent->BrakingDecelerationWalking;
+	AgentParams.GroundFriction = Agent->GroundFriction;
+	AgentParams.AirControl = Agent->AirControl;
+	AgentParams.JumpZVelocity = Agent->JumpZVelocity;
+	AgentParams.GravityScale = Agent->GravityScale;
+	AgentParams.MaxStepHeight = Agent->MaxStepHeight;
+	AgentParams.WalkableFloorZ = FMath::Cos(FMath::DegreesToRadians(Agent->WalkableFloorAngle));
+	AgentParams.CollisionChannel = Agent->CollisionChannel;
+
+	// Agents start falling along the owner's down axis until they find a floor or a gravity field.
+	const FQuat Rotation = Owner->GetActorQuat();
+	Agent->AgentIndex = Agents.Add(Agent);
+	Owners.Add(Owner);
+	Locations.Add(Owner->GetActorLocation());
+	Rotations.Add(Rotation);
+	Velocities.Add(FVector::ZeroVector);
+	DesiredVelocities.Add(FVector::ZeroVector);
+	GravityDirections.Add(-Rotation.GetUpVector());
+	FloorNormals.Add(Rotation.GetUpVector());
+	MovementModes.Add(EGravityCrowdMovementMode::Falling);
+	PendingJumps.Add(false);
+}
+
+void UGravityCrowdSubsystem::RemoveAgent(UGravityCrowdAgentComponent* Agent)
+{
+	if (!Agent || !Agents.IsValidIndex(Agent->AgentIndex) || Agents[Agent->AgentIndex] != Agent)
+	{
+		return;
+	}
+
+	const int32 AgentIndex = Agent->AgentIndex;
+	Agent->AgentIndex = INDEX_NONE;
+
+	Agents.RemoveAtSwap(AgentIndex, 1, false);
+	Owners.RemoveAtSwap(AgentIndex, 1, false);
+	Params.RemoveAtSwap(AgentIndex, 1, false);
+	Locations.RemoveAtSwap(AgentIndex, 1, false);
+	Rotations.RemoveAtSwap(AgentIndex, 1, false);
+	Velocities.RemoveAtSwap(AgentIndex, 1, false);
+	DesiredVelocities.RemoveAtSwap(AgentIndex, 1, false);
+	GravityDirections.RemoveAtSwap(AgentIndex, 1, false);
+	FloorNormals.RemoveAtSwap(AgentIndex, 1, false);
+	MovementModes.RemoveAtSwap(AgentIndex, 1, false);
+	PendingJumps.RemoveAtSwap(AgentIndex, 1, false);
+
+	if (Agents.IsValidIndex(AgentIndex))
+	{
+		Agents[AgentIndex]->AgentIndex = AgentIndex;
+	}
+}
+
+void UGravityCrowdSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityCrowdTick);
+
+	Super::Tick(DeltaTime);
+
+	INC_DWORD_STAT_BY(STAT_GravityCrowdAgents, Agents.Num());
+
+	const float CrowdDeltaTime = FMath::Min(DeltaTime, GravityCrowdCVars::CrowdMaxDeltaTime);
+	if (CrowdDeltaTime <= 0.f)
+	{
+		return;
+	}
+
+	GatherAgents();
+
+	UGravityFieldSubsystem* GravityFieldSubsystem = UGravityFieldSubsystem::Get(this);
+	if (!GravityFieldSubsystem)
+	{
+		return;
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GravityCrowdSimulate);
+
+		// Immutable, safe to read from the worker threads.
+		const TSharedRef<const FGravityFieldSnapshot> GravityFields = GravityFieldSubsystem->GetSnapshot();
+		const float GravityZ = GetWorld()->GetGravityZ();
+
+		const int32 MinBatchSize = GravityCrowdCVars::CrowdMinBatchSize;
+		const EParallelForFlags Flags = MinBatchSize > 0 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+		ParallelFor(TEXT("GravityCrowd"), Agents.Num(), FMath::Max(1, MinBatchSize), [this, CrowdDeltaTime, &GravityFields, GravityZ](int32 AgentIndex)
+		{
+			SimulateAgent(AgentIndex, CrowdDeltaTime, *GravityFields, GravityZ);
+		}, Flags);
+	}
+
+	ApplyAgents();
+}
+
+void UGravityCrowdSubsystem::GatherAgents()
+{
+	for (int32 AgentIndex = 0; AgentIndex < Agents.Num(); ++AgentIndex)
+	{
+		UGravityCrowdAgentComponent* Agent = Agents[AgentIndex];
+		const AActor* Owner = Owners[AgentIndex];
+
+		DesiredVelocities[AgentIndex] = Agent->DesiredVelocity;
+		PendingJumps[AgentIndex] = Agent->bPendingJump;
+		Agent->bPendingJump = false;
+
+		// Anything else moving the owner teleports the agent.
+		const FVector OwnerLocation = Owner->GetActorLocation();
+		if (!OwnerLocation.Equals(Locations[AgentIndex], UE_KINDA_SMALL_NUMBER))
+		{
+			Locations[AgentIndex] = OwnerLocation;
+			MovementModes[AgentIndex] = EGravityCrowdMovementMode::Falling;
+		}
+	}
+}
+
+void UGravityCrowdSubsystem::SimulateAgent(int32 AgentIndex, float DeltaTime, const FGravityFieldSnapshot& GravityFields, float GravityZ)
+{
+	using namespace GravityCrowd;
+
+	// Distance kept between a walking agent and its floor, the same band characters keep.
+	const float MinFloorDist = UBaseCharacterMovementComponent::MIN_FLOOR_DIST;
+	const float MaxFloorDist = UBaseCharacterMovementComponent::MAX_FLOOR_DIST;
+
+	const FGravityCrowdAgentParams& AgentParams = Params[AgentIndex];
+	const FAgentQuery Query(*GetWorld(), Owners[AgentIndex], AgentParams);
+
+	FVector Location = Locations[AgentIndex];
+	FVector Velocity = Velocities[AgentIndex];
+	FVector FloorNormal = FloorNormals[AgentIndex];
+	bool bWalking = MovementModes[AgentIndex] == EGravityCrowdMovementMode::Walking;
+
+	// Outside every gravity field, agents keep the last gravity direction they had, with world gravity.
+	FVector GravityDirection = GravityDirections[AgentIndex];
+	float GravityStrength = 1.f;
+	const FGravityFieldSnapshotSample Gravity = GravityFields.FindGravityField(Location, Rotations[AgentIndex], AgentParams.Radius, AgentParams.HalfHeight);
+	if (Gravity.IsValid())
+	{
+		GravityDirection = Gravity.Direction;
+		GravityStrength = Gravity.Strength;
+	}
+
+	const FVector Up = -GravityDirection;
+	const float GravityAcceleration = FMath::Abs(GravityZ) * GravityStrength * AgentParams.GravityScale;
+
+	// A change of gravity also tilts the floor, which may not be walkable anymore.
+	if (bWalking && (FloorNormal | Up) < AgentParams.WalkableFloorZ)
+	{
+		bWalking = false;
+	}
+
+	if (bWalking && PendingJumps[AgentIndex])
+	{
+		Velocity = FVector::VectorPlaneProject(Velocity, Up) + Up * AgentParams.JumpZVelocity;
+		bWalking = false;
+	}
+
+	const FVector DesiredVelocity = FVector::VectorPlaneProject(DesiredVelocities[AgentIndex], Up).GetClampedToMaxSize(AgentParams.MaxWalkSpeed);
+
+	if (bWalking)
+	{
+		Velocity = CalcWalkingVelocity(FVector::VectorPlaneProject(Velocity, Up), DesiredVelocity, AgentParams, DeltaTime);
+	}
+	else
+	{
+		// Lateral air control towards the desired velocity, gravity along the up axis.
+		const FVector::FReal VerticalSpeed = (Velocity | Up) - GravityAcceleration * DeltaTime;
+		FVector LateralVelocity = FVector::VectorPlaneProject(Velocity, Up);
+		if (!DesiredVelocity.IsNearlyZero())
+		{
+			LateralVelocity += (DesiredVelocity - LateralVelocity).GetClampedToMaxSize(AgentParams.MaxAcceleration * AgentParams.AirControl * DeltaTime);
+		}
+		Velocity = LateralVelocity + Up * VerticalSpeed;
+	}
+
+	// Face the lateral velocity, or keep the current facing, with the capsule axis along gravity.
+	FVector Forward = FVector::VectorPlaneProject(Velocity, Up);
+	if (Forward.SizeSquared() < 1.0)
+	{
+		Forward = FVector::VectorPlaneProject(Rotations[AgentIndex].GetForwardVector(), Up);
+		if (Forward.SizeSquared() < UE_KINDA_SMALL_NUMBER)
+		{
+			Forward = FVector::VectorPlaneProject(Rotations[AgentIndex].GetUpVector(), Up);
+		}
+	}
+	const FQuat Rotation = FRotationMatrix::MakeFromZX(Up, Forward).ToQuat();
+
+	// Walking moves along the floor, so slopes neither slow the agent down nor launch it.
+	FVector Delta = Velocity * DeltaTime;
+	const FVector::FReal FloorUp = FloorNormal | Up;
+	if (bWalking && FloorUp > UE_KINDA_SMALL_NUMBER)
+	{
+		Delta -= Up * ((Delta | FloorNormal) / FloorUp);
+	}
+
+	FHitResult Hit;
+	if (!Delta.IsNearlyZero() && Query.Sweep(Hit, Location, Location + Delta, Rotation))
+	{
+		if (Hit.bStartPenetrating)
+		{
+			// Pushed out along the penetration normal, like MoveUpdatedComponent() resolving an initial overlap.
+			Location += Hit.Normal * (Hit.PenetrationDepth + MinFloorDist);
+		}
+		else
+		{
+			Location = Hit.Location;
+			const FVector RemainingDelta = Delta * (1.f - Hit.Time);
+
+			if (!bWalking && IsWalkable(Hit, Up, AgentParams.WalkableFloorZ))
+			{
+				// Landed, the floor check below snaps to it.
+				bWalking = true;
+				FloorNormal = Hit.ImpactNormal;
+				Velocity = FVector::VectorPlaneProject(Velocity, Up);
+			}
+			else
+			{
+				bool bSteppedUp = false;
+				// Only ledges lower than the max step height above the capsule bottom, as in CanStepUp().
+				const FVector::FReal ImpactHeight = ((Hit.ImpactPoint - Location) | Up) + AgentParams.HalfHeight;
+				if (bWalking && ImpactHeight <= AgentParams.MaxStepHeight)
+				{
+					// Step up: up by the max step height, across, then down onto a walkable floor.
+					const FVector StepUp = Up * AgentParams.MaxStepHeight;
+					const FVector StepDown = -Up * (AgentParams.MaxStepHeight + MaxFloorDist * 2.f);
+					FHitResult StepHit;
+					const FVector UpLocation = Query.Sweep(StepHit, Location, Location + StepUp, Rotation) ? StepHit.Location : Location + StepUp;
+					const FVector AcrossLocation = Query.Sweep(StepHit, UpLocation, UpLocation + RemainingDelta, Rotation) ? StepHit.Location : UpLocation + RemainingDelta;
+					if (!((AcrossLocation - UpLocation).IsNearlyZero()) && Query.Sweep(StepHit, AcrossLocation, AcrossLocation + StepDown, Rotation)
+						&& !StepHit.bStartPenetrating && IsWalkable(StepHit, Up, AgentParams.WalkableFloorZ))
+					{
+						Location = StepHit.Location;
+						FloorNormal = StepHit.ImpactNormal;
+						bSteppedUp = true;
+					}
+				}
+
+				if (!bSteppedUp)
+				{
+					// Slide once along the surface. Walking agents treat unwalkable surfaces as walls, so they don't climb them.
+					FVector SlideNormal = Hit.Normal;
+					if (bWalking)
+					{
+						SlideNormal = FVector::VectorPlaneProject(SlideNormal, Up).GetSafeNormal();
+					}
+
+					if (!SlideNormal.IsNearlyZero())
+					{
+						const FVector SlideDelta = FVector::VectorPlaneProject(RemainingDelta, SlideNormal);
+						FHitResult SlideHit;
+						Location = Query.Sweep(SlideHit, Location, Location + SlideDelta, Rotation) ? SlideHit.Location : Location + SlideDelta;
+						Velocity = FVector::VectorPlaneProject(Velocity, SlideNormal);
+
+						if (!bWalking && IsWalkable(SlideHit, Up, AgentParams.WalkableFloorZ))
+						{
+							bWalking = true;
+							FloorNormal = SlideHit.ImpactNormal;
+							Velocity = FVector::VectorPlaneProject(Velocity, Up);
+						}
+					}
+				}
+			}
+		}
+	}
+	else
+	{
+		Location += Delta;
+	}
+
+	if (bWalking)
+	{
+		// Floor check: stay within the floor distance band, follow the floor down steps and slopes, or start falling.
+		FHitResult FloorHit;
+		const FVector FloorProbe = -Up * (AgentParams.MaxStepHeight + MaxFloorDist);
+		if (Query.Sweep(FloorHit, Location, Location + FloorProbe, Rotation) && !FloorHit.bStartPenetrating && IsWalkable(FloorHit, Up, AgentParams.WalkableFloorZ))
+		{
+			const float FloorDist = FloorHit.Time * FloorProbe.Size();
+			if (FloorDist < MinFloorDist || FloorDist > MaxFloorDist)
+			{
+				Location += -Up * (FloorDist - (MinFloorDist + MaxFloorDist) * 0.5f);
+			}
+			FloorNormal = FloorHit.ImpactNormal;
+		}
+		else
+		{
+			bWalking = false;
+		}
+	}
+
+	Locations[AgentIndex] = Location;
+	Rotations[AgentIndex] = Rotation;
+	Velocities[AgentIndex] = Velocity;
+	GravityDirections[AgentIndex] = GravityDirection;
+	FloorNormals[AgentIndex] = FloorNormal;
+	MovementModes[AgentIndex] = bWalking ? EGravityCrowdMovementMode::Walking : EGravityCrowdMovementMode::Falling;
+}
+
+void UGravityCrowdSubsystem::ApplyAgents()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityCrowdApply);
+
+	for (int32 AgentIndex = 0; AgentIndex < Agents.Num(); ++AgentIndex)
+	{
+		AActor* Owner = Agents[AgentIndex]->GetOwner();
+		Owner->SetActorLocationAndRotation(Locations[AgentIndex], Rotations[AgentIndex], false, nullptr, ETeleportType::None);
+
+		// Read back, attachment or physics may override where the owner ends up.
+		Locations[AgentIndex] = Owner->GetActorLocation();
+	}
+}
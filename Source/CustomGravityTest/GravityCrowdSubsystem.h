@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GravityCrowdSubsystem.generated.h"
+
+class UGravityCrowdAgentComponent;
+struct FGravityFieldSnapshot;
+
+/** Movement mode of a crowd agent. */
+enum class EGravityCrowdMovementMode : uint8
+{
+	Walking,
+	Falling,
+};
+
+/** Movement settings of a crowd agent, copied from its component when it registers. */
+struct FGravityCrowdAgentParams
+{
+	float Radius = 34.f;
+	float HalfHeight = 88.f;
+	float MaxWalkSpeed = 600.f;
+	float MaxAcceleration = 2048.f;
+	float BrakingDecelerationWalking = 2048.f;
+	float GroundFriction = 8.f;
+	float AirControl = 0.05f;
+	float JumpZVelocity = 420.f;
+	float GravityScale = 1.f;
+	float MaxStepHeight = 45.f;
+
+	/** Min dot product between a walkable floor normal and the gravity up axis. */
+	float WalkableFloorZ = 0.71f;
+
+	ECollisionChannel CollisionChannel = ECC_Pawn;
+};
+
+/**
+ * Moves every UGravityCrowdAgentComponent of a world in one batched update, for crowds too large for a UBaseCharacterMovementComponent each.
+ *
+ * Agent state lives in parallel arrays indexed by agent, one per field, so the update streams through them and keeps the settings out
+ * of the hot data. Every frame:
+ *   - Gather, serial: reads desired velocities, jumps and external teleports from the components.
+ *   - Simulate, parallel: samples gravity from the gravity field snapshot, then walks or falls the agent with scene queries only,
+ *     following the rules of UBaseCharacterMovementComponent::PhysWalking() and PhysFalling() in a reduced form: braking and friction,
+ *     air control, one slide along blocking hits, stepping up ledges, snapping to walkable floors and landing.
+ *     Math is gravity relative through dot products and plane projections only, no rotation to gravity space.
+ *   - Apply, serial: places the owner of every agent.
+ */
+UCLASS()
+class CUSTOMGRAVITYTEST_API UGravityCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Agents.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/** Adds an agent at the current location of its owner. Called by the component in BeginPlay. */
+	void AddAgent(UGravityCrowdAgentComponent* Agent);
+
+	/** Removes an agent, moving the last one in its place. Called by the component in EndPlay. */
+	void RemoveAgent(UGravityCrowdAgentComponent* Agent);
+
+	int32 GetNumAgents() const { return Agents.Num(); }
+
+	FVector GetAgentVelocity(int32 AgentIndex) const { return Velocities[AgentIndex]; }
+	FVector GetAgentGravityDirection(int32 AgentIndex) const { return GravityDirections[AgentIndex]; }
+	EGravityCrowdMovementMode GetAgentMovementMode(int32 AgentIndex) const { return MovementModes[AgentIndex]; }
+
+	/** Helper to get the subsystem of the world an object lives in. May return null. */
+	static UGravityCrowdSubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	/** Copies the input of every agent from its component. */
+	void GatherAgents();
+
+	/** Moves a single agent. Only reads shared state and writes to the arrays at AgentIndex, runs on worker threads. */
+	void SimulateAgent(int32 AgentIndex, float DeltaTime, const FGravityFieldSnapshot& GravityFields, float GravityZ);
+
+	/** Places the owner of every agent. */
+	void ApplyAgents();
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UGravityCrowdAgentComponent>> Agents;
+
+	/** Owner of each agent, ignored by its own scene queries. */
+	TArray<const AActor*> Owners;
+
+	TArray<FGravityCrowdAgentParams> Params;
+
+	TArray<FVector> Locations;
+	TArray<FQuat> Rotations;
+	TArray<FVector> Velocities;
+	TArray<FVector> DesiredVelocities;
+	TArray<FVector> GravityDirections;
+
+	/** Normal of the floor of walking agents. */
+	TArray<FVector> FloorNormals;
+
+	TArray<EGravityCrowdMovementMode> MovementModes;
+	TArray<bool> PendingJumps;
+};
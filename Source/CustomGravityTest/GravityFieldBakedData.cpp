@@ -0,0 +1,230 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityFieldBakedData.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GravityFieldBakedData)
+
+DEFINE_LOG_CATEGORY_STATIC(LogGravityFieldBake, Log, All);
+
+namespace GravityFieldBakedData
+{
+	/** Bumped whenever the layout of the payload changes. Payloads of other versions are skipped on load and must be baked again. */
+	static constexpr int32 PayloadVersion = 2;
+
+	/** First version storing the payload size ahead of the payload. Older payloads are read to be skipped. */
+	static constexpr int32 PayloadVersionSized = 2;
+}
+
+FArchive& operator<<(FArchive& Ar, FGravityFieldBakedField& Field)
+{
+	Ar << Field.Bounds;
+	Ar << Field.Rotation;
+	Ar << Field.Priority;
+	Ar << Field.bIsBox;
+	return Ar;
+}
+
+uint16 FGravityFieldBakedGrid::FindField(const FVector& Location) const
+{
+	const FVector Local = (Location - Origin) / VoxelSize;
+	const FIntVector Voxel(FMath::FloorToInt32(Local.X), FMath::FloorToInt32(Local.Y), FMath::FloorToInt32(Local.Z));
+	if (Voxel.X < 0 || Voxel.Y < 0 || Voxel.Z < 0
+		|| Voxel.X >= NumBricks.X * BrickSize || Voxel.Y >= NumBricks.Y * BrickSize || Voxel.Z >= NumBricks.Z * BrickSize)
+	{
+		return UnresolvedField;
+	}
+
+	const FIntVector Brick = Voxel / BrickSize;
+	const uint32 BrickEntry = Bricks[(Brick.Z * NumBricks.Y + Brick.Y) * NumBricks.X + Brick.X];
+	if (BrickEntry == EmptyBrick)
+	{
+		return NoField;
+	}
+
+	const uint32 VoxelOffset = BrickEntry >> 1;
+	if (BrickEntry & 1u)
+	{
+		return Voxels[VoxelOffset];
+	}
+
+	const FIntVector InBrick = Voxel - Brick * BrickSize;
+	return Voxels[VoxelOffset + (InBrick.Z * BrickSize + InBrick.Y) * BrickSize + InBrick.X];
+}
+
+SIZE_T FGravityFieldBakedGrid::GetAllocatedSize() const
+{
+	return Fields.GetAllocatedSize() + Bricks.GetAllocatedSize() + Voxels.GetAllocatedSize();
+}
+
+bool FGravityFieldBakedGrid::IsValid() const
+{
+	if (!(VoxelSize > 0.f) || NumBricks.X < 0 || NumBricks.Y < 0 || NumBricks.Z < 0 || Fields.Num() >= (int32)NoField)
+	{
+		return false;
+	}
+
+	if ((int64)NumBricks.X * NumBricks.Y * NumBricks.Z != Bricks.Num())
+	{
+		return false;
+	}
+
+	for (const uint32 BrickEntry : Bricks)
+	{
+		if (BrickEntry != EmptyBrick && (int64)(BrickEntry >> 1) + ((BrickEntry & 1u) ? 1 : VoxelsPerBrick) > Voxels.Num())
+		{
+			return false;
+		}
+	}
+
+	for (const uint16 Value : Voxels)
+	{
+		if (Value != UnresolvedField && Value != NoField && Value > Fields.Num())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FGravityFieldBakedGrid::Serialize(FArchive& Ar)
+{
+	Ar << Origin;
+	Ar << VoxelSize;
+	Ar << CapsuleMargin;
+	Ar << NumBricks;
+	Ar << Bounds;
+	Ar << Fields;
+
+	// Plain integer arrays are read back with a single memory copy.
+	Ar << Bricks;
+	Ar << Voxels;
+}
+
+void UGravityFieldBakedData::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	if (Ar.IsCountingMemory())
+	{
+		return;
+	}
+
+	int32 Version = GravityFieldBakedData::PayloadVersion;
+	bool bHasGrid = Grid.IsValid();
+	Ar << Version;
+	Ar << bHasGrid;
+
+	if (!bHasGrid)
+	{
+		if (Ar.IsLoading())
+		{
+			Grid.Reset();
+		}
+		return;
+	}
+
+	if (Ar.IsLoading())
+	{
+		Grid.Reset();
+
+		if (Version < GravityFieldBakedData::PayloadVersionSized)
+		{
+			// No stored size, the old layout has to be read through to get past it.
+			FGravityFieldBakedGrid StaleGrid;
+			StaleGrid.Serialize(Ar);
+			UE_LOG(LogGravityFieldBake, Warning, TEXT("%s: baked gravity fields are out of date and ignored, bake them again with cg.BakeGravityFields."), *GetPathName());
+			return;
+		}
+
+		int64 PayloadSize = 0;
+		Ar << PayloadSize;
+		const int64 PayloadEnd = Ar.Tell() + PayloadSize;
+		if (PayloadSize < 0 || (Ar.TotalSize() >= 0 && PayloadEnd > Ar.TotalSize()))
+		{
+			Ar.SetError();
+			UE_LOG(LogGravityFieldBake, Error, TEXT("%s: baked gravity fields are corrupt, bake them again with cg.BakeGravityFields."), *GetPathName());
+			return;
+		}
+
+		if (Version != GravityFieldBakedData::PayloadVersion)
+		{
+			Ar.Seek(PayloadEnd);
+			UE_LOG(LogGravityFieldBake, Warning, TEXT("%s: baked gravity fields are out of date and ignored, bake them again with cg.BakeGravityFields."), *GetPathName());
+			return;
+		}
+
+		TSharedRef<FGravityFieldBakedGrid, ESPMode::ThreadSafe> LoadedGrid = MakeShared<FGravityFieldBakedGrid, ESPMode::ThreadSafe>();
+		LoadedGrid->Serialize(Ar);
+		if (Ar.IsError() || Ar.Tell() != PayloadEnd || !LoadedGrid->IsValid())
+		{
+			// Don't let the rest of the asset be read from the middle of the payload.
+			if (!Ar.IsError())
+			{
+				Ar.Seek(PayloadEnd);
+			}
+			UE_LOG(LogGravityFieldBake, Error, TEXT("%s: baked gravity fields are corrupt and ignored, bake them again with cg.BakeGravityFields."), *GetPathName());
+			return;
+		}
+
+		Grid = LoadedGrid;
+	}
+	else
+	{
+		// Store the payload size ahead of it, so loading can skip payloads of other versions without parsing them.
+		const int64 PayloadSizeOffset = Ar.Tell();
+		int64 PayloadSize = 0;
+		Ar << PayloadSize;
+		Grid->Serialize(Ar);
+
+		const int64 PayloadEnd = Ar.Tell();
+		PayloadSize = PayloadEnd - PayloadSizeOffset - (int64)sizeof(PayloadSize);
+		Ar.Seek(PayloadSizeOffset);
+		Ar << PayloadSize;
+		Ar.Seek(PayloadEnd);
+	}
+}
+
+void UGravityFieldBakedData::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	if (Grid)
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Grid->GetAllocatedSize());
+	}
+}
+
+void UGravityFieldBakedData::SetGrid(TSharedRef<FGravityFieldBakedGrid, ESPMode::ThreadSafe> NewGrid)
+{
+	Grid = NewGrid;
+
+	NumFields = NewGrid->Fields.Num();
+	NumBricks = NewGrid->Bricks.Num();
+	NumStoredBricks = 0;
+
+	int64 NumResolved = 0;
+	for (const uint32 BrickEntry : NewGrid->Bricks)
+	{
+		if (BrickEntry == FGravityFieldBakedGrid::EmptyBrick)
+		{
+			NumResolved += FGravityFieldBakedGrid::VoxelsPerBrick;
+		}
+		else if (BrickEntry & 1u)
+		{
+			NumResolved += NewGrid->Voxels[BrickEntry >> 1] != FGravityFieldBakedGrid::UnresolvedField ? FGravityFieldBakedGrid::VoxelsPerBrick : 0;
+		}
+		else
+		{
+			++NumStoredBricks;
+			const uint16* BrickVoxels = NewGrid->Voxels.GetData() + (BrickEntry >> 1);
+			for (int32 Index = 0; Index < FGravityFieldBakedGrid::VoxelsPerBrick; ++Index)
+			{
+				NumResolved += BrickVoxels[Index] != FGravityFieldBakedGrid::UnresolvedField ? 1 : 0;
+			}
+		}
+	}
+
+	const int64 NumVoxels = int64(NumBricks) * FGravityFieldBakedGrid::VoxelsPerBrick;
+	ResolvedPercent = NumVoxels > 0 ? float(100.0 * NumResolved / NumVoxels) : 0.f;
+}
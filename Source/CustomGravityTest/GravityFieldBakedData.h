@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GravityFieldBakedData.generated.h"
+
+/**
+ * Bake time state of a gravity field that touched a baked volume. Fields are matched against the live ones by their state,
+ * so a bake keeps working across streaming and PIE, and stops being trusted as soon as one of its fields moves.
+ */
+struct FGravityFieldBakedField
+{
+	/** World space bounds of the field when it was baked. */
+	FBox Bounds = FBox(ForceInit);
+
+	/** Rotation of gravity boxes, identity for analytic fields. */
+	FQuat Rotation = FQuat::Identity;
+
+	/** Priority of analytic fields, unused by gravity boxes. */
+	int32 Priority = 0;
+
+	bool bIsBox = false;
+
+	friend FArchive& operator<<(FArchive& Ar, FGravityFieldBakedField& Field);
+};
+
+/**
+ * Sparse grid of the gravity field resolved in every voxel of a baked volume, see UGravityFieldSubsystem::BakeGravityFields().
+ *
+ * The volume is split into bricks of BrickSize^3 voxels. Each brick is either empty (no field in any voxel), uniform (a single
+ * voxel value) or stored in full, so open space and the inside of big fields cost a single entry. A voxel holds an index in the
+ * Fields palette: only voxels where a single field wins for any capsule center inside of it and any capsule reaching up to
+ * CapsuleMargin out of it are resolved, the others are left to the live fields.
+ *
+ * Immutable once baked; shared by the subsystem and by gravity field snapshots, so it can be read from any thread.
+ */
+struct CUSTOMGRAVITYTEST_API FGravityFieldBakedGrid
+{
+	static constexpr int32 BrickSize = 8;
+	static constexpr int32 VoxelsPerBrick = BrickSize * BrickSize * BrickSize;
+
+	/** Voxel value of the voxels the bake could not resolve. */
+	static constexpr uint16 UnresolvedField = 0;
+
+	/** Voxel value of the voxels outside of every field. Other values are 1 + the index of a field in Fields. */
+	static constexpr uint16 NoField = MAX_uint16;
+
+	/** Brick entry of the bricks with NoField in every voxel. */
+	static constexpr uint32 EmptyBrick = MAX_uint32;
+
+	/** World space corner of the first voxel. */
+	FVector Origin = FVector::ZeroVector;
+
+	float VoxelSize = 100.f;
+
+	/** Biggest capsule bounding radius the resolved voxels hold for. */
+	float CapsuleMargin = 0.f;
+
+	FIntVector NumBricks = FIntVector::ZeroValue;
+
+	/** World space bounds of the grid. */
+	FBox Bounds = FBox(ForceInit);
+
+	/** Every field touching the grid at bake time, including the ones that never win a voxel. */
+	TArray<FGravityFieldBakedField> Fields;
+
+	/** One entry per brick, X first: EmptyBrick, or the offset of its voxels in Voxels shifted left once, with bit 0 set for uniform bricks. */
+	TArray<uint32> Bricks;
+
+	TArray<uint16> Voxels;
+
+	/** Returns the voxel value at Location, UnresolvedField if outside of the grid. */
+	uint16 FindField(const FVector& Location) const;
+
+	/** Memory used by the voxel payload, in bytes. */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Returns true if every brick entry and voxel value is in range, so FindField() and lookups in Fields by voxel value need no bounds checks. */
+	bool IsValid() const;
+
+	void Serialize(FArchive& Ar);
+};
+
+/**
+ * Gravity fields of an area baked into a sparse voxel grid, so the gravity field subsystem can resolve queries inside of it
+ * in constant time instead of searching the overlapping boxes and planets.
+ *
+ * Referenced by a UGravityFieldBakedVolume placed in the level: the data loads and unloads with the level or World Partition cell
+ * of the volume. Bake with cg.BakeGravityFields while the level is playing, then save the asset.
+ */
+UCLASS(BlueprintType)
+class CUSTOMGRAVITYTEST_API UGravityFieldBakedData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UObject Interface
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+	//~ End UObject Interface
+
+	/** Baked grid, null until baked. */
+	TSharedPtr<const FGravityFieldBakedGrid, ESPMode::ThreadSafe> GetGrid() const { return Grid; }
+
+	/** Replaces the baked grid. Snapshots holding the previous one keep it alive until they are released. */
+	void SetGrid(TSharedRef<FGravityFieldBakedGrid, ESPMode::ThreadSafe> NewGrid);
+
+	/** Size in cm of a voxel. Smaller voxels resolve more of the space close to field boundaries, and use more memory. */
+	UPROPERTY(EditAnywhere, Category = "Bake", meta = (ClampMin = "10", UIMin = "10"))
+	float VoxelSize = 100.f;
+
+	/** Biggest capsule bounding radius (max of half height and radius) in cm queries can use the bake with. Bigger capsules use the live fields. */
+	UPROPERTY(EditAnywhere, Category = "Bake", meta = (ClampMin = "0", UIMin = "0"))
+	float CapsuleMargin = 100.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Bake")
+	int32 NumFields = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = "Bake")
+	int32 NumBricks = 0;
+
+	/** Bricks neither empty nor uniform, stored with every voxel. */
+	UPROPERTY(VisibleAnywhere, Category = "Bake")
+	int32 NumStoredBricks = 0;
+
+	/** Percentage of the voxels resolved by the bake, the others fall back to the live fields. */
+	UPROPERTY(VisibleAnywhere, Category = "Bake")
+	float ResolvedPercent = 0.f;
+
+private:
+	TSharedPtr<FGravityFieldBakedGrid, ESPMode::ThreadSafe> Grid;
+};
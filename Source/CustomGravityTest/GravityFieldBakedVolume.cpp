@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityFieldBakedVolume.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "GravityFieldBakedData.h"
+#include "GravityFieldSubsystem.h"
+#include "UObject/UObjectIterator.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GravityFieldBakedVolume)
+
+DEFINE_LOG_CATEGORY_STATIC(LogGravityFieldBakedVolume, Log, All);
+
+static FAutoConsoleCommandWithWorld BakeGravityFieldsCommand(
+	TEXT("cg.BakeGravityFields"),
+	TEXT("Bakes the gravity fields of every gravity field baked volume of the current world into their data asset. Save the assets afterwards."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		int32 NumBaked = 0;
+		for (UGravityFieldBakedVolume* Volume : TObjectRange<UGravityFieldBakedVolume>())
+		{
+			if (Volume->GetWorld() == World && Volume->HasBegunPlay() && Volume->Bake())
+			{
+				++NumBaked;
+			}
+		}
+		UE_LOG(LogGravityFieldBakedVolume, Log, TEXT("Baked %d gravity field volumes."), NumBaked);
+	}));
+
+UGravityFieldBakedVolume::UGravityFieldBakedVolume()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Only the bounds of the box are used, no physics queries involved.
+	SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	SetGenerateOverlapEvents(false);
+}
+
+bool UGravityFieldBakedVolume::Bake()
+{
+	UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this);
+	if (!BakedData || !GravityFields)
+	{
+		return false;
+	}
+
+	// Baked volumes only register in play, re-register so the subsystem picks up the new grid.
+	GravityFields->UnregisterBakedVolume(this);
+
+	const double StartTime = FPlatformTime::Seconds();
+	BakedData->SetGrid(GravityFields->BakeGravityFields(Bounds.GetBox(), BakedData->VoxelSize, BakedData->CapsuleMargin));
+	BakedData->MarkPackageDirty();
+
+	UE_LOG(LogGravityFieldBakedVolume, Log, TEXT("%s: baked %d bricks (%d stored), %d fields, %.1f%% resolved in %.2fs"),
+		*GetPathNameSafe(BakedData), BakedData->NumBricks, BakedData->NumStoredBricks, BakedData->NumFields, BakedData->ResolvedPercent,
+		FPlatformTime::Seconds() - StartTime);
+
+	if (HasBegunPlay())
+	{
+		GravityFields->RegisterBakedVolume(this);
+	}
+
+	return true;
+}
+
+void UGravityFieldBakedVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->RegisterBakedVolume(this);
+	}
+}
+
+void UGravityFieldBakedVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->UnregisterBakedVolume(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/BoxComponent.h"
+#include "GravityFieldBakedVolume.generated.h"
+
+class UGravityFieldBakedData;
+
+/**
+ * Area whose gravity fields are baked in a UGravityFieldBakedData, see cg.BakeGravityFields.
+ * Registers the baked data with the gravity field subsystem while it is in play, so it streams with the level or World Partition
+ * cell it is placed in. The baked grid covers the world space bounds of the box.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class CUSTOMGRAVITYTEST_API UGravityFieldBakedVolume : public UBoxComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGravityFieldBakedVolume();
+
+	/**
+	 * Bakes the gravity fields currently registered in the world into BakedData, keeping its bake settings.
+	 * Fields register when they begin play, so this runs in a playing world. The asset still has to be saved afterwards.
+	 * @return False if there is no data asset or no gravity field subsystem.
+	 */
+	bool Bake();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity")
+	TObjectPtr<UGravityFieldBakedData> BakedData;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,1503 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityFieldSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GravityBoxAreaVolume.h"
+#include "GravityFieldBakedData.h"
+#include "GravityFieldBakedVolume.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GravityFieldSubsystem)
+
+DEFINE_LOG_CATEGORY_STATIC(LogGravityField, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("Gravity FindGravityBox"), STAT_GravityFindGravityBox, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Gravity FindGravityField"), STAT_GravityFindGravityField, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Gravity EvaluateGravityBatch"), STAT_GravityEvaluateGravityBatch, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Gravity BuildSnapshot"), STAT_GravityBuildSnapshot, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Gravity Snapshot FindGravityField"), STAT_GravitySnapshotFindGravityField, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gravity Field Cache Hits"), STAT_GravityCacheHits, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gravity Field Cache Misses"), STAT_GravityCacheMisses, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gravity Field Baked Hits"), STAT_GravityBakedHits, STATGROUP_Character);
+
+CSV_DEFINE_CATEGORY(GravityField, true);
+
+namespace GravityFieldCVars
+{
+	static float GravityFieldGridCellSize = 2000.f;
+	FAutoConsoleVariableRef CVarGravityFieldGridCellSize(
+		TEXT("cg.GravityFieldGridCellSize"),
+		GravityFieldGridCellSize,
+		TEXT("Size in cm of the cells of the spatial grid used to index gravity fields. Only read when a world is created."),
+		ECVF_Default);
+
+	static int32 GravityFieldMaxCellsPerEntry = 64;
+	FAutoConsoleVariableRef CVarGravityFieldMaxCellsPerEntry(
+		TEXT("cg.GravityFieldMaxCellsPerEntry"),
+		GravityFieldMaxCellsPerEntry,
+		TEXT("Gravity fields covering more grid cells than this are not inserted in the grid and are tested by every query instead."),
+		ECVF_Default);
+
+	static float GravityFieldCacheSearchRadius = 250.f;
+	FAutoConsoleVariableRef CVarGravityFieldCacheSearchRadius(
+		TEXT("cg.GravityFieldCacheSearchRadius"),
+		GravityFieldCacheSearchRadius,
+		TEXT("Maximum distance in cm a character can move before its cached gravity field is resolved again.\n")
+		TEXT("<=0: Disable the cache, >0: Enable"),
+		ECVF_Default);
+}
+
+static FAutoConsoleCommandWithWorld GravityFieldCacheStatsCommand(
+	TEXT("cg.GravityFieldCacheStats"),
+	TEXT("Logs the gravity field cache hit and miss counts of the current world."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(World))
+		{
+			int64 Hits, Misses;
+			GravityFields->GetCacheStats(Hits, Misses);
+			UE_LOG(LogGravityField, Log, TEXT("Gravity field cache: %lld hits, %lld misses (%.1f%% hit rate)"), Hits, Misses, Hits + Misses > 0 ? 100.0 * Hits / (Hits + Misses) : 0.0);
+		}
+	}));
+
+namespace GravityFieldBatch
+{
+	// Number of locations processed together by the batch evaluation. Sized so the scratch arrays stay on the stack.
+	static constexpr int32 ChunkSize = 64;
+
+	using FReal = FVector::FReal;
+
+	/**
+	 * Finds, for every location, the closest point on the polyline and its squared distance.
+	 * Segments are the outer loop so the inner loop runs over contiguous arrays without branches.
+	 */
+	static void FindClosestPoints(const FGravityFieldShape& Shape, const FReal* RESTRICT X, const FReal* RESTRICT Y, const FReal* RESTRICT Z, int32 Count,
+		FReal* RESTRICT OutDistSq, FReal* RESTRICT OutX, FReal* RESTRICT OutY, FReal* RESTRICT OutZ)
+	{
+		const int32 NumPoints = Shape.Points.Num();
+		check(NumPoints > 0);
+
+		// Start with the first point, this is the whole answer for spherical fields.
+		const FVector& First = Shape.Points[0];
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			OutX[Index] = First.X;
+			OutY[Index] = First.Y;
+			OutZ[Index] = First.Z;
+			OutDistSq[Index] = FMath::Square(X[Index] - First.X) + FMath::Square(Y[Index] - First.Y) + FMath::Square(Z[Index] - First.Z);
+		}
+
+		for (int32 PointIndex = 1; PointIndex < NumPoints; ++PointIndex)
+		{
+			const FVector& Start = Shape.Points[PointIndex - 1];
+			const FVector Delta = Shape.Points[PointIndex] - Start;
+			const FReal LengthSq = Delta.SizeSquared();
+			const FReal InvLengthSq = LengthSq > UE_SMALL_NUMBER ? 1.0 / LengthSq : 0.0;
+
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				const FReal Dot = (X[Index] - Start.X) * Delta.X + (Y[Index] - Start.Y) * Delta.Y + (Z[Index] - Start.Z) * Delta.Z;
+				const FReal T = FMath::Clamp(Dot * InvLengthSq, 0.0, 1.0);
+				const FReal PointX = Start.X + Delta.X * T;
+				const FReal PointY = Start.Y + Delta.Y * T;
+				const FReal PointZ = Start.Z + Delta.Z * T;
+				const FReal DistSq = FMath::Square(X[Index] - PointX) + FMath::Square(Y[Index] - PointY) + FMath::Square(Z[Index] - PointZ);
+
+				const bool bCloser = DistSq < OutDistSq[Index];
+				OutDistSq[Index] = bCloser ? DistSq : OutDistSq[Index];
+				OutX[Index] = bCloser ? PointX : OutX[Index];
+				OutY[Index] = bCloser ? PointY : OutY[Index];
+				OutZ[Index] = bCloser ? PointZ : OutZ[Index];
+			}
+		}
+	}
+
+	static FBox ComputeShapeBounds(const FGravityFieldShape& Shape)
+	{
+		FBox Bounds(ForceInit);
+		for (const FVector& Point : Shape.Points)
+		{
+			Bounds += Point;
+		}
+		return Bounds.ExpandBy(Shape.Radius);
+	}
+}
+
+bool FGravityBoxFieldEntry::OverlapsCapsule(const FVector& Location, const FVector& CapsuleAxis, float Radius, float HalfHeightNoCaps) const
+{
+	// Work in box local space, where the box is an AABB centered at the origin.
+	const FVector LocalCenter = Transform.InverseTransformPositionNoScale(Location);
+	const FVector LocalAxis = Transform.InverseTransformVectorNoScale(CapsuleAxis) * HalfHeightNoCaps;
+	const FVector SegmentStart = LocalCenter - LocalAxis;
+	const FVector SegmentDir = LocalAxis * 2.0;
+
+	// Reject against the bounds of the swept segment first, this is the common case.
+	const FVector SegmentEnd = SegmentStart + SegmentDir;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (FMath::Min(SegmentStart[Axis], SegmentEnd[Axis]) - Radius > Extent[Axis] ||
+			FMath::Max(SegmentStart[Axis], SegmentEnd[Axis]) + Radius < -Extent[Axis])
+		{
+			return false;
+		}
+	}
+
+	// Find the closest points between the segment and the box with a few steps of alternating projection.
+	// Both sets are convex so this converges quickly; starting from the point nearest the box center it is exact
+	// for all but grazing configurations.
+	const double SegmentLengthSquared = SegmentDir.SizeSquared();
+	const double RadiusSquared = FMath::Square(Radius);
+	auto ProjectOnSegment = [&](const FVector& Point) -> FVector
+	{
+		const double T = SegmentLengthSquared > UE_SMALL_NUMBER ? FMath::Clamp(((Point - SegmentStart) | SegmentDir) / SegmentLengthSquared, 0.0, 1.0) : 0.0;
+		return SegmentStart + SegmentDir * T;
+	};
+
+	FVector SegmentPoint = ProjectOnSegment(FVector::ZeroVector);
+	for (int32 Iteration = 0; Iteration < 4; ++Iteration)
+	{
+		const FVector BoxPoint = SegmentPoint.BoundToBox(-Extent, Extent);
+		if (FVector::DistSquared(SegmentPoint, BoxPoint) <= RadiusSquared)
+		{
+			return true;
+		}
+
+		SegmentPoint = ProjectOnSegment(BoxPoint);
+	}
+
+	return false;
+}
+
+void UGravityFieldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CellSize = FMath::Max(GravityFieldCVars::GravityFieldGridCellSize, 100.f);
+}
+
+void UGravityFieldSubsystem::Deinitialize()
+{
+	BoxEntries.Empty();
+	BoxEntryLookup.Empty();
+	AnalyticFields.Empty();
+	AnalyticFieldLookup.Empty();
+	Cells.Empty();
+	OversizedEntries.Empty();
+	BakedVolumes.Empty();
+	Snapshot.Reset();
+
+	Super::Deinitialize();
+}
+
+UGravityFieldSubsystem* UGravityFieldSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UGravityFieldSubsystem>() : nullptr;
+}
+
+void UGravityFieldSubsystem::RegisterGravityBox(UGravityBoxAreaVolume* Volume)
+{
+	if (!Volume || BoxEntryLookup.Contains(Volume))
+	{
+		return;
+	}
+
+	FGravityBoxFieldEntry NewEntry;
+	NewEntry.Volume = Volume;
+	RefreshEntry(NewEntry, *Volume);
+
+	const int32 EntryIndex = BoxEntries.Add(MoveTemp(NewEntry));
+	BoxEntryLookup.Add(Volume, EntryIndex);
+	AddEntryToGrid(EntryIndex);
+	OnFieldsChanged(FBox(ForceInit), BoxEntries[EntryIndex].Bounds);
+
+	UE_LOG(LogGravityField, Verbose, TEXT("RegisterGravityBox: %s (%d registered)"), *GetNameSafe(Volume), BoxEntries.Num());
+}
+
+void UGravityFieldSubsystem::UnregisterGravityBox(UGravityBoxAreaVolume* Volume)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (!BoxEntryLookup.RemoveAndCopyValue(Volume, EntryIndex))
+	{
+		return;
+	}
+
+	const FBox OldBounds = BoxEntries[EntryIndex].Bounds;
+	RemoveEntryFromGrid(EntryIndex);
+	BoxEntries.RemoveAt(EntryIndex);
+	OnFieldsChanged(OldBounds, FBox(ForceInit));
+
+	UE_LOG(LogGravityField, Verbose, TEXT("UnregisterGravityBox: %s (%d registered)"), *GetNameSafe(Volume), BoxEntries.Num());
+}
+
+void UGravityFieldSubsystem::UpdateGravityBox(UGravityBoxAreaVolume* Volume)
+{
+	const int32* EntryIndex = Volume ? BoxEntryLookup.Find(Volume) : nullptr;
+	if (!EntryIndex)
+	{
+		return;
+	}
+
+	FGravityBoxFieldEntry& Entry = BoxEntries[*EntryIndex];
+	FGravityBoxFieldEntry NewEntry = Entry;
+	RefreshEntry(NewEntry, *Volume);
+
+	// Transform updates that leave the box in place, for instance from its attach parent, change nothing.
+	if (NewEntry.Transform.Equals(Entry.Transform, 0.0) && NewEntry.Extent == Entry.Extent)
+	{
+		return;
+	}
+
+	const FBox OldBounds = Entry.Bounds;
+	RemoveEntryFromGrid(*EntryIndex);
+	Entry = MoveTemp(NewEntry);
+	AddEntryToGrid(*EntryIndex);
+	OnFieldsChanged(OldBounds, Entry.Bounds);
+}
+
+void UGravityFieldSubsystem::RefreshEntry(FGravityBoxFieldEntry& Entry, const UGravityBoxAreaVolume& Volume) const
+{
+	const FTransform& ComponentTransform = Volume.GetComponentTransform();
+	Entry.Transform = FTransform(ComponentTransform.GetRotation(), ComponentTransform.GetTranslation());
+	Entry.Extent = Volume.GetScaledBoxExtent();
+	Entry.ExtentSizeSquared = Entry.Extent.SquaredLength();
+	Entry.Bounds = FBox(-Entry.Extent, Entry.Extent).TransformBy(Entry.Transform);
+}
+
+FIntVector UGravityFieldSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+void UGravityFieldSubsystem::AddEntryToGrid(int32 EntryIndex)
+{
+	FGravityBoxFieldEntry& Entry = BoxEntries[EntryIndex];
+	Entry.MinCell = GetCell(Entry.Bounds.Min);
+	Entry.MaxCell = GetCell(Entry.Bounds.Max);
+
+	const FIntVector CellCount = Entry.MaxCell - Entry.MinCell + FIntVector(1);
+	const int64 NumCells = int64(CellCount.X) * CellCount.Y * CellCount.Z;
+	Entry.bOversized = NumCells > GravityFieldCVars::GravityFieldMaxCellsPerEntry;
+
+	if (Entry.bOversized)
+	{
+		OversizedEntries.Add(EntryIndex);
+		return;
+	}
+
+	for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+	{
+		for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+		{
+			for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+			{
+				Cells.FindOrAdd(FIntVector(X, Y, Z)).EntryIndices.Add(EntryIndex);
+			}
+		}
+	}
+}
+
+void UGravityFieldSubsystem::RemoveEntryFromGrid(int32 EntryIndex)
+{
+	const FGravityBoxFieldEntry& Entry = BoxEntries[EntryIndex];
+
+	if (Entry.bOversized)
+	{
+		OversizedEntries.RemoveSingleSwap(EntryIndex);
+		return;
+	}
+
+	for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+	{
+		for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+		{
+			for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+			{
+				const FIntVector CellKey(X, Y, Z);
+				if (FGravityFieldCell* Cell = Cells.Find(CellKey))
+				{
+					Cell->EntryIndices.RemoveSingleSwap(EntryIndex);
+					if (Cell->EntryIndices.IsEmpty())
+					{
+						Cells.Remove(CellKey);
+					}
+				}
+			}
+		}
+	}
+}
+
+void UGravityFieldSubsystem::TestBoxEntry(int32 EntryIndex, const FVector& Location, const FVector& CapsuleAxis, float Radius, float HalfHeightNoCaps, int32& InOutBestIndex) const
+{
+	const FGravityBoxFieldEntry& Entry = BoxEntries[EntryIndex];
+
+	// Cheaper priority test first, it culls most of the boxes nested in each other.
+	if (InOutBestIndex != INDEX_NONE && BoxEntries[InOutBestIndex].ExtentSizeSquared <= Entry.ExtentSizeSquared)
+	{
+		return;
+	}
+
+	if (Entry.OverlapsCapsule(Location, CapsuleAxis, Radius, HalfHeightNoCaps))
+	{
+		InOutBestIndex = EntryIndex;
+	}
+}
+
+void UGravityFieldSubsystem::FindBestBoxInCells(const FIntVector& MinCell, const FIntVector& MaxCell, const FVector& Location, const FVector& CapsuleAxis, float Radius, float HalfHeightNoCaps, int32& OutBestIndex) const
+{
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				if (const FGravityFieldCell* Cell = Cells.Find(FIntVector(X, Y, Z)))
+				{
+					for (const int32 EntryIndex : Cell->EntryIndices)
+					{
+						TestBoxEntry(EntryIndex, Location, CapsuleAxis, Radius, HalfHeightNoCaps, OutBestIndex);
+					}
+				}
+			}
+		}
+	}
+
+	for (const int32 EntryIndex : OversizedEntries)
+	{
+		TestBoxEntry(EntryIndex, Location, CapsuleAxis, Radius, HalfHeightNoCaps, OutBestIndex);
+	}
+}
+
+UGravityBoxAreaVolume* UGravityFieldSubsystem::FindGravityBox(const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityFindGravityBox);
+
+	if (BoxEntries.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	const FVector CapsuleAxis = Rotation.GetUpVector();
+	const float HalfHeightNoCaps = FMath::Max(HalfHeight - Radius, 0.f);
+	const FVector CapsuleExtent = CapsuleAxis.GetAbs() * HalfHeightNoCaps + FVector(Radius);
+
+	int32 BestIndex = INDEX_NONE;
+	FindBestBoxInCells(GetCell(Location - CapsuleExtent), GetCell(Location + CapsuleExtent), Location, CapsuleAxis, Radius, HalfHeightNoCaps, BestIndex);
+
+	return BestIndex != INDEX_NONE ? BoxEntries[BestIndex].Volume.Get() : nullptr;
+}
+
+UGravityBoxAreaVolume* UGravityFieldSubsystem::FindGravityBoxAtPoint(const FVector& Location) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityFindGravityBox);
+
+	if (BoxEntries.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	const FIntVector Cell = GetCell(Location);
+
+	int32 BestIndex = INDEX_NONE;
+	FindBestBoxInCells(Cell, Cell, Location, FVector::UpVector, 0.f, 0.f, BestIndex);
+
+	return BestIndex != INDEX_NONE ? BoxEntries[BestIndex].Volume.Get() : nullptr;
+}
+
+void UGravityFieldSubsystem::GatherBoxEntries(const FBox& Bounds, TArray<int32, TInlineAllocator<16>>& OutEntryIndices) const
+{
+	OutEntryIndices.Reset();
+	if (BoxEntries.Num() == 0)
+	{
+		return;
+	}
+
+	// Spread out queries touch more cells than there are boxes, test every box instead.
+	const FIntVector MinCell = GetCell(Bounds.Min);
+	const FIntVector MaxCell = GetCell(Bounds.Max);
+	const FIntVector CellCount = MaxCell - MinCell + FIntVector(1);
+	if (int64(CellCount.X) * CellCount.Y * CellCount.Z > BoxEntries.Num())
+	{
+		for (TSparseArray<FGravityBoxFieldEntry>::TConstIterator It(BoxEntries); It; ++It)
+		{
+			if (It->Bounds.Intersect(Bounds))
+			{
+				OutEntryIndices.Add(It.GetIndex());
+			}
+		}
+	}
+	else
+	{
+		for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+		{
+			for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+			{
+				for (int32 CellZ = MinCell.Z; CellZ <= MaxCell.Z; ++CellZ)
+				{
+					if (const FGravityFieldCell* Cell = Cells.Find(FIntVector(CellX, CellY, CellZ)))
+					{
+						for (const int32 EntryIndex : Cell->EntryIndices)
+						{
+							if (BoxEntries[EntryIndex].Bounds.Intersect(Bounds))
+							{
+								OutEntryIndices.AddUnique(EntryIndex);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		for (const int32 EntryIndex : OversizedEntries)
+		{
+			if (BoxEntries[EntryIndex].Bounds.Intersect(Bounds))
+			{
+				OutEntryIndices.Add(EntryIndex);
+			}
+		}
+	}
+
+	OutEntryIndices.Sort([this](int32 A, int32 B) { return BoxEntries[A].ExtentSizeSquared < BoxEntries[B].ExtentSizeSquared; });
+}
+
+void UGravityFieldSubsystem::RegisterGravityField(UPrimitiveComponent* Component, FGravityFieldShape&& Shape)
+{
+	if (!Component || !ensureMsgf(Shape.Points.Num() > 0, TEXT("RegisterGravityField: %s has an empty shape"), *GetNameSafe(Component)))
+	{
+		return;
+	}
+
+	if (AnalyticFieldLookup.Contains(Component))
+	{
+		UpdateGravityField(Component, MoveTemp(Shape));
+		return;
+	}
+
+	FGravityAnalyticFieldEntry NewEntry;
+	NewEntry.Component = Component;
+	NewEntry.Bounds = GravityFieldBatch::ComputeShapeBounds(Shape);
+	NewEntry.Shape = MoveTemp(Shape);
+
+	const FBox NewBounds = NewEntry.Bounds;
+	AnalyticFieldLookup.Add(Component, AnalyticFields.Add(MoveTemp(NewEntry)));
+	OnFieldsChanged(FBox(ForceInit), NewBounds);
+
+	UE_LOG(LogGravityField, Verbose, TEXT("RegisterGravityField: %s (%d registered)"), *GetNameSafe(Component), AnalyticFields.Num());
+}
+
+void UGravityFieldSubsystem::UnregisterGravityField(UPrimitiveComponent* Component)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (AnalyticFieldLookup.RemoveAndCopyValue(Component, EntryIndex))
+	{
+		const FBox OldBounds = AnalyticFields[EntryIndex].Bounds;
+		AnalyticFields.RemoveAt(EntryIndex);
+		OnFieldsChanged(OldBounds, FBox(ForceInit));
+
+		UE_LOG(LogGravityField, Verbose, TEXT("UnregisterGravityField: %s (%d registered)"), *GetNameSafe(Component), AnalyticFields.Num());
+	}
+}
+
+void UGravityFieldSubsystem::UpdateGravityField(UPrimitiveComponent* Component, FGravityFieldShape&& Shape)
+{
+	const int32* EntryIndex = Component ? AnalyticFieldLookup.Find(Component) : nullptr;
+	if (!EntryIndex || Shape.Points.Num() == 0)
+	{
+		return;
+	}
+
+	FGravityAnalyticFieldEntry& Entry = AnalyticFields[*EntryIndex];
+	const FBox OldBounds = Entry.Bounds;
+	Entry.Bounds = GravityFieldBatch::ComputeShapeBounds(Shape);
+	Entry.Shape = MoveTemp(Shape);
+	OnFieldsChanged(OldBounds, Entry.Bounds);
+}
+
+void UGravityFieldSubsystem::OnFieldsChanged(const FBox& OldBounds, const FBox& NewBounds)
+{
+	++FieldsGeneration;
+
+	FGravityFieldChange& Change = RecentChanges[FieldsGeneration % MaxRecentChanges];
+	Change.OldBounds = OldBounds;
+	Change.NewBounds = NewBounds;
+
+	for (FGravityBakedVolumeEntry& Entry : BakedVolumes)
+	{
+		if (Change.Intersect(Entry.Grid->Bounds.ExpandBy(Entry.Grid->CapsuleMargin)))
+		{
+			RefreshBakedVolume(Entry);
+		}
+	}
+}
+
+bool UGravityFieldSubsystem::IsCacheAffectedByChanges(const FGravityFieldQueryCache& Cache) const
+{
+	if (FieldsGeneration - Cache.Generation > MaxRecentChanges)
+	{
+		return true;
+	}
+
+	// The capsule can reach any point within its bounding radius of a location within the margin of the cached one.
+	const FBox Reach = FBox::BuildAABB(Cache.Location, FVector(Cache.Margin + FMath::Max(Cache.Radius, Cache.HalfHeight)));
+	for (uint32 Generation = Cache.Generation + 1; Generation != FieldsGeneration + 1; ++Generation)
+	{
+		if (RecentChanges[Generation % MaxRecentChanges].Intersect(Reach))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UGravityFieldSubsystem::RegisterBakedVolume(UGravityFieldBakedVolume* Volume)
+{
+	const UGravityFieldBakedData* BakedData = Volume ? Volume->BakedData.Get() : nullptr;
+	TSharedPtr<const FGravityFieldBakedGrid, ESPMode::ThreadSafe> Grid;
+	if (BakedData)
+	{
+		Grid = BakedData->GetGrid();
+	}
+
+	if (!Grid || BakedVolumes.ContainsByPredicate([Volume](const FGravityBakedVolumeEntry& Entry) { return Entry.Volume == Volume; }))
+	{
+		return;
+	}
+
+	FGravityBakedVolumeEntry& NewEntry = BakedVolumes.AddDefaulted_GetRef();
+	NewEntry.Volume = Volume;
+	NewEntry.Grid = MoveTemp(Grid);
+	OnFieldsChanged(FBox(ForceInit), NewEntry.Grid->Bounds);
+
+	UE_LOG(LogGravityField, Verbose, TEXT("RegisterBakedVolume: %s (%d registered, %s)"), *GetNameSafe(Volume), BakedVolumes.Num(), NewEntry.bEnabled ? TEXT("enabled") : TEXT("disabled"));
+}
+
+void UGravityFieldSubsystem::UnregisterBakedVolume(UGravityFieldBakedVolume* Volume)
+{
+	const int32 EntryIndex = BakedVolumes.IndexOfByPredicate([Volume](const FGravityBakedVolumeEntry& Entry) { return Entry.Volume == Volume; });
+	if (EntryIndex != INDEX_NONE)
+	{
+		const FBox OldBounds = BakedVolumes[EntryIndex].Grid->Bounds;
+		BakedVolumes.RemoveAtSwap(EntryIndex);
+		OnFieldsChanged(OldBounds, FBox(ForceInit));
+
+		UE_LOG(LogGravityField, Verbose, TEXT("UnregisterBakedVolume: %s (%d registered)"), *GetNameSafe(Volume), BakedVolumes.Num());
+	}
+}
+
+void UGravityFieldSubsystem::RefreshBakedVolume(FGravityBakedVolumeEntry& Entry) const
+{
+	// Bounds recomputed from the same level data at runtime may differ from the baked ones by float error.
+	static constexpr float MatchTolerance = 0.1f;
+
+	const FGravityFieldBakedGrid& Grid = *Entry.Grid;
+	const FBox TouchBounds = Grid.Bounds.ExpandBy(Grid.CapsuleMargin);
+
+	Entry.Links.Reset();
+	Entry.Links.SetNum(Grid.Fields.Num());
+	Entry.bEnabled = true;
+
+	// Baked fields are few, a linear search is cheaper than keeping a lookup in sync with moving fields.
+	auto FindBakedField = [&Grid, &Entry](const FBox& Bounds, const FQuat& Rotation, int32 Priority, bool bIsBox)
+	{
+		for (int32 FieldIndex = 0; FieldIndex < Grid.Fields.Num(); ++FieldIndex)
+		{
+			const FGravityFieldBakedField& Field = Grid.Fields[FieldIndex];
+			if (Field.bIsBox == bIsBox && Field.Priority == Priority && !Entry.Links[FieldIndex].IsLinked()
+				&& Field.Bounds.Min.Equals(Bounds.Min, MatchTolerance) && Field.Bounds.Max.Equals(Bounds.Max, MatchTolerance)
+				&& Field.Rotation.Equals(Rotation, UE_KINDA_SMALL_NUMBER))
+			{
+				return FieldIndex;
+			}
+		}
+		return int32(INDEX_NONE);
+	};
+
+	// Every live field touching the grid must be one it was baked from: a new or moved field may win in any voxel.
+	// Baked fields with no live match, for instance not streamed in yet, only leave their own voxels to the live fields.
+	for (auto It = BoxEntries.CreateConstIterator(); It && Entry.bEnabled; ++It)
+	{
+		if (It->Bounds.Intersect(TouchBounds))
+		{
+			const int32 FieldIndex = FindBakedField(It->Bounds, It->Transform.GetRotation(), 0, true);
+			Entry.bEnabled = FieldIndex != INDEX_NONE;
+			if (Entry.bEnabled)
+			{
+				Entry.Links[FieldIndex].BoxIndex = It.GetIndex();
+			}
+		}
+	}
+
+	for (auto It = AnalyticFields.CreateConstIterator(); It && Entry.bEnabled; ++It)
+	{
+		if (It->Bounds.Intersect(TouchBounds))
+		{
+			const int32 FieldIndex = FindBakedField(It->Bounds, FQuat::Identity, It->Shape.Settings.Priority, false);
+			Entry.bEnabled = FieldIndex != INDEX_NONE;
+			if (Entry.bEnabled)
+			{
+				Entry.Links[FieldIndex].AnalyticFieldIndex = It.GetIndex();
+			}
+		}
+	}
+}
+
+bool UGravityFieldSubsystem::FindBakedGravityField(const FVector& Location, float Radius, float HalfHeight, FGravityFieldSample& OutSample, int32& OutAnalyticFieldIndex) const
+{
+	const float BoundingRadius = FMath::Max(Radius, HalfHeight);
+	for (const FGravityBakedVolumeEntry& Entry : BakedVolumes)
+	{
+		if (!Entry.bEnabled || BoundingRadius > Entry.Grid->CapsuleMargin)
+		{
+			continue;
+		}
+
+		const uint16 Value = Entry.Grid->FindField(Location);
+		if (Value == FGravityFieldBakedGrid::UnresolvedField)
+		{
+			continue;
+		}
+
+		if (Value == FGravityFieldBakedGrid::NoField)
+		{
+			OutSample = FGravityFieldSample();
+			return true;
+		}
+
+		const FGravityBakedFieldLink& Link = Entry.Links[Value - 1];
+		if (Link.BoxIndex != INDEX_NONE)
+		{
+			if (UGravityBoxAreaVolume* GravityBox = BoxEntries[Link.BoxIndex].Volume.Get())
+			{
+				OutSample.Component = GravityBox;
+				OutSample.Direction = -GravityBox->GetUpVector();
+				OutSample.Strength = 1.f;
+				return true;
+			}
+		}
+		else if (Link.AnalyticFieldIndex != INDEX_NONE)
+		{
+			const FGravityAnalyticFieldEntry& Field = AnalyticFields[Link.AnalyticFieldIndex];
+			if (UPrimitiveComponent* FieldComponent = Field.Component.Get())
+			{
+				// The field is known, only its direction changes across the voxel.
+				GravityFieldBatch::FReal DistSq;
+				FVector Point;
+				GravityFieldBatch::FindClosestPoints(Field.Shape, &Location.X, &Location.Y, &Location.Z, 1, &DistSq, &Point.X, &Point.Y, &Point.Z);
+
+				OutSample.Component = FieldComponent;
+				OutSample.Direction = (Point - Location).GetSafeNormal(UE_SMALL_NUMBER, FVector::DownVector);
+				OutSample.Strength = Field.Shape.Settings.GravityScale;
+				OutAnalyticFieldIndex = Link.AnalyticFieldIndex;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+TSharedRef<FGravityFieldBakedGrid, ESPMode::ThreadSafe> UGravityFieldSubsystem::BakeGravityFields(const FBox& Bounds, float VoxelSize, float CapsuleMargin) const
+{
+	using FGrid = FGravityFieldBakedGrid;
+
+	TSharedRef<FGrid, ESPMode::ThreadSafe> Grid = MakeShared<FGrid, ESPMode::ThreadSafe>();
+	Grid->VoxelSize = FMath::Max(VoxelSize, 10.f);
+	Grid->CapsuleMargin = FMath::Max(CapsuleMargin, 0.f);
+	Grid->Origin = Bounds.Min;
+
+	const double BrickWorldSize = double(Grid->VoxelSize) * FGrid::BrickSize;
+	const FVector Size = Bounds.GetSize();
+	const FIntVector NumBricks(
+		FMath::Max(FMath::CeilToInt32(Size.X / BrickWorldSize), 1),
+		FMath::Max(FMath::CeilToInt32(Size.Y / BrickWorldSize), 1),
+		FMath::Max(FMath::CeilToInt32(Size.Z / BrickWorldSize), 1));
+	Grid->Bounds = FBox(Grid->Origin, Grid->Origin + FVector(NumBricks) * BrickWorldSize);
+
+	// Every field touching the grid is baked, winning a voxel or not, so the runtime can tell when one of them moves.
+	const FBox TouchBounds = Grid->Bounds.ExpandBy(Grid->CapsuleMargin);
+	TMap<int32, uint16> BoxFieldValues;
+	TMap<int32, uint16> AnalyticFieldValues;
+
+	auto AddField = [&Grid](const FBox& FieldBounds, const FQuat& Rotation, int32 Priority, bool bIsBox)
+	{
+		FGravityFieldBakedField& Field = Grid->Fields.AddDefaulted_GetRef();
+		Field.Bounds = FieldBounds;
+		Field.Rotation = Rotation;
+		Field.Priority = Priority;
+		Field.bIsBox = bIsBox;
+		return uint16(Grid->Fields.Num());
+	};
+
+	for (auto It = BoxEntries.CreateConstIterator(); It; ++It)
+	{
+		if (It->Bounds.Intersect(TouchBounds))
+		{
+			BoxFieldValues.Add(It.GetIndex(), AddField(It->Bounds, It->Transform.GetRotation(), 0, true));
+		}
+	}
+
+	for (auto It = AnalyticFields.CreateConstIterator(); It; ++It)
+	{
+		if (It->Bounds.Intersect(TouchBounds))
+		{
+			AnalyticFieldValues.Add(It.GetIndex(), AddField(It->Bounds, FQuat::Identity, It->Shape.Settings.Priority, false));
+		}
+	}
+
+	if (!ensureMsgf(Grid->Fields.Num() < FGrid::NoField - 1, TEXT("BakeGravityFields: %d fields touch the baked bounds, split the volume"), Grid->Fields.Num()))
+	{
+		// An empty grid resolves nothing, every query falls back to the live fields.
+		Grid->Fields.Reset();
+		return Grid;
+	}
+
+	Grid->NumBricks = NumBricks;
+	Grid->Bricks.Reserve(NumBricks.X * NumBricks.Y * NumBricks.Z);
+
+	// Bake a layer of bricks at a time in parallel, then compact it.
+	const int32 NumLayerBricks = NumBricks.X * NumBricks.Y;
+	TArray<uint16> LayerVoxels;
+	LayerVoxels.SetNumUninitialized(NumLayerBricks * FGrid::VoxelsPerBrick);
+
+	for (int32 BrickZ = 0; BrickZ < NumBricks.Z; ++BrickZ)
+	{
+		ParallelFor(NumLayerBricks, [&](int32 LayerBrickIndex)
+		{
+			const FIntVector Brick(LayerBrickIndex % NumBricks.X, LayerBrickIndex / NumBricks.X, BrickZ);
+			const FVector BrickOrigin = Grid->Origin + FVector(Brick) * BrickWorldSize;
+			uint16* BrickVoxels = LayerVoxels.GetData() + LayerBrickIndex * FGrid::VoxelsPerBrick;
+
+			for (int32 Z = 0; Z < FGrid::BrickSize; ++Z)
+			{
+				for (int32 Y = 0; Y < FGrid::BrickSize; ++Y)
+				{
+					for (int32 X = 0; X < FGrid::BrickSize; ++X)
+					{
+						const FVector VoxelMin = BrickOrigin + FVector(X, Y, Z) * Grid->VoxelSize;
+						BrickVoxels[(Z * FGrid::BrickSize + Y) * FGrid::BrickSize + X] = BakeVoxel(FBox(VoxelMin, VoxelMin + FVector(Grid->VoxelSize)), Grid->CapsuleMargin, BoxFieldValues, AnalyticFieldValues);
+					}
+				}
+			}
+		});
+
+		for (int32 LayerBrickIndex = 0; LayerBrickIndex < NumLayerBricks; ++LayerBrickIndex)
+		{
+			const uint16* BrickVoxels = LayerVoxels.GetData() + LayerBrickIndex * FGrid::VoxelsPerBrick;
+
+			bool bUniform = true;
+			for (int32 Index = 1; Index < FGrid::VoxelsPerBrick && bUniform; ++Index)
+			{
+				bUniform = BrickVoxels[Index] == BrickVoxels[0];
+			}
+
+			if (bUniform && BrickVoxels[0] == FGrid::NoField)
+			{
+				Grid->Bricks.Add(FGrid::EmptyBrick);
+			}
+			else if (bUniform)
+			{
+				Grid->Bricks.Add((uint32(Grid->Voxels.Num()) << 1) | 1u);
+				Grid->Voxels.Add(BrickVoxels[0]);
+			}
+			else
+			{
+				Grid->Bricks.Add(uint32(Grid->Voxels.Num()) << 1);
+				Grid->Voxels.Append(BrickVoxels, FGrid::VoxelsPerBrick);
+			}
+		}
+	}
+
+	Grid->Voxels.Shrink();
+	return Grid;
+}
+
+uint16 UGravityFieldSubsystem::BakeVoxel(const FBox& VoxelBox, float CapsuleMargin, const TMap<int32, uint16>& BoxFieldValues, const TMap<int32, uint16>& AnalyticFieldValues) const
+{
+	using FGrid = FGravityFieldBakedGrid;
+
+	// Capsules centered in the voxel reach up to CapsuleMargin out of it. The smallest box touching the sphere around that region
+	// is the only candidate: it wins every capsule if it contains the whole region, and only some of them otherwise.
+	const FBox Region = VoxelBox.ExpandBy(CapsuleMargin);
+	const FVector RegionCenter = Region.GetCenter();
+	const FVector RegionExtent = Region.GetExtent();
+	const float RegionRadius = RegionExtent.Size();
+
+	int32 BestBoxIndex = INDEX_NONE;
+	FindBestBoxInCells(GetCell(RegionCenter - FVector(RegionRadius)), GetCell(RegionCenter + FVector(RegionRadius)), RegionCenter, FVector::UpVector, RegionRadius, 0.f, BestBoxIndex);
+
+	if (BestBoxIndex != INDEX_NONE)
+	{
+		const FGravityBoxFieldEntry& Entry = BoxEntries[BestBoxIndex];
+
+		// Extent of the region along the box axes.
+		FVector LocalExtent = FVector::ZeroVector;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			FVector WorldAxis = FVector::ZeroVector;
+			WorldAxis[Axis] = RegionExtent[Axis];
+			LocalExtent += Entry.Transform.InverseTransformVectorNoScale(WorldAxis).GetAbs();
+		}
+
+		const FVector Inner = Entry.Extent - Entry.Transform.InverseTransformPositionNoScale(RegionCenter).GetAbs() - LocalExtent;
+		const uint16* Value = BoxFieldValues.Find(BestBoxIndex);
+		return (Inner.GetMin() >= 0.0 && Value) ? *Value : FGrid::UnresolvedField;
+	}
+
+	// Analytic fields are picked by the capsule center, only the voxel itself matters.
+	const FVector VoxelCenter = VoxelBox.GetCenter();
+	const GravityFieldBatch::FReal VoxelRadius = VoxelBox.GetExtent().Size();
+
+	struct FCandidate
+	{
+		int32 FieldIndex;
+		GravityFieldBatch::FReal Distance;
+		int32 Priority;
+		bool bContainsVoxel;
+	};
+	TArray<FCandidate, TInlineAllocator<8>> Candidates;
+
+	for (auto It = AnalyticFields.CreateConstIterator(); It; ++It)
+	{
+		const FGravityAnalyticFieldEntry& Entry = *It;
+		if (!Entry.Bounds.Intersect(VoxelBox))
+		{
+			continue;
+		}
+
+		GravityFieldBatch::FReal DistSq;
+		FVector Point;
+		GravityFieldBatch::FindClosestPoints(Entry.Shape, &VoxelCenter.X, &VoxelCenter.Y, &VoxelCenter.Z, 1, &DistSq, &Point.X, &Point.Y, &Point.Z);
+
+		const GravityFieldBatch::FReal Distance = FMath::Sqrt(DistSq);
+		if (Distance - VoxelRadius <= Entry.Shape.Radius)
+		{
+			Candidates.Add({ It.GetIndex(), Distance, Entry.Shape.Settings.Priority, Distance + VoxelRadius <= Entry.Shape.Radius });
+		}
+	}
+
+	if (Candidates.Num() == 0)
+	{
+		return FGrid::NoField;
+	}
+
+	// Best field containing the whole voxel, with the same rules as FindGravityFieldInternal().
+	const FCandidate* Best = nullptr;
+	for (const FCandidate& Candidate : Candidates)
+	{
+		if (Candidate.bContainsVoxel && (!Best || Candidate.Priority > Best->Priority || (Candidate.Priority == Best->Priority && Candidate.Distance < Best->Distance)))
+		{
+			Best = &Candidate;
+		}
+	}
+
+	if (!Best)
+	{
+		return FGrid::UnresolvedField;
+	}
+
+	// Distances change by at most VoxelRadius within the voxel, any other field that may win somewhere in it leaves it unresolved.
+	for (const FCandidate& Candidate : Candidates)
+	{
+		if (&Candidate != Best && (Candidate.Priority > Best->Priority
+			|| (Candidate.Priority == Best->Priority && Candidate.Distance - VoxelRadius <= Best->Distance + VoxelRadius)))
+		{
+			return FGrid::UnresolvedField;
+		}
+	}
+
+	const uint16* Value = AnalyticFieldValues.Find(Best->FieldIndex);
+	return Value ? *Value : FGrid::UnresolvedField;
+}
+
+FGravityFieldSample UGravityFieldSubsystem::FindGravityField(const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight) const
+{
+	int32 AnalyticFieldIndex;
+	return FindGravityFieldInternal(Location, Rotation, Radius, HalfHeight, AnalyticFieldIndex);
+}
+
+FGravityFieldSample UGravityFieldSubsystem::FindGravityFieldInternal(const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight, int32& OutAnalyticFieldIndex) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityFindGravityField);
+
+	FGravityFieldSample Result;
+	OutAnalyticFieldIndex = INDEX_NONE;
+
+	// Baked volumes answer in constant time where their bake resolved the capsule.
+	if (BakedVolumes.Num() > 0 && FindBakedGravityField(Location, Radius, HalfHeight, Result, OutAnalyticFieldIndex))
+	{
+		INC_DWORD_STAT(STAT_GravityBakedHits);
+		return Result;
+	}
+
+	// Box gravity fields take priority
+	if (UGravityBoxAreaVolume* GravityBox = FindGravityBox(Location, Rotation, Radius, HalfHeight))
+	{
+		Result.Component = GravityBox;
+		Result.Direction = -GravityBox->GetUpVector();
+		Result.Strength = 1.f;
+		return Result;
+	}
+
+	// Test against planet gravity fields
+	int32 BestPriority = MIN_int32;
+	GravityFieldBatch::FReal BestDistSq = UE_BIG_NUMBER;
+	FVector BestPoint = FVector::ZeroVector;
+
+	for (auto It = AnalyticFields.CreateConstIterator(); It; ++It)
+	{
+		const FGravityAnalyticFieldEntry& Entry = *It;
+		if (Entry.Shape.Settings.Priority < BestPriority || !Entry.Bounds.IsInsideOrOn(Location))
+		{
+			continue;
+		}
+
+		GravityFieldBatch::FReal DistSq;
+		FVector Point;
+		GravityFieldBatch::FindClosestPoints(Entry.Shape, &Location.X, &Location.Y, &Location.Z, 1, &DistSq, &Point.X, &Point.Y, &Point.Z);
+
+		if (DistSq <= FMath::Square(Entry.Shape.Radius) && (Entry.Shape.Settings.Priority > BestPriority || DistSq < BestDistSq))
+		{
+			UPrimitiveComponent* FieldComponent = Entry.Component.Get();
+			if (FieldComponent)
+			{
+				BestPriority = Entry.Shape.Settings.Priority;
+				BestDistSq = DistSq;
+				BestPoint = Point;
+				Result.Component = FieldComponent;
+				Result.Strength = Entry.Shape.Settings.GravityScale;
+				OutAnalyticFieldIndex = It.GetIndex();
+			}
+		}
+	}
+
+	if (Result.Component)
+	{
+		// Standing exactly on the field center has no defined direction, keep the default one.
+		const FVector ToField = BestPoint - Location;
+		Result.Direction = ToField.GetSafeNormal(UE_SMALL_NUMBER, FVector::DownVector);
+	}
+
+	return Result;
+}
+
+FGravityFieldSample UGravityFieldSubsystem::FindGravityFieldCached(FGravityFieldQueryCache& Cache, const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight) const
+{
+	bool bCacheValid = Cache.Margin >= 0.f
+		&& Cache.Radius == Radius
+		&& Cache.HalfHeight == HalfHeight
+		&& FVector::DistSquared(Cache.Location, Location) <= FMath::Square(Cache.Margin);
+
+	// Fields moving elsewhere in the world don't invalidate the cache, only the ones within reach of it.
+	if (bCacheValid && Cache.Generation != FieldsGeneration)
+	{
+		bCacheValid = !IsCacheAffectedByChanges(Cache);
+		Cache.Generation = FieldsGeneration;
+	}
+
+	if (bCacheValid)
+	{
+		++NumCacheHits;
+		CSV_CUSTOM_STAT(GravityField, CacheHits, 1, ECsvCustomStatOp::Accumulate);
+		INC_DWORD_STAT(STAT_GravityCacheHits);
+
+		// Analytic fields change direction as the querier moves, only the field lookup is cached.
+		if (Cache.AnalyticFieldIndex != INDEX_NONE)
+		{
+			GravityFieldBatch::FReal DistSq;
+			FVector Point;
+			GravityFieldBatch::FindClosestPoints(AnalyticFields[Cache.AnalyticFieldIndex].Shape, &Location.X, &Location.Y, &Location.Z, 1, &DistSq, &Point.X, &Point.Y, &Point.Z);
+			Cache.Sample.Direction = (Point - Location).GetSafeNormal(UE_SMALL_NUMBER, Cache.Sample.Direction);
+		}
+
+		return Cache.Sample;
+	}
+
+	++NumCacheMisses;
+	CSV_CUSTOM_STAT(GravityField, CacheMisses, 1, ECsvCustomStatOp::Accumulate);
+	INC_DWORD_STAT(STAT_GravityCacheMisses);
+
+	Cache.Sample = FindGravityFieldInternal(Location, Rotation, Radius, HalfHeight, Cache.AnalyticFieldIndex);
+	Cache.Location = Location;
+	Cache.Radius = Radius;
+	Cache.HalfHeight = HalfHeight;
+	Cache.Generation = FieldsGeneration;
+	Cache.Margin = ComputeCacheMargin(Cache.Sample, Cache.AnalyticFieldIndex, Location, Radius, HalfHeight);
+
+	return Cache.Sample;
+}
+
+float UGravityFieldSubsystem::ComputeCacheMargin(const FGravityFieldSample& Sample, int32 AnalyticFieldIndex, const FVector& Location, float Radius, float HalfHeight) const
+{
+	// Fields further away than the search radius can't be reached before moving that far, so it bounds the margin.
+	float Margin = GravityFieldCVars::GravityFieldCacheSearchRadius;
+	if (Margin <= 0.f)
+	{
+		return -1.f;
+	}
+
+	// Other fields are tested against the sphere bounding the capsule, so the margin holds for any capsule rotation.
+	const float BoundingRadius = FMath::Max(HalfHeight, Radius);
+	const UGravityBoxAreaVolume* ResultBox = AnalyticFieldIndex == INDEX_NONE ? Cast<UGravityBoxAreaVolume>(Sample.Component) : nullptr;
+	const FGravityBoxFieldEntry* ResultBoxEntry = nullptr;
+	if (ResultBox)
+	{
+		const int32* ResultBoxIndex = BoxEntryLookup.Find(ResultBox);
+		ResultBoxEntry = ResultBoxIndex ? &BoxEntries[*ResultBoxIndex] : nullptr;
+		if (!ResultBoxEntry)
+		{
+			return -1.f;
+		}
+
+		// The capsule keeps overlapping the box at least while its center is inside of it.
+		// A capsule only grazing the box is not worth caching, it is about to transition.
+		const FVector LocalCenter = ResultBoxEntry->Transform.InverseTransformPositionNoScale(Location);
+		const FVector Inner = ResultBoxEntry->Extent - LocalCenter.GetAbs();
+		Margin = FMath::Min(Margin, FMath::Max(Inner.GetMin(), 0.f));
+	}
+
+	auto DistanceToBox = [&Location](const FGravityBoxFieldEntry& Entry)
+	{
+		const FVector LocalCenter = Entry.Transform.InverseTransformPositionNoScale(Location);
+		return (LocalCenter.GetAbs() - Entry.Extent).ComponentMax(FVector::ZeroVector).Size();
+	};
+
+	auto TestBox = [&](int32 EntryIndex)
+	{
+		const FGravityBoxFieldEntry& Entry = BoxEntries[EntryIndex];
+
+		// Bigger boxes never take over from the current one.
+		if (&Entry == ResultBoxEntry || (ResultBoxEntry && Entry.ExtentSizeSquared >= ResultBoxEntry->ExtentSizeSquared))
+		{
+			return;
+		}
+
+		Margin = FMath::Min(Margin, FMath::Max(float(DistanceToBox(Entry)) - BoundingRadius, 0.f));
+	};
+
+	const FVector SearchExtent(Margin + BoundingRadius);
+	const FIntVector MinCell = GetCell(Location - SearchExtent);
+	const FIntVector MaxCell = GetCell(Location + SearchExtent);
+	for (int32 X = MinCell.X; X <= MaxCell.X && Margin > 0.f; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y && Margin > 0.f; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z && Margin > 0.f; ++Z)
+			{
+				if (const FGravityFieldCell* Cell = Cells.Find(FIntVector(X, Y, Z)))
+				{
+					for (const int32 EntryIndex : Cell->EntryIndices)
+					{
+						TestBox(EntryIndex);
+					}
+				}
+			}
+		}
+	}
+
+	for (const int32 EntryIndex : OversizedEntries)
+	{
+		TestBox(EntryIndex);
+	}
+
+	// Boxes take priority over every analytic field, none of them matter while inside of one.
+	if (ResultBox)
+	{
+		return Margin;
+	}
+
+	const FGravityAnalyticFieldEntry* ResultField = AnalyticFieldIndex != INDEX_NONE ? &AnalyticFields[AnalyticFieldIndex] : nullptr;
+	GravityFieldBatch::FReal ResultDist = 0.0;
+
+	auto DistanceToField = [&Location](const FGravityAnalyticFieldEntry& Entry)
+	{
+		GravityFieldBatch::FReal DistSq;
+		FVector Point;
+		GravityFieldBatch::FindClosestPoints(Entry.Shape, &Location.X, &Location.Y, &Location.Z, 1, &DistSq, &Point.X, &Point.Y, &Point.Z);
+		return FMath::Sqrt(DistSq);
+	};
+
+	if (ResultField)
+	{
+		// Leaving the radius of the field.
+		ResultDist = DistanceToField(*ResultField);
+		Margin = FMath::Min(Margin, FMath::Max(float(ResultField->Shape.Radius - ResultDist), 0.f));
+	}
+
+	for (auto It = AnalyticFields.CreateConstIterator(); It && Margin > 0.f; ++It)
+	{
+		const FGravityAnalyticFieldEntry& Entry = *It;
+		if (&Entry == ResultField || (ResultField && Entry.Shape.Settings.Priority < ResultField->Shape.Settings.Priority))
+		{
+			continue;
+		}
+
+		const GravityFieldBatch::FReal Dist = DistanceToField(Entry);
+		GravityFieldBatch::FReal SafeDistance = Dist - Entry.Shape.Radius;
+		if (ResultField && Entry.Shape.Settings.Priority == ResultField->Shape.Settings.Priority)
+		{
+			// Equal priorities switch to the closest field, both distances change at most by the distance moved.
+			SafeDistance = FMath::Max(SafeDistance, (Dist - ResultDist) * 0.5);
+		}
+
+		Margin = FMath::Min(Margin, FMath::Max(float(SafeDistance), 0.f));
+	}
+
+	return Margin;
+}
+
+void UGravityFieldSubsystem::GetCacheStats(int64& OutHits, int64& OutMisses) const
+{
+	OutHits = NumCacheHits;
+	OutMisses = NumCacheMisses;
+}
+
+TSharedRef<const FGravityFieldSnapshot> UGravityFieldSubsystem::GetSnapshot() const
+{
+	if (Snapshot && Snapshot->Generation == FieldsGeneration)
+	{
+		return Snapshot.ToSharedRef();
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GravityBuildSnapshot);
+
+	TSharedRef<FGravityFieldSnapshot> NewSnapshot = MakeShared<FGravityFieldSnapshot>();
+	NewSnapshot->Generation = FieldsGeneration;
+
+	NewSnapshot->Boxes.Reserve(BoxEntries.Num());
+	for (const FGravityBoxFieldEntry& Entry : BoxEntries)
+	{
+		const UGravityBoxAreaVolume* Volume = Entry.Volume.Get();
+		if (!Volume)
+		{
+			continue;
+		}
+
+		FGravityFieldSnapshot::FBoxField& Box = NewSnapshot->Boxes.AddDefaulted_GetRef();
+		Box.Entry.Transform = Entry.Transform;
+		Box.Entry.Extent = Entry.Extent;
+		Box.Entry.Bounds = Entry.Bounds;
+		Box.Entry.ExtentSizeSquared = Entry.ExtentSizeSquared;
+		Box.Direction = -Volume->GetUpVector();
+		Box.FieldId = Volume->GetUniqueID();
+	}
+
+	NewSnapshot->Boxes.Sort([](const FGravityFieldSnapshot::FBoxField& A, const FGravityFieldSnapshot::FBoxField& B)
+	{
+		return A.Entry.ExtentSizeSquared < B.Entry.ExtentSizeSquared;
+	});
+
+	NewSnapshot->AnalyticFields.Reserve(AnalyticFields.Num());
+	for (const FGravityAnalyticFieldEntry& Entry : AnalyticFields)
+	{
+		if (const UPrimitiveComponent* FieldComponent = Entry.Component.Get())
+		{
+			FGravityFieldSnapshot::FAnalyticField& Field = NewSnapshot->AnalyticFields.AddDefaulted_GetRef();
+			Field.Shape = Entry.Shape;
+			Field.Bounds = Entry.Bounds;
+			Field.FieldId = FieldComponent->GetUniqueID();
+		}
+	}
+
+	// Baked volumes link to the fields of the snapshot instead of the live ones.
+	if (BakedVolumes.Num() > 0)
+	{
+		TMap<uint32, int32> SnapshotBoxIndices;
+		for (int32 Index = 0; Index < NewSnapshot->Boxes.Num(); ++Index)
+		{
+			SnapshotBoxIndices.Add(NewSnapshot->Boxes[Index].FieldId, Index);
+		}
+
+		TMap<uint32, int32> SnapshotAnalyticFieldIndices;
+		for (int32 Index = 0; Index < NewSnapshot->AnalyticFields.Num(); ++Index)
+		{
+			SnapshotAnalyticFieldIndices.Add(NewSnapshot->AnalyticFields[Index].FieldId, Index);
+		}
+
+		for (const FGravityBakedVolumeEntry& Entry : BakedVolumes)
+		{
+			if (!Entry.bEnabled)
+			{
+				continue;
+			}
+
+			FGravityFieldSnapshot::FBakedVolume& BakedVolume = NewSnapshot->BakedVolumes.AddDefaulted_GetRef();
+			BakedVolume.Grid = Entry.Grid;
+			BakedVolume.Links.SetNum(Entry.Links.Num());
+
+			for (int32 FieldIndex = 0; FieldIndex < Entry.Links.Num(); ++FieldIndex)
+			{
+				const FGravityBakedFieldLink& Link = Entry.Links[FieldIndex];
+				if (Link.BoxIndex != INDEX_NONE)
+				{
+					const UGravityBoxAreaVolume* Volume = BoxEntries[Link.BoxIndex].Volume.Get();
+					const int32* SnapshotIndex = Volume ? SnapshotBoxIndices.Find(Volume->GetUniqueID()) : nullptr;
+					BakedVolume.Links[FieldIndex].BoxIndex = SnapshotIndex ? *SnapshotIndex : INDEX_NONE;
+				}
+				else if (Link.AnalyticFieldIndex != INDEX_NONE)
+				{
+					const UPrimitiveComponent* FieldComponent = AnalyticFields[Link.AnalyticFieldIndex].Component.Get();
+					const int32* SnapshotIndex = FieldComponent ? SnapshotAnalyticFieldIndices.Find(FieldComponent->GetUniqueID()) : nullptr;
+					BakedVolume.Links[FieldIndex].AnalyticFieldIndex = SnapshotIndex ? *SnapshotIndex : INDEX_NONE;
+				}
+			}
+		}
+	}
+
+	Snapshot = NewSnapshot;
+	return NewSnapshot;
+}
+
+FGravityFieldSnapshotSample FGravityFieldSnapshot::FindGravityField(const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravitySnapshotFindGravityField);
+
+	FGravityFieldSnapshotSample Result;
+
+	// Same as UGravityFieldSubsystem::FindBakedGravityField().
+	const float BoundingRadius = FMath::Max(Radius, HalfHeight);
+	for (const FBakedVolume& BakedVolume : BakedVolumes)
+	{
+		if (BoundingRadius > BakedVolume.Grid->CapsuleMargin)
+		{
+			continue;
+		}
+
+		const uint16 Value = BakedVolume.Grid->FindField(Location);
+		if (Value == FGravityFieldBakedGrid::NoField)
+		{
+			return Result;
+		}
+
+		const FGravityBakedFieldLink* Link = Value != FGravityFieldBakedGrid::UnresolvedField ? &BakedVolume.Links[Value - 1] : nullptr;
+		if (Link && Link->BoxIndex != INDEX_NONE)
+		{
+			const FBoxField& Box = Boxes[Link->BoxIndex];
+			Result.Direction = Box.Direction;
+			Result.Strength = 1.f;
+			Result.FieldId = Box.FieldId;
+			return Result;
+		}
+
+		if (Link && Link->AnalyticFieldIndex != INDEX_NONE)
+		{
+			const FAnalyticField& Field = AnalyticFields[Link->AnalyticFieldIndex];
+			GravityFieldBatch::FReal DistSq;
+			FVector Point;
+			GravityFieldBatch::FindClosestPoints(Field.Shape, &Location.X, &Location.Y, &Location.Z, 1, &DistSq, &Point.X, &Point.Y, &Point.Z);
+
+			Result.Direction = (Point - Location).GetSafeNormal(UE_SMALL_NUMBER, FVector::DownVector);
+			Result.Strength = Field.Shape.Settings.GravityScale;
+			Result.FieldId = Field.FieldId;
+			return Result;
+		}
+	}
+
+	// Box gravity fields take priority. Snapshots have no grid, the bounds test culls most of them.
+	if (Boxes.Num() > 0)
+	{
+		const FVector CapsuleAxis = Rotation.GetUpVector();
+		const float HalfHeightNoCaps = FMath::Max(HalfHeight - Radius, 0.f);
+		const FVector CapsuleExtent = CapsuleAxis.GetAbs() * HalfHeightNoCaps + FVector(Radius);
+		const FBox CapsuleBounds(Location - CapsuleExtent, Location + CapsuleExtent);
+
+		for (const FBoxField& Box : Boxes)
+		{
+			if (Box.Entry.Bounds.Intersect(CapsuleBounds) && Box.Entry.OverlapsCapsule(Location, CapsuleAxis, Radius, HalfHeightNoCaps))
+			{
+				Result.Direction = Box.Direction;
+				Result.Strength = 1.f;
+				Result.FieldId = Box.FieldId;
+				return Result;
+			}
+		}
+	}
+
+	// Same selection as UGravityFieldSubsystem::FindGravityFieldInternal(): highest priority, then closest.
+	int32 BestPriority = MIN_int32;
+	GravityFieldBatch::FReal BestDistSq = UE_BIG_NUMBER;
+	FVector BestPoint = FVector::ZeroVector;
+
+	for (const FAnalyticField& Field : AnalyticFields)
+	{
+		if (Field.Shape.Settings.Priority < BestPriority || !Field.Bounds.IsInsideOrOn(Location))
+		{
+			continue;
+		}
+
+		GravityFieldBatch::FReal DistSq;
+		FVector Point;
+		GravityFieldBatch::FindClosestPoints(Field.Shape, &Location.X, &Location.Y, &Location.Z, 1, &DistSq, &Point.X, &Point.Y, &Point.Z);
+
+		if (DistSq <= FMath::Square(Field.Shape.Radius) && (Field.Shape.Settings.Priority > BestPriority || DistSq < BestDistSq))
+		{
+			BestPriority = Field.Shape.Settings.Priority;
+			BestDistSq = DistSq;
+			BestPoint = Point;
+			Result.Strength = Field.Shape.Settings.GravityScale;
+			Result.FieldId = Field.FieldId;
+		}
+	}
+
+	if (Result.IsValid())
+	{
+		Result.Direction = (BestPoint - Location).GetSafeNormal(UE_SMALL_NUMBER, FVector::DownVector);
+	}
+
+	return Result;
+}
+
+void UGravityFieldSubsystem::EvaluateGravityBatch(const FGravityFieldBatch& Batch) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityEvaluateGravityBatch);
+
+	const int32 Num = Batch.Num();
+	check(Batch.LocationsY.Num() >= Num && Batch.LocationsZ.Num() >= Num);
+	check(Batch.DirectionsX.Num() >= Num && Batch.DirectionsY.Num() >= Num && Batch.DirectionsZ.Num() >= Num && Batch.Strengths.Num() >= Num);
+
+	for (int32 ChunkStart = 0; ChunkStart < Num; ChunkStart += GravityFieldBatch::ChunkSize)
+	{
+		EvaluateGravityChunk(Batch, ChunkStart, FMath::Min(GravityFieldBatch::ChunkSize, Num - ChunkStart));
+	}
+}
+
+void UGravityFieldSubsystem::EvaluateGravityChunk(const FGravityFieldBatch& Batch, int32 ChunkStart, int32 ChunkNum) const
+{
+	using namespace GravityFieldBatch;
+
+	const FReal* RESTRICT X = Batch.LocationsX.GetData() + ChunkStart;
+	const FReal* RESTRICT Y = Batch.LocationsY.GetData() + ChunkStart;
+	const FReal* RESTRICT Z = Batch.LocationsZ.GetData() + ChunkStart;
+	float* RESTRICT OutX = Batch.DirectionsX.GetData() + ChunkStart;
+	float* RESTRICT OutY = Batch.DirectionsY.GetData() + ChunkStart;
+	float* RESTRICT OutZ = Batch.DirectionsZ.GetData() + ChunkStart;
+	float* RESTRICT OutStrength = Batch.Strengths.GetData() + ChunkStart;
+
+	int32 BestBox[ChunkSize];
+	int32 BestPriority[ChunkSize];
+	FReal BestDistSq[ChunkSize];
+	FReal BestX[ChunkSize];
+	FReal BestY[ChunkSize];
+	FReal BestZ[ChunkSize];
+	float BestStrength[ChunkSize];
+
+	FReal MinX = UE_BIG_NUMBER, MinY = UE_BIG_NUMBER, MinZ = UE_BIG_NUMBER;
+	FReal MaxX = -UE_BIG_NUMBER, MaxY = -UE_BIG_NUMBER, MaxZ = -UE_BIG_NUMBER;
+
+	for (int32 Index = 0; Index < ChunkNum; ++Index)
+	{
+		BestBox[Index] = INDEX_NONE;
+		BestPriority[Index] = MIN_int32;
+		BestDistSq[Index] = UE_BIG_NUMBER;
+		BestX[Index] = X[Index];
+		BestY[Index] = Y[Index];
+		BestZ[Index] = Z[Index];
+		BestStrength[Index] = 0.f;
+		OutX[Index] = 0.f;
+		OutY[Index] = 0.f;
+		OutZ[Index] = 0.f;
+
+		MinX = FMath::Min(MinX, X[Index]);
+		MinY = FMath::Min(MinY, Y[Index]);
+		MinZ = FMath::Min(MinZ, Z[Index]);
+		MaxX = FMath::Max(MaxX, X[Index]);
+		MaxY = FMath::Max(MaxY, Y[Index]);
+		MaxZ = FMath::Max(MaxZ, Z[Index]);
+	}
+
+	// Fields are culled against the bounds of the whole chunk, then tested against every location of it.
+	const FBox ChunkBounds(FVector(MinX, MinY, MinZ), FVector(MaxX, MaxY, MaxZ));
+
+	// Box gravity fields take priority. They are written straight to the output and lock the location for the analytic fields.
+	// Candidates are sorted smallest first, so the first box containing a location is the one with the highest priority.
+	TArray<int32, TInlineAllocator<16>> BoxIndices;
+	GatherBoxEntries(ChunkBounds, BoxIndices);
+
+	for (const int32 EntryIndex : BoxIndices)
+	{
+		const FGravityBoxFieldEntry& Entry = BoxEntries[EntryIndex];
+		const FVector Origin = Entry.Transform.GetTranslation();
+		const FVector AxisX = Entry.Transform.GetUnitAxis(EAxis::X);
+		const FVector AxisY = Entry.Transform.GetUnitAxis(EAxis::Y);
+		const FVector AxisZ = Entry.Transform.GetUnitAxis(EAxis::Z);
+		const float DirX = float(-AxisZ.X);
+		const float DirY = float(-AxisZ.Y);
+		const float DirZ = float(-AxisZ.Z);
+
+		for (int32 Index = 0; Index < ChunkNum; ++Index)
+		{
+			const FReal DeltaX = X[Index] - Origin.X;
+			const FReal DeltaY = Y[Index] - Origin.Y;
+			const FReal DeltaZ = Z[Index] - Origin.Z;
+			const FReal LocalX = DeltaX * AxisX.X + DeltaY * AxisX.Y + DeltaZ * AxisX.Z;
+			const FReal LocalY = DeltaX * AxisY.X + DeltaY * AxisY.Y + DeltaZ * AxisY.Z;
+			const FReal LocalZ = DeltaX * AxisZ.X + DeltaY * AxisZ.Y + DeltaZ * AxisZ.Z;
+
+			const bool bInside = FMath::Abs(LocalX) <= Entry.Extent.X && FMath::Abs(LocalY) <= Entry.Extent.Y && FMath::Abs(LocalZ) <= Entry.Extent.Z;
+			const bool bTake = bInside && BestBox[Index] == INDEX_NONE;
+
+			OutX[Index] = bTake ? DirX : OutX[Index];
+			OutY[Index] = bTake ? DirY : OutY[Index];
+			OutZ[Index] = bTake ? DirZ : OutZ[Index];
+			BestStrength[Index] = bTake ? 1.f : BestStrength[Index];
+			BestBox[Index] = bTake ? EntryIndex : BestBox[Index];
+		}
+	}
+
+	// Merge every analytic field, keeping the highest priority then closest one per location.
+	FReal FieldDistSq[ChunkSize];
+	FReal FieldX[ChunkSize];
+	FReal FieldY[ChunkSize];
+	FReal FieldZ[ChunkSize];
+
+	for (const FGravityAnalyticFieldEntry& Entry : AnalyticFields)
+	{
+		if (!Entry.Bounds.Intersect(ChunkBounds))
+		{
+			continue;
+		}
+
+		FindClosestPoints(Entry.Shape, X, Y, Z, ChunkNum, FieldDistSq, FieldX, FieldY, FieldZ);
+
+		const FReal RadiusSq = FMath::Square(FReal(Entry.Shape.Radius));
+		const int32 Priority = Entry.Shape.Settings.Priority;
+		const float Strength = Entry.Shape.Settings.GravityScale;
+
+		for (int32 Index = 0; Index < ChunkNum; ++Index)
+		{
+			const bool bInside = FieldDistSq[Index] <= RadiusSq;
+			const bool bBetter = Priority > BestPriority[Index] || (Priority == BestPriority[Index] && FieldDistSq[Index] < BestDistSq[Index]);
+			const bool bTake = bInside && bBetter && BestBox[Index] == INDEX_NONE;
+
+			BestPriority[Index] = bTake ? Priority : BestPriority[Index];
+			BestDistSq[Index] = bTake ? FieldDistSq[Index] : BestDistSq[Index];
+			BestX[Index] = bTake ? FieldX[Index] : BestX[Index];
+			BestY[Index] = bTake ? FieldY[Index] : BestY[Index];
+			BestZ[Index] = bTake ? FieldZ[Index] : BestZ[Index];
+			BestStrength[Index] = bTake ? Strength : BestStrength[Index];
+		}
+	}
+
+	// Resolve analytic directions. Unresolved locations have their best point on themselves and keep a zero direction and strength.
+	// Locations exactly on the closest point of their field fall back to world down, like the single queries.
+	for (int32 Index = 0; Index < ChunkNum; ++Index)
+	{
+		const FReal DirX = BestX[Index] - X[Index];
+		const FReal DirY = BestY[Index] - Y[Index];
+		const FReal DirZ = BestZ[Index] - Z[Index];
+		const FReal LengthSq = DirX * DirX + DirY * DirY + DirZ * DirZ;
+		const bool bDegenerate = LengthSq <= UE_SMALL_NUMBER;
+		const FReal InvLength = bDegenerate ? 0.0 : FMath::InvSqrt(LengthSq);
+
+		const bool bIsBox = BestBox[Index] != INDEX_NONE;
+		const bool bIsAnalytic = !bIsBox && BestDistSq[Index] < UE_BIG_NUMBER;
+		const bool bFallback = bIsAnalytic && bDegenerate;
+		OutX[Index] = bIsBox ? OutX[Index] : float(DirX * InvLength);
+		OutY[Index] = bIsBox ? OutY[Index] : float(DirY * InvLength);
+		OutZ[Index] = bIsBox ? OutZ[Index] : (bFallback ? -1.f : float(DirZ * InvLength));
+		OutStrength[Index] = BestStrength[Index];
+	}
+}
@@ -0,0 +1,340 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SparseArray.h"
+#include "Subsystems/WorldSubsystem.h"
+#include <atomic>
+#include "GravityFieldTypes.h"
+#include "GravityFieldSubsystem.generated.h"
+
+class UGravityBoxAreaVolume;
+class UGravityFieldBakedVolume;
+class UPrimitiveComponent;
+struct FGravityFieldBakedGrid;
+
+/** World space snapshot of a registered gravity box, as stored by the spatial index. */
+struct FGravityBoxFieldEntry
+{
+	TWeakObjectPtr<UGravityBoxAreaVolume> Volume;
+
+	/** Unscaled component transform of the box. */
+	FTransform Transform;
+
+	/** Scaled half extent of the box. */
+	FVector Extent;
+
+	/** World space bounds of the oriented box. */
+	FBox Bounds;
+
+	/** Priority key, smaller boxes take priority over bigger ones. */
+	double ExtentSizeSquared = 0.0;
+
+	/** Inclusive range of grid cells the entry was inserted into. Unused if bOversized. */
+	FIntVector MinCell = FIntVector::ZeroValue;
+	FIntVector MaxCell = FIntVector::ZeroValue;
+
+	/** True if the entry covers too many cells and lives in the oversized list instead of the grid. */
+	bool bOversized = false;
+
+	/** Returns true if a capsule (given in world space) overlaps this oriented box. */
+	bool OverlapsCapsule(const FVector& Location, const FVector& CapsuleAxis, float Radius, float HalfHeightNoCaps) const;
+};
+
+/** Registered analytic gravity field (planet, capsule, spline), as stored by the subsystem. */
+struct FGravityAnalyticFieldEntry
+{
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	FGravityFieldShape Shape;
+
+	/** World space bounds of the field, including its radius. */
+	FBox Bounds;
+};
+
+/** Live field a field of a baked grid was matched with. Indices are into the fields of the subsystem or snapshot holding the link. */
+struct FGravityBakedFieldLink
+{
+	int32 BoxIndex = INDEX_NONE;
+	int32 AnalyticFieldIndex = INDEX_NONE;
+
+	bool IsLinked() const { return BoxIndex != INDEX_NONE || AnalyticFieldIndex != INDEX_NONE; }
+};
+
+/** Registered baked gravity volume, with the fields of its grid matched against the live ones. */
+struct FGravityBakedVolumeEntry
+{
+	TWeakObjectPtr<UGravityFieldBakedVolume> Volume;
+
+	TSharedPtr<const FGravityFieldBakedGrid, ESPMode::ThreadSafe> Grid;
+
+	/** One link per field of Grid. Voxels of an unlinked field, for instance not streamed in, fall back to the live fields. */
+	TArray<FGravityBakedFieldLink> Links;
+
+	/** False while a live field the bake does not know about, or that moved since, touches the grid. */
+	bool bEnabled = false;
+};
+
+/** World space region a field change may have affected, see UGravityFieldSubsystem::FindGravityFieldCached(). */
+struct FGravityFieldChange
+{
+	/** Bounds of the field before and after the change. Invalid when it was registered or unregistered. */
+	FBox OldBounds = FBox(ForceInit);
+	FBox NewBounds = FBox(ForceInit);
+
+	bool Intersect(const FBox& Bounds) const { return OldBounds.Intersect(Bounds) || NewBounds.Intersect(Bounds); }
+};
+
+/** Result of a query against a FGravityFieldSnapshot. */
+struct FGravityFieldSnapshotSample
+{
+	/** Normalized gravity direction inside the field. */
+	FVector Direction = FVector::DownVector;
+
+	/** Gravity strength as a multiplier of the world gravity. */
+	float Strength = 0.f;
+
+	/** Unique ID of the component defining the field, 0 if no field was found. */
+	uint32 FieldId = 0;
+
+	bool IsValid() const { return FieldId != 0; }
+};
+
+/**
+ * Immutable copy of every gravity field of a world, holding no object references so it can be read from any thread,
+ * for instance by the parallel agent update of UGravityCrowdSubsystem. Built by UGravityFieldSubsystem::GetSnapshot() and shared until a field changes.
+ */
+struct CUSTOMGRAVITYTEST_API FGravityFieldSnapshot
+{
+	struct FBoxField
+	{
+		/** Copy of the subsystem entry, without its volume or grid cells. */
+		FGravityBoxFieldEntry Entry;
+
+		FVector Direction = FVector::DownVector;
+		uint32 FieldId = 0;
+	};
+
+	struct FAnalyticField
+	{
+		FGravityFieldShape Shape;
+		FBox Bounds;
+		uint32 FieldId = 0;
+	};
+
+	struct FBakedVolume
+	{
+		TSharedPtr<const FGravityFieldBakedGrid, ESPMode::ThreadSafe> Grid;
+
+		/** Links into Boxes and AnalyticFields. */
+		TArray<FGravityBakedFieldLink> Links;
+	};
+
+	/** Gravity boxes, smallest first so the first one overlapping a capsule is the one with highest priority. */
+	TArray<FBoxField> Boxes;
+
+	TArray<FAnalyticField> AnalyticFields;
+
+	/** Enabled baked volumes, looked up before the live fields. */
+	TArray<FBakedVolume> BakedVolumes;
+
+	/** Field generation of the subsystem the snapshot was built from. */
+	uint32 Generation = 0;
+
+	/** Same as UGravityFieldSubsystem::FindGravityField(), against the fields as they were when the snapshot was built. */
+	FGravityFieldSnapshotSample FindGravityField(const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight) const;
+};
+
+/**
+ * Keeps track of every gravity field in a world and answers "which gravity field contains this point/capsule"
+ * without running physics scene queries.
+ *
+ * Gravity boxes register themselves in BeginPlay and unregister in EndPlay. They are indexed in a sparse, uniform grid
+ * of world space cells so a query only tests the handful of boxes registered in the cells it touches. Queries do not allocate.
+ *
+ * Analytic fields (spheres, capsules, splines) describe their gravity with a closed-form shape and are only used where no
+ * gravity box applies. They can be evaluated for many locations at once with EvaluateGravityBatch().
+ *
+ * Baked gravity volumes hold the result of the live fields precomputed over a voxel grid. Queries inside of one are answered
+ * with a single voxel read while the fields it was baked from are all still in place, see BakeGravityFields().
+ */
+UCLASS()
+class CUSTOMGRAVITYTEST_API UGravityFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	/** Adds a gravity box to the index. Called by the volume in BeginPlay. */
+	void RegisterGravityBox(UGravityBoxAreaVolume* Volume);
+
+	/** Removes a gravity box from the index. Called by the volume in EndPlay. */
+	void UnregisterGravityBox(UGravityBoxAreaVolume* Volume);
+
+	/** Refreshes the cached transform and bounds of a registered gravity box, for instance after it moved. */
+	void UpdateGravityBox(UGravityBoxAreaVolume* Volume);
+
+	/**
+	 * Finds the gravity box with highest priority (smallest extent) overlapping the given capsule.
+	 * @param Location		World space capsule center.
+	 * @param Rotation		World space capsule rotation.
+	 * @param Radius		Scaled capsule radius.
+	 * @param HalfHeight	Scaled capsule half height, including the hemispheres.
+	 * @return The best gravity box, or nullptr if the capsule is not inside any.
+	 */
+	UGravityBoxAreaVolume* FindGravityBox(const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight) const;
+
+	/** Finds the gravity box with highest priority (smallest extent) containing the given point. */
+	UGravityBoxAreaVolume* FindGravityBoxAtPoint(const FVector& Location) const;
+
+	/** Adds the baked data of a volume to the lookup. Called by the volume in BeginPlay. Does nothing if the volume has no baked grid. */
+	void RegisterBakedVolume(UGravityFieldBakedVolume* Volume);
+
+	/** Removes a baked volume from the lookup. Called by the volume in EndPlay. */
+	void UnregisterBakedVolume(UGravityFieldBakedVolume* Volume);
+
+	/**
+	 * Resolves the registered live gravity fields over a voxel grid covering Bounds, ignoring baked volumes.
+	 * A voxel is resolved when the same field is found for every capsule centered inside of it with a bounding radius up to
+	 * CapsuleMargin, and left to the live fields otherwise. Slow, meant to be run once when authoring a level.
+	 */
+	TSharedRef<FGravityFieldBakedGrid, ESPMode::ThreadSafe> BakeGravityFields(const FBox& Bounds, float VoxelSize, float CapsuleMargin) const;
+
+	/** Adds or replaces an analytic gravity field. Called by the field component in BeginPlay. */
+	void RegisterGravityField(UPrimitiveComponent* Component, FGravityFieldShape&& Shape);
+
+	/** Removes an analytic gravity field. Called by the field component in EndPlay. */
+	void UnregisterGravityField(UPrimitiveComponent* Component);
+
+	/** Refreshes the shape of a registered analytic gravity field, for instance after it moved. */
+	void UpdateGravityField(UPrimitiveComponent* Component, FGravityFieldShape&& Shape);
+
+	/**
+	 * Finds the gravity field affecting the given capsule. Gravity boxes overlapping the capsule take priority,
+	 * then analytic fields containing the capsule center.
+	 */
+	FGravityFieldSample FindGravityField(const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight) const;
+
+	/**
+	 * Same as FindGravityField(), but reuses the result stored in Cache when the capsule only moved within the cached margin
+	 * and no gravity field changed within reach of it since. Updates Cache on a full resolve.
+	 */
+	FGravityFieldSample FindGravityFieldCached(FGravityFieldQueryCache& Cache, const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight) const;
+
+	/** Returns the number of FindGravityFieldCached() calls that reused or missed their cache since the subsystem was created. */
+	void GetCacheStats(int64& OutHits, int64& OutMisses) const;
+
+	/** Incremented whenever a gravity field is registered, unregistered or moved. */
+	uint32 GetFieldsGeneration() const { return FieldsGeneration; }
+
+	/**
+	 * Evaluates gravity for many locations at once, over fixed size chunks of the input. Fields are culled against the bounds
+	 * of each chunk, then the remaining gravity boxes and analytic fields are tested against every location of the chunk with
+	 * branch free loops so they can be vectorized. Boxes take priority, as in FindGravityField(). Strengths are the GravityScale
+	 * of analytic fields and 1 for boxes. Does not allocate unless a chunk overlaps more than 16 boxes.
+	 */
+	void EvaluateGravityBatch(const FGravityFieldBatch& Batch) const;
+
+	/**
+	 * Returns a thread safe copy of the registered gravity fields. The copy is rebuilt on the first call after a field changed,
+	 * and shared by every caller until then.
+	 */
+	TSharedRef<const FGravityFieldSnapshot> GetSnapshot() const;
+
+	/** Number of gravity boxes currently registered. */
+	int32 GetNumGravityBoxes() const { return BoxEntries.Num(); }
+
+	/** Number of baked volumes currently registered, including the disabled ones. */
+	int32 GetNumBakedVolumes() const { return BakedVolumes.Num(); }
+
+	/** Helper to get the subsystem of the world an object lives in. May return null. */
+	static UGravityFieldSubsystem* Get(const UObject* WorldContextObject);
+
+private:
+	void AddEntryToGrid(int32 EntryIndex);
+	void RemoveEntryFromGrid(int32 EntryIndex);
+	void RefreshEntry(FGravityBoxFieldEntry& Entry, const UGravityBoxAreaVolume& Volume) const;
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** Tests every box in the cell range against the capsule, keeping the best result in OutBestIndex. */
+	void FindBestBoxInCells(const FIntVector& MinCell, const FIntVector& MaxCell, const FVector& Location, const FVector& CapsuleAxis, float Radius, float HalfHeightNoCaps, int32& OutBestIndex) const;
+	void TestBoxEntry(int32 EntryIndex, const FVector& Location, const FVector& CapsuleAxis, float Radius, float HalfHeightNoCaps, int32& InOutBestIndex) const;
+
+	/** Finds every box whose bounds intersect Bounds, smallest first. */
+	void GatherBoxEntries(const FBox& Bounds, TArray<int32, TInlineAllocator<16>>& OutEntryIndices) const;
+
+	/**
+	 * Bumps the field generation and records the region of the change, so only the query caches in reach of it miss.
+	 * Baked volumes touching the region are matched against the live fields again.
+	 */
+	void OnFieldsChanged(const FBox& OldBounds, const FBox& NewBounds);
+
+	/** Returns true if a field changed within reach of the cached capsule since Cache was filled. */
+	bool IsCacheAffectedByChanges(const FGravityFieldQueryCache& Cache) const;
+	void RefreshBakedVolume(FGravityBakedVolumeEntry& Entry) const;
+
+	/** Looks the capsule up in the enabled baked volumes. Returns false if none of them resolved it. */
+	bool FindBakedGravityField(const FVector& Location, float Radius, float HalfHeight, FGravityFieldSample& OutSample, int32& OutAnalyticFieldIndex) const;
+
+	/** Bake of a single voxel, returns its voxel value. The maps give the voxel value of every live box and analytic field touching the grid. */
+	uint16 BakeVoxel(const FBox& VoxelBox, float CapsuleMargin, const TMap<int32, uint16>& BoxFieldValues, const TMap<int32, uint16>& AnalyticFieldValues) const;
+
+	/** Same as FindGravityField(), also returning the index of the analytic field found, if any. */
+	FGravityFieldSample FindGravityFieldInternal(const FVector& Location, const FQuat& Rotation, float Radius, float HalfHeight, int32& OutAnalyticFieldIndex) const;
+
+	/** Computes how far a capsule can move from Location before the result of a query may change. */
+	float ComputeCacheMargin(const FGravityFieldSample& Sample, int32 AnalyticFieldIndex, const FVector& Location, float Radius, float HalfHeight) const;
+
+	/** Analytic field evaluation for a single chunk of EvaluateGravityBatch(). */
+	void EvaluateGravityChunk(const FGravityFieldBatch& Batch, int32 ChunkStart, int32 ChunkNum) const;
+
+	/** Indices of the entries registered in a single grid cell. */
+	struct FGravityFieldCell
+	{
+		TArray<int32, TInlineAllocator<4>> EntryIndices;
+	};
+
+	/** Registered boxes, indices are stable for the lifetime of the registration. */
+	TSparseArray<FGravityBoxFieldEntry> BoxEntries;
+
+	/** Lookup from volume to its index in BoxEntries. */
+	TMap<TObjectKey<UGravityBoxAreaVolume>, int32> BoxEntryLookup;
+
+	/** Sparse grid of world cells. */
+	TMap<FIntVector, FGravityFieldCell> Cells;
+
+	/** Registered analytic fields. */
+	TSparseArray<FGravityAnalyticFieldEntry> AnalyticFields;
+
+	/** Lookup from component to its index in AnalyticFields. */
+	TMap<TObjectKey<UPrimitiveComponent>, int32> AnalyticFieldLookup;
+
+	/** Registered baked volumes. */
+	TArray<FGravityBakedVolumeEntry> BakedVolumes;
+
+	/** Entries too big to be worth inserting in the grid, always tested. */
+	TArray<int32> OversizedEntries;
+
+	/** Size of a grid cell, sampled from cg.GravityFieldGridCellSize when the subsystem is created. */
+	float CellSize = 2000.f;
+
+	/** @see GetFieldsGeneration() */
+	uint32 FieldsGeneration = 1;
+
+	/** Regions of the last field changes, the change of generation G is stored at G % MaxRecentChanges. */
+	static constexpr uint32 MaxRecentChanges = 32;
+	FGravityFieldChange RecentChanges[MaxRecentChanges];
+
+	/** @see GetSnapshot() */
+	mutable TSharedPtr<const FGravityFieldSnapshot> Snapshot;
+
+	/** @see GetCacheStats() */
+	mutable std::atomic<int64> NumCacheHits = 0;
+	mutable std::atomic<int64> NumCacheMisses = 0;
+};
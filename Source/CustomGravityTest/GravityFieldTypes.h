@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GravityFieldTypes.generated.h"
+
+class UPrimitiveComponent;
+
+/** Settings shared by every analytic gravity field. */
+USTRUCT(BlueprintType)
+struct FGravityFieldSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** When fields overlap, the one with the highest priority is used. Equal priorities use the closest field. Gravity boxes always take priority over analytic fields. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity")
+	int32 Priority = 0;
+
+	/** Strength of the gravity inside the field, as a multiplier of the world gravity. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity", meta = (ClampMin = "0", UIMin = "0"))
+	float GravityScale = 1.f;
+};
+
+/**
+ * Closed-form description of an analytic gravity field, in world space.
+ * Gravity pulls towards the closest point of the polyline defined by Points, inside Radius of it.
+ * A single point describes a spherical planet, two points a capsule/cylinder, more points a spline.
+ */
+struct FGravityFieldShape
+{
+	TArray<FVector, TInlineAllocator<2>> Points;
+	float Radius = 0.f;
+	FGravityFieldSettings Settings;
+};
+
+/** Result of a single gravity field query. */
+struct FGravityFieldSample
+{
+	/** Component defining the field, null if no field was found. */
+	UPrimitiveComponent* Component = nullptr;
+
+	/** Normalized gravity direction inside the field. */
+	FVector Direction = FVector::DownVector;
+
+	/** Gravity strength as a multiplier of the world gravity. */
+	float Strength = 0.f;
+
+	bool IsValid() const { return Component != nullptr; }
+};
+
+/**
+ * Input and output arrays of a batch gravity evaluation, in structure of arrays form.
+ * All arrays must hold at least LocationsX.Num() elements. Locations outside every field get a zero direction and strength, locations inside of one always get a normalized direction.
+ */
+struct FGravityFieldBatch
+{
+	TConstArrayView<FVector::FReal> LocationsX;
+	TConstArrayView<FVector::FReal> LocationsY;
+	TConstArrayView<FVector::FReal> LocationsZ;
+
+	TArrayView<float> DirectionsX;
+	TArrayView<float> DirectionsY;
+	TArrayView<float> DirectionsZ;
+	TArrayView<float> Strengths;
+
+	int32 Num() const { return LocationsX.Num(); }
+};
+
+/**
+ * Per querier cache of the last resolved gravity field, see UGravityFieldSubsystem::FindGravityFieldCached().
+ * The previous result is reused while the querier stays within Margin of the location it was resolved at,
+ * keeps the same shape, and no gravity field was registered, unregistered or moved within reach of it since.
+ */
+struct FGravityFieldQueryCache
+{
+	FGravityFieldSample Sample;
+
+	FVector Location = FVector::ZeroVector;
+	float Radius = 0.f;
+	float HalfHeight = 0.f;
+
+	/** Distance the querier can move before a full resolve is needed. Negative if the cache is invalid. */
+	float Margin = -1.f;
+
+	/** Index of the analytic field in Sample, so its direction can be updated without searching. */
+	int32 AnalyticFieldIndex = INDEX_NONE;
+
+	/** Field generation of the subsystem when the cache was filled. */
+	uint32 Generation = 0;
+
+	void Invalidate() { Margin = -1.f; }
+};
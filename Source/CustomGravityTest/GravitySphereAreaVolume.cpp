@@ -0,0 +1,54 @@
+#include "GravitySphereAreaVolume.h"
+#include "Engine/CollisionProfile.h"
+#include "GravityFieldSubsystem.h"
+
+UGravitySphereAreaVolume::UGravitySphereAreaVolume()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Gravity is evaluated analytically, no physics queries involved.
+	SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	SetGenerateOverlapEvents(false);
+}
+
+FGravityFieldShape UGravitySphereAreaVolume::BuildGravityFieldShape() const
+{
+	FGravityFieldShape Shape;
+	Shape.Points.Add(GetComponentLocation());
+	Shape.Radius = GetScaledSphereRadius();
+	Shape.Settings = GravitySettings;
+	return Shape;
+}
+
+void UGravitySphereAreaVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->RegisterGravityField(this, BuildGravityFieldShape());
+	}
+}
+
+void UGravitySphereAreaVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->UnregisterGravityField(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGravitySphereAreaVolume::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	if (HasBegunPlay())
+	{
+		if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+		{
+			GravityFields->UpdateGravityField(this, BuildGravityFieldShape());
+		}
+	}
+}
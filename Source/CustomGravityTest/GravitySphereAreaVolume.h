@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SphereComponent.h"
+#include "GravityFieldTypes.h"
+#include "GravitySphereAreaVolume.generated.h"
+
+/** Spherical planet gravity field. Inside the sphere, gravity pulls towards its center. */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class CUSTOMGRAVITYTEST_API UGravitySphereAreaVolume : public USphereComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGravitySphereAreaVolume();
+
+	/** Builds the closed-form shape of this field from the current component transform. */
+	FGravityFieldShape BuildGravityFieldShape() const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity")
+	FGravityFieldSettings GravitySettings;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+};
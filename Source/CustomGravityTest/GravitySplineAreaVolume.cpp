@@ -0,0 +1,64 @@
+#include "GravitySplineAreaVolume.h"
+#include "Engine/CollisionProfile.h"
+#include "GravityFieldSubsystem.h"
+
+UGravitySplineAreaVolume::UGravitySplineAreaVolume()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Gravity is evaluated analytically, no physics queries involved.
+	SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	SetGenerateOverlapEvents(false);
+
+	InfluenceRadius = 1000.f;
+	SampleDistance = 100.f;
+}
+
+FGravityFieldShape UGravitySplineAreaVolume::BuildGravityFieldShape() const
+{
+	FGravityFieldShape Shape;
+	const float SplineLength = GetSplineLength();
+	const int32 NumSegments = FMath::Max(1, FMath::CeilToInt32(SplineLength / FMath::Max(SampleDistance, 1.f)));
+	Shape.Points.Reserve(NumSegments + 1);
+	for (int32 PointIndex = 0; PointIndex <= NumSegments; ++PointIndex)
+	{
+		const float Distance = SplineLength * PointIndex / NumSegments;
+		Shape.Points.Add(GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World));
+	}
+	Shape.Radius = InfluenceRadius;
+	Shape.Settings = GravitySettings;
+	return Shape;
+}
+
+void UGravitySplineAreaVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->RegisterGravityField(this, BuildGravityFieldShape());
+	}
+}
+
+void UGravitySplineAreaVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+	{
+		GravityFields->UnregisterGravityField(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGravitySplineAreaVolume::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	if (HasBegunPlay())
+	{
+		if (UGravityFieldSubsystem* GravityFields = UGravityFieldSubsystem::Get(this))
+		{
+			GravityFields->UpdateGravityField(this, BuildGravityFieldShape());
+		}
+	}
+}
@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SplineComponent.h"
+#include "GravityFieldTypes.h"
+#include "GravitySplineAreaVolume.generated.h"
+
+/**
+ * Spline following gravity field. Within InfluenceRadius of the spline, gravity pulls towards the closest point on it.
+ * The spline is baked to a polyline when play begins or the component moves, so evaluating it stays closed-form.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class CUSTOMGRAVITYTEST_API UGravitySplineAreaVolume : public USplineComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGravitySplineAreaVolume();
+
+	/** Builds the closed-form shape of this field from the current spline and component transform. */
+	FGravityFieldShape BuildGravityFieldShape() const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity")
+	FGravityFieldSettings GravitySettings;
+
+	/** Distance from the spline within which its gravity applies. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity", meta = (ClampMin = "0", UIMin = "0"))
+	float InfluenceRadius;
+
+	/** Distance along the spline between two points of the baked polyline. Smaller values follow curves more closely. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity", meta = (ClampMin = "1", UIMin = "1"))
+	float SampleDistance;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+};
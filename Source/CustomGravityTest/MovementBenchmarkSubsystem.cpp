@@ -0,0 +1,513 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MovementBenchmarkSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Character/BaseCharacterMovementComponent.h"
+#include "CustomGravityTestCharacter.h"
+#include "GravityBoxAreaVolume.h"
+#include "GravitySphereAreaVolume.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(MovementBenchmarkSubsystem)
+
+DEFINE_LOG_CATEGORY_STATIC(LogMovementBenchmark, Log, All);
+
+namespace MovementBenchmark
+{
+	/** Scenes are built far above the map so they don't interact with its content. */
+	static const FVector Origin(0.0, 0.0, 200000.0);
+
+	static const TCHAR* CubeMesh = TEXT("/Engine/BasicShapes/Cube.Cube");
+	static const TCHAR* SphereMesh = TEXT("/Engine/BasicShapes/Sphere.Sphere");
+
+	/** Size of the engine basic shapes at scale 1, centered on their pivot. */
+	static constexpr double BasicShapeSize = 100.0;
+
+	static constexpr double CharacterSpacing = 300.0;
+	static constexpr double PlatformSpacing = 500.0;
+
+	/** Frames between two changes of input direction, and between two jump attempts. */
+	static constexpr int32 InputInterval = 60;
+	static constexpr int32 JumpInterval = 120;
+	static constexpr float JumpChance = 0.25f;
+
+	static constexpr int32 RandomSeed = 0x6772;
+
+	/** Stairs are pyramids built from stacked slabs, low enough for StepUp() at the default MaxStepHeight. */
+	static constexpr int32 NumStairSteps = 8;
+	static constexpr double StairStepHeight = 30.0;
+	static constexpr double StairStepDepth = 60.0;
+
+	static constexpr double SeamStripWidth = 1000.0;
+	static constexpr double SeamTiltDegrees = 20.0;
+
+	static constexpr double PlanetRadius = 1500.0;
+	static constexpr double PlanetSeparation = 8000.0;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs MovementBenchmarkCommand(
+	TEXT("cg.MovementBenchmark"),
+	TEXT("Runs a movement benchmark in the current world and logs its results.\n")
+	TEXT("Usage: cg.MovementBenchmark [Scenario=Flat|GravitySeams|FieldFalling|Stairs|MovingBases] [Characters=64] [Warmup=60] [Frames=600] [Quit=0]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UMovementBenchmarkSubsystem* Benchmark = UMovementBenchmarkSubsystem::Get(World);
+		if (!Benchmark)
+		{
+			UE_LOG(LogMovementBenchmark, Warning, TEXT("cg.MovementBenchmark: only available in game worlds."));
+			return;
+		}
+
+		const FString Cmd = FString::Join(Args, TEXT(" "));
+
+		FString ScenarioName(TEXT("Flat"));
+		FParse::Value(*Cmd, TEXT("Scenario="), ScenarioName);
+		const int64 ScenarioValue = StaticEnum<EMovementBenchmarkScenario>()->GetValueByNameString(ScenarioName);
+		if (ScenarioValue == INDEX_NONE)
+		{
+			UE_LOG(LogMovementBenchmark, Warning, TEXT("cg.MovementBenchmark: unknown scenario '%s'."), *ScenarioName);
+			return;
+		}
+
+		int32 NumCharacters = 64;
+		int32 NumWarmupFrames = 60;
+		int32 NumFrames = 600;
+		bool bQuit = false;
+		FParse::Value(*Cmd, TEXT("Characters="), NumCharacters);
+		FParse::Value(*Cmd, TEXT("Warmup="), NumWarmupFrames);
+		FParse::Value(*Cmd, TEXT("Frames="), NumFrames);
+		FParse::Bool(*Cmd, TEXT("Quit="), bQuit);
+
+		Benchmark->StartBenchmark((EMovementBenchmarkScenario)ScenarioValue, NumCharacters, NumWarmupFrames, NumFrames, bQuit);
+	}));
+
+static FAutoConsoleCommandWithWorld MovementBenchmarkStopCommand(
+	TEXT("cg.MovementBenchmarkStop"),
+	TEXT("Stops the running movement benchmark without reporting."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UMovementBenchmarkSubsystem* Benchmark = UMovementBenchmarkSubsystem::Get(World))
+		{
+			Benchmark->StopBenchmark();
+		}
+	}));
+
+bool UMovementBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMovementBenchmarkSubsystem::Deinitialize()
+{
+	StopBenchmark();
+
+	Super::Deinitialize();
+}
+
+TStatId UMovementBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMovementBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+UMovementBenchmarkSubsystem* UMovementBenchmarkSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMovementBenchmarkSubsystem>() : nullptr;
+}
+
+void UMovementBenchmarkSubsystem::StartBenchmark(EMovementBenchmarkScenario InScenario, int32 InNumCharacters, int32 InNumWarmupFrames, int32 InNumFrames, bool bInQuitWhenDone)
+{
+	StopBenchmark();
+
+	Scenario = InScenario;
+	NumCharacters = FMath::Max(InNumCharacters, 1);
+	NumWarmupFrames = FMath::Max(InNumWarmupFrames, 0);
+	NumFrames = FMath::Max(InNumFrames, 1);
+	bQuitWhenDone = bInQuitWhenDone;
+
+	FrameIndex = 0;
+	Frames.Reset(NumFrames);
+
+	BuildScenario();
+
+	bRunning = true;
+	LastTickTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogMovementBenchmark, Display, TEXT("Starting %s benchmark: %d characters, %d warm up frames, %d measured frames."),
+		*StaticEnum<EMovementBenchmarkScenario>()->GetNameStringByValue((int64)Scenario), Characters.Num(), NumWarmupFrames, NumFrames);
+}
+
+void UMovementBenchmarkSubsystem::StopBenchmark()
+{
+	DestroyScenario();
+	bRunning = false;
+}
+
+void UMovementBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = FPlatformTime::Seconds();
+	const double FrameMs = (Now - LastTickTime) * 1000.0;
+	LastTickTime = Now;
+
+	// The characters ticked earlier this frame, under the input added by the previous one.
+	if (FrameIndex == NumWarmupFrames)
+	{
+		StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	}
+	else if (FrameIndex > NumWarmupFrames)
+	{
+		RecordFrame(FrameMs);
+	}
+
+	if (Frames.Num() >= NumFrames)
+	{
+		PeakUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		ReportResults();
+		StopBenchmark();
+
+		if (bQuitWhenDone)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+		return;
+	}
+
+	UpdateMovingBases();
+	UpdateInput();
+	++FrameIndex;
+}
+
+void UMovementBenchmarkSubsystem::BuildScenario()
+{
+	using namespace MovementBenchmark;
+
+	const double Spacing = Scenario == EMovementBenchmarkScenario::MovingBases ? PlatformSpacing : CharacterSpacing;
+	const int32 GridSize = FMath::CeilToInt32(FMath::Sqrt((double)NumCharacters));
+	const double GridHalfSize = GridSize * Spacing * 0.5;
+	const double AreaHalfSize = GridHalfSize + 1000.0;
+
+	auto GetGridOffset = [GridSize, GridHalfSize, Spacing](int32 Index)
+	{
+		return FVector2D((Index % GridSize + 0.5) * Spacing - GridHalfSize, (Index / GridSize + 0.5) * Spacing - GridHalfSize);
+	};
+
+	if (Scenario == EMovementBenchmarkScenario::FieldFalling)
+	{
+		// Characters start on a plane halfway between the planets, slightly off center so each one has a closest planet.
+		const FVector PlanetOffset(PlanetSeparation * 0.5, 0.0, 0.0);
+		const double FieldRadius = FMath::Sqrt(FMath::Square(PlanetSeparation * 0.5) + 2.0 * FMath::Square(GridHalfSize)) + 500.0;
+
+		for (const FVector& PlanetLocation : { Origin - PlanetOffset, Origin + PlanetOffset })
+		{
+			SpawnMeshActor(SphereMesh, FTransform(FQuat::Identity, PlanetLocation, FVector(PlanetRadius * 2.0 / BasicShapeSize)));
+			SpawnGravitySphere(PlanetLocation, FieldRadius);
+		}
+
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			const FVector2D GridOffset = GetGridOffset(Index);
+			const double Side = (Index & 1) ? 1.0 : -1.0;
+			SpawnCharacter(Origin + FVector(Side * 200.0, GridOffset.X, GridOffset.Y), FVector(-Side, 0.0, 0.0));
+		}
+		return;
+	}
+
+	// Every other scenario walks on a floor under world gravity, seams and stairs are added on top. Flat measures movement without any gravity field.
+	const double FloorSize = AreaHalfSize * 2.0 / BasicShapeSize;
+	SpawnMeshActor(CubeMesh, FTransform(FQuat::Identity, Origin - FVector(0.0, 0.0, BasicShapeSize * 0.5), FVector(FloorSize, FloorSize, 1.0)));
+	if (Scenario != EMovementBenchmarkScenario::Flat)
+	{
+		SpawnGravityBox(FTransform(Origin + FVector(0.0, 0.0, 1000.0)), FVector(AreaHalfSize, AreaHalfSize, 2000.0));
+	}
+
+	double SpawnHeight = 150.0;
+
+	if (Scenario == EMovementBenchmarkScenario::GravitySeams)
+	{
+		// Strips smaller than the world gravity box take priority over it.
+		const int32 NumStrips = FMath::CeilToInt32(AreaHalfSize * 2.0 / SeamStripWidth);
+		for (int32 Strip = 0; Strip < NumStrips; ++Strip)
+		{
+			const double X = -AreaHalfSize + (Strip + 0.5) * SeamStripWidth;
+			const FQuat Tilt(FVector::ForwardVector, FMath::DegreesToRadians((Strip & 1) ? SeamTiltDegrees : -SeamTiltDegrees));
+			SpawnGravityBox(FTransform(Tilt, Origin + FVector(X, 0.0, 500.0)), FVector(SeamStripWidth * 0.5, AreaHalfSize - 100.0, 1000.0));
+		}
+	}
+	else if (Scenario == EMovementBenchmarkScenario::Stairs)
+	{
+		// Pyramids of slabs across the whole area, characters walk over them along X.
+		const double PyramidWidth = NumStairSteps * StairStepDepth * 2.0;
+		const double PyramidSpacing = PyramidWidth + 600.0;
+		for (double X = -AreaHalfSize + PyramidSpacing * 0.5; X < AreaHalfSize; X += PyramidSpacing)
+		{
+			for (int32 Step = 0; Step < NumStairSteps; ++Step)
+			{
+				const double StepWidth = PyramidWidth - Step * StairStepDepth * 2.0;
+				const FVector Location = Origin + FVector(X, 0.0, (Step + 0.5) * StairStepHeight);
+				SpawnMeshActor(CubeMesh, FTransform(FQuat::Identity, Location, FVector(StepWidth, AreaHalfSize * 2.0, StairStepHeight) / BasicShapeSize));
+			}
+		}
+		SpawnHeight += NumStairSteps * StairStepHeight;
+	}
+	else if (Scenario == EMovementBenchmarkScenario::MovingBases)
+	{
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			const FVector2D GridOffset = GetGridOffset(Index);
+			const FVector Location = Origin + FVector(GridOffset.X, GridOffset.Y, 300.0);
+			if (AActor* Platform = SpawnMeshActor(CubeMesh, FTransform(FQuat::Identity, Location, FVector(3.0, 3.0, 0.3)), EComponentMobility::Movable))
+			{
+				Platforms.Add(Platform);
+				PlatformOrigins.Add(Location);
+			}
+		}
+		SpawnHeight += 350.0;
+	}
+
+	for (int32 Index = 0; Index < NumCharacters; ++Index)
+	{
+		const FVector2D GridOffset = GetGridOffset(Index);
+		SpawnCharacter(Origin + FVector(GridOffset.X, GridOffset.Y, SpawnHeight), UBaseCharacterMovementComponent::DefaultGravityDirection);
+	}
+}
+
+AActor* UMovementBenchmarkSubsystem::SpawnMeshActor(const TCHAR* MeshPath, const FTransform& Transform, EComponentMobility::Type Mobility)
+{
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, MeshPath);
+	if (!Mesh)
+	{
+		UE_LOG(LogMovementBenchmark, Warning, TEXT("Could not load %s, the scene will be incomplete."), MeshPath);
+		return nullptr;
+	}
+
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	Params.ObjectFlags |= RF_Transient;
+
+	AStaticMeshActor* Actor = GetWorld()->SpawnActor<AStaticMeshActor>(Transform.GetLocation(), Transform.Rotator(), Params);
+	if (Actor)
+	{
+		// Set up the component while unregistered, a registered static component can't change its mesh or transform.
+		// Only moving platforms are movable, so the floors aren't dynamic movement bases.
+		UStaticMeshComponent* MeshComponent = Actor->GetStaticMeshComponent();
+		MeshComponent->UnregisterComponent();
+		MeshComponent->SetMobility(Mobility);
+		MeshComponent->SetStaticMesh(Mesh);
+		MeshComponent->SetWorldScale3D(Transform.GetScale3D());
+		MeshComponent->RegisterComponent();
+		SceneActors.Add(Actor);
+	}
+	return Actor;
+}
+
+AActor* UMovementBenchmarkSubsystem::SpawnGravityBox(const FTransform& Transform, const FVector& Extent)
+{
+	FActorSpawnParameters Params;
+	Params.ObjectFlags |= RF_Transient;
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), Transform, Params);
+	if (Actor)
+	{
+		// Registering after the actor began play runs the component BeginPlay, which adds the box to the gravity field subsystem.
+		UGravityBoxAreaVolume* Box = NewObject<UGravityBoxAreaVolume>(Actor);
+		Box->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+		Box->SetBoxExtent(Extent, false);
+		Box->SetWorldTransform(Transform);
+		Actor->SetRootComponent(Box);
+		Box->RegisterComponent();
+		SceneActors.Add(Actor);
+	}
+	return Actor;
+}
+
+AActor* UMovementBenchmarkSubsystem::SpawnGravitySphere(const FVector& Location, float Radius)
+{
+	FActorSpawnParameters Params;
+	Params.ObjectFlags |= RF_Transient;
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location), Params);
+	if (Actor)
+	{
+		UGravitySphereAreaVolume* Sphere = NewObject<UGravitySphereAreaVolume>(Actor);
+		Sphere->SetSphereRadius(Radius, false);
+		Sphere->SetWorldLocation(Location);
+		Actor->SetRootComponent(Sphere);
+		Sphere->RegisterComponent();
+		SceneActors.Add(Actor);
+	}
+	return Actor;
+}
+
+ACustomGravityTestCharacter* UMovementBenchmarkSubsystem::SpawnCharacter(const FVector& Location, const FVector& GravityDirection)
+{
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	Params.ObjectFlags |= RF_Transient;
+
+	const FRotator Rotation = FRotationMatrix::MakeFromZ(-GravityDirection).Rotator();
+	ACustomGravityTestCharacter* Character = GetWorld()->SpawnActor<ACustomGravityTestCharacter>(ACustomGravityTestCharacter::StaticClass(), Location, Rotation, Params);
+	if (Character)
+	{
+		// No controller, the benchmark adds the input itself.
+		UBaseCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement();
+		MovementComponent->bRunPhysicsWithNoController = true;
+		MovementComponent->SetGravityDirection(GravityDirection);
+		Characters.Add(Character);
+	}
+	return Character;
+}
+
+void UMovementBenchmarkSubsystem::UpdateMovingBases()
+{
+	// Driven by the frame index rather than time, so platforms follow the same path whatever the frame rate.
+	const double Time = FrameIndex / 60.0;
+	for (int32 Index = 0; Index < Platforms.Num(); ++Index)
+	{
+		if (AActor* Platform = Platforms[Index])
+		{
+			const double Phase = Index * 0.37;
+			const FVector Offset(FMath::Sin(Time * 0.8 + Phase) * 150.0, FMath::Cos(Time * 0.6 + Phase) * 150.0, FMath::Sin(Time * 1.1 + Phase) * 80.0);
+			Platform->SetActorLocation(PlatformOrigins[Index] + Offset);
+		}
+	}
+}
+
+void UMovementBenchmarkSubsystem::UpdateInput()
+{
+	using namespace MovementBenchmark;
+
+	const bool bWalkAlongX = Scenario == EMovementBenchmarkScenario::GravitySeams || Scenario == EMovementBenchmarkScenario::Stairs;
+
+	for (int32 Index = 0; Index < Characters.Num(); ++Index)
+	{
+		ACustomGravityTestCharacter* Character = Characters[Index];
+		if (!IsValid(Character))
+		{
+			continue;
+		}
+
+		// Seeded from the character and the current interval only, so every run replays the same input.
+		FRandomStream Stream(RandomSeed + Index * 7919 + FrameIndex / InputInterval);
+
+		FVector WishDirection = Stream.GetUnitVector();
+		if (bWalkAlongX)
+		{
+			const double Side = ((FrameIndex / (InputInterval * 4) + Index) & 1) ? 1.0 : -1.0;
+			WishDirection = FVector(Side, Stream.FRandRange(-0.3f, 0.3f), 0.0);
+		}
+
+		const FVector GravityDirection = Character->GetCharacterMovement()->GetGravityDirection();
+		Character->AddMovementInput(FVector::VectorPlaneProject(WishDirection, GravityDirection).GetSafeNormal());
+
+		Character->StopJumping();
+		if ((FrameIndex + Index) % JumpInterval == 0 && Stream.FRand() < JumpChance)
+		{
+			Character->Jump();
+		}
+	}
+}
+
+void UMovementBenchmarkSubsystem::RecordFrame(double FrameMs)
+{
+	FMovementBenchmarkFrame& Frame = Frames.AddDefaulted_GetRef();
+	Frame.FrameMs = FrameMs;
+
+	uint64 MovementCycles = 0;
+	for (const ACustomGravityTestCharacter* Character : Characters)
+	{
+		FBaseCharacterMovementCounters Counters;
+		uint64 TickCycles, TickFrame;
+		if (IsValid(Character) && Character->GetCharacterMovement()->GetLastMovementCounters(Counters, TickCycles, TickFrame) && TickFrame == GFrameCounter)
+		{
+			MovementCycles += TickCycles;
+			Frame.Sweeps += Counters.Sweeps;
+			Frame.FloorProbes += Counters.FloorProbes;
+			Frame.StepUps += Counters.StepUps;
+			Frame.SlideIterations += Counters.SlideIterations;
+			Frame.Substeps += Counters.Substeps;
+			Frame.GravityFieldLookups += Counters.GravityFieldLookups;
+		}
+	}
+
+	Frame.MovementMs = FPlatformTime::ToMilliseconds64(MovementCycles);
+}
+
+void UMovementBenchmarkSubsystem::ReportResults()
+{
+	const FString ScenarioName = StaticEnum<EMovementBenchmarkScenario>()->GetNameStringByValue((int64)Scenario);
+	UE_LOG(LogMovementBenchmark, Display, TEXT("%s benchmark, %d characters, %d frames:"), *ScenarioName, Characters.Num(), Frames.Num());
+
+	auto Summarize = [this](const TCHAR* Name, TFunctionRef<double(const FMovementBenchmarkFrame&)> GetValue)
+	{
+		TArray<double> Values;
+		Values.Reserve(Frames.Num());
+		double Sum = 0.0;
+		for (const FMovementBenchmarkFrame& Frame : Frames)
+		{
+			Sum += Values.Add_GetRef(GetValue(Frame));
+		}
+		Values.Sort();
+
+		auto Percentile = [&Values](double Fraction) { return Values[FMath::Min(FMath::FloorToInt32(Values.Num() * Fraction), Values.Num() - 1)]; };
+		UE_LOG(LogMovementBenchmark, Display, TEXT("  %-20s avg %9.3f  p50 %9.3f  p95 %9.3f  max %9.3f"), Name, Sum / Values.Num(), Percentile(0.5), Percentile(0.95), Values.Last());
+	};
+
+	Summarize(TEXT("Frame ms"), [](const FMovementBenchmarkFrame& Frame) { return Frame.FrameMs; });
+	Summarize(TEXT("Movement ms"), [](const FMovementBenchmarkFrame& Frame) { return Frame.MovementMs; });
+	Summarize(TEXT("Sweeps"), [](const FMovementBenchmarkFrame& Frame) { return (double)Frame.Sweeps; });
+	Summarize(TEXT("Floor probes"), [](const FMovementBenchmarkFrame& Frame) { return (double)Frame.FloorProbes; });
+	Summarize(TEXT("Step ups"), [](const FMovementBenchmarkFrame& Frame) { return (double)Frame.StepUps; });
+	Summarize(TEXT("Slide iterations"), [](const FMovementBenchmarkFrame& Frame) { return (double)Frame.SlideIterations; });
+	Summarize(TEXT("Substeps"), [](const FMovementBenchmarkFrame& Frame) { return (double)Frame.Substeps; });
+	Summarize(TEXT("Gravity lookups"), [](const FMovementBenchmarkFrame& Frame) { return (double)Frame.GravityFieldLookups; });
+
+	// Growth of the process memory over the measure. Run with -trace=memory for allocation counts and call sites.
+	const double MemoryGrowthKB = ((double)PeakUsedPhysical - (double)StartUsedPhysical) / 1024.0;
+	UE_LOG(LogMovementBenchmark, Display, TEXT("  %-20s %.1f KB"), TEXT("Memory growth"), MemoryGrowthKB);
+
+	FString Csv(TEXT("Frame,FrameMs,MovementMs,Sweeps,FloorProbes,StepUps,SlideIterations,Substeps,GravityFieldLookups\n"));
+	for (int32 Index = 0; Index < Frames.Num(); ++Index)
+	{
+		const FMovementBenchmarkFrame& Frame = Frames[Index];
+		Csv += FString::Printf(TEXT("%d,%.4f,%.4f,%d,%d,%d,%d,%d,%d\n"), Index, Frame.FrameMs, Frame.MovementMs,
+			Frame.Sweeps, Frame.FloorProbes, Frame.StepUps, Frame.SlideIterations, Frame.Substeps, Frame.GravityFieldLookups);
+	}
+
+	const FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("MovementBenchmark_%s_%d.csv"), *ScenarioName, Characters.Num());
+	if (FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		UE_LOG(LogMovementBenchmark, Display, TEXT("  Frames saved to %s"), *CsvPath);
+	}
+}
+
+void UMovementBenchmarkSubsystem::DestroyScenario()
+{
+	for (ACustomGravityTestCharacter* Character : Characters)
+	{
+		if (IsValid(Character))
+		{
+			Character->Destroy();
+		}
+	}
+
+	for (AActor* Actor : SceneActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
+	}
+
+	Characters.Reset();
+	SceneActors.Reset();
+	Platforms.Reset();
+	PlatformOrigins.Reset();
+}
@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MovementBenchmarkSubsystem.generated.h"
+
+class ACustomGravityTestCharacter;
+
+/** Scripted scene a movement benchmark runs in. */
+UENUM()
+enum class EMovementBenchmarkScenario : uint8
+{
+	/** Flat floor under world gravity, outside of every gravity field. */
+	Flat,
+	/** Flat floor split in strips of gravity boxes tilted alternately, characters walk across the seams. */
+	GravitySeams,
+	/** Two overlapping planets, characters start in the air between them and fall into one of the fields. */
+	FieldFalling,
+	/** Rows of stairs, characters walk up and down them. */
+	Stairs,
+	/** Each character stands on its own moving platform. */
+	MovingBases,
+};
+
+/** Statistics of a single measured frame of a movement benchmark. */
+struct FMovementBenchmarkFrame
+{
+	/** Game thread frame time. */
+	double FrameMs = 0.0;
+
+	/** Sum of the movement component tick times of the benchmark characters. */
+	double MovementMs = 0.0;
+
+	int32 Sweeps = 0;
+	int32 FloorProbes = 0;
+	int32 StepUps = 0;
+	int32 SlideIterations = 0;
+	int32 Substeps = 0;
+	int32 GravityFieldLookups = 0;
+};
+
+/**
+ * Headless movement benchmark, run with the cg.MovementBenchmark console command.
+ *
+ * Builds the scene of a scenario away from the current map, spawns a number of ACustomGravityTestCharacter without controllers
+ * and drives them with deterministic input. After a warm up, records the frame time, the movement time and the movement counters
+ * of every frame (see FBaseCharacterMovementCounters), then logs a summary, writes every frame to Saved/Benchmarks and cleans up.
+ *
+ * For comparable results, run with a fixed time step, for instance:
+ *   -game -nullrhi -benchmark -fps=60 -ExecCmds="cg.MovementBenchmark Scenario=Stairs Characters=256 Quit=1"
+ */
+UCLASS()
+class UMovementBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return bRunning; }
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/**
+	 * Starts a benchmark, replacing the one running if any.
+	 * @param NumCharacters		Number of characters to spawn.
+	 * @param NumWarmupFrames	Frames run before measuring, lets characters settle on the floor.
+	 * @param NumFrames			Frames measured.
+	 * @param bQuitWhenDone		Request the application to exit once the results are reported.
+	 */
+	void StartBenchmark(EMovementBenchmarkScenario Scenario, int32 NumCharacters, int32 NumWarmupFrames, int32 NumFrames, bool bQuitWhenDone);
+
+	/** Stops the running benchmark without reporting and removes its scene. */
+	void StopBenchmark();
+
+	bool IsRunning() const { return bRunning; }
+
+	/** Helper to get the subsystem of the world an object lives in. May return null. */
+	static UMovementBenchmarkSubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	/** Spawns the scene of Scenario and places the characters in it. */
+	void BuildScenario();
+
+	AActor* SpawnMeshActor(const TCHAR* MeshPath, const FTransform& Transform, EComponentMobility::Type Mobility = EComponentMobility::Static);
+	AActor* SpawnGravityBox(const FTransform& Transform, const FVector& Extent);
+	AActor* SpawnGravitySphere(const FVector& Location, float Radius);
+	ACustomGravityTestCharacter* SpawnCharacter(const FVector& Location, const FVector& GravityDirection);
+
+	/** Moves the platforms of the MovingBases scenario. */
+	void UpdateMovingBases();
+
+	/** Adds this frame's movement input to every character. */
+	void UpdateInput();
+
+	/** Sums the movement counters reported by the characters this frame. */
+	void RecordFrame(double FrameMs);
+
+	/** Logs and saves the summary of the recorded frames. */
+	void ReportResults();
+
+	void DestroyScenario();
+
+	EMovementBenchmarkScenario Scenario = EMovementBenchmarkScenario::Flat;
+	int32 NumCharacters = 0;
+	int32 NumWarmupFrames = 0;
+	int32 NumFrames = 0;
+	bool bQuitWhenDone = false;
+
+	bool bRunning = false;
+
+	/** Frames run since the benchmark started, warm up included. */
+	int32 FrameIndex = 0;
+
+	/** Time of the last tick, for the frame time. */
+	double LastTickTime = 0.0;
+
+	/** Process memory in use when the measure started. */
+	uint64 StartUsedPhysical = 0;
+	uint64 PeakUsedPhysical = 0;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ACustomGravityTestCharacter>> Characters;
+
+	/** Scene actors spawned by the scenario. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> SceneActors;
+
+	/** MovingBases platforms and their rest location, one per character. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> Platforms;
+	TArray<FVector> PlatformOrigins;
+
+	TArray<FMovementBenchmarkFrame> Frames;
+};
@@ -0,0 +1,260 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ServerMoveReplaySubsystem.h"
+#include "Engine/World.h"
+#include "Misc/Paths.h"
+#include "Character/BaseCharacter.h"
+#include "Character/BaseCharacterMovementComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ServerMoveReplaySubsystem)
+
+DEFINE_LOG_CATEGORY_STATIC(LogServerMoveReplay, Log, All);
+
+namespace ServerMoveReplayCVars
+{
+	static float EndLocationTolerance = 1.f;
+	FAutoConsoleVariableRef CVarEndLocationTolerance(
+		TEXT("cg.ReplayServerMovesEndLocationTolerance"),
+		EndLocationTolerance,
+		TEXT("Distance between the replayed and recorded end location of a character beyond which cg.ReplayServerMoves reports it as diverged."),
+		ECVF_Default);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ReplayServerMovesCommand(
+	TEXT("cg.ReplayServerMoves"),
+	TEXT("Replays client moves recorded with cg.RecordServerMoves through the server move path and logs the time spent.\n")
+	TEXT("Usage: cg.ReplayServerMoves <Filename> [Quit=0]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UServerMoveReplaySubsystem* Replay = UServerMoveReplaySubsystem::Get(World);
+		if (!Replay || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogServerMoveReplay, Warning, TEXT("cg.ReplayServerMoves: only available on servers and standalone games."));
+			return;
+		}
+
+		if (Args.Num() == 0)
+		{
+			UE_LOG(LogServerMoveReplay, Warning, TEXT("cg.ReplayServerMoves: missing filename."));
+			return;
+		}
+
+		const FString Cmd = FString::Join(Args, TEXT(" "));
+		bool bQuit = false;
+		FParse::Bool(*Cmd, TEXT("Quit="), bQuit);
+
+		// Relative paths are relative to the project, like the default recording location.
+		const FString Filename = FPaths::IsRelative(Args[0]) ? FPaths::ProjectDir() / Args[0] : Args[0];
+		if (!Replay->StartReplay(Filename, bQuit))
+		{
+			UE_LOG(LogServerMoveReplay, Warning, TEXT("cg.ReplayServerMoves: could not load %s."), *Filename);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld StopReplayingServerMovesCommand(
+	TEXT("cg.StopReplayingServerMoves"),
+	TEXT("Stops the replay started by cg.ReplayServerMoves without reporting."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UServerMoveReplaySubsystem* Replay = UServerMoveReplaySubsystem::Get(World))
+		{
+			Replay->StopReplay();
+		}
+	}));
+
+bool UServerMoveReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UServerMoveReplaySubsystem::Deinitialize()
+{
+	StopReplay();
+
+	Super::Deinitialize();
+}
+
+TStatId UServerMoveReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UServerMoveReplaySubsystem, STATGROUP_Tickables);
+}
+
+UServerMoveReplaySubsystem* UServerMoveReplaySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UServerMoveReplaySubsystem>() : nullptr;
+}
+
+bool UServerMoveReplaySubsystem::StartReplay(const FString& Filename, bool bInQuitWhenDone)
+{
+	StopReplay();
+
+	if (!Recording.Load(Filename))
+	{
+		return false;
+	}
+
+	UE_CLOG(Recording.MapName != GetWorld()->GetMapName(), LogServerMoveReplay, Warning, TEXT("Replaying moves recorded in %s in %s, movement bases won't be found and characters will likely be corrected."),
+		*Recording.MapName, *GetWorld()->GetMapName());
+
+	bQuitWhenDone = bInQuitWhenDone;
+	FrameIndex = 0;
+	NextMoveIndex = 0;
+	FrameMs.Reset(Recording.Moves.Num() > 0 ? Recording.Moves.Last().Frame + 1 : 0);
+	NumMovesReplayed = 0;
+	NumCorrections = 0;
+
+	PackageMap = NewObject<UBaseCharacterMoveRecordingPackageMap>(GetWorld());
+	SpawnCharacters();
+
+	bRunning = true;
+
+	UE_LOG(LogServerMoveReplay, Display, TEXT("Replaying %d moves from %d characters recorded in %s."), Recording.Moves.Num(), Recording.Streams.Num(), *Recording.MapName);
+	return true;
+}
+
+void UServerMoveReplaySubsystem::StopReplay()
+{
+	DestroyCharacters();
+
+	Recording = FBaseCharacterMoveRecording();
+	PackageMap = nullptr;
+	bRunning = false;
+}
+
+void UServerMoveReplaySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (NextMoveIndex >= Recording.Moves.Num())
+	{
+		ReportResults();
+		StopReplay();
+
+		if (bQuitWhenDone)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+		return;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	// Moves of a recorded frame arrived between two server updates, feed them the same way.
+	for (; NextMoveIndex < Recording.Moves.Num() && Recording.Moves[NextMoveIndex].Frame <= FrameIndex; ++NextMoveIndex)
+	{
+		const FBaseCharacterRecordedMove& Move = Recording.Moves[NextMoveIndex];
+		ABaseCharacter* Character = Characters[Move.StreamIndex];
+		if (IsValid(Character))
+		{
+			Recording.GetMoveBits(Move, PackedBits);
+			Character->GetCharacterMovement()->ServerMovePacked_ServerReceive(PackedBits);
+			++NumMovesReplayed;
+		}
+	}
+
+	// Then handle moves batched for the movement manager and generate corrections, as the net driver would when replicating.
+	for (ABaseCharacter* Character : Characters)
+	{
+		if (IsValid(Character))
+		{
+			UBaseCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement();
+			MovementComponent->ProcessQueuedServerMoves();
+
+			const uint16 CorrectionsSent = MovementComponent->GetMovementCounters().CorrectionsSent;
+			MovementComponent->SendClientAdjustment();
+			NumCorrections += (uint16)(MovementComponent->GetMovementCounters().CorrectionsSent - CorrectionsSent);
+		}
+	}
+
+	FrameMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+	++FrameIndex;
+}
+
+void UServerMoveReplaySubsystem::SpawnCharacters()
+{
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	Params.ObjectFlags |= RF_Transient;
+
+	Characters.Reset(Recording.Streams.Num());
+	for (const FBaseCharacterRecordedStream& Stream : Recording.Streams)
+	{
+		UClass* CharacterClass = Stream.CharacterClass.TryLoadClass<ABaseCharacter>();
+		ABaseCharacter* Character = CharacterClass ? GetWorld()->SpawnActor<ABaseCharacter>(CharacterClass, Stream.Location, Stream.Rotation.Rotator(), Params) : nullptr;
+		if (Character)
+		{
+			// Owned by a remote client as far as the server move path is concerned, without a connection to send responses to.
+			Character->SetAutonomousProxy(true);
+
+			// No controller, which would otherwise skip the physics of every replayed move. Only the replayed moves may move the
+			// character though, the regular tick would run an extra move without input every frame.
+			UBaseCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement();
+			MovementComponent->bRunPhysicsWithNoController = true;
+			MovementComponent->SetComponentTickEnabled(false);
+			MovementComponent->SetServerMoveReplayPackageMap(PackageMap);
+			MovementComponent->SetGravityDirection(Stream.GravityDirection);
+		}
+		else
+		{
+			UE_LOG(LogServerMoveReplay, Warning, TEXT("Could not spawn a %s, its moves will be skipped."), *Stream.CharacterClass.ToString());
+		}
+		Characters.Add(Character);
+	}
+}
+
+void UServerMoveReplaySubsystem::ReportResults()
+{
+	double TotalMs = 0.0;
+	for (double Ms : FrameMs)
+	{
+		TotalMs += Ms;
+	}
+
+	TArray<double> SortedFrameMs = FrameMs;
+	SortedFrameMs.Sort();
+	auto Percentile = [&SortedFrameMs](double Fraction) { return SortedFrameMs.Num() > 0 ? SortedFrameMs[FMath::Min(FMath::FloorToInt32(SortedFrameMs.Num() * Fraction), SortedFrameMs.Num() - 1)] : 0.0; };
+
+	UE_LOG(LogServerMoveReplay, Display, TEXT("Replayed %d moves from %d characters over %d frames:"), NumMovesReplayed, Characters.Num(), FrameMs.Num());
+	UE_LOG(LogServerMoveReplay, Display, TEXT("  Total %.3f ms, %.0f moves/s, %.3f us/move"),
+		TotalMs, TotalMs > 0.0 ? NumMovesReplayed * 1000.0 / TotalMs : 0.0, NumMovesReplayed > 0 ? TotalMs * 1000.0 / NumMovesReplayed : 0.0);
+	UE_LOG(LogServerMoveReplay, Display, TEXT("  Frame ms  avg %.3f  p50 %.3f  p95 %.3f  max %.3f"),
+		FrameMs.Num() > 0 ? TotalMs / FrameMs.Num() : 0.0, Percentile(0.5), Percentile(0.95), SortedFrameMs.Num() > 0 ? SortedFrameMs.Last() : 0.0);
+	UE_LOG(LogServerMoveReplay, Display, TEXT("  Corrections sent %d"), NumCorrections);
+
+	// Moves carry their own timestamps and accelerations, so on the same map and build characters should end up where they were recorded.
+	int32 NumChecked = 0;
+	int32 NumDiverged = 0;
+	for (int32 StreamIndex = 0; StreamIndex < Recording.Streams.Num(); ++StreamIndex)
+	{
+		const FBaseCharacterRecordedStream& Stream = Recording.Streams[StreamIndex];
+		const ABaseCharacter* Character = Characters[StreamIndex];
+		if (!Stream.bHasEndLocation || !IsValid(Character))
+		{
+			continue;
+		}
+
+		++NumChecked;
+		const double Distance = FVector::Dist(Character->GetActorLocation(), Stream.EndLocation);
+		if (Distance > ServerMoveReplayCVars::EndLocationTolerance)
+		{
+			++NumDiverged;
+			UE_LOG(LogServerMoveReplay, Warning, TEXT("  Character %d (%s) ended %.2f away from its recorded location, at %s instead of %s"),
+				StreamIndex, *Character->GetName(), Distance, *Character->GetActorLocation().ToCompactString(), *Stream.EndLocation.ToCompactString());
+		}
+	}
+	UE_LOG(LogServerMoveReplay, Display, TEXT("  End locations matched %d/%d"), NumChecked - NumDiverged, NumChecked);
+}
+
+void UServerMoveReplaySubsystem::DestroyCharacters()
+{
+	for (ABaseCharacter* Character : Characters)
+	{
+		if (IsValid(Character))
+		{
+			Character->Destroy();
+		}
+	}
+
+	Characters.Reset();
+}
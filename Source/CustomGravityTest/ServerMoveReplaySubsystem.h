@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Character/BaseCharacterMoveRecording.h"
+#include "Character/BaseCharacterMovementReplication.h"
+#include "ServerMoveReplaySubsystem.generated.h"
+
+class ABaseCharacter;
+
+/**
+ * Replays client moves recorded with cg.RecordServerMoves, run with the cg.ReplayServerMoves console command.
+ *
+ * Spawns a character without controller for each recorded stream, then every frame feeds the moves recorded during the matching
+ * server frame through UBaseCharacterMovementComponent::ServerMovePacked_ServerReceive(), including client error checks and correction
+ * generation, and logs the time spent once all of them are replayed. It then checks that every character ended up where it was when
+ * the recording stopped, within cg.ReplayServerMovesEndLocationTolerance. Replay in the map the moves were recorded in.
+ *
+ * Run on a headless server with a fixed time step to replay as fast as possible, for instance:
+ *   -server -nullrhi -benchmark -ExecCmds="cg.ReplayServerMoves Saved/MoveRecordings/Session.cgmoves Quit=1"
+ */
+UCLASS()
+class UServerMoveReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return bRunning; }
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/**
+	 * Loads a recording and starts replaying it, replacing the replay running if any. Returns false if the file could not be loaded.
+	 * @param bQuitWhenDone		Request the application to exit once the results are reported.
+	 */
+	bool StartReplay(const FString& Filename, bool bQuitWhenDone);
+
+	/** Stops the running replay without reporting and destroys its characters. */
+	void StopReplay();
+
+	bool IsRunning() const { return bRunning; }
+
+	/** Helper to get the subsystem of the world an object lives in. May return null. */
+	static UServerMoveReplaySubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+private:
+	/** Spawns the character of every recorded stream. */
+	void SpawnCharacters();
+
+	/** Logs the summary of the replay. */
+	void ReportResults();
+
+	void DestroyCharacters();
+
+	FBaseCharacterMoveRecording Recording;
+
+	/** Bits of the move being fed to the server, kept to reuse its allocation. */
+	FBaseCharacterServerMovePackedBits PackedBits;
+
+	bool bQuitWhenDone = false;
+	bool bRunning = false;
+
+	/** Recorded frame replayed next, and the first of its moves. */
+	uint32 FrameIndex = 0;
+	int32 NextMoveIndex = 0;
+
+	/** Time spent replaying each frame, and totals over the replay. */
+	TArray<double> FrameMs;
+	int32 NumMovesReplayed = 0;
+	int32 NumCorrections = 0;
+
+	/** Character of each stream, null if it could not be spawned. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ABaseCharacter>> Characters;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UBaseCharacterMoveRecordingPackageMap> PackageMap;
+};